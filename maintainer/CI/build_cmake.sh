@@ -100,6 +100,8 @@ set_default_value with_ccache false
 set_default_value with_hdf5 true
 set_default_value with_scafacos false
 set_default_value with_stokesian_dynamics false
+set_default_value with_openmp false
+set_default_value omp_num_threads 2
 set_default_value test_timeout 300
 set_default_value hide_gpu false
 
@@ -142,6 +144,14 @@ else
     cmake_params="${cmake_params} -DWITH_STOKESIAN_DYNAMICS=OFF"
 fi
 
+if [ "${with_openmp}" = true ]; then
+    cmake_params="${cmake_params} -DWITH_OPENMP=ON"
+    # run the threaded code paths in the tests
+    export OMP_NUM_THREADS="${omp_num_threads}"
+else
+    cmake_params="${cmake_params} -DWITH_OPENMP=OFF"
+fi
+
 if [ "${with_coverage}" = true ]; then
     cmake_params="-DWITH_COVERAGE=ON ${cmake_params}"
 fi
@@ -184,7 +194,8 @@ outp srcdir builddir \
     check_odd_only \
     with_static_analysis myconfig \
     build_procs check_procs \
-    with_cuda with_cuda_compiler with_ccache
+    with_cuda with_cuda_compiler with_ccache \
+    with_openmp omp_num_threads
 
 echo "Creating ${builddir}..."
 mkdir -p "${builddir}"
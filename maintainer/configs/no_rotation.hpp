@@ -42,6 +42,7 @@
 
 // Hydrodynamics
 #define LB_BOUNDARIES
+#define LB_SINGLE_PRECISION
 #ifdef CUDA
 #define LB_BOUNDARIES_GPU
 #endif
@@ -26,6 +26,8 @@
 
 #include <boost/range/iterator_range.hpp>
 
+#include <cassert>
+#include <cstdint>
 #include <functional>
 #include <vector>
 
@@ -94,6 +96,63 @@ private:
   iterator m_red_black_divider;
 };
 
+/**
+ * @brief Verlet list of the particles of a cell.
+ *
+ * The list is stored in compressed sparse row format: the interaction
+ * partners of the i-th particle of the cell are stored as indices into
+ * the packed particle index in the elements offsets[i] to
+ * offsets[i + 1] - 1 of the partner array. This needs 4 bytes per pair
+ * and per particle, and the partners of a particle are contiguous.
+ */
+class VerletList {
+  std::vector<std::uint32_t> m_offsets;
+  std::vector<std::uint32_t> m_partners;
+
+public:
+  void clear() {
+    m_offsets.clear();
+    m_partners.clear();
+  }
+
+  /**
+   * @brief Add a pair.
+   *
+   * Pairs have to be added in ascending order of @p i.
+   *
+   * @param i Index of the particle in the cell.
+   * @param j Packed index of the interaction partner.
+   */
+  void add_pair(int i, int j) {
+    assert(m_offsets.size() <= static_cast<std::size_t>(i) + 1);
+    while (m_offsets.size() <= static_cast<std::size_t>(i)) {
+      m_offsets.push_back(static_cast<std::uint32_t>(m_partners.size()));
+    }
+    m_partners.push_back(static_cast<std::uint32_t>(j));
+  }
+
+  /**
+   * @brief Complete the list after all pairs were added.
+   *
+   * @param n_part Number of particles in the cell.
+   */
+  void finalize(int n_part) {
+    m_offsets.resize(n_part + 1,
+                     static_cast<std::uint32_t>(m_partners.size()));
+  }
+
+  /** Number of particles in the list. */
+  int n_particles() const {
+    return m_offsets.empty() ? 0 : static_cast<int>(m_offsets.size()) - 1;
+  }
+
+  /** Interaction partners of the i-th particle. */
+  Utils::Span<const std::uint32_t> partners(int i) const {
+    return {m_partners.data() + m_offsets[i],
+            m_offsets[i + 1] - m_offsets[i]};
+  }
+};
+
 class Cell {
   using neighbors_type = Neighbors<Cell *>;
 
@@ -106,8 +165,12 @@ public:
 
   neighbors_type m_neighbors;
 
-  /** Interaction pairs */
-  std::vector<std::pair<Particle *, Particle *>> m_verlet_list;
+  /** Index of the first particle of this cell in the packed
+   *  particle index of the cell structure. */
+  int m_packed_offset = 0;
+
+  /** Interaction pairs of the particles of this cell */
+  VerletList m_verlet_list;
 
   /**
    * @brief All neighbors of the cell.
@@ -24,9 +24,17 @@
 #include "AtomDecomposition.hpp"
 #include "DomainDecomposition.hpp"
 
+#include <utils/Vector.hpp>
 #include <utils/contains.hpp>
+#include <utils/morton.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 void CellStructure::check_particle_index() {
   auto const max_id = get_max_local_particle_id();
@@ -101,6 +109,9 @@ void CellStructure::remove_particle(int id) {
       }
     }
   }
+
+  m_rebuild_packed_index = true;
+  m_rebuild_verlet_list = true;
 }
 
 Particle *CellStructure::add_local_particle(Particle &&p) {
@@ -141,6 +152,8 @@ void CellStructure::remove_all_particles() {
   }
 
   m_particle_index.clear();
+  m_rebuild_packed_index = true;
+  m_rebuild_verlet_list = true;
 }
 
 /* Map the data parts flags from cells to those used internally
@@ -162,21 +175,40 @@ static unsigned map_data_parts(unsigned data_parts) {
 }
 
 void CellStructure::ghosts_count() {
+  /* The buffers of the ghost communication are sized for the
+   * old number of particles. */
+  m_ghost_request.reset();
   ghost_communicator(decomposition().exchange_ghosts_comm(),
                      GHOSTTRANS_PARTNUM);
+
+  /* Ghost particles may have moved in memory */
+  m_rebuild_packed_index = true;
+  m_rebuild_verlet_list = true;
 }
 void CellStructure::ghosts_update(unsigned data_parts) {
-  ghost_communicator(decomposition().exchange_ghosts_comm(),
-                     map_data_parts(data_parts));
+  ghosts_update_begin(data_parts);
+  ghosts_wait();
+}
+void CellStructure::ghosts_update_begin(unsigned data_parts) {
+  ghosts_wait();
+  ghost_communicator_begin(decomposition().exchange_ghosts_comm(),
+                           map_data_parts(data_parts), m_ghost_request);
 }
 void CellStructure::ghosts_reduce_forces() {
-  ghost_communicator(decomposition().collect_ghost_force_comm(),
-                     GHOSTTRANS_FORCE);
+  ghosts_reduce_forces_begin();
+  ghosts_wait();
+}
+void CellStructure::ghosts_reduce_forces_begin() {
+  ghosts_wait();
+  ghost_communicator_begin(decomposition().collect_ghost_force_comm(),
+                           GHOSTTRANS_FORCE, m_ghost_request);
 }
 #ifdef BOND_CONSTRAINT
 void CellStructure::ghosts_reduce_rattle_correction() {
-  ghost_communicator(decomposition().collect_ghost_force_comm(),
-                     GHOSTTRANS_RATTLE);
+  ghosts_wait();
+  ghost_communicator_begin(decomposition().collect_ghost_force_comm(),
+                           GHOSTTRANS_RATTLE, m_ghost_request);
+  ghosts_wait();
 }
 #endif
 
@@ -212,9 +244,55 @@ struct UpdateParticleIndexVisitor {
   }
   void operator()(ModifiedList mp) const { cs->update_particle_index(mp.pl); }
 };
+
+/**
+ * @brief Order particles along the Morton curve.
+ *
+ * The curve is laid over the bounding box of the particles.
+ */
+void sort_particles_morton(ParticleList &particles) {
+  if (particles.size() < 2) {
+    return;
+  }
+
+  auto lower = particles.begin()->r.p;
+  auto upper = lower;
+  for (auto const &p : particles) {
+    for (int i = 0; i < 3; i++) {
+      lower[i] = std::min(lower[i], p.r.p[i]);
+      upper[i] = std::max(upper[i], p.r.p[i]);
+    }
+  }
+
+  auto const max_bin = static_cast<double>((1u << Utils::morton_bits) - 1u);
+  Utils::Vector3d scale;
+  for (int i = 0; i < 3; i++) {
+    auto const extent = upper[i] - lower[i];
+    scale[i] = (extent > 0.) ? max_bin / extent : 0.;
+  }
+
+  std::vector<std::pair<uint64_t, std::size_t>> keys;
+  keys.reserve(particles.size());
+  for (auto const &p : particles) {
+    auto const bin = [&](int i) {
+      return static_cast<uint32_t>((p.r.p[i] - lower[i]) * scale[i]);
+    };
+    keys.emplace_back(Utils::morton_code(bin(0), bin(1), bin(2)),
+                      keys.size());
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::vector<Particle> sorted;
+  sorted.reserve(particles.size());
+  for (auto const &key : keys) {
+    sorted.emplace_back(std::move(*(particles.begin() + key.second)));
+  }
+  std::move(sorted.begin(), sorted.end(), particles.begin());
+}
 } // namespace
 
 void CellStructure::resort_particles(int global_flag) {
+  ghosts_wait();
   invalidate_ghosts();
 
   static std::vector<ParticleChange> diff;
@@ -226,7 +304,17 @@ void CellStructure::resort_particles(int global_flag) {
     boost::apply_visitor(UpdateParticleIndexVisitor{this}, d);
   }
 
+  if (particle_sort_interval > 0 and
+      ++m_resorts_since_sort >= particle_sort_interval) {
+    for (auto cell : local_cells()) {
+      sort_particles_morton(cell->particles());
+      update_particle_index(cell->particles());
+    }
+    m_resorts_since_sort = 0;
+  }
+
   m_rebuild_verlet_list = true;
+  m_rebuild_packed_index = true;
 
 #ifdef ADDITIONAL_CHECKS
   check_particle_index();
@@ -234,6 +322,54 @@ void CellStructure::resort_particles(int global_flag) {
 #endif
 }
 
+void CellStructure::update_packed_index() {
+  if (not m_rebuild_packed_index) {
+    return;
+  }
+
+  m_packed_particles.clear();
+
+  auto const append = [this](Cell *cell) {
+    cell->m_packed_offset = static_cast<int>(m_packed_particles.size());
+    for (auto &p : cell->particles()) {
+      m_packed_particles.push_back(std::addressof(p));
+    }
+  };
+
+  for (auto cell : decomposition().local_cells()) {
+    append(cell);
+  }
+  m_n_local_packed = static_cast<int>(m_packed_particles.size());
+  for (auto cell : decomposition().ghost_cells()) {
+    append(cell);
+  }
+
+  m_rebuild_packed_index = false;
+}
+
+void CellStructure::gather_soa() {
+  auto const n_part = static_cast<long>(m_packed_particles.size());
+  m_soa.resize(m_packed_particles.size());
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (long i = 0; i < n_part; i++) {
+    m_soa.set(i, *m_packed_particles[i]);
+  }
+}
+
+void CellStructure::scatter_soa_forces() {
+  auto const n_part = static_cast<long>(m_packed_particles.size());
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (long i = 0; i < n_part; i++) {
+    m_packed_particles[i]->f.f += m_soa.force_of(i);
+  }
+}
+
 void CellStructure::set_atom_decomposition(boost::mpi::communicator const &comm,
                                            BoxGeometry const &box) {
   set_particle_decomposition(std::make_unique<AtomDecomposition>(comm, box));
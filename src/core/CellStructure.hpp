@@ -30,6 +30,8 @@
 #include "ParticleDecomposition.hpp"
 #include "ParticleList.hpp"
 #include "ParticleRange.hpp"
+#include "ParticleSoA.hpp"
+#include "algorithm/colored_link_cell.hpp"
 #include "algorithm/link_cell.hpp"
 #include "bond_error.hpp"
 #include "ghosts.hpp"
@@ -40,8 +42,15 @@
 #include <boost/range/algorithm/find_if.hpp>
 #include <boost/range/algorithm/transform.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <utility>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 /** Cell Structure */
 enum CellStructureType : int {
   /** cell structure domain decomposition */
@@ -100,14 +109,32 @@ struct MinimalImageDistance {
   const BoxGeometry box;
 
   Distance operator()(Particle const &p1, Particle const &p2) const {
-    return Distance(box.get_mi_vector(p1.r.p, p2.r.p));
+    return (*this)(p1.r.p, p2.r.p);
+  }
+
+  Distance operator()(Utils::Vector3d const &pos1,
+                      Utils::Vector3d const &pos2) const {
+    return Distance(box.get_mi_vector(pos1, pos2));
+  }
+
+  /** Component @p dim of the distance vector. */
+  double coord(double a, double b, unsigned dim) const {
+    return box.get_mi_coord(a, b, dim);
   }
 };
 
 struct EuclidianDistance {
   Distance operator()(Particle const &p1, Particle const &p2) const {
-    return Distance(p1.r.p - p2.r.p);
+    return (*this)(p1.r.p, p2.r.p);
+  }
+
+  Distance operator()(Utils::Vector3d const &pos1,
+                      Utils::Vector3d const &pos2) const {
+    return Distance(pos1 - pos2);
   }
+
+  /** Component @p dim of the distance vector. */
+  double coord(double a, double b, unsigned) const { return a - b; }
 };
 } // namespace detail
 
@@ -131,10 +158,40 @@ private:
    */
   unsigned m_resort_particles = Cells::RESORT_NONE;
   bool m_rebuild_verlet_list = true;
-  std::vector<std::pair<Particle *, Particle *>> m_verlet_list;
+  /** Local cells grouped into independent sets,
+   *  see @ref Algorithm::color_cells. */
+  std::vector<std::vector<Cell *>> m_cell_colors;
+  /** Local and ghost particles in cell order,
+   *  see @ref update_packed_index. */
+  std::vector<Particle *> m_packed_particles;
+  /** Number of local particles in @ref m_packed_particles. */
+  int m_n_local_packed = 0;
+  bool m_rebuild_packed_index = true;
+  /** Number of resorts since the particles were last sorted. */
+  int m_resorts_since_sort = 0;
+  /** Packed copy of the particle data of @ref m_packed_particles. */
+  ParticleSoA m_soa;
+  /** Ghost communication in flight. */
+  GhostCommunicationRequest m_ghost_request;
+  /** Progress on other communication in flight during the pair loops,
+   *  see @ref set_progress_callback. */
+  std::function<void()> m_progress_callback;
 
 public:
   bool use_verlet_list = true;
+  /** Calculate central pair forces from packed particle data,
+   *  see @ref ParticleSoA. */
+  bool use_soa = false;
+  /** Sort the particles of every local cell along the Morton curve
+   *  on every n-th resort, never if zero. */
+  int particle_sort_interval = 0;
+  /** Overlap the ghost communication of the force calculation
+   *  with the pair forces and bonds of the local particles.
+   *  The pair forces only overlap in @ref verlet_list_loop, if the
+   *  Verlet lists are not rebuilt. @ref link_cell and
+   *  @ref soa_non_bonded_loop wait for the ghosts before they start.
+   */
+  bool overlap_communication = false;
 
   /**
    * @brief Update local particle index.
@@ -373,10 +430,55 @@ public:
    */
   void ghosts_update(unsigned data_parts);
 
+  /**
+   * @brief Start the update of the ghost particles.
+   *
+   * Like @ref ghosts_update, but returns before the data has arrived.
+   * The ghost particles must not be accessed until @ref ghosts_wait
+   * was called, except by the pair loops, which calculate the pairs
+   * of local particles first.
+   *
+   * @param data_parts Particle parts to update, combination of @ref
+   * Cells::DataPart
+   */
+  void ghosts_update_begin(unsigned data_parts);
+
   /**
    * @brief Add forces from ghost particles to real particles.
    */
   void ghosts_reduce_forces();
+
+  /**
+   * @brief Start to add forces from ghost particles to real particles.
+   *
+   * Like @ref ghosts_reduce_forces, but returns before the forces have
+   * arrived. The forces must not be accessed until @ref ghosts_wait
+   * was called.
+   */
+  void ghosts_reduce_forces_begin();
+
+  /**
+   * @brief Whether a ghost communication has not been finished yet.
+   */
+  bool ghosts_pending() const { return m_ghost_request.pending(); }
+
+  /**
+   * @brief Finish the pending ghost communication, if any.
+   */
+  void ghosts_wait() { m_ghost_request.wait(); }
+
+  /**
+   * @brief Set a callable to make progress on communication which is
+   *        in flight during the pair loops.
+   *
+   * The callable is invoked by the calling thread after every cell in
+   * the loops which process the cells in order, and after every color
+   * in the loops which process the cells concurrently. An empty callable
+   * disables it.
+   */
+  void set_progress_callback(std::function<void()> callback) {
+    m_progress_callback = std::move(callback);
+  }
 #ifdef BOND_CONSTRAINT
   /**
    * @brief Add rattle corrections from ghost particles to real particles.
@@ -417,11 +519,16 @@ private:
    *                p, the bond id and a span with the bond
    *                partners as arguments. Its return value
    *                should indicate if the bond was broken.
+   * @param bond_filter Predicate on the partner ids of a bond,
+   *                    only matching bonds are evaluated.
    */
-  template <class Handler>
-  void execute_bond_handler(Particle &p, Handler handler) {
+  template <class Handler, class BondFilter>
+  void execute_bond_handler(Particle &p, Handler handler,
+                            BondFilter const &bond_filter) {
     for (const BondView bond : p.bonds()) {
       auto const partner_ids = bond.partner_ids();
+      if (not bond_filter(partner_ids))
+        continue;
 
       try {
         auto partners = resolve_bond_partners(partner_ids);
@@ -460,7 +567,12 @@ private:
   /** @brief Set the particle decomposition, keeping the particles. */
   void set_particle_decomposition(
       std::unique_ptr<ParticleDecomposition> &&decomposition) {
+    /* The ghost communication refers to the old communicators. */
+    m_ghost_request.reset();
     clear_particle_index();
+    m_cell_colors.clear();
+    m_rebuild_packed_index = true;
+    m_rebuild_verlet_list = true;
 
     /* Swap in new cell system */
     std::swap(m_decomposition, decomposition);
@@ -494,102 +606,414 @@ public:
                                 LocalBox<double> const &local_geo);
 
 public:
+  /**
+   * @brief Run a kernel over all bonds of the local particles.
+   *
+   * While a ghost update is in flight, the bonds whose partners are
+   * all local particles are evaluated first, and the bonds with ghost
+   * partners after the update has arrived.
+   *
+   * @param bond_kernel Callable with (Particle, int, Utils::Span<Particle *>),
+   *        see @ref execute_bond_handler.
+   */
   template <class BondKernel> void bond_loop(BondKernel const &bond_kernel) {
+    if (not ghosts_pending()) {
+      for (auto &p : local_particles()) {
+        execute_bond_handler(p, bond_kernel,
+                             [](Utils::Span<const int>) { return true; });
+      }
+      return;
+    }
+
+    auto const local_partners = [this](Utils::Span<const int> partner_ids) {
+      return std::all_of(partner_ids.begin(), partner_ids.end(),
+                         [this](int id) {
+                           auto const partner = get_local_particle(id);
+                           return partner and not partner->l.ghost;
+                         });
+    };
     for (auto &p : local_particles()) {
-      execute_bond_handler(p, bond_kernel);
+      execute_bond_handler(p, bond_kernel, local_partners);
+    }
+    ghosts_wait();
+    for (auto &p : local_particles()) {
+      execute_bond_handler(p, bond_kernel,
+                           [&local_partners](Utils::Span<const int> ids) {
+                             return not local_partners(ids);
+                           });
     }
   }
 
 private:
   /**
-   * @brief Run link_cell algorithm for local cells.
+   * @brief Local cells grouped by color, computed on first use.
+   */
+  std::vector<std::vector<Cell *>> const &cell_colors() {
+    if (m_cell_colors.empty()) {
+      m_cell_colors = Algorithm::color_cells(
+          boost::make_indirect_iterator(local_cells().begin()),
+          boost::make_indirect_iterator(local_cells().end()));
+    }
+
+    return m_cell_colors;
+  }
+
+  /**
+   * @brief Whether @ref local_cell_loop processes cells concurrently.
+   */
+  static bool runs_concurrently(bool concurrent) {
+#ifdef _OPENMP
+    return concurrent and omp_get_max_threads() > 1;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * @brief Apply a kernel to every local cell.
    *
-   * @tparam Kernel Needs to be callable with (Particle, Particle, Distance).
-   * @param kernel Pair kernel functor.
+   * If @p concurrent is set and more than one OpenMP thread
+   * is available, the cells are processed by color, cells of
+   * the same color are processed concurrently, and the progress
+   * callback is invoked after every color. Otherwise the cells
+   * are processed in order, and the progress callback is invoked
+   * after every cell.
+   *
+   * @param cell_kernel Callable with a cell reference as argument.
+   * @param concurrent Whether cells may be processed concurrently.
    */
-  template <class Kernel> void link_cell(Kernel kernel) {
+  template <class CellKernel>
+  void local_cell_loop(CellKernel &&cell_kernel, bool concurrent) {
+    if (runs_concurrently(concurrent)) {
+      Algorithm::for_each_colored_cell(cell_colors(), cell_kernel, [this]() {
+        if (m_progress_callback) {
+          m_progress_callback();
+        }
+      });
+      return;
+    }
+    for (auto cell : local_cells()) {
+      cell_kernel(*cell);
+      if (m_progress_callback) {
+        m_progress_callback();
+      }
+    }
+  }
+
+  /**
+   * @brief Call a functor with the distance function
+   *        of the active decomposition.
+   */
+  template <class F> void visit_distance_function(F &&f) {
     auto const maybe_box = decomposition().minimum_image_distance();
-    auto const first = boost::make_indirect_iterator(local_cells().begin());
-    auto const last = boost::make_indirect_iterator(local_cells().end());
 
     if (maybe_box) {
-      Algorithm::link_cell(
-          first, last,
-          [&kernel, df = detail::MinimalImageDistance{*maybe_box}](
-              Particle &p1, Particle &p2) { kernel(p1, p2, df(p1, p2)); });
+      f(detail::MinimalImageDistance{*maybe_box});
     } else {
-      Algorithm::link_cell(
-          first, last,
-          [&kernel, df = detail::EuclidianDistance{}](
-              Particle &p1, Particle &p2) { kernel(p1, p2, df(p1, p2)); });
+      f(detail::EuclidianDistance{});
     }
   }
 
-  /** Non-bonded pair loop with verlet lists.
+  /**
+   * @brief Run link_cell algorithm for local cells.
    *
-   * @param pair_kernel Kernel to apply
+   * @tparam Kernel Needs to be callable with (Particle, Particle, Distance).
+   * @param kernel Pair kernel functor.
+   * @param concurrent Whether cells may be processed concurrently.
+   */
+  template <class Kernel> void link_cell(Kernel kernel, bool concurrent) {
+    ghosts_wait();
+    visit_distance_function([&](auto const &df) {
+      local_cell_loop(
+          [&](Cell &cell) {
+            Algorithm::link_cell_pairs(
+                cell, [&kernel, &df](Particle &p1, Particle &p2) {
+                  kernel(p1, p2, df(p1, p2));
+                });
+          },
+          concurrent);
+    });
+  }
+
+  /**
+   * @brief Number the local and ghost particles consecutively.
+   *
+   * The particles of the local cells, followed by those of the
+   * ghost cells, are stored in @ref m_packed_particles, and every
+   * cell stores the index of its first particle. The index is only
+   * rebuilt if particles may have moved in memory since the last call.
+   */
+  void update_packed_index();
+
+  /**
+   * @brief Copy the particle data into @ref m_soa.
+   */
+  void gather_soa();
+
+  /**
+   * @brief Add the forces from @ref m_soa to the particles.
+   */
+  void scatter_soa_forces();
+
+  /**
+   * @brief Run link_cell algorithm for one cell on packed indices.
+   *
+   * Visits the same pairs in the same order as
+   * @ref Algorithm::link_cell_pairs.
+   *
+   * @param cell Cell to process.
+   * @param kernel Callable with the packed indices of the pair.
+   */
+  template <class Kernel>
+  static void link_cell_packed(Cell &cell, Kernel &&kernel) {
+    auto const first = cell.m_packed_offset;
+    auto const last = first + static_cast<int>(cell.particles().size());
+
+    for (int i = first; i < last; i++) {
+      /* Pairs in this cell */
+      for (int j = i + 1; j < last; j++) {
+        kernel(i, j);
+      }
+
+      /* Pairs with neighbors */
+      for (auto const neighbor : cell.neighbors().red()) {
+        auto const n_first = neighbor->m_packed_offset;
+        auto const n_last =
+            n_first + static_cast<int>(neighbor->particles().size());
+        for (int j = n_first; j < n_last; j++) {
+          kernel(i, j);
+        }
+      }
+    }
+  }
+
+  /** Non-bonded pair loop with verlet lists on packed indices.
+   *
+   * The verlet lists are kept per cell, so that they can
+   * be processed in the same order as the link cell algorithm,
+   * see @ref VerletList for the storage format.
+   *
+   * @param kernel Callable with (int, int, Distance).
+   * @param distance Callable returning the Distance of a pair of indices.
    * @param verlet_criterion Filter for verlet lists.
+   * @param concurrent Whether cells may be processed concurrently.
    */
-  template <class PairKernel, class VerletCriterion>
-  void verlet_list_loop(PairKernel pair_kernel,
-                        const VerletCriterion &verlet_criterion) {
+  template <class Kernel, class DistanceFunction, class VerletCriterion>
+  void verlet_list_loop(Kernel kernel, DistanceFunction const &distance,
+                        const VerletCriterion &verlet_criterion,
+                        bool concurrent) {
     /* In this case the verlet list update is attached to
      * the pair kernel, and the verlet list is rebuilt as
      * we go. */
     if (m_rebuild_verlet_list) {
-      m_verlet_list.clear();
-
-      link_cell([&](Particle &p1, Particle &p2, Distance const &d) {
-        if (verlet_criterion(p1, p2, d)) {
-          m_verlet_list.emplace_back(&p1, &p2);
-          pair_kernel(p1, p2, d);
-        }
-      });
+      ghosts_wait();
+      local_cell_loop(
+          [&](Cell &cell) {
+            auto &verlet_list = cell.m_verlet_list;
+            auto const first = cell.m_packed_offset;
+
+            verlet_list.clear();
+            link_cell_packed(cell, [&](int i, int j) {
+              auto const d = distance(i, j);
+              if (verlet_criterion(*m_packed_particles[i],
+                                   *m_packed_particles[j], d)) {
+                verlet_list.add_pair(i - first, j);
+                kernel(i, j, d);
+              }
+            });
+            verlet_list.finalize(static_cast<int>(cell.particles().size()));
+          },
+          concurrent);
 
       m_rebuild_verlet_list = false;
+    } else if (ghosts_pending()) {
+      /* The pairs of local particles are calculated while the ghost
+       * update is in flight, and the pairs with ghosts afterwards. */
+      auto const n_local = m_n_local_packed;
+      auto const progress = not runs_concurrently(concurrent);
+
+      verlet_pair_loop(
+          kernel, distance, [n_local](int j) { return j < n_local; },
+          concurrent, progress);
+      ghosts_wait();
+      verlet_pair_loop(
+          kernel, distance, [n_local](int j) { return j >= n_local; },
+          concurrent, false);
     } else {
-      auto const maybe_box = decomposition().minimum_image_distance();
       /* In this case the pair kernel is just run over the verlet list. */
-      if (maybe_box) {
-        auto const distance_function = detail::MinimalImageDistance{*maybe_box};
-        for (auto &pair : m_verlet_list) {
-          pair_kernel(*pair.first, *pair.second,
-                      distance_function(*pair.first, *pair.second));
-        }
-      } else {
-        auto const distance_function = detail::EuclidianDistance{};
-        for (auto &pair : m_verlet_list) {
-          pair_kernel(*pair.first, *pair.second,
-                      distance_function(*pair.first, *pair.second));
-        }
-      }
+      verlet_pair_loop(
+          kernel, distance, [](int) { return true; }, concurrent, false);
     }
   }
 
+  /** Run a pair kernel over the verlet lists.
+   *
+   * @param kernel Callable with (int, int, Distance).
+   * @param distance Callable returning the Distance of a pair of indices.
+   * @param partner_filter Predicate on the packed index of a partner,
+   *        only pairs with matching partners are visited.
+   * @param concurrent Whether cells may be processed concurrently.
+   * @param progress Whether to make progress on the pending ghost
+   *        communication after every cell.
+   */
+  template <class Kernel, class DistanceFunction, class PartnerFilter>
+  void verlet_pair_loop(Kernel &kernel, DistanceFunction const &distance,
+                        PartnerFilter const &partner_filter, bool concurrent,
+                        bool progress) {
+    local_cell_loop(
+        [&](Cell &cell) {
+          auto const &verlet_list = cell.m_verlet_list;
+          auto const first = cell.m_packed_offset;
+
+          for (int k = 0; k < verlet_list.n_particles(); k++) {
+            auto const i = first + k;
+            for (auto const partner : verlet_list.partners(k)) {
+              auto const j = static_cast<int>(partner);
+              if (partner_filter(j)) {
+                kernel(i, j, distance(i, j));
+              }
+            }
+          }
+
+          if (progress) {
+            m_ghost_request.test();
+          }
+        },
+        concurrent);
+  }
+
+  /** Non-bonded pair loop with verlet lists.
+   *
+   * @param pair_kernel Kernel to apply
+   * @param verlet_criterion Filter for verlet lists.
+   * @param concurrent Whether cells may be processed concurrently.
+   */
+  template <class PairKernel, class VerletCriterion>
+  void verlet_list_loop(PairKernel pair_kernel,
+                        const VerletCriterion &verlet_criterion,
+                        bool concurrent) {
+    update_packed_index();
+
+    visit_distance_function([&](auto const &df) {
+      verlet_list_loop(
+          [&](int i, int j, Distance const &d) {
+            pair_kernel(*m_packed_particles[i], *m_packed_particles[j], d);
+          },
+          [&](int i, int j) {
+            return df(*m_packed_particles[i], *m_packed_particles[j]);
+          },
+          verlet_criterion, concurrent);
+    });
+  }
+
 public:
   /** Non-bonded pair loop.
    * @param pair_kernel Kernel to apply
    */
   template <class PairKernel> void non_bonded_loop(PairKernel pair_kernel) {
-    link_cell(pair_kernel);
+    link_cell(pair_kernel, false);
   }
 
   /** Non-bonded pair loop with potential use
    * of verlet lists.
+   *
+   * If @p concurrent is set, pairs are processed by several
+   * OpenMP threads, see @ref Algorithm::colored_link_cell. The
+   * pair kernel then has to be safe to call concurrently for
+   * pairs that do not share a particle.
+   *
    * @param pair_kernel Kernel to apply
    * @param verlet_criterion Filter for verlet lists.
+   * @param concurrent Whether the pair kernel may be called concurrently.
    */
   template <class PairKernel, class VerletCriterion>
   void non_bonded_loop(PairKernel pair_kernel,
-                       const VerletCriterion &verlet_criterion) {
+                       const VerletCriterion &verlet_criterion,
+                       bool concurrent = false) {
     if (use_verlet_list) {
-      verlet_list_loop(pair_kernel, verlet_criterion);
+      verlet_list_loop(pair_kernel, verlet_criterion, concurrent);
     } else {
       /* No verlet lists, just run the kernel with pairs from the cells. */
-      link_cell(pair_kernel);
+      link_cell(pair_kernel, concurrent);
     }
   }
 
+  /** Non-bonded pair loop on packed particle data.
+   *
+   * Copies positions, types and charges of the local and ghost
+   * particles into a @ref ParticleSoA, runs the kernels over all
+   * pairs, and adds the forces accumulated in the packed storage
+   * to the particles. Verlet lists are used if @ref use_verlet_list
+   * is set, and are shared with @ref non_bonded_loop. With verlet
+   * lists, all partners of a particle are passed to the particle
+   * kernel at once, otherwise the pair kernel is called for every pair.
+   * A pending ghost update is finished before the data is packed.
+   *
+   * @param pair_kernel Kernel to apply, callable with
+   *        (Particle, Particle, ParticleSoA, int, int, Distance),
+   *        where the integers are the indices of the pair in
+   *        the packed storage.
+   * @param particle_kernel Kernel to apply, callable with
+   *        (Span<Particle *const>, ParticleSoA, int,
+   *        Span<const uint32_t>, DistanceFunction), where the
+   *        first argument are the particles in packed order,
+   *        followed by the packed index of a particle, the packed
+   *        indices of its interaction partners, and the distance
+   *        function of the decomposition.
+   * @param verlet_criterion Filter for verlet lists.
+   * @param concurrent Whether the kernels may be called concurrently,
+   *        see @ref non_bonded_loop.
+   */
+  template <class PairKernel, class ParticleKernel, class VerletCriterion>
+  void soa_non_bonded_loop(PairKernel pair_kernel,
+                           ParticleKernel particle_kernel,
+                           const VerletCriterion &verlet_criterion,
+                           bool concurrent = false) {
+    ghosts_wait();
+    update_packed_index();
+    gather_soa();
+
+    visit_distance_function([&](auto const &df) {
+      auto const kernel = [&](int i, int j, Distance const &d) {
+        pair_kernel(*m_packed_particles[i], *m_packed_particles[j], m_soa, i,
+                    j, d);
+      };
+      auto const distance = [&](int i, int j) {
+        return df(m_soa.position(i), m_soa.position(j));
+      };
+
+      if (use_verlet_list) {
+        if (m_rebuild_verlet_list) {
+          verlet_list_loop([](int, int, Distance const &) {}, distance,
+                           verlet_criterion, concurrent);
+        }
+
+        auto const particles = Utils::make_const_span(m_packed_particles);
+        local_cell_loop(
+            [&](Cell &cell) {
+              auto const &verlet_list = cell.m_verlet_list;
+              auto const first = cell.m_packed_offset;
+
+              for (int k = 0; k < verlet_list.n_particles(); k++) {
+                particle_kernel(particles, m_soa, first + k,
+                                verlet_list.partners(k), df);
+              }
+            },
+            concurrent);
+      } else {
+        local_cell_loop(
+            [&](Cell &cell) {
+              link_cell_packed(cell, [&](int i, int j) {
+                kernel(i, j, distance(i, j));
+              });
+            },
+            concurrent);
+      }
+    });
+
+    scatter_soa_forces();
+  }
+
 private:
   /**
    * @brief Check that particle index is commensurate with particles.
@@ -629,6 +1053,80 @@ public:
 
     return particle_to_cell(p);
   }
+
+private:
+  /**
+   * @brief Find the local cell that holds a local particle.
+   *
+   * Particles are only resorted once one of them has moved by more than
+   * half the skin, so until then a particle can be outside of the cell
+   * it is stored in, which is then a neighbor of the cell of its position.
+   */
+  Cell *find_storage_cell(Particle const &p) {
+    auto const holds = [&p](Cell *cell) {
+      auto const &particles = cell->particles();
+      std::less<Particle const *> less;
+      return not less(&p, particles.begin()) and less(&p, particles.end());
+    };
+    if (auto cell = particle_to_cell(p)) {
+      if (holds(cell))
+        return cell;
+      for (auto const neighbor : cell->neighbors().all()) {
+        if (holds(neighbor))
+          return neighbor;
+      }
+    }
+    for (auto const cell : local_cells()) {
+      if (holds(cell))
+        return cell;
+    }
+    return nullptr;
+  }
+
+public:
+  /**
+   * @brief Run a kernel for all pairs of a local particle with the other
+   *        particles in its cell and in the neighboring cells.
+   *
+   * These are all the pairs of the particle that are visited by
+   * @ref non_bonded_loop, but in no particular order.
+   *
+   * @param p Local particle.
+   * @param kernel Callable with (Particle, Particle, Distance).
+   */
+  template <class Kernel>
+  void particle_neighbor_loop(Particle const &p, Kernel kernel) {
+    ghosts_wait();
+    auto *cell = find_storage_cell(p);
+    assert(cell);
+
+    visit_distance_function([&](auto const &df) {
+      for (auto const &p2 : cell->particles()) {
+        if (&p2 != &p) {
+          kernel(p, p2, df(p, p2));
+        }
+      }
+      /* the neighbors of a cell may include the cell itself */
+      for (auto const neighbor : cell->neighbors().all()) {
+        if (neighbor == cell)
+          continue;
+        for (auto const &p2 : neighbor->particles()) {
+          kernel(p, p2, df(p, p2));
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief Run a kernel on all local cells.
+   *
+   * @param kernel Callable with (Cell).
+   */
+  template <class CellKernel> void for_each_local_cell(CellKernel kernel) {
+    for (auto cell : local_cells()) {
+      kernel(*cell);
+    }
+  }
 };
 
 #endif // ESPRESSO_CELLSTRUCTURE_HPP
@@ -26,6 +26,7 @@
 
 #include <utils/Vector.hpp>
 #include <utils/index.hpp>
+#include <utils/morton.hpp>
 #include <utils/mpi/cart_comm.hpp>
 #include <utils/mpi/sendrecv.hpp>
 
@@ -37,6 +38,7 @@
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <utility>
@@ -48,8 +50,17 @@ Cell *DomainDecomposition::position_to_cell(const Utils::Vector3d &pos) {
   Utils::Vector3i cpos;
 
   for (int i = 0; i < 3; i++) {
-    cpos[i] = static_cast<int>(std::floor(pos[i] * inv_cell_size[i])) + 1 -
-              cell_offset[i];
+    /* The local box is the half-open interval [my_left, my_right), and
+       neighboring nodes share the value of their common boundary. */
+    auto const rel_pos = pos[i] - m_local_box.my_left()[i];
+    if (pos[i] < m_local_box.my_left()[i])
+      cpos[i] = 0;
+    else if (pos[i] >= m_local_box.my_right()[i])
+      cpos[i] = cell_grid[i] + 1;
+    else
+      cpos[i] =
+          std::min(static_cast<int>(std::floor(rel_pos * inv_cell_size[i])) + 1,
+                   cell_grid[i]);
 
     /* particles outside our box. Still take them if
        nonperiodic boundary. We also accept the particle if we are at
@@ -236,6 +247,7 @@ void DomainDecomposition::resort(bool global,
 
 void DomainDecomposition::mark_cells() {
   int cnt_c = 0;
+  std::vector<std::pair<uint64_t, Cell *>> local_cells_by_code;
 
   m_local_cells.clear();
   m_ghost_cells.clear();
@@ -245,10 +257,19 @@ void DomainDecomposition::mark_cells() {
       for (int m = 0; m < ghost_cell_grid[0]; m++) {
         if ((m > 0 && m < ghost_cell_grid[0] - 1 && n > 0 &&
              n < ghost_cell_grid[1] - 1 && o > 0 && o < ghost_cell_grid[2] - 1))
-          m_local_cells.push_back(&cells.at(cnt_c++));
+          local_cells_by_code.emplace_back(Utils::morton_code(m, n, o),
+                                           &cells.at(cnt_c++));
         else
           m_ghost_cells.push_back(&cells.at(cnt_c++));
       }
+
+  /* Order the local cells along the Morton curve, so that cells
+   * that are processed one after the other are close in space. */
+  std::sort(local_cells_by_code.begin(), local_cells_by_code.end(),
+            [](auto const &a, auto const &b) { return a.first < b.first; });
+  for (auto const &c : local_cells_by_code) {
+    m_local_cells.push_back(c.second);
+  }
 }
 void DomainDecomposition::fill_comm_cell_lists(ParticleList **part_lists,
                                                const Utils::Vector3i &lc,
@@ -305,26 +326,32 @@ void DomainDecomposition::create_cell_grid(double range) {
 
     n_local_cells = cell_grid[0] * cell_grid[1] * cell_grid[2];
   } else {
+    /* The cell grid is calculated for the equally spaced node grid,
+     * which is the same on all nodes. */
+    Utils::Vector3d local_length;
+    for (int i = 0; i < 3; i++)
+      local_length[i] = m_box.length()[i] / cart_info.dims[i];
+
     /* Calculate initial cell grid */
-    double volume = m_local_box.length()[0];
+    double volume = local_length[0];
     for (int i = 1; i < 3; i++)
-      volume *= m_local_box.length()[i];
+      volume *= local_length[i];
     double scale = pow(DomainDecomposition::max_num_cells / volume, 1. / 3.);
     for (int i = 0; i < 3; i++) {
       /* this is at least 1 */
-      cell_grid[i] = (int)ceil(m_local_box.length()[i] * scale);
-      cell_range[i] = m_local_box.length()[i] / cell_grid[i];
+      cell_grid[i] = (int)ceil(local_length[i] * scale);
+      cell_range[i] = local_length[i] / cell_grid[i];
 
       if (cell_range[i] < range) {
         /* ok, too many cells for this direction, set to minimum */
-        cell_grid[i] = (int)floor(m_local_box.length()[i] / range);
+        cell_grid[i] = (int)floor(local_length[i] / range);
         if (cell_grid[i] < 1) {
           runtimeErrorMsg() << "interaction range " << range << " in direction "
                             << i << " is larger than the local box size "
-                            << m_local_box.length()[i];
+                            << local_length[i];
           cell_grid[i] = 1;
         }
-        cell_range[i] = m_local_box.length()[i] / cell_grid[i];
+        cell_range[i] = local_length[i] / cell_grid[i];
       }
     }
 
@@ -351,9 +378,26 @@ void DomainDecomposition::create_cell_grid(double range) {
       }
 
       cell_grid[min_ind]--;
-      cell_range[min_ind] = m_local_box.length()[min_ind] / cell_grid[min_ind];
+      cell_range[min_ind] = local_length[min_ind] / cell_grid[min_ind];
     }
 
+    /* Shifted node boundaries: keep the cell range of the equally spaced
+     * grid, so that the number of cells only depends on the local box
+     * length in the respective direction. */
+    for (int i = 0; i < 3; i++) {
+      if (m_local_box.length()[i] == local_length[i])
+        continue;
+
+      if (m_local_box.length()[i] < range) {
+        runtimeErrorMsg() << "interaction range " << range << " in direction "
+                          << i << " is larger than the local box size "
+                          << m_local_box.length()[i];
+      }
+      cell_grid[i] = std::max(
+          1, static_cast<int>(m_local_box.length()[i] / cell_range[i]));
+    }
+    n_local_cells = cell_grid[0] * cell_grid[1] * cell_grid[2];
+
     /* sanity check */
     if (n_local_cells < min_num_cells) {
       runtimeErrorMsg()
@@ -368,8 +412,6 @@ void DomainDecomposition::create_cell_grid(double range) {
     runtimeErrorMsg() << "no suitable cell grid found ";
   }
 
-  auto const node_pos = cart_info.coords;
-
   /* now set all dependent variables */
   int new_cells = 1;
   for (int i = 0; i < 3; i++) {
@@ -377,7 +419,6 @@ void DomainDecomposition::create_cell_grid(double range) {
     new_cells *= ghost_cell_grid[i];
     cell_size[i] = m_local_box.length()[i] / (double)cell_grid[i];
     inv_cell_size[i] = 1.0 / cell_size[i];
-    cell_offset[i] = node_pos[i] * cell_grid[i];
   }
 
   /* allocate cell array and cell pointer arrays */
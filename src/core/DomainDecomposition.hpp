@@ -70,8 +70,6 @@ struct DomainDecomposition : public ParticleDecomposition {
   Utils::Vector3i cell_grid = {};
   /** Cell size. */
   Utils::Vector3d cell_size = {};
-  /** Offset in global grid */
-  Utils::Vector3i cell_offset = {};
   /** linked cell grid with ghost frame. */
   Utils::Vector3i ghost_cell_grid = {};
   /** inverse cell size = \see DomainDecomposition::cell_size ^ -1. */
@@ -185,7 +183,11 @@ private:
    *  Calculates the cell grid, based on the local box size and the range.
    *  If the number of cells is larger than @c max_num_cells,
    *  it increases @c max_range until the number of cells is
-   *  smaller or equal to @c max_num_cells. It sets:
+   *  smaller or equal to @c max_num_cells. The cell size is chosen for
+   *  the equally spaced node grid; if the node boundaries are shifted,
+   *  the number of cells in a direction only depends on the local box
+   *  length in that direction, so that the ghost layers of neighboring
+   *  nodes match. It sets:
    *  @c cell_grid,
    *  @c ghost_cell_grid,
    *  @c cell_size, and
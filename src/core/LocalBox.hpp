@@ -36,6 +36,19 @@ public:
         m_upper_corner(lower_corner + local_box_length),
         m_boundaries(boundaries) {}
 
+  /** @brief Local box between two corners.
+   *
+   *  The corners are stored as given, so that neighboring nodes which
+   *  compute their common boundary the same way agree on it bit by bit.
+   */
+  static LocalBox from_corners(Utils::Vector<T, 3> const &lower_corner,
+                               Utils::Vector<T, 3> const &upper_corner,
+                               Utils::Array<int, 6> const &boundaries) {
+    LocalBox box(lower_corner, upper_corner - lower_corner, boundaries);
+    box.m_upper_corner = upper_corner;
+    return box;
+  }
+
   /** Left (bottom, front) corner of this nodes local box. */
   Utils::Vector<T, 3> const &my_left() const { return m_lower_corner; }
   /** Right (top, back) corner of this nodes local box. */
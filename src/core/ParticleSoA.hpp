@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_PARTICLE_SOA_HPP
+#define ESPRESSO_PARTICLE_SOA_HPP
+
+#include "config.hpp"
+
+#include "Particle.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Packed copy of the particle data needed by central pair forces.
+ *
+ * Positions, types and charges are stored in separate contiguous
+ * arrays (structure of arrays), so that pair loops do not have to
+ * load the full @ref Particle. Forces are accumulated into separate
+ * arrays as well, and have to be added to the particles afterwards.
+ */
+struct ParticleSoA {
+  std::array<std::vector<double>, 3> pos;
+  std::vector<int> type;
+#ifdef ELECTROSTATICS
+  std::vector<double> q;
+#endif
+#ifdef EXCLUSIONS
+  /** Whether the particle has exclusions. */
+  std::vector<std::uint8_t> has_exclusions;
+#endif
+  std::array<std::vector<double>, 3> force;
+
+  std::size_t size() const { return type.size(); }
+
+  void resize(std::size_t n) {
+    for (int i = 0; i < 3; i++) {
+      pos[i].resize(n);
+      force[i].resize(n);
+    }
+    type.resize(n);
+#ifdef ELECTROSTATICS
+    q.resize(n);
+#endif
+#ifdef EXCLUSIONS
+    has_exclusions.resize(n);
+#endif
+  }
+
+  /**
+   * @brief Copy the data of a particle into a slot and reset its force.
+   */
+  void set(std::size_t i, Particle const &p) {
+    for (int j = 0; j < 3; j++) {
+      pos[j][i] = p.r.p[j];
+      force[j][i] = 0.;
+    }
+    type[i] = p.p.type;
+#ifdef ELECTROSTATICS
+    q[i] = p.p.q;
+#endif
+#ifdef EXCLUSIONS
+    has_exclusions[i] = not p.exclusions().empty();
+#endif
+  }
+
+  Utils::Vector3d position(std::size_t i) const {
+    return {pos[0][i], pos[1][i], pos[2][i]};
+  }
+
+  Utils::Vector3d force_of(std::size_t i) const {
+    return {force[0][i], force[1][i], force[2][i]};
+  }
+
+  void add_force(std::size_t i, Utils::Vector3d const &f) {
+    for (int j = 0; j < 3; j++) {
+      force[j][i] += f[j];
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ALGORITHM_COLORED_LINK_CELL_HPP
+#define ALGORITHM_COLORED_LINK_CELL_HPP
+
+#include "algorithm/link_cell.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Algorithm {
+/**
+ * @brief Partition cells into independent sets.
+ *
+ * The link cell algorithm applied to a cell writes to the particles
+ * of the cell itself and to the particles of its red neighbors.
+ * This greedily assigns a color to each cell, such that no two cells
+ * of the same color write to a common cell. All cells of one color
+ * can therefore be processed concurrently. The relative order of the
+ * cells is preserved within each color.
+ *
+ * @param first Iterator to the first cell.
+ * @param last Iterator past the last cell.
+ * @return Cells grouped by color.
+ */
+template <typename CellIterator>
+auto color_cells(CellIterator first, CellIterator last) {
+  using CellT = typename std::iterator_traits<CellIterator>::value_type;
+
+  std::vector<CellT *> cells;
+  for (; first != last; ++first) {
+    cells.push_back(&(*first));
+  }
+
+  /* Cells that are written when processing a cell. */
+  auto const write_set = [](CellT *cell) {
+    std::vector<CellT const *> ret{cell};
+    for (auto const &neighbor : cell->neighbors().red()) {
+      ret.push_back(&(*neighbor));
+    }
+    return ret;
+  };
+
+  /* For every cell, the indices of the cells whose processing writes it. */
+  std::unordered_map<CellT const *, std::vector<std::size_t>> writers;
+  for (std::size_t i = 0; i < cells.size(); ++i) {
+    for (auto const target : write_set(cells[i])) {
+      writers[target].push_back(i);
+    }
+  }
+
+  std::vector<int> colors(cells.size(), -1);
+  std::vector<bool> taken;
+  int n_colors = 0;
+  for (std::size_t i = 0; i < cells.size(); ++i) {
+    taken.assign(n_colors, false);
+    for (auto const target : write_set(cells[i])) {
+      for (auto const j : writers[target]) {
+        if (colors[j] >= 0) {
+          taken[colors[j]] = true;
+        }
+      }
+    }
+
+    colors[i] = static_cast<int>(
+        std::distance(taken.begin(), std::find(taken.begin(), taken.end(),
+                                               false)));
+    n_colors = std::max(n_colors, colors[i] + 1);
+  }
+
+  std::vector<std::vector<CellT *>> ret(n_colors);
+  for (std::size_t i = 0; i < cells.size(); ++i) {
+    ret[colors[i]].push_back(cells[i]);
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Apply a kernel to every cell, one color at a time.
+ *
+ * Cells of the same color are processed concurrently if
+ * OpenMP is available, colors are processed in order.
+ *
+ * @param colors Cells grouped by color, as returned by @ref color_cells.
+ * @param cell_kernel Callable with a cell reference as argument.
+ * @param color_done Callable without arguments, invoked by the calling
+ *        thread after all cells of a color have been processed.
+ */
+template <typename ColorRange, typename CellKernel, typename ColorCallback>
+void for_each_colored_cell(ColorRange const &colors, CellKernel &&cell_kernel,
+                           ColorCallback &&color_done) {
+  for (auto const &color : colors) {
+    auto const n_cells = static_cast<long>(color.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (long i = 0; i < n_cells; ++i) {
+      cell_kernel(*color[i]);
+    }
+    color_done();
+  }
+}
+
+template <typename ColorRange, typename CellKernel>
+void for_each_colored_cell(ColorRange const &colors, CellKernel &&cell_kernel) {
+  for_each_colored_cell(colors, std::forward<CellKernel>(cell_kernel), []() {});
+}
+
+/**
+ * @brief Link cell algorithm over colored cells.
+ *
+ * Visits the same pairs as @ref link_cell, but cells of one color
+ * are processed concurrently. The pair kernel has to be safe to
+ * call concurrently for pairs with no particle in common.
+ *
+ * @param colors Cells grouped by color, as returned by @ref color_cells.
+ * @param pair_kernel Callable with two particle references as arguments.
+ */
+template <typename ColorRange, typename PairKernel>
+void colored_link_cell(ColorRange const &colors, PairKernel &&pair_kernel) {
+  for_each_colored_cell(colors, [&pair_kernel](auto &cell) {
+    link_cell_pairs(cell, pair_kernel);
+  });
+}
+} // namespace Algorithm
+
+#endif
@@ -22,6 +22,29 @@
 #include <iterator>
 
 namespace Algorithm {
+/**
+ * @brief Iterates over all pairs within a single cell,
+ *        and over all pairs with its red neighbors.
+ */
+template <typename CellT, typename PairKernel>
+void link_cell_pairs(CellT &cell, PairKernel &&pair_kernel) {
+  for (auto it = cell.particles().begin(); it != cell.particles().end();
+       ++it) {
+    auto &p1 = *it;
+
+    /* Pairs in this cell */
+    for (auto jt = std::next(it); jt != cell.particles().end(); ++jt) {
+      pair_kernel(p1, *jt);
+    }
+
+    /* Pairs with neighbors */
+    for (auto &neighbor : cell.neighbors().red()) {
+      for (auto &p2 : neighbor->particles()) {
+        pair_kernel(p1, p2);
+      }
+    }
+  }
+}
 
 /**
  * @brief Iterates over all particles in the cell range,
@@ -32,22 +55,7 @@ template <typename CellIterator, typename PairKernel>
 void link_cell(CellIterator first, CellIterator last,
                PairKernel &&pair_kernel) {
   for (; first != last; ++first) {
-    for (auto it = first->particles().begin(); it != first->particles().end();
-         ++it) {
-      auto &p1 = *it;
-
-      /* Pairs in this cell */
-      for (auto jt = std::next(it); jt != first->particles().end(); ++jt) {
-        pair_kernel(p1, *jt);
-      }
-
-      /* Pairs with neighbors */
-      for (auto &neighbor : first->neighbors().red()) {
-        for (auto &p2 : neighbor->particles()) {
-          pair_kernel(p1, p2);
-        }
-      }
-    }
+    link_cell_pairs(*first, pair_kernel);
   }
 }
 } // namespace Algorithm
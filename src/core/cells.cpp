@@ -198,7 +198,7 @@ void check_resort_particles() {
   cell_structure.set_resort_particles(level);
 }
 
-void cells_update_ghosts(unsigned data_parts) {
+void cells_update_ghosts(unsigned data_parts, bool overlap) {
   /* data parts that are only updated on resort */
   auto constexpr resort_only_parts =
       Cells::DATA_PART_PROPERTIES | Cells::DATA_PART_BONDS;
@@ -229,7 +229,11 @@ void cells_update_ghosts(unsigned data_parts) {
     cell_structure.clear_resort_particles();
   } else {
     /* Communication step: ghost information */
-    cell_structure.ghosts_update(data_parts & ~resort_only_parts);
+    if (overlap and cell_structure.overlap_communication) {
+      cell_structure.ghosts_update_begin(data_parts & ~resort_only_parts);
+    } else {
+      cell_structure.ghosts_update(data_parts & ~resort_only_parts);
+    }
   }
 }
 
@@ -251,3 +255,31 @@ REGISTER_CALLBACK(mpi_set_use_verlet_lists_local)
 void mpi_set_use_verlet_lists(bool use_verlet_lists) {
   mpi_call_all(mpi_set_use_verlet_lists_local, use_verlet_lists);
 }
+
+void mpi_set_use_soa_local(bool use_soa) { cell_structure.use_soa = use_soa; }
+
+REGISTER_CALLBACK(mpi_set_use_soa_local)
+
+void mpi_set_use_soa(bool use_soa) {
+  mpi_call_all(mpi_set_use_soa_local, use_soa);
+}
+
+void mpi_set_particle_sort_interval_local(int interval) {
+  cell_structure.particle_sort_interval = interval;
+}
+
+REGISTER_CALLBACK(mpi_set_particle_sort_interval_local)
+
+void mpi_set_particle_sort_interval(int interval) {
+  mpi_call_all(mpi_set_particle_sort_interval_local, interval);
+}
+
+void mpi_set_overlap_communication_local(bool overlap) {
+  cell_structure.overlap_communication = overlap;
+}
+
+REGISTER_CALLBACK(mpi_set_overlap_communication_local)
+
+void mpi_set_overlap_communication(bool overlap) {
+  mpi_call_all(mpi_set_overlap_communication_local, overlap);
+}
@@ -76,10 +76,41 @@ void mpi_bcast_cell_structure(int cs);
  */
 void mpi_set_use_verlet_lists(bool use_verlet_lists);
 
+/**
+ * @brief Set @ref CellStructure::use_soa "cell_structure::use_soa"
+ *
+ * @param use_soa Should central pair forces be calculated from
+ *                packed particle data?
+ */
+void mpi_set_use_soa(bool use_soa);
+
+/**
+ * @brief Set @ref CellStructure::particle_sort_interval
+ * "cell_structure::particle_sort_interval"
+ *
+ * @param interval Number of resorts between sorting the particles
+ *                 along the Morton curve, 0 to disable sorting.
+ */
+void mpi_set_particle_sort_interval(int interval);
+
+/**
+ * @brief Set @ref CellStructure::overlap_communication
+ * "cell_structure::overlap_communication"
+ *
+ * @param overlap Whether to overlap the ghost communication
+ *                with the force calculation.
+ */
+void mpi_set_overlap_communication(bool overlap);
+
 /** Update ghost information. If needed,
  *  the particles are also resorted.
+ *
+ *  @param data_parts Particle parts to update.
+ *  @param overlap If @ref CellStructure::overlap_communication is set
+ *         and no resort is needed, only start the update. The caller
+ *         then has to finish it, see @ref CellStructure::ghosts_wait.
  */
-void cells_update_ghosts(unsigned data_parts);
+void cells_update_ghosts(unsigned data_parts, bool overlap = false);
 
 /**
  * @brief Get pairs closer than @p distance from the cells.
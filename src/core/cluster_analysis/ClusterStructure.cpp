@@ -20,17 +20,187 @@
 
 #include "Cluster.hpp"
 #include "PartCfg.hpp"
+#include "pair_criteria/pair_criteria.hpp"
+
+#include "CellStructure.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
 #include "errorhandling.hpp"
+#include "event.hpp"
 #include "partCfg_global.hpp"
 
 #include <utils/for_each_pair.hpp>
+#include <utils/mpi/gather_buffer.hpp>
+
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/optional.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/variant.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/variant.hpp>
 
 #include <algorithm>
+#include <functional>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace ClusterAnalysis {
+namespace {
+/** @brief Pair criteria which can be evaluated on all nodes. */
+using DistributedCriterion =
+    boost::variant<PairCriteria::DistanceCriterion,
+                   PairCriteria::EnergyCriterion, PairCriteria::BondCriterion>;
+
+boost::optional<DistributedCriterion>
+distributed_criterion(PairCriteria::PairCriterion const *criterion) {
+  using namespace PairCriteria;
+  if (auto const c = dynamic_cast<DistanceCriterion const *>(criterion))
+    return {DistributedCriterion{*c}};
+  if (auto const c = dynamic_cast<EnergyCriterion const *>(criterion))
+    return {DistributedCriterion{*c}};
+  if (auto const c = dynamic_cast<BondCriterion const *>(criterion))
+    return {DistributedCriterion{*c}};
+  return boost::none;
+}
+
+/** @brief Disjoint sets of particle ids.
+ *  The representative of a set is its smallest particle id.
+ */
+class ParticleIdForest {
+  std::unordered_map<int, int> m_parent;
+
+public:
+  int find(int id) {
+    auto it = m_parent.find(id);
+    if (it == m_parent.end()) {
+      m_parent.emplace(id, id);
+      return id;
+    }
+    while (it->second != id) {
+      auto const parent = m_parent.find(it->second);
+      /* path halving */
+      it->second = parent->second;
+      id = it->second;
+      it = m_parent.find(id);
+    }
+    return id;
+  }
+
+  void unite(int id1, int id2) {
+    auto const root1 = find(id1);
+    auto const root2 = find(id2);
+    if (root1 < root2) {
+      m_parent[root2] = root1;
+    } else if (root2 < root1) {
+      m_parent[root1] = root2;
+    }
+  }
+
+  /** @brief Pairs of particle id and representative. */
+  std::vector<std::pair<int, int>> labels() {
+    std::vector<std::pair<int, int>> result;
+    result.reserve(m_parent.size());
+    for (auto const &kv : m_parent) {
+      result.emplace_back(kv.first, kv.second);
+    }
+    for (auto &label : result) {
+      label.second = find(label.second);
+    }
+    return result;
+  }
+};
+
+/** @brief Whether the pairs found by the cell system include all pairs
+ *  for which @p criterion can be true.
+ */
+class PairLoopSuffices : public boost::static_visitor<bool> {
+public:
+  bool operator()(PairCriteria::DistanceCriterion criterion) const {
+    auto const range = cell_structure.max_range();
+    auto const cut_off = criterion.get_cut_off();
+    return cut_off <= *std::min_element(range.begin(), range.end());
+  }
+  /* the energy vanishes beyond the interaction range */
+  bool operator()(PairCriteria::EnergyCriterion criterion) const {
+    return criterion.get_cut_off() > 0.;
+  }
+  /* bonded pairs are taken from the bond lists */
+  bool operator()(PairCriteria::BondCriterion const &) const { return false; }
+};
+
+/** @brief Label the clusters of the local particles.
+ *
+ *  Pairs of local particles and their ghosts are taken either from
+ *  the cell system or from the pair bonds of the local particles.
+ *  Every node builds disjoint sets of the particles it has seen,
+ *  and the labels are gathered on the head node, where the sets of
+ *  all nodes are merged.
+ *
+ *  @return Pairs of particle id and the smallest particle id in the
+ *          local set, or nothing if the pairs cannot be found in the
+ *          cell system, e.g. because the range of the criterion exceeds
+ *          the cell size or because a bond partner is not available.
+ */
+boost::optional<std::vector<std::pair<int, int>>>
+cluster_labels_local(DistributedCriterion const &criterion,
+                     bool bonded_only) {
+  on_observable_calc();
+
+  auto const &pair_criterion = boost::apply_visitor(
+      [](auto const &c) -> PairCriteria::PairCriterion const & { return c; },
+      criterion);
+
+  ParticleIdForest forest;
+  auto const add_pair = [&](Particle const &p1, Particle const &p2) {
+    if (p1.identity() != p2.identity() and pair_criterion.decide(p1, p2)) {
+      forest.unite(p1.identity(), p2.identity());
+    }
+  };
+
+  auto const use_pair_loop =
+      not bonded_only and boost::apply_visitor(PairLoopSuffices{}, criterion);
+  auto valid = bonded_only or
+               boost::get<PairCriteria::BondCriterion>(&criterion) or
+               use_pair_loop;
+  valid = boost::mpi::all_reduce(comm_cart, valid, std::logical_and<bool>());
+  if (not valid) {
+    return boost::none;
+  }
+
+  if (use_pair_loop) {
+    cell_structure.non_bonded_loop(
+        [&add_pair](Particle const &p1, Particle const &p2, Distance const &) {
+          add_pair(p1, p2);
+        });
+  } else {
+    for (auto const &p : cell_structure.local_particles()) {
+      for (auto const bond : p.bonds()) {
+        if (bond.partner_ids().size() == 1) {
+          auto const partner =
+              cell_structure.get_local_particle(bond.partner_ids()[0]);
+          if (partner == nullptr) {
+            valid = false;
+            continue;
+          }
+          add_pair(p, *partner);
+        }
+      }
+    }
+    valid = boost::mpi::all_reduce(comm_cart, valid, std::logical_and<bool>());
+    if (not valid) {
+      return boost::none;
+    }
+  }
+
+  auto labels = forest.labels();
+  Utils::Mpi::gather_buffer(labels, comm_cart);
+  return {std::move(labels)};
+}
+} // namespace
+
+REGISTER_CALLBACK_MASTER_RANK(cluster_labels_local)
 
 ClusterStructure::ClusterStructure() { clear(); }
 
@@ -44,11 +214,51 @@ inline bool ClusterStructure::part_of_cluster(const Particle &p) {
   return cluster_id.find(p.p.identity) != cluster_id.end();
 }
 
+bool ClusterStructure::run_distributed(bool bonded_only) {
+  auto const criterion = distributed_criterion(m_pair_criterion.get());
+  if (not criterion) {
+    return false;
+  }
+  auto const labels =
+      mpi_call(::Communication::Result::master_rank, cluster_labels_local,
+               *criterion, bonded_only);
+  if (not labels) {
+    return false;
+  }
+
+  // Merge the sets of the nodes
+  ParticleIdForest forest;
+  for (auto const &label : *labels) {
+    forest.unite(label.first, label.second);
+  }
+  for (auto const &label : forest.labels()) {
+    cluster_id[label.first] = label.second;
+  }
+
+  // Number the clusters consecutively, in the order of their smallest
+  // particle id, which is the first one to be seen
+  std::unordered_map<int, int> numbers;
+  for (auto &it : cluster_id) {
+    auto const number =
+        numbers.emplace(it.second, static_cast<int>(numbers.size()) + 1);
+    if (number.second) {
+      clusters[number.first->second] = std::make_shared<Cluster>();
+    }
+    it.second = number.first->second;
+    clusters[it.second]->particles.push_back(it.first);
+  }
+  return true;
+}
+
 // Analyze the cluster structure of the given particles
 void ClusterStructure::run_for_all_pairs() {
   // clear data structs
   clear();
 
+  if (run_distributed(false)) {
+    return;
+  }
+
   // Iterate over pairs
   Utils::for_each_pair(partCfg().begin(), partCfg().end(),
                        [this](const Particle &p1, const Particle &p2) {
@@ -59,6 +269,10 @@ void ClusterStructure::run_for_all_pairs() {
 
 void ClusterStructure::run_for_bonded_particles() {
   clear();
+
+  if (run_distributed(true)) {
+    return;
+  }
   for (const auto &p : partCfg()) {
     for (auto const bond : p.bonds()) {
       if (bond.partner_ids().size() == 1) {
@@ -68,6 +68,12 @@ private:
   /** @brief pair criterion which decides whether two particles are neighbors */
   std::shared_ptr<PairCriteria::PairCriterion> m_pair_criterion;
 
+  /** @brief Run the cluster analysis in parallel on all nodes.
+   *  This requires a pair criterion known to all nodes, and that the
+   *  neighbors of a particle can be found in the cell system.
+   *  @return Whether the analysis could be done.
+   */
+  bool run_distributed(bool bonded_only);
   /** @brief Consider an individual pair of particles during cluster analysis */
   void add_pair(const Particle &p1, const Particle &p2);
   /** Merge clusters and populate their structures */
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Unit tests for the cluster analysis. */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE Cluster analysis test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "cluster_analysis/ClusterStructure.hpp"
+#include "pair_criteria/pair_criteria.hpp"
+
+#include "EspressoSystemStandAlone.hpp"
+#include "bonded_interactions/bonded_interaction_utils.hpp"
+#include "bonded_interactions/harmonic.hpp"
+#include "communication.hpp"
+#include "grid.hpp"
+#include "particle_data.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace utf = boost::unit_test;
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+using Clusters = std::vector<std::vector<int>>;
+
+/** Connected components of the graph with edges @p pairs. */
+Clusters reference_clusters(std::vector<std::pair<int, int>> const &pairs,
+                            int n_particles) {
+  std::vector<int> parent(n_particles);
+  std::iota(parent.begin(), parent.end(), 0);
+  auto const find = [&parent](int i) {
+    while (parent[i] != i)
+      i = parent[i];
+    return i;
+  };
+  std::vector<bool> in_cluster(n_particles, false);
+  for (auto const &pair : pairs) {
+    parent[find(pair.first)] = find(pair.second);
+    in_cluster[pair.first] = in_cluster[pair.second] = true;
+  }
+  std::map<int, std::vector<int>> clusters;
+  for (int pid = 0; pid < n_particles; ++pid) {
+    if (in_cluster[pid])
+      clusters[find(pid)].push_back(pid);
+  }
+  Clusters result;
+  for (auto const &kv : clusters)
+    result.push_back(kv.second);
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+Clusters get_clusters(ClusterAnalysis::ClusterStructure const &cs) {
+  Clusters result;
+  for (auto const &kv : cs.clusters) {
+    for (auto const pid : kv.second->particles) {
+      BOOST_REQUIRE_EQUAL(cs.cluster_id.at(pid), kv.first);
+    }
+    result.push_back(kv.second->particles);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(ClusterStructure_test,
+                     *utf::precondition(if_head_node())) {
+  using namespace ClusterAnalysis;
+  using namespace PairCriteria;
+  int const n_particles = 300;
+
+  // a 4x4x4 cell grid
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(10.));
+  espresso::system->set_skin(0.4);
+  mpi_set_min_global_cut(2.);
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> uniform(0., 10.);
+  std::vector<Utils::Vector3d> positions;
+  for (int pid = 0; pid < n_particles; ++pid) {
+    positions.push_back(
+        {uniform(generator), uniform(generator), uniform(generator)});
+    place_particle(pid, positions.back());
+  }
+  auto const pairs_within = [&positions](double cut_off) {
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < n_particles; ++i) {
+      for (int j = i + 1; j < n_particles; ++j) {
+        auto const d = box_geo.get_mi_vector(positions[i], positions[j]);
+        if (d.norm() <= cut_off)
+          pairs.emplace_back(i, j);
+      }
+    }
+    return pairs;
+  };
+
+  ClusterStructure cs;
+  auto distance_criterion = std::make_shared<DistanceCriterion>();
+  cs.set_pair_criterion(distance_criterion);
+
+  // distance criterion within and beyond the cell size
+  for (auto const cut_off : {1., 3.}) {
+    distance_criterion->set_cut_off(cut_off);
+    cs.run_for_all_pairs();
+    auto const clusters = get_clusters(cs);
+    BOOST_REQUIRE(not clusters.empty());
+    BOOST_CHECK(clusters ==
+                reference_clusters(pairs_within(cut_off), n_particles));
+  }
+
+  // bonds between close particles
+  int const bond_id = 0;
+  set_bonded_ia_params(bond_id, HarmonicBond(1., 0.5, 1.5));
+  std::vector<std::pair<int, int>> bonded_pairs;
+  for (auto const &pair : pairs_within(1.5)) {
+    if ((pair.first + pair.second) % 3 == 0) {
+      add_particle_bond(pair.first, std::vector<int>{bond_id, pair.second});
+      bonded_pairs.push_back(pair);
+    }
+  }
+
+  auto bond_criterion = std::make_shared<BondCriterion>();
+  bond_criterion->set_bond_type(bond_id);
+  for (int i = 0; i < 2; ++i) {
+    cs.set_pair_criterion(bond_criterion);
+    cs.run_for_all_pairs();
+    auto const reference = reference_clusters(bonded_pairs, n_particles);
+    BOOST_REQUIRE_GT(reference.size(), 1);
+    BOOST_CHECK(get_clusters(cs) == reference);
+    cs.run_for_bonded_particles();
+    BOOST_CHECK(get_clusters(cs) == reference);
+
+    // bonded pairs which are also close
+    distance_criterion->set_cut_off(1.);
+    cs.set_pair_criterion(distance_criterion);
+    cs.run_for_bonded_particles();
+    auto close_pairs = bonded_pairs;
+    close_pairs.erase(std::remove_if(close_pairs.begin(), close_pairs.end(),
+                                     [&positions](auto const &pair) {
+                                       return box_geo
+                                                  .get_mi_vector(
+                                                      positions[pair.first],
+                                                      positions[pair.second])
+                                                  .norm() > 1.;
+                                     }),
+                      close_pairs.end());
+    BOOST_CHECK(get_clusters(cs) == reference_clusters(close_pairs,
+                                                       n_particles));
+
+    // a bond between distant particles, the partner is not a ghost
+    auto const far_pair = std::make_pair(0, 1);
+    BOOST_REQUIRE_GT(
+        box_geo.get_mi_vector(positions[0], positions[1]).norm(), 4.);
+    add_particle_bond(far_pair.first,
+                      std::vector<int>{bond_id, far_pair.second});
+    bonded_pairs.push_back(far_pair);
+  }
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
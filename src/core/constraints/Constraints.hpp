@@ -20,6 +20,7 @@
 #define CORE_CONSTRAINTS_CONSTRAINTS_HPP
 
 #include "Observable_stat.hpp"
+#include "Particle.hpp"
 #include "grid.hpp"
 #include "statistics.hpp"
 
@@ -66,6 +67,7 @@ public:
   iterator end() { return m_constraints.end(); }
   const_iterator begin() const { return m_constraints.begin(); }
   const_iterator end() const { return m_constraints.end(); }
+  bool empty() const { return m_constraints.empty(); }
 
   void add_forces(ParticleRange &particles, double t) const {
     if (m_constraints.empty())
@@ -87,11 +89,15 @@ public:
   void add_energy(const ParticleRange &particles, double t,
                   Observable_stat &energy) const {
     for (auto &p : particles) {
-      auto const pos = folded_position(p.r.p, box_geo);
+      add_energy(p, t, energy);
+    }
+  }
 
-      for (auto const &c : *this) {
-        c->add_energy(p, pos, t, energy);
-      }
+  void add_energy(const Particle &p, double t, Observable_stat &energy) const {
+    auto const pos = folded_position(p.r.p, box_geo);
+
+    for (auto const &c : *this) {
+      c->add_energy(p, pos, t, energy);
     }
   }
 
@@ -51,6 +51,8 @@
 #include <cstdio>
 #include <limits>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 Coulomb_parameters coulomb;
 
@@ -253,6 +255,23 @@ void init() {
   }
 }
 
+void calc_long_range_force_begin(const ParticleRange &particles) {
+#ifdef P3M
+  if (coulomb.method == COULOMB_P3M) {
+    p3m_charge_assign(particles);
+    p3m_calc_kspace_forces_begin();
+  }
+#endif
+}
+
+void calc_long_range_force_progress() {
+#ifdef P3M
+  if (coulomb.method == COULOMB_P3M) {
+    p3m_calc_kspace_forces_progress();
+  }
+#endif
+}
+
 void calc_long_range_force(const ParticleRange &particles) {
   switch (coulomb.method) {
 #ifdef P3M
@@ -285,14 +304,17 @@ void calc_long_range_force(const ParticleRange &particles) {
 #endif
 #ifdef P3M
   case COULOMB_P3M:
-    p3m_charge_assign(particles);
+    if (not p3m_calc_kspace_forces_pending()) {
+      p3m_charge_assign(particles);
+      p3m_calc_kspace_forces_begin();
+    }
 #ifdef NPT
     if (integ_switch == INTEG_METHOD_NPT_ISO) {
-      auto const energy = p3m_calc_kspace_forces(true, true, particles);
+      auto const energy = p3m_calc_kspace_forces_end(true, particles);
       npt_add_virial_contribution(energy);
     } else
 #endif
-      p3m_calc_kspace_forces(true, false, particles);
+      p3m_calc_kspace_forces_end(false, particles);
     break;
 #endif
 #ifdef SCAFACOS
@@ -364,6 +386,51 @@ double calc_energy_long_range(const ParticleRange &particles) {
   return energy;
 }
 
+bool has_energy_long_range_change() {
+  switch (coulomb.method) {
+  case COULOMB_NONE:
+  case COULOMB_DH:
+  case COULOMB_RF:
+    return true;
+#ifdef P3M
+  case COULOMB_P3M:
+    return p3m.params.epsilon == P3M_EPSILON_METALLIC;
+#endif
+  default:
+    return false;
+  }
+}
+
+double calc_energy_long_range_reference(const ParticleRange &particles) {
+  assert(has_energy_long_range_change());
+#ifdef P3M
+  if (coulomb.method == COULOMB_P3M) {
+    return p3m_calc_kspace_energy_reference(particles);
+  }
+#endif
+  return calc_energy_long_range(particles);
+}
+
+double calc_energy_long_range_change(
+    std::vector<std::pair<double, Utils::Vector3d>> const &charges_old,
+    std::vector<std::pair<double, Utils::Vector3d>> const &charges_new) {
+  assert(has_energy_long_range_change());
+#ifdef P3M
+  if (coulomb.method == COULOMB_P3M) {
+    return p3m_calc_kspace_energy_change(charges_old, charges_new);
+  }
+#endif
+  return 0.;
+}
+
+void accept_energy_long_range_change() {
+#ifdef P3M
+  if (coulomb.method == COULOMB_P3M) {
+    p3m_accept_kspace_energy_change();
+  }
+#endif
+}
+
 int icc_sanity_check() {
   switch (coulomb.method) {
 #ifdef P3M
@@ -29,6 +29,9 @@
 
 #include <utils/Vector.hpp>
 
+#include <utility>
+#include <vector>
+
 /** Type codes for the type of %Coulomb interaction.
  *  Enumeration of implemented methods for the electrostatic interaction.
  */
@@ -71,10 +74,44 @@ void on_coulomb_change();
 void on_boxl_change();
 void init();
 
+/** @brief Start the long-range force calculation, if the active method
+ *  can overlap its communication with other work.
+ *
+ *  The calculation is completed by @ref calc_long_range_force.
+ */
+void calc_long_range_force_begin(const ParticleRange &particles);
+/** @brief Make progress on a long-range force calculation started by
+ *  @ref calc_long_range_force_begin.
+ */
+void calc_long_range_force_progress();
 void calc_long_range_force(const ParticleRange &particles);
 
 double calc_energy_long_range(const ParticleRange &particles);
 
+/** @brief Whether the active method can calculate the change of its
+ *  long-range energy by a change of charges with
+ *  @ref calc_energy_long_range_change.
+ */
+bool has_energy_long_range_change();
+/** @brief Calculate the long-range energy like @ref calc_energy_long_range
+ *  and keep it as reference state of @ref calc_energy_long_range_change.
+ */
+double calc_energy_long_range_reference(const ParticleRange &particles);
+/** @brief Calculate the change of the long-range energy by a change of
+ *  charges, relative to the reference state.
+ *
+ *  @param charges_old Charges and positions before the change.
+ *  @param charges_new Charges and positions after the change.
+ *  @return The contribution of this node to the energy change.
+ */
+double calc_energy_long_range_change(
+    std::vector<std::pair<double, Utils::Vector3d>> const &charges_old,
+    std::vector<std::pair<double, Utils::Vector3d>> const &charges_new);
+/** @brief Make the last change of @ref calc_energy_long_range_change
+ *  part of the reference state.
+ */
+void accept_energy_long_range_change();
+
 int icc_sanity_check();
 
 void bcast_coulomb_params();
@@ -132,9 +132,9 @@ std::vector<double> grid_influence_function(P3MParameters const &params,
         auto const ind = Utils::get_linear_index(n - n_start, size,
                                                  Utils::MemoryOrder::ROW_MAJOR);
 
-        if (((n[0] % (params.mesh[0] / 2) == 0) &&
-             (n[1] % (params.mesh[0] / 2) == 0) &&
-             (n[2] % (params.mesh[0] / 2) == 0))) {
+        if ((detail::is_self_conjugate(n[0], params.mesh[0]) &&
+             detail::is_self_conjugate(n[1], params.mesh[0]) &&
+             detail::is_self_conjugate(n[2], params.mesh[0]))) {
           g[ind] = 0.0;
         } else {
           auto const shift = Utils::Vector3i{shifts[0][n[0]], shifts[0][n[1]],
@@ -181,12 +181,16 @@ double G_opt_dipolar_self_energy(P3MParameters const &params,
  * @param n_start Lower left corner of the grid
  * @param n_end Upper right corner of the grid.
  * @param g Energies on the grid.
+ * @param weight Multiplicity of a grid point, as a function of its
+ *        position relative to @p n_start.
  * @return Total self-energy.
  */
+template <class Weight>
 double grid_influence_function_self_energy(P3MParameters const &params,
                                            Utils::Vector3i const &n_start,
                                            Utils::Vector3i const &n_end,
-                                           std::vector<double> const &g) {
+                                           std::vector<double> const &g,
+                                           Weight const &weight) {
   auto const size = n_end - n_start;
 
   auto const shifts =
@@ -199,9 +203,9 @@ double grid_influence_function_self_energy(P3MParameters const &params,
   for (n[0] = n_start[0]; n[0] < n_end[0]; n[0]++) {
     for (n[1] = n_start[1]; n[1] < n_end[1]; n[1]++) {
       for (n[2] = n_start[2]; n[2] < n_end[2]; n[2]++) {
-        if (((n[0] % (params.mesh[0] / 2) == 0) &&
-             (n[1] % (params.mesh[0] / 2) == 0) &&
-             (n[2] % (params.mesh[0] / 2) == 0))) {
+        if ((detail::is_self_conjugate(n[0], params.mesh[0]) &&
+             detail::is_self_conjugate(n[1], params.mesh[0]) &&
+             detail::is_self_conjugate(n[2], params.mesh[0]))) {
           energy += 0.0;
         } else {
           auto const ind = Utils::get_linear_index(
@@ -211,7 +215,7 @@ double grid_influence_function_self_energy(P3MParameters const &params,
           auto const d_op =
               Utils::Vector3i{d_ops[0][n[0]], d_ops[0][n[1]], d_ops[0][n[2]]};
           auto const U2 = G_opt_dipolar_self_energy(params, shift);
-          energy += g[ind] * U2 * d_op.norm2();
+          energy += weight(n - n_start) * g[ind] * U2 * d_op.norm2();
         }
       }
     }
@@ -42,20 +42,23 @@
 #include <fftw3.h>
 #include <mpi.h>
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
-#include <cstdio>
+#include <cstddef>
 #include <cstring>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 using Utils::get_linear_index;
 using Utils::permute_ifield;
 
 /** @name MPI tags for FFT communication */
 /**@{*/
-/** Tag for communication in forw_grid_comm() */
+/** Tag for the redistribution before a forward FFT */
 #define REQ_FFT_FORW 301
-/** Tag for communication in back_grid_comm() */
+/** Tag for the redistribution after a backward FFT */
 #define REQ_FFT_BACK 302
 /**@}*/
 
@@ -350,66 +353,243 @@ void pack_block_permute2(double const *const in, double *const out,
   }
 }
 
-/** Communicate the grid data according to the given forward FFT plan.
- *  \param plan   FFT communication plan.
- *  \param in     input mesh.
- *  \param out    output mesh.
+/** Block layout of a redistribution of the grid data. */
+struct grid_comm_layout {
+  /** group of nodes which have to communicate with each other. */
+  std::vector<int> const &group;
+  /** packing function for send blocks. */
+  void (*pack_function)(double const *const, double *const, int const *,
+                        int const *, int const *, int);
+  /** Send block specification, sizes and dimension of the input mesh. */
+  std::vector<int> const &send_block;
+  std::vector<int> const &send_size;
+  int const *send_mesh;
+  /** Recv block specification, sizes and dimension of the output mesh. */
+  std::vector<int> const &recv_block;
+  std::vector<int> const &recv_size;
+  int const *recv_mesh;
+  /** size of block elements. */
+  int element;
+  /** MPI tag. */
+  int tag;
+};
+
+/** Layout of the redistribution before a forward FFT.
+ *  \param plan   Forward FFT plan.
+ */
+grid_comm_layout forw_layout(fft_forw_plan const &plan) {
+  return {plan.group,      plan.pack_function, plan.send_block,
+          plan.send_size,  plan.old_mesh,      plan.recv_block,
+          plan.recv_size,  plan.new_mesh,      plan.element,
+          REQ_FFT_FORW};
+}
+
+/** Layout of the redistribution after a backward FFT.
+ *  Back means: Use the send/receive stuff from the forward plan but
+ *  replace the receive blocks by the send blocks and vice
+ *  versa. Attention then also new_mesh and old_mesh are exchanged.
+ *  \param plan_f Forward FFT plan.
+ *  \param plan_b Backward FFT plan.
+ */
+grid_comm_layout back_layout(fft_forw_plan const &plan_f,
+                             fft_back_plan const &plan_b) {
+  return {plan_f.group,     plan_b.pack_function, plan_f.recv_block,
+          plan_f.recv_size, plan_f.new_mesh,      plan_f.send_block,
+          plan_f.send_size, plan_f.old_mesh,      plan_f.element,
+          REQ_FFT_BACK};
+}
+
+/** Start the redistribution of the grid data.
+ *  The blocks of all meshes for a node are sent in a single message,
+ *  and the messages to all nodes of the group are posted at once.
+ *  \param layout Block layout.
+ *  \param in     input meshes.
  *  \param fft    FFT communication plan.
  *  \param comm   MPI communicator.
  */
-void forw_grid_comm(fft_forw_plan plan, const double *in, double *out,
-                    fft_data_struct &fft,
-                    const boost::mpi::communicator &comm) {
-  for (int i = 0; i < plan.group.size(); i++) {
-    plan.pack_function(in, fft.send_buf.data(), &(plan.send_block[6 * i]),
-                       &(plan.send_block[6 * i + 3]), plan.old_mesh,
-                       plan.element);
-
-    if (plan.group[i] != comm.rank()) {
-      MPI_Sendrecv(fft.send_buf.data(), plan.send_size[i], MPI_DOUBLE,
-                   plan.group[i], REQ_FFT_FORW, fft.recv_buf.data(),
-                   plan.recv_size[i], MPI_DOUBLE, plan.group[i], REQ_FFT_FORW,
-                   comm, MPI_STATUS_IGNORE);
-    } else { /* Self communication... */
-      std::swap(fft.send_buf, fft.recv_buf);
+void grid_comm_start(grid_comm_layout const &layout, Utils::Span<double *> in,
+                     fft_data_struct &fft,
+                     const boost::mpi::communicator &comm) {
+  auto const n_meshes = static_cast<int>(in.size());
+  auto const n_nodes = layout.group.size();
+
+  std::size_t send_total = 0, recv_total = 0;
+  for (std::size_t i = 0; i < n_nodes; i++) {
+    send_total += n_meshes * layout.send_size[i];
+    recv_total += n_meshes * layout.recv_size[i];
+  }
+  if (fft.send_buf.size() < send_total)
+    fft.send_buf.resize(send_total);
+  if (fft.recv_buf.size() < recv_total)
+    fft.recv_buf.resize(recv_total);
+
+  auto &requests = fft.request.requests;
+  requests.clear();
+
+  /* post the receives first, so that the messages can be delivered
+     directly into the buffer */
+  std::size_t offset = 0;
+  for (std::size_t i = 0; i < n_nodes; i++) {
+    if (layout.group[i] != comm.rank()) {
+      requests.emplace_back();
+      MPI_Irecv(fft.recv_buf.data() + offset, n_meshes * layout.recv_size[i],
+                MPI_DOUBLE, layout.group[i], layout.tag, comm,
+                &requests.back());
     }
-    fft_unpack_block(fft.recv_buf.data(), out, &(plan.recv_block[6 * i]),
-                     &(plan.recv_block[6 * i + 3]), plan.new_mesh,
-                     plan.element);
+    offset += n_meshes * layout.recv_size[i];
+  }
+
+  offset = 0;
+  for (std::size_t i = 0; i < n_nodes; i++) {
+    auto const send_buf = fft.send_buf.data() + offset;
+    for (int m = 0; m < n_meshes; m++) {
+      layout.pack_function(in[m], send_buf + m * layout.send_size[i],
+                           &(layout.send_block[6 * i]),
+                           &(layout.send_block[6 * i + 3]), layout.send_mesh,
+                           layout.element);
+    }
+    if (layout.group[i] != comm.rank()) {
+      requests.emplace_back();
+      MPI_Isend(send_buf, n_meshes * layout.send_size[i], MPI_DOUBLE,
+                layout.group[i], layout.tag, comm, &requests.back());
+    }
+    offset += n_meshes * layout.send_size[i];
   }
 }
 
-/** Communicate the grid data according to the given backward FFT plan.
- *  \param plan_f Forward FFT plan.
- *  \param plan_b Backward FFT plan.
- *  \param in     input mesh.
- *  \param out    output mesh.
+/** Finish the redistribution of the grid data, after all messages
+ *  posted by @ref grid_comm_start have completed.
+ *  \param layout Block layout.
+ *  \param out    output meshes.
  *  \param fft    FFT communication plan.
  *  \param comm   MPI communicator.
  */
-void back_grid_comm(fft_forw_plan plan_f, fft_back_plan plan_b,
-                    const double *in, double *out, fft_data_struct &fft,
-                    const boost::mpi::communicator &comm) {
-  /* Back means: Use the send/receive stuff from the forward plan but
-     replace the receive blocks by the send blocks and vice
-     versa. Attention then also new_mesh and old_mesh are exchanged */
-
-  for (int i = 0; i < plan_f.group.size(); i++) {
-    plan_b.pack_function(in, fft.send_buf.data(), &(plan_f.recv_block[6 * i]),
-                         &(plan_f.recv_block[6 * i + 3]), plan_f.new_mesh,
-                         plan_f.element);
-
-    if (plan_f.group[i] != comm.rank()) { /* send first, receive second */
-      MPI_Sendrecv(fft.send_buf.data(), plan_f.recv_size[i], MPI_DOUBLE,
-                   plan_f.group[i], REQ_FFT_BACK, fft.recv_buf.data(),
-                   plan_f.send_size[i], MPI_DOUBLE, plan_f.group[i],
-                   REQ_FFT_BACK, comm, MPI_STATUS_IGNORE);
-    } else { /* Self communication... */
-      std::swap(fft.send_buf, fft.recv_buf);
+void grid_comm_finish(grid_comm_layout const &layout,
+                      Utils::Span<double *> out, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm) {
+  auto const n_meshes = static_cast<int>(out.size());
+
+  std::size_t send_offset = 0, recv_offset = 0;
+  for (std::size_t i = 0; i < layout.group.size(); i++) {
+    /* Self communication: the block is still in the send buffer */
+    auto const recv_buf = (layout.group[i] == comm.rank())
+                              ? fft.send_buf.data() + send_offset
+                              : fft.recv_buf.data() + recv_offset;
+    for (int m = 0; m < n_meshes; m++) {
+      fft_unpack_block(recv_buf + m * layout.recv_size[i], out[m],
+                       &(layout.recv_block[6 * i]),
+                       &(layout.recv_block[6 * i + 3]), layout.recv_mesh,
+                       layout.element);
+    }
+    send_offset += n_meshes * layout.send_size[i];
+    recv_offset += n_meshes * layout.recv_size[i];
+  }
+}
+
+/** Make room for a batch of meshes in the FFT buffers.
+ *  \param fft       FFT plan.
+ *  \param n_meshes  Number of meshes.
+ *  \return Pointers to the intermediate meshes in @ref
+ *          fft_data_struct::data_buf.
+ */
+std::vector<double *> reserve_buffers(fft_data_struct &fft, int n_meshes) {
+  /* keep the alignment the FFTW plans were created with */
+  auto const stride = 8 * ((fft.max_mesh_size + 7) / 8);
+  auto const mesh_size = static_cast<std::size_t>(n_meshes * stride);
+
+  if (fft.data_buf.size() < mesh_size) {
+    fft.data_buf.resize(mesh_size);
+  }
+
+  std::vector<double *> buffers(n_meshes);
+  for (int m = 0; m < n_meshes; m++) {
+    buffers[m] = fft.data_buf.data() + m * stride;
+  }
+  return buffers;
+}
+
+/** Finish the redistribution in flight and continue the pending
+ *  transform up to the next redistribution.
+ *  \param fft    FFT plan.
+ *  \param comm   MPI communicator.
+ */
+void fft_advance(fft_data_struct &fft, const boost::mpi::communicator &comm) {
+  auto &request = fft.request;
+  auto const data = Utils::make_span(request.data);
+  auto const buf = Utils::make_span(request.buf);
+
+  if (request.forward) {
+    switch (request.step) {
+    case 1:
+      grid_comm_finish(forw_layout(fft.plan[1]), buf, fft, comm);
+      /* perform real to complex FFT (in is fft.data_buf, out is data) */
+      for (std::size_t m = 0; m < data.size(); m++) {
+        fftw_execute_dft_r2c(fft.plan[1].our_fftw_plan, buf[m],
+                             reinterpret_cast<fftw_complex *>(data[m]));
+      }
+      /* ===== second direction ===== */
+      /* communication to current dir row format (in is data) */
+      grid_comm_start(forw_layout(fft.plan[2]), data, fft, comm);
+      request.step = 2;
+      break;
+    case 2:
+      grid_comm_finish(forw_layout(fft.plan[2]), buf, fft, comm);
+      /* perform FFT (in/out is fft.data_buf) */
+      for (auto const b : buf) {
+        auto const c_buf = reinterpret_cast<fftw_complex *>(b);
+        fftw_execute_dft(fft.plan[2].our_fftw_plan, c_buf, c_buf);
+      }
+      /* ===== third direction  ===== */
+      /* communication to current dir row format (in is fft.data_buf) */
+      grid_comm_start(forw_layout(fft.plan[3]), buf, fft, comm);
+      request.step = 3;
+      break;
+    case 3:
+      grid_comm_finish(forw_layout(fft.plan[3]), data, fft, comm);
+      /* perform FFT (in/out is data)*/
+      for (auto const d : data) {
+        auto const c_data = reinterpret_cast<fftw_complex *>(d);
+        fftw_execute_dft(fft.plan[3].our_fftw_plan, c_data, c_data);
+      }
+      /* REMARK: Result has to be in data. */
+      request.step = 0;
+      break;
+    }
+  } else {
+    switch (request.step) {
+    case 3:
+      grid_comm_finish(back_layout(fft.plan[3], fft.back[3]), buf, fft, comm);
+      /* ===== second direction ===== */
+      /* perform FFT (in is fft.data_buf) */
+      for (auto const b : buf) {
+        auto const c_buf = reinterpret_cast<fftw_complex *>(b);
+        fftw_execute_dft(fft.back[2].our_fftw_plan, c_buf, c_buf);
+      }
+      /* communicate (in is fft.data_buf) */
+      grid_comm_start(back_layout(fft.plan[2], fft.back[2]), buf, fft, comm);
+      request.step = 2;
+      break;
+    case 2:
+      grid_comm_finish(back_layout(fft.plan[2], fft.back[2]), data, fft,
+                       comm);
+      /* ===== first direction  ===== */
+      /* perform complex to real FFT (in is data, out is fft.data_buf) */
+      for (std::size_t m = 0; m < data.size(); m++) {
+        fftw_execute_dft_c2r(fft.back[1].our_fftw_plan,
+                             reinterpret_cast<fftw_complex *>(data[m]),
+                             buf[m]);
+      }
+      /* communicate (in is fft.data_buf) */
+      grid_comm_start(back_layout(fft.plan[1], fft.back[1]), buf, fft, comm);
+      request.step = 1;
+      break;
+    case 1:
+      grid_comm_finish(back_layout(fft.plan[1], fft.back[1]), data, fft,
+                       comm);
+      /* REMARK: Result has to be in data. */
+      request.step = 0;
+      break;
     }
-    fft_unpack_block(fft.recv_buf.data(), out, &(plan_f.send_block[6 * i]),
-                     &(plan_f.send_block[6 * i + 3]), plan_f.old_mesh,
-                     plan_f.element);
   }
 }
 
@@ -532,6 +712,17 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
   fft.plan[2].row_dir = (fft.plan[1].row_dir - 1) % 3;
   fft.plan[3].row_dir = (fft.plan[1].row_dir - 2) % 3;
 
+  /* === half spectrum === */
+  /* The real to complex FFT along the row direction of the first plan
+     keeps only half of the spectrum, the following plans
+     redistribute the reduced k-space mesh. */
+  int axes[3] = {0, 1, 2};
+  permute_ifield(axes, 3, -(fft.plan[1].n_permute));
+  auto const r2c_dir = axes[2];
+  int ks_mesh_dim[3] = {global_mesh_dim[0], global_mesh_dim[1],
+                        global_mesh_dim[2]};
+  ks_mesh_dim[r2c_dir] = global_mesh_dim[r2c_dir] / 2 + 1;
+
   /* === communication groups === */
   /* copy local mesh off real space charge assignment grid */
   for (i = 0; i < 3; i++)
@@ -539,6 +730,7 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
 
   for (i = 1; i < 4; i++) {
     using Utils::make_span;
+    auto const *const mesh_dim = (i == 1) ? global_mesh_dim : ks_mesh_dim;
     auto group = find_comm_groups(
         {n_grid[i - 1][0], n_grid[i - 1][1], n_grid[i - 1][2]},
         {n_grid[i][0], n_grid[i][1], n_grid[i][2]}, n_id[i - 1],
@@ -566,7 +758,7 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
     fft.plan[i].recv_size.resize(fft.plan[i].group.size());
 
     fft.plan[i].new_size =
-        calc_local_mesh(my_pos[i], n_grid[i], global_mesh_dim, global_mesh_off,
+        calc_local_mesh(my_pos[i], n_grid[i], mesh_dim, global_mesh_off,
                         fft.plan[i].new_mesh, fft.plan[i].start);
     permute_ifield(fft.plan[i].new_mesh, 3, -(fft.plan[i].n_permute));
     permute_ifield(fft.plan[i].start, 3, -(fft.plan[i].n_permute));
@@ -578,7 +770,7 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
       int node = fft.plan[i].group[j];
       fft.plan[i].send_size[j] = calc_send_block(
           my_pos[i - 1], n_grid[i - 1], &(n_pos[i][3 * node]), n_grid[i],
-          global_mesh_dim, global_mesh_off, &(fft.plan[i].send_block[6 * j]));
+          mesh_dim, global_mesh_off, &(fft.plan[i].send_block[6 * j]));
       permute_ifield(&(fft.plan[i].send_block[6 * j]), 3,
                      -(fft.plan[i - 1].n_permute));
       permute_ifield(&(fft.plan[i].send_block[6 * j + 3]), 3,
@@ -595,7 +787,7 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
       /* recv block: comm.rank() from comm-group-node i (identity: node) */
       fft.plan[i].recv_size[j] = calc_send_block(
           my_pos[i], n_grid[i], &(n_pos[i - 1][3 * node]), n_grid[i - 1],
-          global_mesh_dim, global_mesh_off, &(fft.plan[i].recv_block[6 * j]));
+          mesh_dim, global_mesh_off, &(fft.plan[i].recv_block[6 * j]));
       permute_ifield(&(fft.plan[i].recv_block[6 * j]), 3,
                      -(fft.plan[i].n_permute));
       permute_ifield(&(fft.plan[i].recv_block[6 * j + 3]), 3,
@@ -606,6 +798,9 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
 
     for (j = 0; j < 3; j++)
       fft.plan[i].old_mesh[j] = fft.plan[i - 1].new_mesh[j];
+    /* the rows of the first plan are halved by the real to complex FFT */
+    if (i == 2)
+      fft.plan[i].old_mesh[2] = fft.plan[1].new_mesh[2] / 2 + 1;
     if (i == 1)
       fft.plan[i].element = 1;
     else {
@@ -617,12 +812,22 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
     }
   }
 
+  /* position of the halved direction in k-space */
+  int ks_axes[3] = {0, 1, 2};
+  permute_ifield(ks_axes, 3, -(fft.plan[3].n_permute));
+  fft.half_dir = static_cast<int>(std::find(ks_axes, ks_axes + 3, r2c_dir) -
+                                  ks_axes);
+  fft.half_mesh = global_mesh_dim[r2c_dir];
+
+  /* size of the rows after the real to complex FFT */
+  auto const r2c_row = fft.plan[1].new_mesh[2] / 2 + 1;
+
   /* Factor 2 for complex fields */
   fft.max_comm_size *= 2;
-  fft.max_mesh_size = (ca_mesh_dim[0] * ca_mesh_dim[1] * ca_mesh_dim[2]);
-  for (i = 1; i < 4; i++)
-    if (2 * fft.plan[i].new_size > fft.max_mesh_size)
-      fft.max_mesh_size = 2 * fft.plan[i].new_size;
+  fft.max_mesh_size =
+      std::max({ca_mesh_dim[0] * ca_mesh_dim[1] * ca_mesh_dim[2],
+                fft.plan[1].new_size, 2 * fft.plan[1].n_ffts * r2c_row,
+                2 * fft.plan[2].new_size, 2 * fft.plan[3].new_size});
 
   /* === pack function === */
   for (i = 1; i < 4; i++) {
@@ -641,6 +846,10 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
   fft.recv_buf.resize(fft.max_comm_size);
   fft.data_buf.resize(fft.max_mesh_size);
   auto *c_data = (fftw_complex *)(fft.data_buf.data());
+  /* the first direction is transformed out of place, which needs a
+     second array for the planning */
+  fft_vector<double> plan_buf(fft.max_mesh_size);
+  auto *c_plan_buf = (fftw_complex *)(plan_buf.data());
 
   /* === FFT Routines (Using FFTW / RFFTW package)=== */
   for (i = 1; i < 4; i++) {
@@ -649,10 +858,17 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
 
     if (fft.init_tag)
       fftw_destroy_plan(fft.plan[i].our_fftw_plan);
-    fft.plan[i].our_fftw_plan = fftw_plan_many_dft(
-        1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
-        fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
-        fft.plan[i].dir, FFTW_PATIENT);
+    if (i == 1) {
+      fft.plan[i].our_fftw_plan = fftw_plan_many_dft_r2c(
+          1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts,
+          fft.data_buf.data(), nullptr, 1, fft.plan[i].new_mesh[2],
+          c_plan_buf, nullptr, 1, r2c_row, FFTW_PATIENT);
+    } else {
+      fft.plan[i].our_fftw_plan = fftw_plan_many_dft(
+          1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
+          fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
+          fft.plan[i].dir, FFTW_PATIENT);
+    }
   }
 
   /* === The BACK Direction === */
@@ -662,10 +878,17 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
 
     if (fft.init_tag)
       fftw_destroy_plan(fft.back[i].our_fftw_plan);
-    fft.back[i].our_fftw_plan = fftw_plan_many_dft(
-        1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
-        fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
-        fft.back[i].dir, FFTW_PATIENT);
+    if (i == 1) {
+      fft.back[i].our_fftw_plan = fftw_plan_many_dft_c2r(
+          1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_plan_buf,
+          nullptr, 1, r2c_row, fft.data_buf.data(), nullptr, 1,
+          fft.plan[i].new_mesh[2], FFTW_PATIENT);
+    } else {
+      fft.back[i].our_fftw_plan = fftw_plan_many_dft(
+          1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
+          fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
+          fft.back[i].dir, FFTW_PATIENT);
+    }
 
     fft.back[i].pack_function = pack_block_permute1;
   }
@@ -680,77 +903,70 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
   return fft.max_mesh_size;
 }
 
-void fft_perform_forw(double *data, fft_data_struct &fft,
-                      const boost::mpi::communicator &comm) {
-  /* ===== first direction  ===== */
-
-  auto *c_data = (fftw_complex *)data;
-  auto *c_data_buf = (fftw_complex *)fft.data_buf.data();
-
-  /* communication to current dir row format (in is data) */
-  forw_grid_comm(fft.plan[1], data, fft.data_buf.data(), fft, comm);
+void fft_perform_forw_start(Utils::Span<double *> data, fft_data_struct &fft,
+                            const boost::mpi::communicator &comm) {
+  auto &request = fft.request;
+  assert(request.step == 0);
+  request.forward = true;
+  request.data.assign(data.begin(), data.end());
+  request.buf = reserve_buffers(fft, static_cast<int>(data.size()));
 
-  /* complexify the real data array (in is fft.data_buf) */
-  for (int i = 0; i < fft.plan[1].new_size; i++) {
-    data[2 * i + 0] = fft.data_buf[i]; /* real value */
-    data[2 * i + 1] = 0;               /* complex value */
-  }
-  /* perform FFT (in/out is data)*/
-  fftw_execute_dft(fft.plan[1].our_fftw_plan, c_data, c_data);
-  /* ===== second direction ===== */
+  /* ===== first direction  ===== */
   /* communication to current dir row format (in is data) */
-  forw_grid_comm(fft.plan[2], data, fft.data_buf.data(), fft, comm);
-  /* perform FFT (in/out is fft.data_buf) */
-  fftw_execute_dft(fft.plan[2].our_fftw_plan, c_data_buf, c_data_buf);
-  /* ===== third direction  ===== */
-  /* communication to current dir row format (in is fft.data_buf) */
-  forw_grid_comm(fft.plan[3], fft.data_buf.data(), data, fft, comm);
-  /* perform FFT (in/out is data)*/
-  fftw_execute_dft(fft.plan[3].our_fftw_plan, c_data, c_data);
-
-  /* REMARK: Result has to be in data. */
+  grid_comm_start(forw_layout(fft.plan[1]), data, fft, comm);
+  request.step = 1;
 }
 
-void fft_perform_back(double *data, bool check_complex, fft_data_struct &fft,
-                      const boost::mpi::communicator &comm) {
-
-  auto *c_data = (fftw_complex *)data;
-  auto *c_data_buf = (fftw_complex *)fft.data_buf.data();
+void fft_perform_back_start(Utils::Span<double *> data, fft_data_struct &fft,
+                            const boost::mpi::communicator &comm) {
+  auto &request = fft.request;
+  assert(request.step == 0);
+  request.forward = false;
+  request.data.assign(data.begin(), data.end());
+  request.buf = reserve_buffers(fft, static_cast<int>(data.size()));
 
   /* ===== third direction  ===== */
-
   /* perform FFT (in is data) */
-  fftw_execute_dft(fft.back[3].our_fftw_plan, c_data, c_data);
+  for (auto const d : data) {
+    auto const c_data = reinterpret_cast<fftw_complex *>(d);
+    fftw_execute_dft(fft.back[3].our_fftw_plan, c_data, c_data);
+  }
   /* communicate (in is data)*/
-  back_grid_comm(fft.plan[3], fft.back[3], data, fft.data_buf.data(), fft,
-                 comm);
+  grid_comm_start(back_layout(fft.plan[3], fft.back[3]), data, fft, comm);
+  request.step = 3;
+}
 
-  /* ===== second direction ===== */
-  /* perform FFT (in is fft.data_buf) */
-  fftw_execute_dft(fft.back[2].our_fftw_plan, c_data_buf, c_data_buf);
-  /* communicate (in is fft.data_buf) */
-  back_grid_comm(fft.plan[2], fft.back[2], fft.data_buf.data(), data, fft,
-                 comm);
+bool fft_test(fft_data_struct &fft, const boost::mpi::communicator &comm) {
+  auto &request = fft.request;
+  if (request.step != 0) {
+    int done;
+    MPI_Testall(static_cast<int>(request.requests.size()),
+                request.requests.data(), &done, MPI_STATUSES_IGNORE);
+    if (done)
+      fft_advance(fft, comm);
+  }
+  return request.step == 0;
+}
 
-  /* ===== first direction  ===== */
-  /* perform FFT (in is data) */
-  fftw_execute_dft(fft.back[1].our_fftw_plan, c_data, c_data);
-  /* throw away the (hopefully) empty complex component (in is data) */
-  for (int i = 0; i < fft.plan[1].new_size; i++) {
-    fft.data_buf[i] = data[2 * i]; /* real value */
-    // Vincent:
-    if (check_complex && (data[2 * i + 1] > 1e-5)) {
-      printf("Complex value is not zero (i=%d,data=%g)!!!\n", i,
-             data[2 * i + 1]);
-      if (i > 100)
-        throw std::runtime_error("Complex value is not zero");
-    }
+void fft_wait(fft_data_struct &fft, const boost::mpi::communicator &comm) {
+  auto &request = fft.request;
+  while (request.step != 0) {
+    MPI_Waitall(static_cast<int>(request.requests.size()),
+                request.requests.data(), MPI_STATUSES_IGNORE);
+    fft_advance(fft, comm);
   }
-  /* communicate (in is fft.data_buf) */
-  back_grid_comm(fft.plan[1], fft.back[1], fft.data_buf.data(), data, fft,
-                 comm);
+}
 
-  /* REMARK: Result has to be in data. */
+void fft_perform_forw(Utils::Span<double *> data, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm) {
+  fft_perform_forw_start(data, fft, comm);
+  fft_wait(fft, comm);
+}
+
+void fft_perform_back(Utils::Span<double *> data, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm) {
+  fft_perform_back_start(data, fft, comm);
+  fft_wait(fft, comm);
 }
 
 void fft_pack_block(double const *const in, double *const out,
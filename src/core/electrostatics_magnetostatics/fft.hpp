@@ -31,9 +31,12 @@
  *  1D-FFT. After performing the FFT on that direction the data is
  *  redistributed.
  *
- *  For simplicity at the moment I have implemented a full complex to
- *  complex FFT (even though a real to complex FFT would be
- *  sufficient)
+ *  Since the input mesh is real, the first 1D-FFT is a real to complex
+ *  transform, which only keeps the non-negative half of the spectrum
+ *  along its row direction. The other half follows from the Hermitian
+ *  symmetry of the transform and is neither communicated nor stored.
+ *  The backward FFT ends with the corresponding complex to real
+ *  transform, which requires Hermitian k-space data.
  *
  *  \todo Combine the forward and backward structures.
  *  \todo The packing routines could be moved to utils.hpp when they are needed
@@ -45,10 +48,12 @@
 #include "config.hpp"
 #if defined(P3M) || defined(DP3M)
 
+#include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
 #include <boost/mpi/communicator.hpp>
 #include <fftw3.h>
+#include <mpi.h>
 
 #include <algorithm>
 #include <cstddef>
@@ -141,6 +146,28 @@ struct fft_back_plan {
                         int const *, int const *, int);
 };
 
+/** State of a non-blocking 3D FFT.
+ *
+ *  A transform alternates between redistributions of the grid data and
+ *  local 1D FFTs. Only the redistribution in flight is stored, the local
+ *  FFTs following it are performed by @ref fft_test or @ref fft_wait
+ *  once all its messages have arrived.
+ */
+struct fft_request {
+  /** Index of the plan whose redistribution is in flight,
+   *  0 if no transform is pending.
+   */
+  int step = 0;
+  /** Whether the pending transform is a forward FFT. */
+  bool forward = true;
+  /** Meshes of the pending transform. */
+  std::vector<double *> data;
+  /** Intermediate meshes in @ref fft_data_struct::data_buf. */
+  std::vector<double *> buf;
+  /** Messages of the redistribution in flight. */
+  std::vector<MPI_Request> requests;
+};
+
 /** Information about the three one dimensional FFTs and how the nodes
  *  have to communicate inbetween.
  *
@@ -163,12 +190,24 @@ struct fft_data_struct {
   /** Maximal local mesh size. */
   int max_mesh_size = 0;
 
-  /** send buffer. */
+  /** send buffer, grows with the number of meshes transformed together. */
   std::vector<double> send_buf;
-  /** receive buffer. */
+  /** receive buffer, grows with the number of meshes transformed together. */
   std::vector<double> recv_buf;
-  /** Buffer for receive data. */
+  /** Buffer for receive data, holds one intermediate mesh per mesh
+   *  transformed together.
+   */
   fft_vector<double> data_buf;
+
+  /** Direction of the k-space mesh (in the order of plan[3]) along which
+   *  only half of the spectrum is stored.
+   */
+  int half_dir = 0;
+  /** Global mesh size along @ref half_dir. */
+  int half_mesh = 0;
+
+  /** Pending non-blocking transform. */
+  fft_request request;
 };
 
 /** Initialize everything connected to the 3D-FFT.
@@ -188,25 +227,107 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
              int &ks_pnum, fft_data_struct &fft, const Utils::Vector3i &grid,
              const boost::mpi::communicator &comm);
 
+/** Start non-blocking in-place forward 3D FFTs of several meshes.
+ *  The first redistribution of the grid data is posted, the transform
+ *  is continued by @ref fft_test and completed by @ref fft_wait.
+ *  No other transform may be started with the same plan before the
+ *  pending one has completed.
+ *  \param[in,out] data  Meshes, have to stay valid until the transform
+ *                       has completed.
+ *  \param[in,out] fft   FFT plan.
+ *  \param[in]     comm  MPI communicator
+ */
+void fft_perform_forw_start(Utils::Span<double *> data, fft_data_struct &fft,
+                            const boost::mpi::communicator &comm);
+
+/** Start non-blocking in-place backward 3D FFTs of several meshes.
+ *  See @ref fft_perform_forw_start and @ref fft_perform_back.
+ *  \param[in,out] data  Meshes, have to stay valid until the transform
+ *                       has completed.
+ *  \param[in,out] fft   FFT plan.
+ *  \param[in]     comm  MPI communicator
+ */
+void fft_perform_back_start(Utils::Span<double *> data, fft_data_struct &fft,
+                            const boost::mpi::communicator &comm);
+
+/** Make progress on the pending non-blocking transform.
+ *  If the redistribution in flight has completed, the transform is
+ *  continued up to the next redistribution.
+ *  \param[in,out] fft   FFT plan.
+ *  \param[in]     comm  MPI communicator
+ *  \return Whether no transform is pending any more.
+ */
+bool fft_test(fft_data_struct &fft, const boost::mpi::communicator &comm);
+
+/** Complete the pending non-blocking transform, if any.
+ *  \param[in,out] fft   FFT plan.
+ *  \param[in]     comm  MPI communicator
+ */
+void fft_wait(fft_data_struct &fft, const boost::mpi::communicator &comm);
+
+/** Perform in-place forward 3D FFTs of several meshes.
+ *  The meshes are transformed together, i.e. the data of all meshes is
+ *  redistributed with a single message per pair of nodes.
+ *  \warning The content of \a data is overwritten.
+ *  \param[in,out] data  Meshes.
+ *  \param[in,out] fft   FFT plan.
+ *  \param[in]     comm  MPI communicator
+ */
+void fft_perform_forw(Utils::Span<double *> data, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm);
+
 /** Perform an in-place forward 3D FFT.
  *  \warning The content of \a data is overwritten.
  *  \param[in,out] data  Mesh.
  *  \param[in,out] fft   FFT plan.
  *  \param[in]     comm  MPI communicator
  */
-void fft_perform_forw(double *data, fft_data_struct &fft,
+inline void fft_perform_forw(double *data, fft_data_struct &fft,
+                             const boost::mpi::communicator &comm) {
+  fft_perform_forw(Utils::Span<double *>(&data, 1), fft, comm);
+}
+
+/** Perform in-place backward 3D FFTs of several meshes.
+ *  The k-space data has to be Hermitian, i.e. the transform of a real mesh.
+ *  The meshes are transformed together, i.e. the data of all meshes is
+ *  redistributed with a single message per pair of nodes.
+ *  \warning The content of \a data is overwritten.
+ *  \param[in,out] data  Meshes.
+ *  \param[in,out] fft   FFT plan.
+ *  \param[in]     comm  MPI communicator.
+ */
+void fft_perform_back(Utils::Span<double *> data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm);
 
 /** Perform an in-place backward 3D FFT.
+ *  The k-space data has to be Hermitian, i.e. the transform of a real mesh.
  *  \warning The content of \a data is overwritten.
- *  \param[in,out] data           Mesh.
- *  \param[in]     check_complex  Throw an error if the complex component is
- *                                non-zero.
- *  \param[in,out] fft            FFT plan.
- *  \param[in]     comm           MPI communicator.
+ *  \param[in,out] data  Mesh.
+ *  \param[in,out] fft   FFT plan.
+ *  \param[in]     comm  MPI communicator.
  */
-void fft_perform_back(double *data, bool check_complex, fft_data_struct &fft,
-                      const boost::mpi::communicator &comm);
+inline void fft_perform_back(double *data, fft_data_struct &fft,
+                             const boost::mpi::communicator &comm) {
+  fft_perform_back(Utils::Span<double *>(&data, 1), fft, comm);
+}
+
+/** Multiplicity of a k-space mesh point in the full spectrum.
+ *
+ *  Only half of the spectrum is stored along @ref fft_data_struct::half_dir.
+ *  Sums over the full spectrum of terms that are symmetric under
+ *  \f$ k \to -k \f$ therefore have to count the stored points twice,
+ *  except for the self-conjugate planes \f$ k = 0 \f$ and
+ *  \f$ k = N/2 \f$.
+ *
+ *  \param fft  FFT plan.
+ *  \param j    Index of the point in the local k-space mesh (plan[3]).
+ *  \return Weight of the point, 1 or 2.
+ */
+inline double fft_hermitian_weight(fft_data_struct const &fft,
+                                   int const j[3]) {
+  auto const k = j[fft.half_dir] + fft.plan[3].start[fft.half_dir];
+  return (k == 0 or 2 * k == fft.half_mesh) ? 1. : 2.;
+}
 
 /** Pack a block (<tt>size[3]</tt> starting at <tt>start[3]</tt>) of an input
  *  3d-grid with dimension <tt>dim[3]</tt> into an output 3d-block with
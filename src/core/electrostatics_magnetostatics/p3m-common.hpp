@@ -77,6 +77,9 @@ enum FFT_WAVE_VECTOR : int { KY = 0, KZ = 1, KX = 2 };
 #define P3M_RCUT_PREC 1e-3
 /** granularity of the time measurement */
 #define P3M_TIME_GRAN 2
+/** number of harmonics of the self force correction for analytical
+ *  differentiation */
+#define P3M_AD_SELF_FORCE_HARMONICS 2
 
 /************************************************
  * data types
@@ -147,11 +150,15 @@ typedef struct {
   /** number of points unto which a single charge is interpolated, i.e.
    *  p3m.cao^3 */
   int cao3 = 0;
+  /** obtain the forces from the gradient of the charge assignment
+   *  function (analytical differentiation) instead of ik-differentiation,
+   *  only used by the Coulomb P3M. */
+  bool ad = false;
 
   template <typename Archive> void serialize(Archive &ar, long int) {
     ar &tuning &alpha_L &r_cut_iL &mesh;
     ar &mesh_off &cao &accuracy &epsilon &cao_cut;
-    ar &a &ai &alpha &r_cut &cao3;
+    ar &a &ai &alpha &r_cut &cao3 &ad;
   }
 
 } P3MParameters;
@@ -202,9 +209,9 @@ namespace detail {
 /** Calculate indices that shift @ref P3MParameters::mesh "mesh" by `mesh/2`.
  *  For each mesh size @f$ n @f$ in @c mesh_size, create a sequence of integer
  *  values @f$ \left( 0, \ldots, \lfloor n/2 \rfloor, -\lfloor n/2 \rfloor,
- *  \ldots, -1\right) @f$ if @c zero_out_midpoint is false, otherwise
- *  @f$ \left( 0, \ldots, \lfloor n/2 - 1 \rfloor, 0, -\lfloor n/2 \rfloor,
- *  \ldots, -1\right) @f$.
+ *  \ldots, -1\right) @f$. If @c zero_out_midpoint is true, the Nyquist
+ *  index @f$ n/2 @f$ of an even mesh is set to zero, so that the sequence
+ *  is odd under @f$ j \to n - j @f$ for any @f$ n @f$.
  */
 std::array<std::vector<int>, 3> inline calc_meshift(
     std::array<int, 3> const &mesh_size, bool zero_out_midpoint = false) {
@@ -217,12 +224,19 @@ std::array<std::vector<int>, 3> inline calc_meshift(
       ret[i][j] = j;
       ret[i][mesh_size[i] - j] = -j;
     }
-    if (zero_out_midpoint)
+    if (zero_out_midpoint and mesh_size[i] % 2 == 0)
       ret[i][mesh_size[i] / 2] = 0;
   }
 
   return ret;
 }
+
+/** Whether a mesh index is its own mirror image under @f$ j \to n - j @f$,
+ *  i.e. the index 0 or the Nyquist index of an even mesh.
+ */
+inline bool is_self_conjugate(int j, int mesh_size) {
+  return j == 0 or 2 * j == mesh_size;
+}
 } // namespace detail
 
 #endif /* _P3M_COMMON_H */
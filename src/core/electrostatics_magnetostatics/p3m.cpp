@@ -49,6 +49,7 @@
 #include <utils/Vector.hpp>
 #include <utils/constants.hpp>
 #include <utils/integral_parameter.hpp>
+#include <utils/math/bspline.hpp>
 #include <utils/math/int_pow.hpp>
 #include <utils/math/sinc.hpp>
 #include <utils/math/sqr.hpp>
@@ -61,12 +62,16 @@
 #include <boost/range/numeric.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
 #include <complex>
 #include <cstddef>
 #include <cstdio>
 #include <functional>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 using Utils::sinc;
 
@@ -112,6 +117,11 @@ static void p3m_calc_influence_function_force();
  */
 static void p3m_calc_influence_function_energy();
 
+/** Calculate the harmonics of the self force with analytical
+ *  differentiation from the force influence function.
+ */
+static void p3m_calc_ad_self_force();
+
 /**@}*/
 
 /** @name P3M tuning helper functions */
@@ -292,7 +302,24 @@ void p3m_set_eps(double eps) {
   mpi_bcast_coulomb_params();
 }
 
+void p3m_set_ad(bool ad) {
+  p3m.params.ad = ad;
+
+  mpi_bcast_coulomb_params();
+}
+
 namespace {
+/** Charged particles of a range, in order. */
+std::vector<Particle *> charged_particles(const ParticleRange &particles) {
+  std::vector<Particle *> ret;
+  for (auto &p : particles) {
+    if (p.p.q != 0.0) {
+      ret.push_back(&p);
+    }
+  }
+  return ret;
+}
+
 template <size_t cao> struct AssignCharge {
   void operator()(double q, const Utils::Vector3d &real_pos,
                   const Utils::Vector3d &ai, p3m_local_mesh const &local_mesh,
@@ -315,12 +342,23 @@ template <size_t cao> struct AssignCharge {
   }
 
   void operator()(const ParticleRange &particles) {
-    for (auto &p : particles) {
-      if (p.p.q != 0.0) {
-        this->operator()(p.p.q, p.r.p, p3m.params.ai, p3m.local_mesh,
-                         p3m.inter_weights);
-      }
+    auto const charged = charged_particles(particles);
+    auto const n_charged = static_cast<long>(charged.size());
+
+    p3m.inter_weights.resize(charged.size());
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < n_charged; i++) {
+      p3m.inter_weights.store<cao>(
+          i, p3m_calculate_interpolation_weights<cao>(
+                 charged[i]->r.p, p3m.params.ai, p3m.local_mesh));
     }
+
+    p3m_assign_concurrently<cao>(p3m.local_mesh, p3m.inter_weights,
+                                 [&charged](size_t i, int ind, double w) {
+                                   p3m.rs_mesh[ind] += w * charged[i]->p.q;
+                                 });
   }
 };
 } // namespace
@@ -356,27 +394,176 @@ template <size_t cao> struct AssignForces {
 
     assert(cao == p3m.inter_weights.cao());
 
-    /* charged particle counter */
-    int cp_cnt = 0;
+    /* The weights are stored in the order of the charged particles. */
+    auto const charged = charged_particles(particles);
+    auto const n_charged = static_cast<long>(charged.size());
+    assert(charged.size() == p3m.inter_weights.size());
 
-    for (auto &p : particles) {
-      auto const q = p.p.q;
-      if (q != 0.0) {
-        auto const pref = q * force_prefac;
-        auto const w = p3m.inter_weights.load<cao>(cp_cnt++);
+    auto const E_x = p3m.E_mesh[0].data();
+    auto const E_y = p3m.E_mesh[1].data();
+    auto const E_z = p3m.E_mesh[2].data();
 
-        Utils::Vector3d E{};
-        p3m_interpolate(p3m.local_mesh, w, [&E](int ind, double w) {
-          E += w * Utils::Vector3d{p3m.E_mesh[0][ind], p3m.E_mesh[1][ind],
-                                   p3m.E_mesh[2][ind]};
-        });
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < n_charged; i++) {
+      auto &p = *charged[i];
+      auto const w = p3m.inter_weights.load<cao>(i);
+
+      Utils::Vector3d E{};
+      p3m_interpolate(p3m.local_mesh, w,
+                      [&E, E_x, E_y, E_z](int ind, double w) {
+                        E[0] += w * E_x[ind];
+                        E[1] += w * E_y[ind];
+                        E[2] += w * E_z[ind];
+                      });
+
+      p.f.f -= (p.p.q * force_prefac) * E;
+    }
+  }
+};
+
+/** Assign the forces from the potential mesh, by the gradient of the
+ *  charge assignment function (analytical differentiation).
+ */
+template <size_t cao> struct AssignForcesAD {
+  void operator()(double force_prefac, const ParticleRange &particles) const {
+    assert(cao == p3m.inter_weights.cao());
 
-        p.f.f -= pref * E;
+    /* The weights are stored in the order of the charged particles. */
+    auto const charged = charged_particles(particles);
+    auto const n_charged = static_cast<long>(charged.size());
+    assert(charged.size() == p3m.inter_weights.size());
+
+    auto const phi = p3m.E_mesh[0].data();
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < n_charged; i++) {
+      auto &p = *charged[i];
+      auto const w = p3m.inter_weights.load<cao>(i);
+      auto const dw = p3m_calculate_interpolation_weight_derivatives<cao>(
+          p.r.p, p3m.params.ai, p3m.local_mesh);
+
+      Utils::Vector3d E{};
+      p3m_interpolate_gradient(p3m.local_mesh, w, dw,
+                               [&E, phi](int ind, Utils::Vector3d const &dw) {
+                                 E += phi[ind] * dw;
+                               });
+
+      /* remove the force of the particle on itself */
+      for (int d = 0; d < 3; d++) {
+        auto const u = 2. * Utils::pi() *
+                       (p.r.p[d] * p3m.params.ai[d] - p3m.params.mesh_off[d]);
+        for (int s = 0; s < P3M_AD_SELF_FORCE_HARMONICS; s++) {
+          E[d] += p.p.q * p3m.ad_self_force[s][d] * std::sin((s + 1) * u);
+        }
       }
+
+      p.f.f -= (p.p.q * force_prefac) * E;
     }
   }
 };
 
+/** Stage of the split-phase k-space force calculation. */
+enum class KSpaceStage {
+  /** No calculation pending. */
+  IDLE,
+  /** Forward transform of the charge mesh pending. */
+  FORWARD,
+  /** Backward transform of the field meshes pending. */
+  BACKWARD
+};
+
+KSpaceStage kspace_stage = KSpaceStage::IDLE;
+
+/** Calculate the k-space electric field by ik-differentiation
+ *  of the potential.
+ */
+void calc_field_ik() {
+  /* sqrt(-1)*k differentiation */
+  int j[3];
+  int ind = 0;
+  for (j[0] = 0; j[0] < p3m.fft.plan[3].new_mesh[0]; j[0]++) {
+    for (j[1] = 0; j[1] < p3m.fft.plan[3].new_mesh[1]; j[1]++) {
+      for (j[2] = 0; j[2] < p3m.fft.plan[3].new_mesh[2]; j[2]++) {
+        auto const rho_hat = std::complex<double>(p3m.rs_mesh[2 * ind + 0],
+                                                  p3m.rs_mesh[2 * ind + 1]);
+        auto const phi_hat = p3m.g_force[ind] * rho_hat;
+
+        for (int d = 0; d < 3; d++) {
+          /* direction in r-space: */
+          int d_rs = (d + p3m.ks_pnum) % 3;
+          /* directions */
+          auto const k = 2.0 * Utils::pi() *
+                         p3m.d_op[d_rs][j[d] + p3m.fft.plan[3].start[d]] *
+                         box_geo.length_inv()[d_rs];
+
+          /* i*k*(Re+i*Im) = - Im*k + i*Re*k     (i=sqrt(-1)) */
+          p3m.E_mesh[d_rs][2 * ind + 0] = -k * phi_hat.imag();
+          p3m.E_mesh[d_rs][2 * ind + 1] = +k * phi_hat.real();
+        }
+
+        ind++;
+      }
+    }
+  }
+}
+
+/** Calculate the k-space potential for the analytical differentiation
+ *  of the charge assignment function.
+ */
+void calc_potential_ad() {
+  auto const phi_mesh = p3m.E_mesh[0].data();
+  for (int ind = 0; ind < p3m.fft.plan[3].new_size; ind++) {
+    phi_mesh[2 * ind + 0] = p3m.g_force[ind] * p3m.rs_mesh[2 * ind + 0];
+    phi_mesh[2 * ind + 1] = p3m.g_force[ind] * p3m.rs_mesh[2 * ind + 1];
+  }
+}
+
+/** Meshes which are transformed back for the force calculation: the
+ *  three field components, or only the potential with analytical
+ *  differentiation.
+ */
+std::vector<double *> force_meshes() {
+  if (p3m.params.ad) {
+    return {p3m.E_mesh[0].data()};
+  }
+  return {p3m.E_mesh[0].data(), p3m.E_mesh[1].data(), p3m.E_mesh[2].data()};
+}
+
+/** Calculate the k-space force meshes from the transformed charge mesh
+ *  and start their backward transform.
+ */
+void start_back_transform() {
+  if (p3m.params.ad) {
+    calc_potential_ad();
+  } else {
+    calc_field_ik();
+  }
+
+  auto meshes = force_meshes();
+  fft_perform_back_start(Utils::make_span(meshes), p3m.fft, comm_cart);
+  kspace_stage = KSpaceStage::BACKWARD;
+}
+
+/** Interpolate the forces from the transformed force meshes. */
+void assign_forces(const ParticleRange &particles) {
+  auto meshes = force_meshes();
+  p3m.sm.spread_grid(Utils::make_span(meshes), comm_cart,
+                     p3m.local_mesh.dim);
+
+  auto const force_prefac = coulomb.prefactor / box_geo.volume();
+  if (p3m.params.ad) {
+    Utils::integral_parameter<AssignForcesAD, 1, 7>(p3m.params.cao,
+                                                    force_prefac, particles);
+  } else {
+    Utils::integral_parameter<AssignForces, 1, 7>(p3m.params.cao,
+                                                  force_prefac, particles);
+  }
+}
+
 auto dipole_moment(Particle const &p, BoxGeometry const &box) {
   return p.p.q * unfolded_position(p.r.p, p.l.i, box.length());
 }
@@ -410,6 +597,50 @@ double dipole_correction_energy(Utils::Vector3d const &box_dipole) {
 
   return pref * box_dipole.norm2();
 }
+
+/** Calculate the k-space energy from the transformed charge mesh.
+ *  Note: after the forward FFT, the grids are in the order yzx and not
+ *  xyz anymore!
+ *  @param box_dipole Dipole moment of the box, only needed if the
+ *         boundaries are not metallic.
+ *  @return The energy on the head node, 0 on the other nodes.
+ */
+double kspace_energy(boost::optional<Utils::Vector3d> const &box_dipole) {
+  double node_k_space_energy = 0.;
+
+  int j[3];
+  int ind = 0;
+  for (j[0] = 0; j[0] < p3m.fft.plan[3].new_mesh[0]; j[0]++) {
+    for (j[1] = 0; j[1] < p3m.fft.plan[3].new_mesh[1]; j[1]++) {
+      for (j[2] = 0; j[2] < p3m.fft.plan[3].new_mesh[2]; j[2]++) {
+        // Use the energy optimized influence function for energy!
+        node_k_space_energy += fft_hermitian_weight(p3m.fft, j) *
+                               p3m.g_energy[ind] *
+                               (Utils::sqr(p3m.rs_mesh[2 * ind]) +
+                                Utils::sqr(p3m.rs_mesh[2 * ind + 1]));
+        ind++;
+      }
+    }
+  }
+  node_k_space_energy *= coulomb.prefactor / (2 * box_geo.volume());
+
+  double k_space_energy = 0.0;
+  boost::mpi::reduce(comm_cart, node_k_space_energy, k_space_energy,
+                     std::plus<>(), 0);
+  if (this_node == 0) {
+    /* self energy correction */
+    k_space_energy -= coulomb.prefactor *
+                      (p3m.sum_q2 * p3m.params.alpha * Utils::sqrt_pi_i());
+    /* net charge correction */
+    k_space_energy -= coulomb.prefactor * p3m.square_sum_q * Utils::pi() /
+                      (2.0 * box_geo.volume() * Utils::sqr(p3m.params.alpha));
+    /* dipole correction */
+    if (p3m.params.epsilon != P3M_EPSILON_METALLIC) {
+      k_space_energy += dipole_correction_energy(box_dipole.value());
+    }
+  }
+  return k_space_energy;
+}
 } // namespace
 
 /** @details Calculate the long range electrostatics part of the pressure
@@ -447,8 +678,9 @@ Utils::Vector9d p3m_calc_kspace_pressure_tensor() {
           auto const node_k_space_energy =
               (sqk == 0)
                   ? 0.0
-                  : p3m.g_energy[ind] * (Utils::sqr(p3m.rs_mesh[2 * ind]) +
-                                         Utils::sqr(p3m.rs_mesh[2 * ind + 1]));
+                  : fft_hermitian_weight(p3m.fft, j) * p3m.g_energy[ind] *
+                        (Utils::sqr(p3m.rs_mesh[2 * ind]) +
+                         Utils::sqr(p3m.rs_mesh[2 * ind + 1]));
           ind++;
 
           auto const vterm =
@@ -477,114 +709,314 @@ Utils::Vector9d p3m_calc_kspace_pressure_tensor() {
   return force_prefac * node_k_space_pressure_tensor;
 }
 
+void p3m_calc_kspace_forces_begin() {
+  assert(kspace_stage == KSpaceStage::IDLE);
+
+  /* Gather information for FFT grid inside the nodes domain (inner local mesh)
+   * and start the forward 3D FFT (Charge Assignment Mesh). */
+  p3m.sm.gather_grid(p3m.rs_mesh.data(), comm_cart, p3m.local_mesh.dim);
+  auto rs_mesh = p3m.rs_mesh.data();
+  fft_perform_forw_start(Utils::Span<double *>(&rs_mesh, 1), p3m.fft,
+                         comm_cart);
+  kspace_stage = KSpaceStage::FORWARD;
+}
+
+void p3m_calc_kspace_forces_progress() {
+  if (kspace_stage == KSpaceStage::FORWARD) {
+    if (fft_test(p3m.fft, comm_cart))
+      start_back_transform();
+  } else if (kspace_stage == KSpaceStage::BACKWARD) {
+    fft_test(p3m.fft, comm_cart);
+  }
+}
+
+bool p3m_calc_kspace_forces_pending() {
+  return kspace_stage != KSpaceStage::IDLE;
+}
+
+double p3m_calc_kspace_forces_end(bool energy_flag,
+                                  const ParticleRange &particles) {
+  assert(kspace_stage != KSpaceStage::IDLE);
+
+  if (kspace_stage == KSpaceStage::FORWARD) {
+    fft_wait(p3m.fft, comm_cart);
+    start_back_transform();
+  }
+  fft_wait(p3m.fft, comm_cart);
+  kspace_stage = KSpaceStage::IDLE;
+
+  /* The dipole moment is only needed if we don't have metallic boundaries. */
+  auto const box_dipole = (p3m.params.epsilon != P3M_EPSILON_METALLIC)
+                              ? boost::make_optional(calc_dipole_moment(
+                                    comm_cart, particles, box_geo))
+                              : boost::none;
+
+  /* === k-space force calculation  === */
+  assign_forces(particles);
+
+  if (p3m.params.epsilon != P3M_EPSILON_METALLIC) {
+    add_dipole_correction(box_dipole.value(), particles);
+  }
+
+  if (energy_flag) {
+    return kspace_energy(box_dipole);
+  }
+
+  return 0.0;
+}
+
 double p3m_calc_kspace_forces(bool force_flag, bool energy_flag,
                               const ParticleRange &particles) {
+  if (force_flag) {
+    p3m_calc_kspace_forces_begin();
+    return p3m_calc_kspace_forces_end(energy_flag, particles);
+  }
+
   /* Gather information for FFT grid inside the nodes domain (inner local mesh)
    * and perform forward 3D FFT (Charge Assignment Mesh). */
   p3m.sm.gather_grid(p3m.rs_mesh.data(), comm_cart, p3m.local_mesh.dim);
   fft_perform_forw(p3m.rs_mesh.data(), p3m.fft, comm_cart);
 
-  // Note: after these calls, the grids are in the order yzx and not xyz
-  // anymore!!!
   /* The dipole moment is only needed if we don't have metallic boundaries. */
   auto const box_dipole = (p3m.params.epsilon != P3M_EPSILON_METALLIC)
                               ? boost::make_optional(calc_dipole_moment(
                                     comm_cart, particles, box_geo))
                               : boost::none;
 
-  /* === k-space force calculation  === */
-  if (force_flag) {
-    /* sqrt(-1)*k differentiation */
-    int j[3];
-    int ind = 0;
-    for (j[0] = 0; j[0] < p3m.fft.plan[3].new_mesh[0]; j[0]++) {
-      for (j[1] = 0; j[1] < p3m.fft.plan[3].new_mesh[1]; j[1]++) {
-        for (j[2] = 0; j[2] < p3m.fft.plan[3].new_mesh[2]; j[2]++) {
-          auto const rho_hat = std::complex<double>(p3m.rs_mesh[2 * ind + 0],
-                                                    p3m.rs_mesh[2 * ind + 1]);
-          auto const phi_hat = p3m.g_force[ind] * rho_hat;
-
-          for (int d = 0; d < 3; d++) {
-            /* direction in r-space: */
-            int d_rs = (d + p3m.ks_pnum) % 3;
-            /* directions */
-            auto const k = 2.0 * Utils::pi() *
-                           p3m.d_op[d_rs][j[d] + p3m.fft.plan[3].start[d]] *
-                           box_geo.length_inv()[d_rs];
-
-            /* i*k*(Re+i*Im) = - Im*k + i*Re*k     (i=sqrt(-1)) */
-            p3m.E_mesh[d_rs][2 * ind + 0] = -k * phi_hat.imag();
-            p3m.E_mesh[d_rs][2 * ind + 1] = +k * phi_hat.real();
-          }
+  if (energy_flag) {
+    return kspace_energy(box_dipole);
+  }
 
-          ind++;
-        }
-      }
-    }
+  return 0.0;
+}
 
-    /* Back FFT force component mesh */
-    for (int d = 0; d < 3; d++) {
-      fft_perform_back(p3m.E_mesh[d].data(),
-                       /* check_complex */ !p3m.params.tuning, p3m.fft,
-                       comm_cart);
-    }
+namespace {
+/** Reference state of @ref p3m_calc_kspace_energy_change. */
+struct KSpaceEnergyReference {
+  /** Local part of the transformed charge mesh. */
+  std::vector<double> rho_hat;
+  /** Sum of the charges. */
+  double sum_q = 0.;
+  /** Sum of the squared charges. */
+  double sum_q2 = 0.;
+  /** Change of @ref rho_hat by the last change of charges. */
+  std::vector<double> delta_rho_hat;
+  /** Change of @ref sum_q by the last change of charges. */
+  double delta_sum_q = 0.;
+  /** Change of @ref sum_q2 by the last change of charges. */
+  double delta_sum_q2 = 0.;
+};
 
-    {
-      std::array<double *, 3> E_fields = {
-          p3m.E_mesh[0].data(), p3m.E_mesh[1].data(), p3m.E_mesh[2].data()};
-      /* redistribute force component mesh */
-      p3m.sm.spread_grid(Utils::make_span(E_fields), comm_cart,
-                         p3m.local_mesh.dim);
-    }
+KSpaceEnergyReference kspace_energy_reference;
 
-    auto const force_prefac = coulomb.prefactor / box_geo.volume();
-    Utils::integral_parameter<AssignForces, 1, 7>(p3m.params.cao, force_prefac,
-                                                  particles);
+/** Number of points of the local k-space mesh. */
+int local_kspace_mesh_size() {
+  auto const &new_mesh = p3m.fft.plan[3].new_mesh;
+  return new_mesh[0] * new_mesh[1] * new_mesh[2];
+}
 
-    if (p3m.params.epsilon != P3M_EPSILON_METALLIC) {
-      add_dipole_correction(box_dipole.value(), particles);
+/** Discrete Fourier transform of the charge assignment weights of a unit
+ *  charge along one direction, for all wave numbers of the mesh. The
+ *  weights are those of @ref p3m_calculate_interpolation_weights, in
+ *  global mesh coordinates.
+ */
+std::vector<std::complex<double>> assignment_structure_factor(double position,
+                                                              int dir) {
+  auto const mesh = p3m.params.mesh[dir];
+  auto const cao = p3m.params.cao;
+  auto const pos_shift = std::floor((cao - 1) / 2.0) - (cao % 2) / 2.0;
+  auto const pos = position * p3m.params.ai[dir] - p3m.params.mesh_off[dir] -
+                   pos_shift;
+  auto const nmp = static_cast<int>(std::floor(pos));
+  auto const dist = (pos - nmp) - 0.5;
+
+  std::vector<std::complex<double>> ret(mesh);
+  for (int i = 0; i < cao; i++) {
+    auto const w = Utils::bspline(i, dist, cao);
+    auto const m = ((nmp + i) % mesh + mesh) % mesh;
+    for (int k = 0; k < mesh; k++) {
+      /* same sign as the forward FFT */
+      ret[k] += w * std::polar(1., -2. * Utils::pi() * ((k * m) % mesh) / mesh);
     }
-  } /* if(force_flag) */
+  }
+  return ret;
+}
+} // namespace
 
-  /* === k-space energy calculation  === */
-  if (energy_flag) {
-    double node_k_space_energy = 0.;
+double p3m_calc_kspace_energy_reference(const ParticleRange &particles) {
+  assert(p3m.params.epsilon == P3M_EPSILON_METALLIC);
+  auto &ref = kspace_energy_reference;
+
+  p3m_charge_assign(particles);
+  auto const energy = p3m_calc_kspace_forces(false, true, particles);
+
+  /* the energy calculation leaves the transformed charge mesh */
+  auto const size = 2 * local_kspace_mesh_size();
+  ref.rho_hat.assign(p3m.rs_mesh.begin(), p3m.rs_mesh.begin() + size);
+  ref.delta_rho_hat.clear();
+  ref.delta_sum_q = 0.;
+  ref.delta_sum_q2 = 0.;
+
+  double local_q = 0.;
+  double local_q2 = 0.;
+  for (auto const &p : particles) {
+    local_q += p.p.q;
+    local_q2 += Utils::sqr(p.p.q);
+  }
+  ref.sum_q = boost::mpi::all_reduce(comm_cart, local_q, std::plus<>());
+  ref.sum_q2 = boost::mpi::all_reduce(comm_cart, local_q2, std::plus<>());
 
-    for (int i = 0; i < p3m.fft.plan[3].new_size; i++) {
-      // Use the energy optimized influence function for energy!
-      node_k_space_energy +=
-          p3m.g_energy[i] *
-          (Utils::sqr(p3m.rs_mesh[2 * i]) + Utils::sqr(p3m.rs_mesh[2 * i + 1]));
-    }
-    node_k_space_energy *= coulomb.prefactor / (2 * box_geo.volume());
-
-    double k_space_energy = 0.0;
-    boost::mpi::reduce(comm_cart, node_k_space_energy, k_space_energy,
-                       std::plus<>(), 0);
-    if (this_node == 0) {
-      /* self energy correction */
-      k_space_energy -= coulomb.prefactor *
-                        (p3m.sum_q2 * p3m.params.alpha * Utils::sqrt_pi_i());
-      /* net charge correction */
-      k_space_energy -= coulomb.prefactor * p3m.square_sum_q * Utils::pi() /
-                        (2.0 * box_geo.volume() * Utils::sqr(p3m.params.alpha));
-      /* dipole correction */
-      if (p3m.params.epsilon != P3M_EPSILON_METALLIC) {
-        k_space_energy += dipole_correction_energy(box_dipole.value());
+  return energy;
+}
+
+double p3m_calc_kspace_energy_change(
+    std::vector<std::pair<double, Utils::Vector3d>> const &charges_old,
+    std::vector<std::pair<double, Utils::Vector3d>> const &charges_new) {
+  using namespace detail::FFT_indexing;
+  assert(p3m.params.epsilon == P3M_EPSILON_METALLIC);
+  auto &ref = kspace_energy_reference;
+  assert(ref.rho_hat.size() ==
+         static_cast<std::size_t>(2 * local_kspace_mesh_size()));
+
+  /* structure factors of the removed and of the added charges */
+  struct ChargeStructureFactor {
+    double q;
+    std::array<std::vector<std::complex<double>>, 3> s;
+  };
+  std::vector<ChargeStructureFactor> factors;
+  ref.delta_sum_q = 0.;
+  ref.delta_sum_q2 = 0.;
+  auto const add_charge = [&](double q, Utils::Vector3d const &pos,
+                              double sign) {
+    if (q == 0.)
+      return;
+    factors.push_back({sign * q,
+                       {assignment_structure_factor(pos[RX], RX),
+                        assignment_structure_factor(pos[RY], RY),
+                        assignment_structure_factor(pos[RZ], RZ)}});
+    ref.delta_sum_q += sign * q;
+    ref.delta_sum_q2 += sign * Utils::sqr(q);
+  };
+  for (auto const &charge : charges_old)
+    add_charge(charge.first, charge.second, -1.);
+  for (auto const &charge : charges_new)
+    add_charge(charge.first, charge.second, +1.);
+
+  /* Only the cross term of the transformed charge mesh with its change
+   * and the square of the change contribute to the energy change. */
+  auto const &plan = p3m.fft.plan[3];
+  ref.delta_rho_hat.resize(2 * local_kspace_mesh_size());
+  double node_energy_change = 0.;
+  int j[3];
+  int ind = 0;
+  for (j[0] = 0; j[0] < plan.new_mesh[0]; j[0]++) {
+    for (j[1] = 0; j[1] < plan.new_mesh[1]; j[1]++) {
+      for (j[2] = 0; j[2] < plan.new_mesh[2]; j[2]++) {
+        auto const kx = j[KX] + plan.start[KX];
+        auto const ky = j[KY] + plan.start[KY];
+        auto const kz = j[KZ] + plan.start[KZ];
+        std::complex<double> delta{};
+        for (auto const &f : factors) {
+          delta += f.q * f.s[RX][kx] * f.s[RY][ky] * f.s[RZ][kz];
+        }
+        auto const rho = std::complex<double>(ref.rho_hat[2 * ind],
+                                              ref.rho_hat[2 * ind + 1]);
+        node_energy_change +=
+            fft_hermitian_weight(p3m.fft, j) * p3m.g_energy[ind] *
+            (2. * (rho.real() * delta.real() + rho.imag() * delta.imag()) +
+             std::norm(delta));
+        ref.delta_rho_hat[2 * ind] = delta.real();
+        ref.delta_rho_hat[2 * ind + 1] = delta.imag();
+        ind++;
       }
     }
-    return k_space_energy;
-  } /* if (energy_flag) */
+  }
+  node_energy_change *= coulomb.prefactor / (2 * box_geo.volume());
+
+  if (this_node == 0) {
+    /* self energy correction */
+    node_energy_change -= coulomb.prefactor * ref.delta_sum_q2 *
+                          p3m.params.alpha * Utils::sqrt_pi_i();
+    /* net charge correction */
+    node_energy_change -=
+        coulomb.prefactor *
+        (Utils::sqr(ref.sum_q + ref.delta_sum_q) - Utils::sqr(ref.sum_q)) *
+        Utils::pi() / (2.0 * box_geo.volume() * Utils::sqr(p3m.params.alpha));
+  }
+  return node_energy_change;
+}
 
-  return 0.0;
+void p3m_accept_kspace_energy_change() {
+  auto &ref = kspace_energy_reference;
+  if (ref.delta_rho_hat.empty())
+    return;
+
+  for (std::size_t i = 0; i < ref.rho_hat.size(); i++) {
+    ref.rho_hat[i] += ref.delta_rho_hat[i];
+  }
+  ref.sum_q += ref.delta_sum_q;
+  ref.sum_q2 += ref.delta_sum_q2;
+  ref.delta_rho_hat.clear();
+  ref.delta_sum_q = 0.;
+  ref.delta_sum_q2 = 0.;
 }
 
 void p3m_calc_influence_function_force() {
   auto const start = Utils::Vector3i{p3m.fft.plan[3].start};
   auto const size = Utils::Vector3i{p3m.fft.plan[3].new_mesh};
 
-  p3m.g_force = grid_influence_function<1>(p3m.params, start, start + size,
-                                           box_geo.length());
+  if (p3m.params.ad) {
+    p3m.g_force = grid_influence_function_ad<1>(p3m.params, start,
+                                                start + size, box_geo.length());
+  } else {
+    p3m.g_force = grid_influence_function<1>(p3m.params, start, start + size,
+                                             box_geo.length());
+  }
+}
+
+void p3m_calc_ad_self_force() {
+  using namespace detail::FFT_indexing;
+
+  p3m.ad_self_force = {};
+  if (not p3m.params.ad)
+    return;
+
+  auto const shifts = detail::calc_meshift(
+      {p3m.params.mesh[0], p3m.params.mesh[1], p3m.params.mesh[2]});
+  auto const start = Utils::Vector3i{p3m.fft.plan[3].start};
+  auto const h = Utils::Vector3d{p3m.params.a};
+  auto const &box_l = box_geo.length();
+
+  std::array<Utils::Vector3d, P3M_AD_SELF_FORCE_HARMONICS> local_sums{};
+  int j[3];
+  int ind = 0;
+  for (j[0] = 0; j[0] < p3m.fft.plan[3].new_mesh[0]; j[0]++) {
+    for (j[1] = 0; j[1] < p3m.fft.plan[3].new_mesh[1]; j[1]++) {
+      for (j[2] = 0; j[2] < p3m.fft.plan[3].new_mesh[2]; j[2]++) {
+        auto const n = Utils::Vector3i{j} + start;
+        auto const k = 2 * Utils::pi() *
+                       Utils::Vector3d{shifts[RX][n[KX]] / box_l[RX],
+                                       shifts[RY][n[KY]] / box_l[RY],
+                                       shifts[RZ][n[KZ]] / box_l[RZ]};
+        auto const harmonics =
+            ad_self_force_harmonics<2, P3M_AD_SELF_FORCE_HARMONICS>(
+                p3m.params.cao, k, h);
+        auto const weight = fft_hermitian_weight(p3m.fft, j) * p3m.g_force[ind];
+        for (int s = 0; s < P3M_AD_SELF_FORCE_HARMONICS; s++) {
+          local_sums[s] += weight * harmonics[s];
+        }
+        ind++;
+      }
+    }
+  }
+
+  /* the harmonics for s and -s combine to a sine */
+  boost::mpi::all_reduce(comm_cart, local_sums.data()->data(),
+                         3 * P3M_AD_SELF_FORCE_HARMONICS,
+                         p3m.ad_self_force.data()->data(), std::plus<>());
+  for (auto &a : p3m.ad_self_force) {
+    a *= 2.;
+  }
 }
 
 void p3m_calc_influence_function_energy() {
@@ -1354,6 +1786,7 @@ void p3m_scaleby_box_l() {
   p3m_sanity_checks_boxl();
   p3m_calc_influence_function_force();
   p3m_calc_influence_function_energy();
+  p3m_calc_ad_self_force();
 }
 
 #endif /* of P3M */
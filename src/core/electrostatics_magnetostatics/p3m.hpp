@@ -51,6 +51,8 @@
 
 #include <array>
 #include <cmath>
+#include <utility>
+#include <vector>
 
 /************************************************
  * data types
@@ -63,7 +65,8 @@ struct p3m_data_struct : public p3m_data_struct_base {
   p3m_local_mesh local_mesh;
   /** real space mesh (local) for CA/FFT. */
   fft_vector<double> rs_mesh;
-  /** mesh (local) for the electric field. */
+  /** mesh (local) for the electric field. With analytical
+   *  differentiation, only the first one is used, for the potential. */
   std::array<fft_vector<double>, 3> E_mesh;
 
   /** number of charged particles (only on master node). */
@@ -75,6 +78,12 @@ struct p3m_data_struct : public p3m_data_struct_base {
 
   p3m_interpolation_cache inter_weights;
 
+  /** Amplitudes of the harmonics of the self force with analytical
+   *  differentiation, in units of the squared charge and of the force
+   *  prefactor.
+   */
+  std::array<Utils::Vector3d, P3M_AD_SELF_FORCE_HARMONICS> ad_self_force;
+
   /** send/recv mesh sizes */
   p3m_send_mesh sm;
 
@@ -141,6 +150,69 @@ void p3m_scaleby_box_l();
 double p3m_calc_kspace_forces(bool force_flag, bool energy_flag,
                               const ParticleRange &particles);
 
+/** @brief Start the split-phase calculation of the k-space forces.
+ *
+ *  The charges have to be assigned to the mesh already. The transforms
+ *  of the meshes are communicated with non-blocking messages, so that
+ *  other work can be done until @ref p3m_calc_kspace_forces_end is
+ *  called. Has to be called on all nodes.
+ */
+void p3m_calc_kspace_forces_begin();
+
+/** @brief Make progress on the pending split-phase k-space calculation.
+ *
+ *  Continues the transforms up to the next redistribution of the
+ *  meshes whose messages have not yet arrived.
+ */
+void p3m_calc_kspace_forces_progress();
+
+/** @brief Whether a split-phase k-space calculation is pending. */
+bool p3m_calc_kspace_forces_pending();
+
+/** @brief Complete the split-phase calculation of the k-space forces
+ *  started by @ref p3m_calc_kspace_forces_begin.
+ *
+ *  @param energy_flag Whether to also calculate the k-space energy.
+ *  @param particles   Local particles.
+ *  @return The k-space energy on the head node if @p energy_flag is set,
+ *          0 otherwise.
+ */
+double p3m_calc_kspace_forces_end(bool energy_flag,
+                                  const ParticleRange &particles);
+
+/** @brief Calculate the k-space energy and keep the transformed charge
+ *  mesh as reference state of @ref p3m_calc_kspace_energy_change.
+ *
+ *  Only for metallic boundary conditions. Has to be called on all nodes.
+ *
+ *  @param particles   Local particles.
+ *  @return The k-space energy on the head node, 0 on the other nodes.
+ */
+double p3m_calc_kspace_energy_reference(const ParticleRange &particles);
+
+/** @brief Calculate the change of the k-space energy by a change of
+ *  charges, relative to the reference state.
+ *
+ *  The Fourier transform of the assignment of the changed charges to the
+ *  mesh is added to the transformed charge mesh of the reference state,
+ *  which replaces the charge assignment and the FFTs of the whole system
+ *  by a sum over the local k-space mesh. The charges that are moved or
+ *  changed enter once with their old and once with their new value.
+ *  Has to be called on all nodes.
+ *
+ *  @param charges_old Charges and positions before the change.
+ *  @param charges_new Charges and positions after the change.
+ *  @return The contribution of this node to the energy change.
+ */
+double p3m_calc_kspace_energy_change(
+    std::vector<std::pair<double, Utils::Vector3d>> const &charges_old,
+    std::vector<std::pair<double, Utils::Vector3d>> const &charges_new);
+
+/** @brief Make the change of the last call of
+ *  @ref p3m_calc_kspace_energy_change part of the reference state.
+ */
+void p3m_accept_kspace_energy_change();
+
 /** Compute the k-space part of the pressure tensor */
 Utils::Vector9d p3m_calc_kspace_pressure_tensor();
 
@@ -227,6 +299,12 @@ void p3m_set_mesh_offset(double x, double y, double z);
  */
 void p3m_set_eps(double eps);
 
+/** Set @ref P3MParameters::ad "ad" parameter
+ *
+ *  @param[in]  ad           @copybrief P3MParameters::ad
+ */
+void p3m_set_ad(bool ad);
+
 /** Calculate real space contribution of Coulomb pair energy. */
 inline double p3m_pair_energy(double chgfac, double dist) {
   if (dist < p3m.params.r_cut && dist != 0) {
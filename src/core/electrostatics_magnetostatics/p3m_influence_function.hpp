@@ -30,6 +30,7 @@
 
 #include <boost/range/numeric.hpp>
 
+#include <array>
 #include <cmath>
 #include <cstddef>
 
@@ -52,13 +53,14 @@ std::pair<double, double> aliasing_sums_ik(size_t cao, double alpha,
 
   constexpr double two_pi = 2 * Utils::pi();
   constexpr double two_pi_i = 1 / two_pi;
+  constexpr auto m_max = static_cast<int>(m);
 
   double numerator = 0.0;
   double denominator = 0.0;
 
-  for (int mx = -m; mx <= m; mx++) {
-    for (int my = -m; my <= m; my++) {
-      for (int mz = -m; mz <= m; mz++) {
+  for (int mx = -m_max; mx <= m_max; mx++) {
+    for (int my = -m_max; my <= m_max; my++) {
+      for (int mz = -m_max; mz <= m_max; mz++) {
         auto const km =
             k + two_pi * Vector3d{mx / h[RX], my / h[RY], mz / h[RZ]};
         auto const U2 = std::pow(sinc(km[RX] * h[RX] * two_pi_i) *
@@ -73,6 +75,106 @@ std::pair<double, double> aliasing_sums_ik(size_t cao, double alpha,
   }
   return {numerator, denominator};
 }
+
+template <size_t m>
+Utils::Vector3d aliasing_sums_ad(size_t cao, double alpha,
+                                 const Utils::Vector3d &k,
+                                 const Utils::Vector3d &h) {
+  using namespace detail::FFT_indexing;
+  using Utils::sinc;
+  using Utils::Vector3d;
+
+  constexpr double two_pi = 2 * Utils::pi();
+  constexpr double two_pi_i = 1 / two_pi;
+  constexpr auto m_max = static_cast<int>(m);
+
+  double numerator = 0.0;
+  double sum_U2 = 0.0;
+  double sum_U2_k2 = 0.0;
+
+  for (int mx = -m_max; mx <= m_max; mx++) {
+    for (int my = -m_max; my <= m_max; my++) {
+      for (int mz = -m_max; mz <= m_max; mz++) {
+        auto const km =
+            k + two_pi * Vector3d{mx / h[RX], my / h[RY], mz / h[RZ]};
+        auto const U2 = std::pow(sinc(km[RX] * h[RX] * two_pi_i) *
+                                     sinc(km[RY] * h[RY] * two_pi_i) *
+                                     sinc(km[RZ] * h[RZ] * two_pi_i),
+                                 2 * cao);
+        auto const km2 = km.norm2();
+
+        /* the k = 0 mode does not contribute */
+        if (km2 > 0.) {
+          numerator += U2 * km2 * g_ewald(alpha, km2);
+        }
+        sum_U2 += U2;
+        sum_U2_k2 += U2 * km2;
+      }
+    }
+  }
+  return {numerator, sum_U2, sum_U2_k2};
+}
+
+/**
+ * @brief Evaluate an influence function over a regular grid of k vectors.
+ *
+ * @param params P3M parameters
+ * @param n_start Lower left corner of the grid
+ * @param n_end Upper right corner of the grid.
+ * @param box_l Box size
+ * @param G Influence function, called with the k vector and the grid
+ *          spacing.
+ * @return Values of @p G at regular grid points.
+ */
+template <class F>
+std::vector<double> map_influence_function(const P3MParameters &params,
+                                           const Utils::Vector3i &n_start,
+                                           const Utils::Vector3i &n_end,
+                                           const Utils::Vector3d &box_l,
+                                           F G) {
+  using namespace detail::FFT_indexing;
+
+  auto const shifts =
+      detail::calc_meshift({params.mesh[0], params.mesh[1], params.mesh[2]});
+
+  auto const size = n_end - n_start;
+
+  /* The influence function grid */
+  auto g =
+      std::vector<double>(boost::accumulate(size, 1, std::multiplies<>()), 0.);
+
+  /* Skip influence function calculation in tuning mode,
+     the results need not be correct for timing. */
+  if (params.tuning) {
+    return g;
+  }
+
+  auto const h = Utils::Vector3d{params.a};
+
+  Utils::Vector3i n{};
+  for (n[0] = n_start[0]; n[0] < n_end[0]; n[0]++) {
+    for (n[1] = n_start[1]; n[1] < n_end[1]; n[1]++) {
+      for (n[2] = n_start[2]; n[2] < n_end[2]; n[2]++) {
+        auto const ind = Utils::get_linear_index(n - n_start, size,
+                                                 Utils::MemoryOrder::ROW_MAJOR);
+        if (detail::is_self_conjugate(n[KX], params.mesh[RX]) &&
+            detail::is_self_conjugate(n[KY], params.mesh[RY]) &&
+            detail::is_self_conjugate(n[KZ], params.mesh[RZ])) {
+          g[ind] = 0.0;
+        } else {
+          auto const k = 2 * Utils::pi() *
+                         Utils::Vector3d{shifts[RX][n[KX]] / box_l[RX],
+                                         shifts[RY][n[KY]] / box_l[RY],
+                                         shifts[RZ][n[KZ]] / box_l[RZ]};
+
+          g[ind] = G(k, h);
+        }
+      }
+    }
+  }
+
+  return g;
+}
 } // namespace detail
 
 /**
@@ -127,48 +229,121 @@ std::vector<double> grid_influence_function(const P3MParameters &params,
                                             const Utils::Vector3i &n_start,
                                             const Utils::Vector3i &n_end,
                                             const Utils::Vector3d &box_l) {
-  using namespace detail::FFT_indexing;
-
-  auto const shifts =
-      detail::calc_meshift({params.mesh[0], params.mesh[1], params.mesh[2]});
+  return detail::map_influence_function(
+      params, n_start, n_end, box_l,
+      [&params](Utils::Vector3d const &k, Utils::Vector3d const &h) {
+        return G_opt<S, m>(params.cao, params.alpha, k, h);
+      });
+}
 
-  auto const size = n_end - n_start;
+/**
+ * @brief Optimal influence function for analytical differentiation.
+ *
+ *  This is the influence function of @cite ballenegger12a which
+ *  minimizes the force error if the forces are obtained from the
+ *  gradient of the charge assignment function, instead of the
+ *  ik-differentiated field.
+ *
+ * @tparam m Number of aliasing terms to take into account.
+ * @tparam T Floating-point type.
+ *
+ * @param cao Charge assignment order.
+ * @param alpha Ewald splitting parameter.
+ * @param k k Vector to evaluate the function for.
+ * @param h Grid spacing.
+ */
+template <size_t m, class T>
+double G_opt_ad(size_t cao, T alpha, const Utils::Vector3<T> &k,
+                const Utils::Vector3<T> &h) {
+  if (k.norm2() == 0.0) {
+    return 0.0;
+  }
 
-  /* The influence function grid */
-  auto g =
-      std::vector<double>(boost::accumulate(size, 1, std::multiplies<>()), 0.);
+  auto const as = detail::aliasing_sums_ad<m>(cao, alpha, k, h);
+  return as[0] / (as[1] * as[2]);
+}
 
-  /* Skip influence function calculation in tuning mode,
-     the results need not be correct for timing. */
-  if (params.tuning) {
-    return g;
-  }
+/**
+ * @brief Fourier coefficients of the self force of analytical
+ * differentiation, for one k vector.
+ *
+ *  With analytical differentiation, a charge feels a force from its
+ *  own mesh charge, which is periodic in the mesh spacing. This
+ *  evaluates the contribution of one k vector to the amplitudes
+ *  of its harmonics along the three directions, see
+ *  @cite ballenegger11a. Only the dominant harmonics along the
+ *  mesh axes are taken into account.
+ *
+ * @tparam m Number of aliasing terms to take into account.
+ * @tparam n_harmonics Number of harmonics per direction.
+ *
+ * @param cao Charge assignment order.
+ * @param k k Vector to evaluate the function for.
+ * @param h Grid spacing.
+ * @return Amplitudes of the harmonics, to be multiplied with the
+ *         influence function and summed over all k vectors.
+ */
+template <size_t m, size_t n_harmonics>
+std::array<Utils::Vector3d, n_harmonics>
+ad_self_force_harmonics(size_t cao, const Utils::Vector3d &k,
+                        const Utils::Vector3d &h) {
+  using Utils::sinc;
 
-  auto const h = Utils::Vector3d{params.a};
+  constexpr double two_pi = 2 * Utils::pi();
+  constexpr double two_pi_i = 1 / two_pi;
+  constexpr auto m_max = static_cast<int>(m);
+  constexpr auto n_h = static_cast<int>(n_harmonics);
 
-  Utils::Vector3i n{};
-  for (n[0] = n_start[0]; n[0] < n_end[0]; n[0]++) {
-    for (n[1] = n_start[1]; n[1] < n_end[1]; n[1]++) {
-      for (n[2] = n_start[2]; n[2] < n_end[2]; n[2]++) {
-        auto const ind = Utils::get_linear_index(n - n_start, size,
-                                                 Utils::MemoryOrder::ROW_MAJOR);
-        if ((n[KX] % (params.mesh[RX] / 2) == 0) &&
-            (n[KY] % (params.mesh[RY] / 2) == 0) &&
-            (n[KZ] % (params.mesh[RZ] / 2) == 0)) {
-          g[ind] = 0.0;
-        } else {
-          auto const k = 2 * Utils::pi() *
-                         Utils::Vector3d{shifts[RX][n[KX]] / box_l[RX],
-                                         shifts[RY][n[KY]] / box_l[RY],
-                                         shifts[RZ][n[KZ]] / box_l[RZ]};
+  auto const U = [cao, &h](int d, double k_d) {
+    return std::pow(sinc(k_d * h[d] * two_pi_i), cao);
+  };
 
-          g[ind] = G_opt<S, m>(params.cao, params.alpha, k, h);
-        }
+  Utils::Vector3d sum_U2{};
+  std::array<Utils::Vector3d, n_harmonics> sum_UU{};
+  for (int d = 0; d < 3; d++) {
+    for (int md = -m_max; md <= m_max; md++) {
+      auto const U_m = U(d, k[d] + two_pi * md / h[d]);
+      sum_U2[d] += U_m * U_m;
+      for (int s = 1; s <= n_h; s++) {
+        sum_UU[s - 1][d] += U_m * U(d, k[d] + two_pi * (md + s) / h[d]);
       }
     }
   }
 
-  return g;
+  std::array<Utils::Vector3d, n_harmonics> ret{};
+  for (int s = 1; s <= n_h; s++) {
+    for (int d = 0; d < 3; d++) {
+      ret[s - 1][d] = Utils::pi() * s / h[d] * sum_UU[s - 1][d] *
+                      sum_U2[(d + 1) % 3] * sum_U2[(d + 2) % 3];
+    }
+  }
+  return ret;
+}
+
+/**
+ * @brief Map the influence function for analytical differentiation
+ * over a grid.
+ *
+ * Same as @ref grid_influence_function, for @ref G_opt_ad.
+ *
+ * @tparam m Number of aliasing terms to take into account.
+ *
+ * @param params P3M parameters
+ * @param n_start Lower left corner of the grid
+ * @param n_end Upper right corner of the grid.
+ * @param box_l Box size
+ * @return Values of G_opt_ad at regular grid points.
+ */
+template <size_t m = 0>
+std::vector<double> grid_influence_function_ad(const P3MParameters &params,
+                                               const Utils::Vector3i &n_start,
+                                               const Utils::Vector3i &n_end,
+                                               const Utils::Vector3d &box_l) {
+  return detail::map_influence_function(
+      params, n_start, n_end, box_l,
+      [&params](Utils::Vector3d const &k, Utils::Vector3d const &h) {
+        return G_opt_ad<m>(params.cao, params.alpha, k, h);
+      });
 }
 
 #endif // ESPRESSO_P3M_INFLUENCE_FUNCTION_HPP
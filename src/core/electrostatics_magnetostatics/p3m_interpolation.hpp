@@ -22,6 +22,7 @@
 #define ESPRESSO_P3M_INTERPOLATION_HPP
 
 #include <utils/Span.hpp>
+#include <utils/Vector.hpp>
 #include <utils/index.hpp>
 #include <utils/math/bspline.hpp>
 
@@ -29,9 +30,15 @@
 
 #include <cassert>
 #include <cstddef>
+#include <numeric>
 #include <tuple>
+#include <utility>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 /**
  * @brief Interpolation weights for one point.
  *
@@ -50,7 +57,8 @@ template <int cao> struct InterpolationWeights {
  * @brief Cache for interpolation weights.
  *
  * This is a storage container for interpolation weights of
- * type InterpolationWeights.
+ * type InterpolationWeights. The weights of a point are stored
+ * contiguously, so that they can be loaded with few vector loads.
  */
 class p3m_interpolation_cache {
   size_t m_cao = 0;
@@ -89,6 +97,39 @@ public:
     boost::copy(w.w_z, it);
   }
 
+  /**
+   * @brief Store weights for one point at an index.
+   *
+   * Points at different indices can be stored concurrently.
+   *
+   * @tparam cao Interpolation order has to match the order
+   *         set at last call to @ref p3m_interpolation_cache::reset.
+   * @param i Index of the entry to store, smaller than @ref size.
+   * @param w Interpolation weights to store.
+   */
+  template <int cao>
+  void store(size_t i, const InterpolationWeights<cao> &w) {
+    assert(cao == m_cao);
+    assert(i < size());
+
+    ca_fmp[i] = w.ind;
+    auto const offset = ca_frac.begin() + 3 * i * m_cao;
+    boost::copy(w.w_x, offset + 0 * m_cao);
+    boost::copy(w.w_y, offset + 1 * m_cao);
+    boost::copy(w.w_z, offset + 2 * m_cao);
+  }
+
+  /**
+   * @brief Linear index of the first mesh point of an entry.
+   *
+   * @param i Index of the entry.
+   * @return Linear mesh index of the corner of the interpolation cube.
+   */
+  int index(size_t i) const {
+    assert(i < size());
+    return ca_fmp[i];
+  }
+
   /**
    * @brief Load entry from the cache.
    *
@@ -127,19 +168,30 @@ public:
     ca_frac.clear();
     ca_fmp.clear();
   }
+
+  /**
+   * @brief Set the number of points in the cache.
+   *
+   * @param n Number of points.
+   */
+  void resize(size_t n) {
+    ca_fmp.resize(n);
+    ca_frac.resize(3 * m_cao * n);
+  }
 };
 
+namespace detail {
 /**
- * @brief Calculate the P-th order interpolation weights.
+ * @brief Find the first mesh point of the interpolation cube of a point.
  *
- * As described in from @cite hockney88a 5-189 (or 8-61).
- * The weights are also tabulated in @cite deserno98a @cite deserno98b.
+ * @return Position of the first mesh point in the local mesh and
+ *         the distance of the point from the nearest mesh point,
+ *         in units of the mesh constant.
  */
 template <int cao>
-InterpolationWeights<cao>
-p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
-                                    const Utils::Vector3d &ai,
-                                    p3m_local_mesh const &local_mesh) {
+std::pair<Utils::Vector3i, Utils::Vector3d>
+p3m_assignment_cube(const Utils::Vector3d &position, const Utils::Vector3d &ai,
+                    p3m_local_mesh const &local_mesh) {
   /** position shift for calc. of first assignment mesh point. */
   static auto const pos_shift = std::floor((cao - 1) / 2.0) - (cao % 2) / 2.0;
 
@@ -159,13 +211,33 @@ p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
     dist[d] = (pos - nmp[d]) - 0.5;
   }
 
+  assert((nmp + Utils::Vector3i::broadcast(cao)) <= local_mesh.dim);
+  return {nmp, dist};
+}
+} // namespace detail
+
+/**
+ * @brief Calculate the P-th order interpolation weights.
+ *
+ * As described in from @cite hockney88a 5-189 (or 8-61).
+ * The weights are also tabulated in @cite deserno98a @cite deserno98b.
+ */
+template <int cao>
+InterpolationWeights<cao>
+p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
+                                    const Utils::Vector3d &ai,
+                                    p3m_local_mesh const &local_mesh) {
+  Utils::Vector3i nmp;
+  Utils::Vector3d dist;
+  std::tie(nmp, dist) =
+      detail::p3m_assignment_cube<cao>(position, ai, local_mesh);
+
   InterpolationWeights<cao> ret;
 
   /* 3d-array index of nearest mesh point */
   ret.ind = Utils::get_linear_index(nmp, local_mesh.dim,
                                     Utils::MemoryOrder::ROW_MAJOR);
 
-  assert((nmp + Utils::Vector3i::broadcast(cao)) <= local_mesh.dim);
   for (int i = 0; i < cao; i++) {
     using Utils::bspline;
 
@@ -177,6 +249,40 @@ p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
   return ret;
 }
 
+/**
+ * @brief Calculate the derivatives of the P-th order interpolation weights.
+ *
+ * These are the derivatives of the weights of
+ * @ref p3m_calculate_interpolation_weights with respect to the
+ * position of the point.
+ */
+template <int cao>
+InterpolationWeights<cao>
+p3m_calculate_interpolation_weight_derivatives(
+    const Utils::Vector3d &position, const Utils::Vector3d &ai,
+    p3m_local_mesh const &local_mesh) {
+  Utils::Vector3i nmp;
+  Utils::Vector3d dist;
+  std::tie(nmp, dist) =
+      detail::p3m_assignment_cube<cao>(position, ai, local_mesh);
+
+  InterpolationWeights<cao> ret;
+
+  /* 3d-array index of nearest mesh point */
+  ret.ind = Utils::get_linear_index(nmp, local_mesh.dim,
+                                    Utils::MemoryOrder::ROW_MAJOR);
+
+  for (int i = 0; i < cao; i++) {
+    using Utils::bspline_d;
+
+    ret.w_x[i] = ai[0] * bspline_d<cao>(i, dist[0]);
+    ret.w_y[i] = ai[1] * bspline_d<cao>(i, dist[1]);
+    ret.w_z[i] = ai[2] * bspline_d<cao>(i, dist[2]);
+  }
+
+  return ret;
+}
+
 /**
  * @brief P3M grid interpolation.
  *
@@ -207,4 +313,108 @@ void p3m_interpolate(p3m_local_mesh const &local_mesh,
   }
 }
 
+/**
+ * @brief P3M grid interpolation of a gradient.
+ *
+ * This runs an kernel for every interpolation point
+ * with the linear grid index and the gradient of the
+ * weight of the point with respect to the interpolated
+ * position as arguments.
+ *
+ * @param local_mesh Mesh info.
+ * @param weights Set of weights
+ * @param derivatives Derivatives of the weights, from
+ *        @ref p3m_calculate_interpolation_weight_derivatives.
+ * @param kernel The kernel to run.
+ */
+template <int cao, class Kernel>
+void p3m_interpolate_gradient(p3m_local_mesh const &local_mesh,
+                              InterpolationWeights<cao> const &weights,
+                              InterpolationWeights<cao> const &derivatives,
+                              Kernel kernel) {
+  assert(weights.ind == derivatives.ind);
+
+  auto q_ind = weights.ind;
+  for (int i0 = 0; i0 < cao; i0++) {
+    for (int i1 = 0; i1 < cao; i1++) {
+      auto const w_xy = weights.w_x[i0] * weights.w_y[i1];
+      auto const dw_xy = Utils::Vector2d{derivatives.w_x[i0] * weights.w_y[i1],
+                                         weights.w_x[i0] * derivatives.w_y[i1]};
+      for (int i2 = 0; i2 < cao; i2++) {
+        kernel(q_ind, Utils::Vector3d{dw_xy[0] * weights.w_z[i2],
+                                      dw_xy[1] * weights.w_z[i2],
+                                      w_xy * derivatives.w_z[i2]});
+
+        q_ind++;
+      }
+      q_ind += local_mesh.q_2_off;
+    }
+    q_ind += local_mesh.q_21_off;
+  }
+}
+
+/**
+ * @brief Assign the points of an interpolation cache to the mesh.
+ *
+ * If more than one OpenMP thread is available, the points are
+ * grouped into slabs of @p cao mesh planes along the first mesh
+ * direction, by the first plane of their interpolation cube.
+ * The points of a slab only write to this slab and the next one,
+ * so all even slabs, and then all odd slabs, are processed
+ * concurrently. Within a slab, the points are processed in order.
+ *
+ * @param local_mesh Mesh info.
+ * @param weights Interpolation weights of the points.
+ * @param kernel Callable with the index of the point in @p weights,
+ *        the linear mesh index and the weight of the mesh point.
+ */
+template <int cao, class Kernel>
+void p3m_assign_concurrently(p3m_local_mesh const &local_mesh,
+                             p3m_interpolation_cache const &weights,
+                             Kernel kernel) {
+  assert(cao == weights.cao());
+  auto const n_points = weights.size();
+
+#ifdef _OPENMP
+  if (omp_get_max_threads() > 1) {
+    auto const plane_size = local_mesh.dim[1] * local_mesh.dim[2];
+    auto const n_slabs = local_mesh.dim[0] / cao + 1;
+
+    /* Sort the points by slab, keeping their order within a slab. */
+    std::vector<size_t> slab_begin(n_slabs + 1, 0);
+    std::vector<int> slab(n_points);
+    for (size_t i = 0; i < n_points; i++) {
+      slab[i] = weights.index(i) / plane_size / cao;
+      slab_begin[slab[i] + 1]++;
+    }
+    std::partial_sum(slab_begin.begin(), slab_begin.end(), slab_begin.begin());
+
+    std::vector<size_t> order(n_points);
+    auto slab_end = slab_begin;
+    for (size_t i = 0; i < n_points; i++) {
+      order[slab_end[slab[i]]++] = i;
+    }
+
+    for (int color = 0; color < 2; color++) {
+#pragma omp parallel for schedule(dynamic)
+      for (int s = color; s < n_slabs; s += 2) {
+        for (auto k = slab_begin[s]; k < slab_begin[s + 1]; k++) {
+          auto const i = order[k];
+          p3m_interpolate(local_mesh, weights.load<cao>(i),
+                          [&kernel, i](int ind, double w) {
+                            kernel(i, ind, w);
+                          });
+        }
+      }
+    }
+    return;
+  }
+#endif
+
+  for (size_t i = 0; i < n_points; i++) {
+    p3m_interpolate(local_mesh, weights.load<cao>(i),
+                    [&kernel, i](int ind, double w) { kernel(i, ind, w); });
+  }
+}
+
 #endif // ESPRESSO_P3M_INTERPOLATION_HPP
@@ -24,6 +24,8 @@
 
 #include "EspressoSystemInterface.hpp"
 #include "Observable_stat.hpp"
+#include "bond_error.hpp"
+#include "cells.hpp"
 #include "communication.hpp"
 #include "constraints.hpp"
 #include "cuda_interface.hpp"
@@ -33,6 +35,7 @@
 #include "forces.hpp"
 #include "integrate.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "particle_data.hpp"
 #include "reduce_observable_stat.hpp"
 
 #include "short_range_loop.hpp"
@@ -40,6 +43,16 @@
 #include "electrostatics_magnetostatics/coulomb.hpp"
 #include "electrostatics_magnetostatics/dipole.hpp"
 
+#include <utils/Span.hpp>
+
+#include <boost/container/static_vector.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 ActorList energyActors;
 
 /** Energy of the system */
@@ -128,6 +141,240 @@ double calculate_current_potential_energy_of_system() {
   return obs_energy.accumulate(-obs_energy.kinetic[0]);
 }
 
+/** @brief Non-bonded and constraint energy of a local particle with the
+ *  neighbors for which @p filter returns true.
+ */
+template <class Filter>
+static double non_bonded_energy(Particle const &p, Filter filter) {
+  /* the energies are summed directly: an Observable_stat holds all
+   * pairs of types and is expensive to set up for a single particle.
+   * Pairs without interaction contribute nothing, so unlike in
+   * short_range_loop the cutoffs need not be checked. */
+  auto energy = 0.;
+
+  cell_structure.particle_neighbor_loop(
+      p, [&energy, &filter](Particle const &p1, Particle const &p2,
+                            Distance const &d) {
+        if (filter(p2)) {
+          energy += calc_total_non_bonded_pair_energy(p1, p2, d.vec21,
+                                                      sqrt(d.dist2), d.dist2);
+        }
+      });
+
+  if (not Constraints::constraints.empty()) {
+    Observable_stat constraint_energy{1};
+    Constraints::constraints.add_energy(p, get_sim_time(), constraint_energy);
+    energy += constraint_energy.accumulate(0.);
+  }
+
+  return energy;
+}
+
+double particle_non_bonded_energy(Particle const &p) {
+  return non_bonded_energy(p, [](Particle const &) { return true; });
+}
+
+/** @brief Short-range energy of a set of particles, see
+ *  @ref calculate_particles_energy, on this node.
+ *
+ *  The non-bonded and constraint energies are added on the nodes
+ *  the particles are local on, the bonds on the nodes they are stored on.
+ *
+ *  @param p_ids Sorted ids of the particles.
+ */
+static double particles_energy_local(std::vector<int> p_ids) {
+  /* only the ghosts have to be up to date, the long-range methods
+   * need not be reinitialized for the short-range energy */
+  cells_update_ghosts(global_ghost_flags());
+
+  auto const in_set = [&p_ids](int p_id) {
+    return std::binary_search(p_ids.begin(), p_ids.end(), p_id);
+  };
+
+  auto energy = 0.;
+
+  for (auto const p_id : p_ids) {
+    auto const *p = cell_structure.get_local_particle(p_id);
+    if (p and not p->l.ghost) {
+      /* pairs of particles in the set are counted by the lower id */
+      energy += non_bonded_energy(*p, [p_id, &in_set](Particle const &p2) {
+        return p2.identity() > p_id or not in_set(p2.identity());
+      });
+    }
+  }
+
+  /* The bonds of a particle are stored on the particle itself or on
+   * one of its partners. As in @ref short_range_loop, bonds are only
+   * evaluated if there is an active bond cutoff. Every bond is stored
+   * once, so that it is counted once. */
+  if (maximal_cutoff_bonded() >= 0.) {
+    for (auto const &p1 : cell_structure.local_particles()) {
+      for (BondView const bond : p1.bonds()) {
+        auto const partner_ids = bond.partner_ids();
+        if (not in_set(p1.identity()) and
+            std::none_of(partner_ids.begin(), partner_ids.end(), in_set))
+          continue;
+
+        boost::container::static_vector<Particle *, 4> partners;
+        cell_structure.get_local_particles(partner_ids,
+                                           std::back_inserter(partners));
+        if (std::any_of(partners.begin(), partners.end(),
+                        [](Particle *partner) { return partner == nullptr; })) {
+          bond_broken_error(p1.identity(), partner_ids);
+          continue;
+        }
+
+        auto const result =
+            calc_bonded_energy(bonded_ia_params[bond.bond_id()], p1,
+                               Utils::make_span(partners));
+        if (result) {
+          energy += result.get();
+        } else {
+          bond_broken_error(p1.identity(), partner_ids);
+        }
+      }
+    }
+  }
+
+  return energy;
+}
+
+REGISTER_CALLBACK_REDUCTION(particles_energy_local, std::plus<double>())
+
+double calculate_particles_energy(std::vector<int> p_ids) {
+  std::sort(p_ids.begin(), p_ids.end());
+  p_ids.erase(std::unique(p_ids.begin(), p_ids.end()), p_ids.end());
+  auto const energy = mpi_call(Communication::Result::reduction,
+                               std::plus<double>(), particles_energy_local,
+                               p_ids);
+  /* the ghost update may have resorted the particles */
+  clear_particle_node();
+  return energy;
+}
+
+double calculate_particle_energy(int p_id) {
+  return calculate_particles_energy({p_id});
+}
+
+/** @brief Whether the change of the long-range energy by a change of
+ *  charges can be calculated from the changed charges alone.
+ */
+static bool long_range_energy_change_is_local() {
+  if (not energyActors.empty())
+    return false;
+#ifdef DIPOLES
+  if (dipole.method != DIPOLAR_NONE)
+    return false;
+#endif
+#ifdef ELECTROSTATICS
+  return Coulomb::has_energy_long_range_change();
+#else
+  return true;
+#endif
+}
+
+/** Long-range energy of the reference state, on the head node. */
+static double long_range_energy_reference = 0.;
+/** Change of the long-range energy by the last change of charges,
+ *  on the head node.
+ */
+static double long_range_energy_change = 0.;
+
+/** @brief Long-range energy, see @ref calculate_long_range_energy,
+ *  on this node.
+ */
+static double long_range_energy_local() {
+  on_observable_calc();
+
+  Observable_stat energy{1};
+
+#ifdef CUDA
+  clear_energy_on_GPU();
+#endif
+
+  EspressoSystemInterface::Instance().update();
+
+  for (auto &energyActor : energyActors)
+    energyActor->computeEnergy(espressoSystemInterface);
+
+  auto const particles = cell_structure.local_particles();
+#ifdef ELECTROSTATICS
+  energy.coulomb[1] = (long_range_energy_change_is_local())
+                          ? Coulomb::calc_energy_long_range_reference(particles)
+                          : Coulomb::calc_energy_long_range(particles);
+#endif
+#ifdef DIPOLES
+  energy.dipolar[1] = Dipole::calc_energy_long_range(particles);
+#endif
+
+#ifdef CUDA
+  auto const energy_host = copy_energy_from_GPU();
+  if (!energy.coulomb.empty())
+    energy.coulomb[1] += energy_host.coulomb;
+  if (!energy.dipolar.empty())
+    energy.dipolar[1] += energy_host.dipolar;
+#endif
+
+  return energy.accumulate(0.);
+}
+
+REGISTER_CALLBACK_REDUCTION(long_range_energy_local, std::plus<double>())
+
+double calculate_long_range_energy() {
+  long_range_energy_reference =
+      mpi_call(Communication::Result::reduction, std::plus<double>(),
+               long_range_energy_local);
+  long_range_energy_change = 0.;
+  return long_range_energy_reference;
+}
+
+/** @brief Change of the long-range energy, see
+ *  @ref calculate_long_range_energy_change, on this node.
+ */
+static double
+long_range_energy_change_local(std::vector<ParticleCharge> charges_old,
+                               std::vector<ParticleCharge> charges_new) {
+#ifdef ELECTROSTATICS
+  return Coulomb::calc_energy_long_range_change(charges_old, charges_new);
+#else
+  return 0.;
+#endif
+}
+
+REGISTER_CALLBACK_REDUCTION(long_range_energy_change_local, std::plus<double>())
+
+double calculate_long_range_energy_change(
+    std::vector<ParticleCharge> const &charges_old,
+    std::vector<ParticleCharge> const &charges_new) {
+  if (long_range_energy_change_is_local()) {
+    long_range_energy_change =
+        mpi_call(Communication::Result::reduction, std::plus<double>(),
+                 long_range_energy_change_local, charges_old, charges_new);
+  } else {
+    long_range_energy_change =
+        mpi_call(Communication::Result::reduction, std::plus<double>(),
+                 long_range_energy_local) -
+        long_range_energy_reference;
+  }
+  return long_range_energy_change;
+}
+
+static void accept_long_range_energy_change_local() {
+#ifdef ELECTROSTATICS
+  Coulomb::accept_energy_long_range_change();
+#endif
+}
+
+REGISTER_CALLBACK(accept_long_range_energy_change_local)
+
+void accept_long_range_energy_change() {
+  if (long_range_energy_change_is_local()) {
+    mpi_call_all(accept_long_range_energy_change_local);
+  }
+  long_range_energy_reference += long_range_energy_change;
+  long_range_energy_change = 0.;
+}
+
 double observable_compute_energy() {
   update_energy();
   return obs_energy.accumulate(0);
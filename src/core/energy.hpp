@@ -28,9 +28,15 @@
 #define _ENERGY_H
 
 #include "Observable_stat.hpp"
+#include "Particle.hpp"
 #include "ParticleRange.hpp"
 #include "actor/ActorList.hpp"
 
+#include <utils/Vector.hpp>
+
+#include <utility>
+#include <vector>
+
 extern ActorList energyActors;
 
 /** Parallel energy calculation. */
@@ -48,6 +54,75 @@ void calc_long_range_energies(const ParticleRange &particles);
 /** Calculate the total energy of the system. */
 double calculate_current_potential_energy_of_system();
 
+/** @brief Calculate the short-range energy of a set of particles.
+ *
+ *  This is the sum of the non-bonded energies of the particles with all
+ *  other particles, where pairs within the set are counted once, of the
+ *  energies of the bonds the particles take part in, and of their
+ *  energies in the constraints. A change of these particles changes the
+ *  short-range energy of the system by the change of this energy, which
+ *  only requires the particles in the neighboring cells. The ghosts are
+ *  updated once and the energies are reduced once for the whole set, and
+ *  the bonds of the local particles are scanned once. Long-range
+ *  contributions are not included, see @ref calculate_long_range_energy.
+ *  Particles that are moved along with the particles, like virtual
+ *  sites, are not taken into account.
+ *
+ *  @param p_ids Ids of the particles, ids without a particle are skipped.
+ */
+double calculate_particles_energy(std::vector<int> p_ids);
+
+/** @brief Calculate the short-range energy of a particle,
+ *  see @ref calculate_particles_energy.
+ *
+ *  @param p_id Id of the particle, the energy is zero if there is no
+ *              such particle.
+ */
+double calculate_particle_energy(int p_id);
+
+/** @brief Non-bonded and constraint energy of a local particle.
+ *
+ *  Like @ref calculate_particle_energy without the bonds, but only on
+ *  this node and without communication: the ghost particles have to
+ *  be up to date.
+ */
+double particle_non_bonded_energy(Particle const &p);
+
+/** @brief Calculate the long-range energy of the system.
+ *
+ *  These are the k-space parts of the electrostatic and magnetostatic
+ *  energies, and the energies of the GPU methods. The state of the system
+ *  becomes the reference state of @ref calculate_long_range_energy_change.
+ */
+double calculate_long_range_energy();
+
+/** Charge and position of a particle. */
+using ParticleCharge = std::pair<double, Utils::Vector3d>;
+
+/** @brief Calculate the change of the long-range energy by a change of
+ *  particle charges or positions.
+ *
+ *  The change is relative to the reference state, i.e. the state at the
+ *  last call of @ref calculate_long_range_energy and the changes accepted
+ *  since then by @ref accept_long_range_energy_change. With P3M and
+ *  metallic boundary conditions, only the contribution of the changed
+ *  charges to the transformed charge mesh is calculated, otherwise the
+ *  long-range energy of the whole system.
+ *
+ *  @param charges_old Charges and positions of the changed particles
+ *                     before the change.
+ *  @param charges_new Charges and positions of the changed particles
+ *                     after the change.
+ */
+double calculate_long_range_energy_change(
+    std::vector<ParticleCharge> const &charges_old,
+    std::vector<ParticleCharge> const &charges_new);
+
+/** @brief Make the last change of @ref calculate_long_range_energy_change
+ *  part of the reference state.
+ */
+void accept_long_range_energy_change();
+
 /** Helper function for @ref Observables::Energy. */
 double observable_compute_energy();
 
@@ -29,23 +29,10 @@
 #include "energy.hpp"
 
 #include "bonded_interactions/bonded_interaction_data.hpp"
-#include "nonbonded_interactions/bmhtf-nacl.hpp"
-#include "nonbonded_interactions/buckingham.hpp"
-#include "nonbonded_interactions/gaussian.hpp"
+#include "nonbonded_interactions/central_potentials.hpp"
 #include "nonbonded_interactions/gay_berne.hpp"
-#include "nonbonded_interactions/hat.hpp"
-#include "nonbonded_interactions/hertzian.hpp"
-#include "nonbonded_interactions/lj.hpp"
-#include "nonbonded_interactions/ljcos.hpp"
-#include "nonbonded_interactions/ljcos2.hpp"
-#include "nonbonded_interactions/ljgen.hpp"
-#include "nonbonded_interactions/morse.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
-#include "nonbonded_interactions/nonbonded_tab.hpp"
-#include "nonbonded_interactions/smooth_step.hpp"
-#include "nonbonded_interactions/soft_sphere.hpp"
 #include "nonbonded_interactions/thole.hpp"
-#include "nonbonded_interactions/wca.hpp"
 
 #ifdef ELECTROSTATICS
 #include "electrostatics_magnetostatics/coulomb_inline.hpp"
@@ -82,82 +69,14 @@ inline double calc_non_bonded_pair_energy(Particle const &p1,
                                           Utils::Vector3d const &d,
                                           double const dist) {
 
-  double ret = 0;
-
-#ifdef LENNARD_JONES
-  /* Lennard-Jones */
-  ret += lj_pair_energy(ia_params, dist);
-#endif
-#ifdef WCA
-  /* WCA */
-  ret += wca_pair_energy(ia_params, dist);
-#endif
-
-#ifdef LENNARD_JONES_GENERIC
-  /* Generic Lennard-Jones */
-  ret += ljgen_pair_energy(ia_params, dist);
-#endif
-
-#ifdef SMOOTH_STEP
-  /* smooth step */
-  ret += SmSt_pair_energy(ia_params, dist);
-#endif
-
-#ifdef HERTZIAN
-  /* Hertzian potential */
-  ret += hertzian_pair_energy(ia_params, dist);
-#endif
-
-#ifdef GAUSSIAN
-  /* Gaussian potential */
-  ret += gaussian_pair_energy(ia_params, dist);
-#endif
-
-#ifdef BMHTF_NACL
-  /* BMHTF NaCl */
-  ret += BMHTF_pair_energy(ia_params, dist);
-#endif
-
-#ifdef MORSE
-  /* Morse */
-  ret += morse_pair_energy(ia_params, dist);
-#endif
-
-#ifdef BUCKINGHAM
-  /* Buckingham */
-  ret += buck_pair_energy(ia_params, dist);
-#endif
-
-#ifdef SOFT_SPHERE
-  /* soft-sphere */
-  ret += soft_pair_energy(ia_params, dist);
-#endif
-
-#ifdef HAT
-  /* hat */
-  ret += hat_pair_energy(ia_params, dist);
-#endif
-
-#ifdef LJCOS2
-  /* Lennard-Jones */
-  ret += ljcos2_pair_energy(ia_params, dist);
-#endif
+  /* potentials that only depend on the distance */
+  double ret = central_pair_energy(ia_params, dist);
 
 #ifdef THOLE
   /* Thole damping */
   ret += thole_pair_energy(p1, p2, ia_params, d, dist);
 #endif
 
-#ifdef TABULATED
-  /* tabulated */
-  ret += tabulated_pair_energy(ia_params, dist);
-#endif
-
-#ifdef LJCOS
-  /* Lennard-Jones cosine */
-  ret += ljcos_pair_energy(ia_params, dist);
-#endif
-
 #ifdef GAY_BERNE
   /* Gay-Berne */
   ret += gb_pair_energy(p1.r.calc_director(), p2.r.calc_director(), ia_params,
@@ -201,6 +120,37 @@ inline void add_non_bonded_pair_energy(Particle const &p1, Particle const &p2,
 #endif
 }
 
+/** Sum of the contributions of @ref add_non_bonded_pair_energy.
+ *  @param p1        particle 1.
+ *  @param p2        particle 2.
+ *  @param d         vector between p1 and p2.
+ *  @param dist      distance between p1 and p2.
+ *  @param dist2     distance squared between p1 and p2.
+ */
+inline double calc_total_non_bonded_pair_energy(Particle const &p1,
+                                                Particle const &p2,
+                                                Utils::Vector3d const &d,
+                                                double const dist,
+                                                double const dist2) {
+  auto energy = 0.;
+
+#ifdef EXCLUSIONS
+  if (do_nonbonded(p1, p2))
+#endif
+    energy += calc_non_bonded_pair_energy(
+        p1, p2, *get_ia_param(p1.p.type, p2.p.type), d, dist);
+
+#ifdef ELECTROSTATICS
+  energy += Coulomb::pair_energy(p1, p2, p1.p.q * p2.p.q, d, dist, dist2);
+#endif
+
+#ifdef DIPOLES
+  energy += Dipole::pair_energy(p1, p2, d, dist, dist2);
+#endif
+
+  return energy;
+}
+
 inline boost::optional<double>
 calc_bonded_energy(Bonded_IA_Parameters const &iaparams, Particle const &p1,
                    Utils::Span<Particle *> partners) {
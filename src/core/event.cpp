@@ -42,6 +42,7 @@
 #include "grid_based_algorithms/lb_interface.hpp"
 #include "immersed_boundaries.hpp"
 #include "integrate.hpp"
+#include "load_balancing.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "npt.hpp"
 #include "partCfg_global.hpp"
@@ -110,6 +111,7 @@ void on_integration_start(double time_step) {
 #endif
   interactions_sanity_checks();
   lb_lbfluid_sanity_checks(time_step);
+  load_balancing_sanity_checks();
 
   /********************************************/
   /* end sanity checks                        */
@@ -204,6 +206,8 @@ void on_particle_change() {
 }
 
 void on_coulomb_change() {
+  /* mesh-based methods need the equally spaced node grid */
+  load_balancing_on_method_change();
 
 #ifdef ELECTROSTATICS
   Coulomb::on_coulomb_change();
@@ -222,6 +226,7 @@ void on_coulomb_change() {
 }
 
 void on_short_range_ia_change() {
+  recalc_ia_params();
   cells_re_init(cell_structure.decomposition_type());
 
   recalc_forces = true;
@@ -241,6 +246,7 @@ void on_boxl_change(bool skip_method_adaption) {
   grid_changed_box_l(box_geo);
   /* Electrostatics cutoffs mostly depend on the system size,
    * therefore recalculate them. */
+  recalc_ia_params();
   cells_re_init(cell_structure.decomposition_type());
 
   if (not skip_method_adaption) {
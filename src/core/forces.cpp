@@ -31,6 +31,7 @@
 #include "comfixed_global.hpp"
 #include "communication.hpp"
 #include "constraints.hpp"
+#include "electrostatics_magnetostatics/coulomb.hpp"
 #include "electrostatics_magnetostatics/dipole.hpp"
 #include "electrostatics_magnetostatics/icc.hpp"
 #include "electrostatics_magnetostatics/p3m_gpu.hpp"
@@ -41,18 +42,136 @@
 #include "grid_based_algorithms/lb_particle_coupling.hpp"
 #include "immersed_boundaries.hpp"
 #include "integrate.hpp"
+#include "load_balancing.hpp"
 #include "nonbonded_interactions/VerletCriterion.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "npt.hpp"
 #include "short_range_loop.hpp"
 #include "virtual_sites.hpp"
+#include "virtual_sites/VirtualSitesOff.hpp"
 
 #include <profiler/profiler.hpp>
 
+#include <utils/Span.hpp>
+
 #include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 
 ActorList forceActors;
 
+/**
+ * @brief Whether the non-bonded force kernel may run concurrently.
+ *
+ * The kernel only writes to the forces of the particle pair,
+ * except when it records collisions, or accumulates the
+ * instantaneous virial for the NpT integrator.
+ */
+static bool pair_force_kernel_is_concurrent() {
+#ifdef COLLISION_DETECTION
+  if (collision_params.mode != COLLISION_MODE_OFF)
+    return false;
+#endif
+#ifdef NPT
+  if (integ_switch == INTEG_METHOD_NPT_ISO)
+    return false;
+#endif
+#if defined(ELECTROSTATICS) && defined(SCAFACOS)
+  if (coulomb.method == COULOMB_SCAFACOS)
+    return false;
+#endif
+  return true;
+}
+
+/**
+ * @brief Whether the non-bonded forces can be calculated
+ *        from packed particle data.
+ *
+ * This is the case if all non-bonded forces are central forces,
+ * which only depend on the types, the charges and the distance
+ * of the particles, see @ref add_central_pair_force.
+ */
+static bool central_pair_forces_only() {
+#ifdef COLLISION_DETECTION
+  if (collision_params.mode != COLLISION_MODE_OFF)
+    return false;
+#endif
+#ifdef NPT
+  if (integ_switch == INTEG_METHOD_NPT_ISO)
+    return false;
+#endif
+#ifdef DPD
+  if (thermo_switch & THERMO_DPD)
+    return false;
+#endif
+#ifdef P3M
+  if (coulomb.method == COULOMB_ELC_P3M and elc_params.dielectric_contrast_on)
+    return false;
+#endif
+#ifdef DP3M
+  if (dipole.method == DIPOLAR_P3M or dipole.method == DIPOLAR_MDLC_P3M)
+    return false;
+#endif
+#if defined(THOLE) || defined(GAY_BERNE)
+  for (auto const &ia : ia_params) {
+#ifdef THOLE
+    if (ia.thole.scaling_coeff != 0. and ia.thole.q1q2 != 0.)
+      return false;
+#endif
+#ifdef GAY_BERNE
+    if (ia.gay_berne.cut != INACTIVE_CUTOFF)
+      return false;
+#endif
+  }
+#endif
+  return true;
+}
+
+/**
+ * @brief Whether the long-range forces can be calculated while
+ *        the ghost forces are reduced.
+ *
+ * The long-range forces only act on local particles, unless
+ * virtual sites transfer them to other particles. On GPUs, they
+ * are collected together with the other GPU forces, which have to
+ * be added before the reduction.
+ */
+static bool overlap_long_range_forces() {
+  if (not cell_structure.overlap_communication)
+    return false;
+#ifdef CUDA
+  return false;
+#else
+#ifdef VIRTUAL_SITES
+  if (not std::dynamic_pointer_cast<VirtualSitesOff>(virtual_sites()))
+    return false;
+#endif
+  return true;
+#endif
+}
+
+/**
+ * @brief Start the long-range forces of the methods which can overlap
+ *        their communication with the short-range loop.
+ *
+ * The calculation is completed by @ref calc_long_range_forces.
+ */
+static void calc_long_range_forces_begin(const ParticleRange &particles) {
+#ifdef ELECTROSTATICS
+  Coulomb::calc_long_range_force_begin(particles);
+#endif
+}
+
+/** @brief Make progress on the long-range forces started by
+ *         @ref calc_long_range_forces_begin.
+ */
+static void calc_long_range_forces_progress() {
+#ifdef ELECTROSTATICS
+  Coulomb::calc_long_range_force_progress();
+#endif
+}
+
 void init_forces(const ParticleRange &particles, double time_step, double kT) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
   /* The force initialization depends on the used thermostat and the
@@ -96,6 +215,8 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
   auto particles = cell_structure.local_particles();
   auto ghost_particles = cell_structure.ghost_particles();
 #ifdef ELECTROSTATICS
+  if (icc_cfg.n_icc > 0)
+    cell_structure.ghosts_wait();
   icc_iteration(particles, cell_structure.ghost_particles());
 #endif
   init_forces(particles, time_step, kT);
@@ -107,7 +228,15 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
 #endif
   }
 
-  calc_long_range_forces(particles);
+  /* With overlapping communication, the long-range calculation is started
+   * here, and its communication progresses during the short-range loop. */
+  auto const overlap_long_range = overlap_long_range_forces();
+  if (cell_structure.overlap_communication) {
+    calc_long_range_forces_begin(particles);
+    cell_structure.set_progress_callback(calc_long_range_forces_progress);
+  } else {
+    calc_long_range_forces(particles);
+  }
 
 #ifdef ELECTROSTATICS
   auto const coulomb_cutoff = Coulomb::cutoff(box_geo.length());
@@ -121,18 +250,64 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
   auto const dipole_cutoff = INACTIVE_CUTOFF;
 #endif
 
-  short_range_loop(
-      add_bonded_force,
-      [](Particle &p1, Particle &p2, Distance const &d) {
-        add_non_bonded_pair_force(p1, p2, d.vec21, sqrt(d.dist2), d.dist2);
+  auto const verlet_criterion =
+      VerletCriterion{skin, interaction_range(), coulomb_cutoff, dipole_cutoff,
+                      collision_detection_cutoff()};
+
+  auto const short_range_start = std::chrono::steady_clock::now();
+  if (cell_structure.use_soa and central_pair_forces_only()) {
+    short_range_soa_loop(
+        add_bonded_force,
+        [](Particle const &p1, Particle const &p2, ParticleSoA &soa, int i,
+           int j, Distance const &d) {
+#ifdef EXCLUSIONS
+          auto const excluded = soa.has_exclusions[i] and !do_nonbonded(p1, p2);
+#else
+          auto const excluded = false;
+#endif
+          add_central_pair_force(soa, i, j, d.vec21, sqrt(d.dist2), excluded);
+        },
+        [](Utils::Span<Particle *const> particles, ParticleSoA &soa, int i,
+           Utils::Span<const std::uint32_t> partners, auto const &df) {
+#ifdef EXCLUSIONS
+          if (soa.has_exclusions[i]) {
+            for (auto const j : partners) {
+              auto const d = df(soa.position(i), soa.position(j));
+              auto const excluded =
+                  !do_nonbonded(*particles[i], *particles[j]);
+              add_central_pair_force(soa, i, static_cast<int>(j), d.vec21,
+                                     sqrt(d.dist2), excluded);
+            }
+            return;
+          }
+#endif
+          add_central_pair_forces_batch(soa, i, partners, df);
+        },
+        maximal_cutoff(), maximal_cutoff_bonded(), verlet_criterion,
+        pair_force_kernel_is_concurrent());
+  } else {
+    short_range_loop(
+        add_bonded_force,
+        [](Particle &p1, Particle &p2, Distance const &d) {
+          add_non_bonded_pair_force(p1, p2, d.vec21, sqrt(d.dist2), d.dist2);
 #ifdef COLLISION_DETECTION
-        if (collision_params.mode != COLLISION_MODE_OFF)
-          detect_collision(p1, p2, d.dist2);
+          if (collision_params.mode != COLLISION_MODE_OFF)
+            detect_collision(p1, p2, d.dist2);
 #endif
-      },
-      maximal_cutoff(), maximal_cutoff_bonded(),
-      VerletCriterion{skin, interaction_range(), coulomb_cutoff, dipole_cutoff,
-                      collision_detection_cutoff()});
+        },
+        maximal_cutoff(), maximal_cutoff_bonded(), verlet_criterion,
+        pair_force_kernel_is_concurrent());
+  }
+  auto const short_range_time =
+      std::chrono::steady_clock::now() - short_range_start;
+  load_balancing_add_force_time(
+      std::chrono::duration<double>(short_range_time).count());
+
+  if (cell_structure.overlap_communication) {
+    cell_structure.set_progress_callback({});
+    if (not overlap_long_range)
+      calc_long_range_forces(particles);
+  }
 
   Constraints::constraints.add_forces(particles, get_sim_time());
 
@@ -154,6 +329,9 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
   // Must be done here. Forces need to be ghost-communicated
   immersed_boundaries.volume_conservation(cell_structure);
 
+  /* A concurrent LB time step has overlapped with the forces so far. */
+  lb_lbfluid_finish_propagation();
+
   lb_lbcoupling_calc_particle_lattice_ia(thermo_virtual, particles,
                                          ghost_particles, time_step);
 
@@ -167,7 +345,13 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
 #endif
 
   // Communication Step: ghost forces
-  cell_structure.ghosts_reduce_forces();
+  if (overlap_long_range) {
+    cell_structure.ghosts_reduce_forces_begin();
+    calc_long_range_forces(particles);
+    cell_structure.ghosts_wait();
+  } else {
+    cell_structure.ghosts_reduce_forces();
+  }
 
   // should be pretty late, since it needs to zero out the total force
   comfixed.apply(comm_cart, particles);
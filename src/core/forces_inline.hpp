@@ -28,23 +28,10 @@
 #include "bonded_interactions/bonded_interaction_data.hpp"
 #include "immersed_boundary/ibm_tribend.hpp"
 #include "immersed_boundary/ibm_triel.hpp"
-#include "nonbonded_interactions/bmhtf-nacl.hpp"
-#include "nonbonded_interactions/buckingham.hpp"
-#include "nonbonded_interactions/gaussian.hpp"
+#include "nonbonded_interactions/central_potentials.hpp"
 #include "nonbonded_interactions/gay_berne.hpp"
-#include "nonbonded_interactions/hat.hpp"
-#include "nonbonded_interactions/hertzian.hpp"
-#include "nonbonded_interactions/lj.hpp"
-#include "nonbonded_interactions/ljcos.hpp"
-#include "nonbonded_interactions/ljcos2.hpp"
-#include "nonbonded_interactions/ljgen.hpp"
-#include "nonbonded_interactions/morse.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
-#include "nonbonded_interactions/nonbonded_tab.hpp"
-#include "nonbonded_interactions/smooth_step.hpp"
-#include "nonbonded_interactions/soft_sphere.hpp"
 #include "nonbonded_interactions/thole.hpp"
-#include "nonbonded_interactions/wca.hpp"
 #include "object-in-fluid/oif_global_forces.hpp"
 #include "object-in-fluid/oif_local_forces.hpp"
 
@@ -61,6 +48,7 @@
 #endif
 
 #include "Particle.hpp"
+#include "ParticleSoA.hpp"
 #include "errorhandling.hpp"
 #include "exclusions.hpp"
 #include "rotation.hpp"
@@ -69,10 +57,17 @@
 
 #include <utils/Span.hpp>
 #include <utils/Vector.hpp>
+#include <utils/constants.hpp>
+#include <utils/math/AS_erfc_part.hpp>
+#include <utils/math/int_pow.hpp>
 
 #include <boost/optional.hpp>
 #include <boost/variant.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <tuple>
 
 /** Initialize the forces for a ghost particle */
@@ -124,74 +119,30 @@ inline ParticleForce init_local_particle_force(Particle const &part,
   return thermostat_force(part, time_step, kT) + external_force(part);
 }
 
+/** Calculate the non-bonded forces between a pair of particles that
+ *  only depend on their types and their distance. Only the potentials
+ *  that are active for the types of the pair are evaluated, see
+ *  @ref for_each_central_potential.
+ *  @param ia_params    interaction parameters of the pair.
+ *  @param d            vector between the particles.
+ *  @param dist         distance between the particles.
+ */
+inline Utils::Vector3d
+calc_central_pair_force(IA_parameters const &ia_params,
+                        Utils::Vector3d const &d, double const dist) {
+  return central_pair_force_factor(ia_params, dist) * d;
+}
+
 inline ParticleForce calc_non_bonded_pair_force(Particle const &p1,
                                                 Particle const &p2,
                                                 IA_parameters const &ia_params,
                                                 Utils::Vector3d const &d,
                                                 double const dist) {
-
-  ParticleForce pf{};
-  double force_factor = 0;
-/* Lennard-Jones */
-#ifdef LENNARD_JONES
-  force_factor += lj_pair_force_factor(ia_params, dist);
-#endif
-/* WCA */
-#ifdef WCA
-  force_factor += wca_pair_force_factor(ia_params, dist);
-#endif
-/* Lennard-Jones generic */
-#ifdef LENNARD_JONES_GENERIC
-  force_factor += ljgen_pair_force_factor(ia_params, dist);
-#endif
-/* smooth step */
-#ifdef SMOOTH_STEP
-  force_factor += SmSt_pair_force_factor(ia_params, dist);
-#endif
-/* Hertzian force */
-#ifdef HERTZIAN
-  force_factor += hertzian_pair_force_factor(ia_params, dist);
-#endif
-/* Gaussian force */
-#ifdef GAUSSIAN
-  force_factor += gaussian_pair_force_factor(ia_params, dist);
-#endif
-/* BMHTF NaCl */
-#ifdef BMHTF_NACL
-  force_factor += BMHTF_pair_force_factor(ia_params, dist);
-#endif
-/* Buckingham*/
-#ifdef BUCKINGHAM
-  force_factor += buck_pair_force_factor(ia_params, dist);
-#endif
-/* Morse*/
-#ifdef MORSE
-  force_factor += morse_pair_force_factor(ia_params, dist);
-#endif
-/*soft-sphere potential*/
-#ifdef SOFT_SPHERE
-  force_factor += soft_pair_force_factor(ia_params, dist);
-#endif
-/*hat potential*/
-#ifdef HAT
-  force_factor += hat_pair_force_factor(ia_params, dist);
-#endif
-/* Lennard-Jones cosine */
-#ifdef LJCOS
-  force_factor += ljcos_pair_force_factor(ia_params, dist);
-#endif
-/* Lennard-Jones cosine */
-#ifdef LJCOS2
-  force_factor += ljcos2_pair_force_factor(ia_params, dist);
-#endif
+  ParticleForce pf{calc_central_pair_force(ia_params, d, dist)};
 /* Thole damping */
 #ifdef THOLE
   pf.f += thole_pair_force(p1, p2, ia_params, d, dist);
 #endif
-/* tabulated */
-#ifdef TABULATED
-  force_factor += tabulated_pair_force_factor(ia_params, dist);
-#endif
 /* Gay-Berne */
 #ifdef GAY_BERNE
   // The gb force function isn't inlined, probably due to its size
@@ -200,7 +151,6 @@ inline ParticleForce calc_non_bonded_pair_force(Particle const &p1,
                         d, dist);
   }
 #endif
-  pf.f += force_factor * d;
   return pf;
 }
 
@@ -297,6 +247,176 @@ inline void add_non_bonded_pair_force(Particle &p1, Particle &p2,
   p2.f += calc_opposing_force(pf, d);
 }
 
+/** Calculate the central non-bonded forces between a pair of particles
+ *  from packed particle data, and add them to the packed forces.
+ *  This is equivalent to @ref add_non_bonded_pair_force if all
+ *  interactions of the pair are central forces.
+ *  @param[in,out] soa  packed particle data.
+ *  @param i            packed index of particle 1.
+ *  @param j            packed index of particle 2.
+ *  @param d            vector between the particles.
+ *  @param dist         distance between the particles.
+ *  @param excluded     whether the short-range interactions of
+ *                      the pair are excluded.
+ */
+inline void add_central_pair_force(ParticleSoA &soa, int i, int j,
+                                   Utils::Vector3d const &d, double dist,
+                                   bool excluded) {
+  IA_parameters const &ia_params = *get_ia_param(soa.type[i], soa.type[j]);
+  Utils::Vector3d force{};
+
+  if (dist < ia_params.max_cut and not excluded) {
+    force += calc_central_pair_force(ia_params, d, dist);
+  }
+
+#ifdef ELECTROSTATICS
+  auto const q1q2 = soa.q[i] * soa.q[j];
+  if (q1q2 != 0.) {
+    force += Coulomb::central_force(q1q2, d, dist);
+  }
+#endif
+
+  soa.add_force(i, force);
+  soa.add_force(j, -force);
+}
+
+/** Number of pairs that are evaluated together by
+ *  @ref add_central_pair_forces_batch.
+ */
+constexpr std::size_t central_force_batch_size = 16;
+
+/** Calculate the central non-bonded forces between a particle and its
+ *  interaction partners from packed particle data, and add them to the
+ *  packed forces.
+ *
+ *  The Lennard-Jones, WCA and P3M real-space forces are evaluated for
+ *  @ref central_force_batch_size pairs at a time, in loops without
+ *  branches that the compiler can vectorize. Pairs of types with other
+ *  active potentials (see @ref BatchIAParameters::batched) are passed
+ *  to @ref add_central_pair_force, and Coulomb methods other than P3M
+ *  are evaluated pair by pair. Exclusions are not taken into account.
+ *
+ *  @param[in,out] soa  packed particle data.
+ *  @param i            packed index of the particle.
+ *  @param partners     packed indices of the interaction partners.
+ *  @param df           distance function.
+ */
+template <class DistanceFunction>
+void add_central_pair_forces_batch(ParticleSoA &soa, int i,
+                                   Utils::Span<const std::uint32_t> partners,
+                                   DistanceFunction const &df) {
+  constexpr auto batch_size = central_force_batch_size;
+  auto const *const params = get_batch_ia_params(soa.type[i]);
+  double const pos_i[3] = {soa.pos[0][i], soa.pos[1][i], soa.pos[2][i]};
+#ifdef ELECTROSTATICS
+  auto const q_i = soa.q[i];
+#ifdef P3M
+  auto const p3m_real_space =
+      (q_i != 0.) and
+      (coulomb.method == COULOMB_P3M or coulomb.method == COULOMB_P3M_GPU or
+       coulomb.method == COULOMB_ELC_P3M);
+#else
+  auto const p3m_real_space = false;
+#endif
+  auto const pairwise_coulomb =
+      (q_i != 0.) and not p3m_real_space and coulomb.method != COULOMB_NONE;
+#endif
+  Utils::Vector3d force_i{};
+
+  for (std::size_t begin = 0; begin < partners.size(); begin += batch_size) {
+    auto const n = std::min(batch_size, partners.size() - begin);
+    auto const *const js = partners.data() + begin;
+
+    double d[3][batch_size];
+    double dist[batch_size];
+    double factor[batch_size];
+
+    for (std::size_t k = 0; k < n; k++) {
+      for (unsigned dim = 0; dim < 3; dim++) {
+        d[dim][k] = df.coord(pos_i[dim], soa.pos[dim][js[k]], dim);
+      }
+      dist[k] = std::sqrt(d[0][k] * d[0][k] + d[1][k] * d[1][k] +
+                          d[2][k] * d[2][k]);
+      factor[k] = 0.;
+    }
+
+#ifdef LENNARD_JONES
+    for (std::size_t k = 0; k < n; k++) {
+      auto const &lj = params[soa.type[js[k]]].lj;
+      auto const r_off = dist[k] - lj.offset;
+      auto const frac6 = Utils::int_pow<6>(lj.sig / r_off);
+      auto const in_range =
+          (dist[k] < lj.cut + lj.offset) and (dist[k] > lj.min + lj.offset);
+      factor[k] += in_range ? 48.0 * lj.eps * frac6 * (frac6 - 0.5) /
+                                  (r_off * dist[k])
+                            : 0.;
+    }
+#endif
+
+#ifdef WCA
+    for (std::size_t k = 0; k < n; k++) {
+      auto const &wca = params[soa.type[js[k]]].wca;
+      auto const frac6 = Utils::int_pow<6>(wca.sig / dist[k]);
+      auto const in_range = dist[k] < wca.cut;
+      factor[k] += in_range ? 48.0 * wca.eps * frac6 * (frac6 - 0.5) /
+                                  (dist[k] * dist[k])
+                            : 0.;
+    }
+#endif
+
+#ifdef P3M
+    if (p3m_real_space) {
+      auto const alpha = p3m.params.alpha;
+      auto const r_cut = p3m.params.r_cut;
+      for (std::size_t k = 0; k < n; k++) {
+        auto const q1q2 = q_i * soa.q[js[k]];
+        auto const adist = alpha * dist[k];
+#if USE_ERFC_APPROXIMATION
+        auto const erfc_part_ri = Utils::AS_erfc_part(adist) / dist[k];
+        auto const fac1 = q1q2 * exp(-adist * adist);
+        auto const fac2 = fac1 *
+                          (erfc_part_ri + 2.0 * alpha * Utils::sqrt_pi_i()) /
+                          (dist[k] * dist[k]);
+#else
+        auto const erfc_part_ri = erfc(adist) / dist[k];
+        auto const fac2 =
+            q1q2 *
+            (erfc_part_ri +
+             2.0 * alpha * Utils::sqrt_pi_i() * exp(-adist * adist)) /
+            (dist[k] * dist[k]);
+#endif
+        auto const in_range = (dist[k] < r_cut) and (dist[k] > 0.);
+        factor[k] += in_range ? coulomb.prefactor * fac2 : 0.;
+      }
+    }
+#endif
+
+    for (std::size_t k = 0; k < n; k++) {
+      auto const j = static_cast<int>(js[k]);
+      auto const d_k = Utils::Vector3d{d[0][k], d[1][k], d[2][k]};
+
+      if (not params[soa.type[j]].batched) {
+        add_central_pair_force(soa, i, j, d_k, dist[k], false);
+        continue;
+      }
+
+      auto force = factor[k] * d_k;
+#ifdef ELECTROSTATICS
+      if (pairwise_coulomb) {
+        auto const q1q2 = q_i * soa.q[j];
+        if (q1q2 != 0.) {
+          force += Coulomb::central_force(q1q2, d_k, dist[k]);
+        }
+      }
+#endif
+      force_i += force;
+      soa.add_force(j, -force);
+    }
+  }
+
+  soa.add_force(i, force_i);
+}
+
 /** Compute the bonded interaction force between particle pairs.
  *
  *  @param[in] p1          First particle.
@@ -43,10 +43,14 @@
 #include <boost/range/numeric.hpp>
 #include <boost/serialization/vector.hpp>
 
+#include <mpi.h>
+
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <functional>
 #include <iterator>
+#include <memory>
 #include <vector>
 
 /** Tag for ghosts communications. */
@@ -122,12 +126,6 @@ static void prepare_send_buffer(CommBuf &send_buffer,
 
   auto archiver = Utils::MemcpyOArchive{Utils::make_span(send_buffer)};
 
-  /* Construct archive that pushes back to the bond buffer */
-  namespace io = boost::iostreams;
-  io::stream<io::back_insert_device<std::vector<char>>> os{
-      io::back_inserter(send_buffer.bonds())};
-  boost::archive::binary_oarchive bond_archiver{os};
-
   /* put in data */
   for (auto part_list : ghost_comm.part_lists) {
     if (data_parts & GHOSTTRANS_PARTNUM) {
@@ -155,14 +153,27 @@ static void prepare_send_buffer(CommBuf &send_buffer,
           archiver << part.rattle;
         }
 #endif
-        if (data_parts & GHOSTTRANS_BONDS) {
-          bond_archiver << part.bonds();
-        }
       }
     }
   }
 
   assert(archiver.bytes_written() == send_buffer.size());
+
+  /* The bonds have variable size, and are only serialized on request. */
+  if ((data_parts & GHOSTTRANS_BONDS) and
+      not(data_parts & GHOSTTRANS_PARTNUM)) {
+    /* Construct archive that pushes back to the bond buffer */
+    namespace io = boost::iostreams;
+    io::stream<io::back_insert_device<std::vector<char>>> os{
+        io::back_inserter(send_buffer.bonds())};
+    boost::archive::binary_oarchive bond_archiver{os};
+
+    for (auto part_list : ghost_comm.part_lists) {
+      for (Particle &part : *part_list) {
+        bond_archiver << part.bonds();
+      }
+    }
+  }
 }
 
 static void prepare_ghost_cell(ParticleList *cell, int size) {
@@ -386,25 +397,30 @@ void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts) {
 
     /* transfer data */
     // Use two send/recvs in order to avoid having to serialize CommBuf
-    // (which consists of already serialized data).
+    // (which consists of already serialized data). The bond buffer is
+    // only transferred if the bonds were requested.
     switch (comm_type) {
     case GHOST_RECV:
       comm.recv(node, REQ_GHOST_SEND, recv_buffer.data(), recv_buffer.size());
-      comm.recv(node, REQ_GHOST_SEND, recv_buffer.bonds());
+      if (data_parts & GHOSTTRANS_BONDS)
+        comm.recv(node, REQ_GHOST_SEND, recv_buffer.bonds());
       break;
     case GHOST_SEND:
       comm.send(node, REQ_GHOST_SEND, send_buffer.data(), send_buffer.size());
-      comm.send(node, REQ_GHOST_SEND, send_buffer.bonds());
+      if (data_parts & GHOSTTRANS_BONDS)
+        comm.send(node, REQ_GHOST_SEND, send_buffer.bonds());
       break;
     case GHOST_BCST:
       if (node == comm.rank()) {
         boost::mpi::broadcast(comm, send_buffer.data(), send_buffer.size(),
                               node);
-        boost::mpi::broadcast(comm, send_buffer.bonds(), node);
+        if (data_parts & GHOSTTRANS_BONDS)
+          boost::mpi::broadcast(comm, send_buffer.bonds(), node);
       } else {
         boost::mpi::broadcast(comm, recv_buffer.data(), recv_buffer.size(),
                               node);
-        boost::mpi::broadcast(comm, recv_buffer.bonds(), node);
+        if (data_parts & GHOSTTRANS_BONDS)
+          boost::mpi::broadcast(comm, recv_buffer.bonds(), node);
       }
       break;
     case GHOST_RDCE:
@@ -463,3 +479,275 @@ void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts) {
     }
   }
 }
+
+/** A point-to-point transfer of a non-blocking ghost communication.
+ *
+ *  The transfer owns its buffer and a persistent MPI request bound to it,
+ *  so that repeated communications of the same cells neither allocate
+ *  nor set up new requests. The request is only recreated if the buffer
+ *  has moved or changed its size.
+ */
+struct GhostTransfer {
+  bool recv = false;
+  bool done = false;
+  CommBuf buffer;
+  MPI_Request request = MPI_REQUEST_NULL;
+  /** Buffer the persistent request was created for. */
+  const char *request_data = nullptr;
+  std::size_t request_size = 0;
+
+  void start(const GhostCommunication &ghost_comm, MPI_Comm comm) {
+    if (request == MPI_REQUEST_NULL or request_data != buffer.data() or
+        request_size != buffer.size()) {
+      free_request();
+      auto const count = static_cast<int>(buffer.size());
+      if (recv) {
+        MPI_Recv_init(buffer.data(), count, MPI_BYTE, ghost_comm.node,
+                      REQ_GHOST_SEND, comm, &request);
+      } else {
+        MPI_Send_init(buffer.data(), count, MPI_BYTE, ghost_comm.node,
+                      REQ_GHOST_SEND, comm, &request);
+      }
+      request_data = buffer.data();
+      request_size = buffer.size();
+    }
+    done = false;
+    MPI_Start(&request);
+  }
+
+  bool test() {
+    if (not done) {
+      int flag;
+      MPI_Test(&request, &flag, MPI_STATUS_IGNORE);
+      done = static_cast<bool>(flag);
+    }
+    return done;
+  }
+
+  void wait() {
+    if (not done) {
+      MPI_Wait(&request, MPI_STATUS_IGNORE);
+      done = true;
+    }
+  }
+
+  void free_request() {
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (request != MPI_REQUEST_NULL and not finalized) {
+      MPI_Request_free(&request);
+    }
+    request = MPI_REQUEST_NULL;
+  }
+};
+
+/** Transfers of a communicator for a combination of data parts,
+ *  one per communication. */
+struct GhostTransferPlan {
+  const GhostCommunicator *gcr = nullptr;
+  unsigned int data_parts = GHOSTTRANS_NONE;
+  std::vector<GhostTransfer> transfers;
+
+  GhostTransferPlan(const GhostCommunicator &gcr, unsigned int data_parts)
+      : gcr(&gcr), data_parts(data_parts),
+        transfers(gcr.communications.size()) {}
+  GhostTransferPlan(GhostTransferPlan const &) = delete;
+  GhostTransferPlan &operator=(GhostTransferPlan const &) = delete;
+  ~GhostTransferPlan() {
+    for (auto &transfer : transfers) {
+      transfer.free_request();
+    }
+  }
+};
+
+struct GhostCommunicationRequest::State {
+  /** Transfers of all communicators used since the last reset. */
+  std::vector<std::unique_ptr<GhostTransferPlan>> plans;
+  /** Plan in progress, nullptr if there is none. */
+  GhostTransferPlan *plan = nullptr;
+  /** Index of the first communication in flight. */
+  std::size_t first_comm = 0;
+  /** Index of the next communication to post. */
+  std::size_t next_comm = 0;
+  /** Sorted particle lists that are written by receives in flight. */
+  std::vector<const ParticleList *> recv_lists;
+
+  GhostTransferPlan &get_plan(const GhostCommunicator &gcr,
+                              unsigned int data_parts) {
+    auto it = std::find_if(plans.begin(), plans.end(), [&](auto const &p) {
+      return p->gcr == &gcr and p->data_parts == data_parts and
+             p->transfers.size() == gcr.communications.size();
+    });
+    if (it == plans.end()) {
+      plans.emplace_back(std::make_unique<GhostTransferPlan>(gcr, data_parts));
+      return *plans.back();
+    }
+    return **it;
+  }
+
+  auto const &communications() const { return plan->gcr->communications; }
+
+  /** Whether a communication reads cells written by a receive in flight. */
+  bool depends_on_recv(const GhostCommunication &ghost_comm) const {
+    return std::any_of(ghost_comm.part_lists.begin(),
+                       ghost_comm.part_lists.end(),
+                       [this](const ParticleList *part_list) {
+                         return std::binary_search(recv_lists.begin(),
+                                                   recv_lists.end(), part_list);
+                       });
+  }
+
+  /** Apply a function to the transfers in flight. */
+  template <class F> bool for_each_transfer(F &&f) {
+    for (auto i = first_comm; i < next_comm; i++) {
+      int const comm_type = communications()[i].type & GHOST_JOBMASK;
+      if (comm_type != GHOST_LOCL and not f(plan->transfers[i], i))
+        return false;
+    }
+    return true;
+  }
+
+  /** Post transfers until one depends on a transfer in flight. */
+  void post() {
+    auto const comm = static_cast<MPI_Comm>(plan->gcr->mpi_comm);
+    auto const data_parts = plan->data_parts;
+    first_comm = next_comm;
+
+    for (; next_comm < communications().size(); ++next_comm) {
+      auto const &ghost_comm = communications()[next_comm];
+      int const comm_type = ghost_comm.type & GHOST_JOBMASK;
+
+      if (comm_type == GHOST_LOCL) {
+        /* the source cells may be filled by a transfer in flight */
+        if (next_comm != first_comm)
+          return;
+        cell_cell_transfer(ghost_comm, data_parts);
+        first_comm++;
+        continue;
+      }
+
+      if (comm_type == GHOST_SEND and depends_on_recv(ghost_comm))
+        return;
+
+      auto &transfer = plan->transfers[next_comm];
+      transfer.recv = (comm_type == GHOST_RECV);
+
+      if (transfer.recv) {
+        prepare_recv_buffer(transfer.buffer, ghost_comm, data_parts);
+        recv_lists.insert(recv_lists.end(), ghost_comm.part_lists.begin(),
+                          ghost_comm.part_lists.end());
+        std::sort(recv_lists.begin(), recv_lists.end());
+      } else {
+        prepare_send_buffer(transfer.buffer, ghost_comm, data_parts);
+      }
+      transfer.start(ghost_comm, comm);
+    }
+  }
+
+  /** Write back the received data once all transfers have arrived. */
+  void finish_transfers() {
+    auto const data_parts = plan->data_parts;
+    for_each_transfer([&](GhostTransfer &transfer, std::size_t i) {
+      if (not transfer.recv)
+        return true;
+
+      auto const &ghost_comm = communications()[i];
+      /* forces have to be added, the rest overwritten */
+      if (data_parts == GHOSTTRANS_FORCE)
+        add_forces_from_recv_buffer(transfer.buffer, ghost_comm);
+#ifdef BOND_CONSTRAINT
+      else if (data_parts == GHOSTTRANS_RATTLE)
+        add_rattle_correction_from_recv_buffer(transfer.buffer, ghost_comm);
+#endif
+      else
+        put_recv_buffer(transfer.buffer, ghost_comm, data_parts);
+      return true;
+    });
+
+    first_comm = next_comm;
+    recv_lists.clear();
+  }
+};
+
+GhostCommunicationRequest::GhostCommunicationRequest()
+    : m_state(std::make_unique<State>()) {}
+GhostCommunicationRequest::~GhostCommunicationRequest() = default;
+GhostCommunicationRequest::GhostCommunicationRequest(
+    GhostCommunicationRequest &&) noexcept = default;
+GhostCommunicationRequest &GhostCommunicationRequest::operator=(
+    GhostCommunicationRequest &&) noexcept = default;
+
+bool GhostCommunicationRequest::pending() const {
+  return m_state and m_state->plan;
+}
+
+bool GhostCommunicationRequest::test() {
+  while (pending()) {
+    auto &state = *m_state;
+    if (not state.for_each_transfer(
+            [](GhostTransfer &transfer, std::size_t) {
+              return transfer.test();
+            }))
+      return false;
+
+    state.finish_transfers();
+    state.post();
+
+    if (state.first_comm == state.communications().size())
+      state.plan = nullptr;
+  }
+
+  return true;
+}
+
+void GhostCommunicationRequest::wait() {
+  while (pending()) {
+    m_state->for_each_transfer([](GhostTransfer &transfer, std::size_t) {
+      transfer.wait();
+      return true;
+    });
+
+    test();
+  }
+}
+
+void GhostCommunicationRequest::reset() {
+  wait();
+  m_state->plans.clear();
+}
+
+void ghost_communicator_begin(const GhostCommunicator &gcr,
+                              unsigned int data_parts,
+                              GhostCommunicationRequest &request) {
+  assert(not request.pending());
+
+  if (GHOSTTRANS_NONE == data_parts)
+    return;
+
+  /* The sizes of these data parts are only known after the
+   * transfer of the previous communications. */
+  auto const variable_size =
+      data_parts & (GHOSTTRANS_PARTNUM | GHOSTTRANS_BONDS);
+  auto const collective = std::any_of(
+      gcr.communications.begin(), gcr.communications.end(),
+      [](GhostCommunication const &ghost_comm) {
+        int const comm_type = ghost_comm.type & GHOST_JOBMASK;
+        return comm_type == GHOST_BCST or comm_type == GHOST_RDCE;
+      });
+
+  if (variable_size or collective) {
+    ghost_communicator(gcr, data_parts);
+    return;
+  }
+
+  auto &state = *request.m_state;
+  state.plan = &state.get_plan(gcr, data_parts);
+  state.first_comm = 0;
+  state.next_comm = 0;
+  state.recv_lists.clear();
+
+  state.post();
+
+  if (state.first_comm == state.communications().size())
+    state.plan = nullptr;
+}
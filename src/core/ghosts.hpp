@@ -83,6 +83,21 @@
  *
  *  The ghost communicators are created by the cell
  *  systems.
+ *
+ *  <h2> Non-blocking communication </h2>
+ *  A ghost communication can also be started with
+ *  @ref ghost_communicator_begin, which posts the transfers with
+ *  non-blocking MPI calls and returns immediately, so that the caller can
+ *  do work which does not depend on the transferred data, e.g. calculate
+ *  the pair forces between local particles, and finish the communication
+ *  later with @ref GhostCommunicationRequest::wait.
+ *  Communications which depend on the result of earlier ones, e.g. because
+ *  they send ghost cells filled by an earlier communication, are only
+ *  posted once the earlier ones have arrived. To make progress on these,
+ *  @ref GhostCommunicationRequest::test should be called from time to time.
+ *  The transfers use persistent MPI requests and buffers, which are kept
+ *  in the request object, so that repeated communications with the same
+ *  communicator and data parts do not allocate memory.
  */
 #include "ParticleList.hpp"
 
@@ -91,6 +106,7 @@
 #include <boost/mpi/communicator.hpp>
 
 #include <cstddef>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -168,6 +184,49 @@ struct GhostCommunicator {
   std::vector<GhostCommunication> communications;
 };
 
+/** Handle of a non-blocking ghost communication,
+ *  see @ref ghost_communicator_begin.
+ */
+class GhostCommunicationRequest {
+public:
+  GhostCommunicationRequest();
+  ~GhostCommunicationRequest();
+  GhostCommunicationRequest(GhostCommunicationRequest &&) noexcept;
+  GhostCommunicationRequest &operator=(GhostCommunicationRequest &&) noexcept;
+
+  /** Whether the communication has not been finished yet. */
+  bool pending() const;
+  /**
+   * @brief Make progress on the communication without blocking.
+   *
+   * Writes back the data of transfers that have arrived, and posts
+   * the transfers that depend on them.
+   *
+   * @return Whether the communication is finished.
+   */
+  bool test();
+  /** @brief Block until the communication is finished. */
+  void wait();
+  /**
+   * @brief Release the buffers and persistent MPI requests.
+   *
+   * The transfers of a communicator are set up on first use, and reused
+   * as long as the sizes of the communicated cells do not change.
+   * Has to be called if the communicators may have been destroyed,
+   * and should be called if the number of particles in the communicated
+   * cells has changed. Finishes a pending communication first.
+   */
+  void reset();
+
+private:
+  friend void ghost_communicator_begin(const GhostCommunicator &gcr,
+                                       unsigned int data_parts,
+                                       GhostCommunicationRequest &request);
+
+  struct State;
+  std::unique_ptr<State> m_state;
+};
+
 /**@}*/
 
 /** \name Exported Functions */
@@ -179,6 +238,26 @@ struct GhostCommunicator {
  */
 void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts);
 
+/**
+ * @brief Start a ghost communication with caller specified data parts.
+ *
+ * The communication is done with non-blocking point-to-point
+ * operations, and finished by @ref GhostCommunicationRequest::wait.
+ * Until then, the particle data in the communicated cells must not be
+ * accessed. Communicators with broadcasts or reductions and transfers
+ * of data with variable size (@ref GHOSTTRANS_PARTNUM,
+ * @ref GHOSTTRANS_BONDS) are done by @ref ghost_communicator right away.
+ * The communicator has to stay valid until the communication is finished.
+ * All nodes have to start the same communications in the same order.
+ *
+ * @param gcr Communicator to execute.
+ * @param data_parts Data parts to transfer.
+ * @param request Handle of the communication, must not be pending.
+ */
+void ghost_communicator_begin(const GhostCommunicator &gcr,
+                              unsigned int data_parts,
+                              GhostCommunicationRequest &request);
+
 /**@}*/
 
 #endif
@@ -33,11 +33,9 @@
 #include <utils/Vector.hpp>
 #include <utils/mpi/cart_comm.hpp>
 
-#include <boost/algorithm/clamp.hpp>
-
 #include <mpi.h>
 
-#include <cmath>
+#include <vector>
 
 /**********************************************
  * variables
@@ -48,17 +46,40 @@ LocalBox<double> local_geo;
 
 Utils::Vector3i node_grid{};
 
+static NodeBoundaries node_boundaries;
+
 /************************************************************/
 
 void init_node_grid() { grid_changed_n_nodes(); }
 
+/** @brief Position of the lower boundary of node @p k along @p dir.
+ *
+ *  The local boxes and @ref map_position_node_array all use this
+ *  expression, so that both sides of a node boundary agree on it.
+ */
+static double node_boundary(BoxGeometry const &box,
+                            std::vector<double> const &bounds, int n_nodes,
+                            int dir, int k) {
+  if (bounds.empty()) {
+    return (k == n_nodes) ? box.length()[dir]
+                          : k * (box.length()[dir] / n_nodes);
+  }
+  return bounds[k] * box.length()[dir];
+}
+
 int map_position_node_array(const Utils::Vector3d &pos) {
   auto const f_pos = folded_position(pos, box_geo);
 
+  /* the node boundaries are half-open intervals [lower, upper) */
   Utils::Vector3i im;
   for (int i = 0; i < 3; i++) {
-    im[i] = static_cast<int>(std::floor(f_pos[i] / local_geo.length()[i]));
-    im[i] = boost::algorithm::clamp(im[i], 0, node_grid[i] - 1);
+    auto const &bounds = node_boundaries[i];
+    im[i] = 0;
+    while (im[i] + 1 < node_grid[i] and
+           node_boundary(box_geo, bounds, node_grid[i], i, im[i] + 1) <=
+               f_pos[i]) {
+      im[i]++;
+    }
   }
 
   return Utils::Mpi::cart_rank(comm_cart, im);
@@ -76,12 +97,12 @@ calc_node_neighbors(const boost::mpi::communicator &comm) {
 LocalBox<double> regular_decomposition(const BoxGeometry &box,
                                        Utils::Vector3i const &node_pos,
                                        Utils::Vector3i const &node_grid_par) {
-  Utils::Vector3d local_length;
   Utils::Vector3d my_left;
+  Utils::Vector3d my_right;
 
   for (int i = 0; i < 3; i++) {
-    local_length[i] = box.length()[i] / node_grid_par[i];
-    my_left[i] = node_pos[i] * local_length[i];
+    my_left[i] = node_boundary(box, {}, node_grid_par[i], i, node_pos[i]);
+    my_right[i] = node_boundary(box, {}, node_grid_par[i], i, node_pos[i] + 1);
   }
 
   Utils::Array<int, 6> boundaries;
@@ -92,14 +113,45 @@ LocalBox<double> regular_decomposition(const BoxGeometry &box,
     boundaries[2 * dir + 1] = -(node_pos[dir] == node_grid_par[dir] - 1);
   }
 
-  return {my_left, local_length, boundaries};
+  return LocalBox<double>::from_corners(my_left, my_right, boundaries);
+}
+
+LocalBox<double> tensor_product_decomposition(
+    const BoxGeometry &box, Utils::Vector3i const &node_pos,
+    Utils::Vector3i const &node_grid_par, NodeBoundaries const &boundaries) {
+  auto const regular = regular_decomposition(box, node_pos, node_grid_par);
+
+  auto my_left = regular.my_left();
+  auto my_right = regular.my_right();
+  for (int i = 0; i < 3; i++) {
+    auto const &bounds = boundaries[i];
+    if (bounds.empty())
+      continue;
+
+    my_left[i] = node_boundary(box, bounds, node_grid_par[i], i, node_pos[i]);
+    my_right[i] =
+        node_boundary(box, bounds, node_grid_par[i], i, node_pos[i] + 1);
+  }
+
+  return LocalBox<double>::from_corners(my_left, my_right, regular.boundary());
+}
+
+NodeBoundaries const &get_node_boundaries() { return node_boundaries; }
+
+void set_node_boundaries(NodeBoundaries const &boundaries) {
+  node_boundaries = boundaries;
+  grid_changed_box_l(box_geo);
 }
 
 void grid_changed_box_l(const BoxGeometry &box) {
-  local_geo = regular_decomposition(box, calc_node_pos(comm_cart), node_grid);
+  local_geo = tensor_product_decomposition(box, calc_node_pos(comm_cart),
+                                           node_grid, node_boundaries);
 }
 
 void grid_changed_n_nodes() {
+  /* The boundaries of the old node grid are meaningless now. */
+  node_boundaries = NodeBoundaries{};
+
   comm_cart =
       Utils::Mpi::cart_create(comm_cart, node_grid, /* reorder */ false);
 
@@ -38,12 +38,21 @@
 
 #include <boost/mpi/communicator.hpp>
 
+#include <array>
+#include <vector>
+
 extern BoxGeometry box_geo;
 extern LocalBox<double> local_geo;
 
 /** The number of nodes in each spatial dimension. */
 extern Utils::Vector3i node_grid;
 
+/** Relative positions of the node boundaries in each spatial dimension,
+ *  @c node_grid[i] + 1 values from 0 to 1. An empty list stands for
+ *  equally spaced boundaries.
+ */
+using NodeBoundaries = std::array<std::vector<double>, 3>;
+
 /** Make sure that the node grid is set, eventually
  *  determine one automatically.
  */
@@ -111,6 +120,31 @@ LocalBox<double> regular_decomposition(const BoxGeometry &box,
                                        Utils::Vector3i const &node_pos,
                                        Utils::Vector3i const &node_grid);
 
+/**
+ * @brief Composition of the simulation box into a tensor product grid.
+ *
+ * The subdomain boundaries along each direction are shared by all nodes,
+ * but do not have to be equally spaced.
+ *
+ * @param box Geometry of the simulation box
+ * @param node_pos Position of node in the node grid
+ * @param node_grid Nodes in each direction
+ * @param boundaries Relative node boundaries, see @ref NodeBoundaries
+ * @return Geometry for the node
+ */
+LocalBox<double> tensor_product_decomposition(
+    const BoxGeometry &box, Utils::Vector3i const &node_pos,
+    Utils::Vector3i const &node_grid, NodeBoundaries const &boundaries);
+
+/** @brief Current relative node boundaries. */
+NodeBoundaries const &get_node_boundaries();
+
+/** @brief Set the relative node boundaries and update the local box.
+ *
+ *  The cell structure has to be reinitialized afterwards.
+ */
+void set_node_boundaries(NodeBoundaries const &boundaries);
+
 /** @brief Set and broadcast the box length.
  *  @param length new box length
  */
@@ -32,233 +32,195 @@
 #include "grid_based_algorithms/lattice.hpp"
 #include "halo.hpp"
 
-#include <utils/Vector.hpp>
-
-#include <cstdlib>
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
-#include <memory>
-
-/** Predefined fieldtype for double-precision LB */
-static std::shared_ptr<FieldType> fieldtype_double =
-    std::make_shared<FieldType>(static_cast<int>(sizeof(double)));
-
-/** Set halo region to a given value
- * @param[out] dest pointer to the halo buffer
- * @param value integer value to write into the halo buffer
- * @param type halo field layout description
- */
-void halo_dtset(char *dest, int value, std::shared_ptr<FieldType> type) {
-  auto const vblocks = type->vblocks;
-  auto const vstride = type->vstride;
-  auto const vskip = type->vskip;
-  auto const &lens = type->lengths;
-  auto const &disps = type->disps;
-  auto const extent = type->extent;
-  auto const block_size = static_cast<long>(vskip) * static_cast<long>(extent);
+#include <utility>
+#include <vector>
+
+HaloCommunicator::HaloCommunicator(const Lattice &lattice, void *base,
+                                   MPI_Datatype datatype,
+                                   std::vector<HaloFace> const &faces,
+                                   bool open_boundaries)
+    : m_base(static_cast<char *>(base)) {
+  MPI_Type_size(datatype, &m_value_size);
+  m_field_size = static_cast<std::size_t>(lattice.halo_grid_volume) *
+                 static_cast<std::size_t>(m_value_size);
+
+  auto const &period = lattice.halo_grid;
+  auto const node_neighbors = calc_node_neighbors(comm_cart);
 
-  for (int i = 0; i < vblocks; i++) {
-    for (int j = 0; j < vstride; j++) {
-      for (std::size_t k = 0; k < disps.size(); k++)
-        memset(dest + disps[k], value, lens[k]);
+  for (int dir = 0; dir < 3; dir++) {
+    int n_blocks = 1;
+    for (int k = dir + 1; k < 3; k++) {
+      n_blocks *= period[k];
     }
-    dest += block_size;
-  }
-}
-
-void halo_dtcopy(char *r_buffer, char *s_buffer, int count,
-                 std::shared_ptr<FieldType> type);
-
-void halo_copy_vector(char *r_buffer, char *s_buffer, int count,
-                      std::shared_ptr<FieldType> type, bool vflag) {
-
-  auto const vblocks = type->vblocks;
-  auto const vstride = type->vstride;
-  auto const extent = type->extent;
-
-  auto block_size = static_cast<long>(type->vskip);
-  if (vflag) {
-    block_size *= static_cast<long>(type->subtype->extent);
-  }
-
-  for (int i = 0; i < count; i++, s_buffer += extent, r_buffer += extent) {
-    char *dest = r_buffer, *src = s_buffer;
-    for (int j = 0; j < vblocks; j++, dest += block_size, src += block_size) {
-      halo_dtcopy(dest, src, vstride, type->subtype);
+    int block_length = 1;
+    for (int k = 0; k < dir; k++) {
+      block_length *= period[k];
     }
+    m_plane_layout[dir] = {
+        {n_blocks, block_length, block_length * period[dir]}};
   }
-}
-
-/** Copy lattice data with layout described by @p type.
- * @param r_buffer data destination
- * @param s_buffer data source
- * @param count    amount of data to copy
- * @param type     field layout type
- */
-void halo_dtcopy(char *r_buffer, char *s_buffer, int count,
-                 std::shared_ptr<FieldType> type) {
 
-  if (type->subtype) {
-    halo_copy_vector(r_buffer, s_buffer, count, type, type->vflag);
-  } else {
-
-    for (int i = 0; i < count;
-         i++, s_buffer += type->extent, r_buffer += type->extent) {
-      if (!type->count) {
-        memmove(r_buffer, s_buffer, type->extent);
-      } else {
-        for (int j = 0; j < type->count; j++) {
-          memmove(r_buffer + type->disps[j], s_buffer + type->disps[j],
-                  type->lengths[j]);
-        }
-      }
+  for (auto const &face : faces) {
+    auto const dir = face.dir;
+    auto const &layout = m_plane_layout[dir];
+
+    Transfer t;
+    t.dir = dir;
+    t.send_buffer = m_base + face.send_plane * layout[1] * m_value_size;
+    t.recv_buffer = m_base + face.recv_plane * layout[1] * m_value_size;
+    t.fields = face.fields;
+    t.local = node_grid[dir] == 1;
+    t.send = true;
+    t.recv = true;
+    t.datatype = MPI_DATATYPE_NULL;
+    t.send_request = MPI_REQUEST_NULL;
+    t.recv_request = MPI_REQUEST_NULL;
+
+    /* nothing is sent across the boundaries of an open box */
+    if (open_boundaries and not box_geo.periodic(dir)) {
+      t.send = local_geo.boundary()[2 * dir + face.side] == 0;
+      t.recv = local_geo.boundary()[2 * dir + 1 - face.side] == 0;
     }
-  }
-}
-
-void prepare_halo_communication(HaloCommunicator &hc, const Lattice &lattice,
-                                MPI_Datatype datatype,
-                                const Utils::Vector3i &local_node_grid) {
-
-  const auto &grid = lattice.grid;
-  const auto &period = lattice.halo_grid;
-
-  for (int n = 0; n < hc.num; n++) {
-    MPI_Type_free(&(hc.halo_info[n].datatype));
-  }
-
-  int const num = 2 * 3; /* two communications in each space direction */
-  hc.num = num;
-  hc.halo_info.resize(num);
 
-  auto const extent = static_cast<long>(fieldtype_double->extent);
+    if (not t.local) {
+      MPI_Datatype plane;
+      MPI_Type_vector(layout[0], layout[1], layout[2], datatype, &plane);
 
-  auto const node_neighbors = calc_node_neighbors(comm_cart);
-
-  int cnt = 0;
-  for (int dir = 0; dir < 3; dir++) {
-    for (int lr = 0; lr < 2; lr++) {
-
-      HaloInfo &hinfo = hc.halo_info[cnt];
-
-      int nblocks = 1;
-      for (int k = dir + 1; k < 3; k++) {
-        nblocks *= period[k];
+      std::vector<MPI_Aint> displacements;
+      for (auto const field : t.fields) {
+        displacements.push_back(static_cast<MPI_Aint>(field) *
+                                static_cast<MPI_Aint>(m_field_size));
       }
-      int stride = 1;
-      for (int k = 0; k < dir; k++) {
-        stride *= period[k];
+      MPI_Type_create_hindexed_block(static_cast<int>(displacements.size()),
+                                     1, displacements.data(), plane,
+                                     &t.datatype);
+      MPI_Type_commit(&t.datatype);
+      MPI_Type_free(&plane);
+
+      auto const dest = node_neighbors[2 * dir + face.side];
+      auto const source = node_neighbors[2 * dir + 1 - face.side];
+      /* the faces of a direction are in flight at the same time */
+      auto const tag = REQ_HALO_SPREAD + face.side;
+      if (t.send) {
+        MPI_Send_init(t.send_buffer, 1, t.datatype, dest, tag, comm_cart,
+                      &t.send_request);
       }
-      int skip = 1;
-      for (int k = 0; k < dir + 1 && k < 2; k++) {
-        skip *= period[k];
+      if (t.recv) {
+        MPI_Recv_init(t.recv_buffer, 1, t.datatype, source, tag, comm_cart,
+                      &t.recv_request);
       }
+    }
 
-      if (lr == 0) {
-        /* send to left, recv from right */
-        hinfo.s_offset = extent * static_cast<long>(stride * 1);
-        hinfo.r_offset = extent * static_cast<long>(stride * (grid[dir] + 1));
-      } else {
-        /* send to right, recv from left */
-        hinfo.s_offset = extent * static_cast<long>(stride * grid[dir]);
-        hinfo.r_offset = extent * static_cast<long>(stride * 0);
-      }
+    m_transfers.push_back(std::move(t));
+  }
+}
 
-      hinfo.source_node = node_neighbors[2 * dir + 1 - lr];
-      hinfo.dest_node = node_neighbors[2 * dir + lr];
+HaloCommunicator::HaloCommunicator(HaloCommunicator &&other) noexcept
+    : m_base(other.m_base), m_value_size(other.m_value_size),
+      m_field_size(other.m_field_size), m_plane_layout(other.m_plane_layout),
+      m_transfers(std::move(other.m_transfers)) {
+  other.m_transfers.clear();
+}
 
-      hinfo.fieldtype = std::make_shared<FieldType>(nblocks, stride, skip, true,
-                                                    fieldtype_double);
+HaloCommunicator &
+HaloCommunicator::operator=(HaloCommunicator &&other) noexcept {
+  std::swap(m_base, other.m_base);
+  std::swap(m_value_size, other.m_value_size);
+  std::swap(m_field_size, other.m_field_size);
+  std::swap(m_plane_layout, other.m_plane_layout);
+  std::swap(m_transfers, other.m_transfers);
+  return *this;
+}
 
-      MPI_Type_vector(nblocks, stride, skip, datatype, &hinfo.datatype);
-      MPI_Type_commit(&hinfo.datatype);
+HaloCommunicator::~HaloCommunicator() { release(); }
+
+void HaloCommunicator::release() {
+  /* static instances may outlive MPI */
+  int finalized;
+  MPI_Finalized(&finalized);
+  if (finalized)
+    return;
+
+  for (auto &t : m_transfers) {
+    if (t.send_request != MPI_REQUEST_NULL)
+      MPI_Request_free(&t.send_request);
+    if (t.recv_request != MPI_REQUEST_NULL)
+      MPI_Request_free(&t.recv_request);
+    if (t.datatype != MPI_DATATYPE_NULL)
+      MPI_Type_free(&t.datatype);
+  }
+  m_transfers.clear();
+}
 
-      if (!box_geo.periodic(dir) &&
-          (local_geo.boundary()[2 * dir + lr] != 0 ||
-           local_geo.boundary()[2 * dir + 1 - lr] != 0)) {
-        if (local_node_grid[dir] == 1) {
-          hinfo.type = HALO_OPEN;
-        } else if (lr == 0) {
-          if (local_geo.boundary()[2 * dir + lr] == 1) {
-            hinfo.type = HALO_RECV;
-          } else {
-            hinfo.type = HALO_SEND;
-          }
-        } else {
-          if (local_geo.boundary()[2 * dir + lr] == -1) {
-            hinfo.type = HALO_RECV;
-          } else {
-            hinfo.type = HALO_SEND;
-          }
-        }
-      } else {
-        if (local_node_grid[dir] == 1) {
-          hc.halo_info[cnt].type = HALO_LOCL;
-        } else {
-          hc.halo_info[cnt].type = HALO_SENDRECV;
-        }
-      }
-      cnt++;
+void HaloCommunicator::copy_local(Transfer const &t) const {
+  auto const &layout = m_plane_layout[t.dir];
+  auto const length = static_cast<std::size_t>(layout[1] * m_value_size);
+  auto const stride = layout[2] * m_value_size;
+  for (auto const field : t.fields) {
+    auto const offset = field * m_field_size;
+    auto const *src = t.send_buffer + offset;
+    auto *dest = t.recv_buffer + offset;
+    for (int block = 0; block < layout[0]; block++) {
+      std::memcpy(dest, src, length);
+      src += stride;
+      dest += stride;
     }
   }
 }
 
-void release_halo_communication(HaloCommunicator &hc) {
-  for (int n = 0; n < hc.num; n++) {
-    MPI_Type_free(&(hc.halo_info[n].datatype));
+void HaloCommunicator::set_zero(Transfer const &t) const {
+  auto const &layout = m_plane_layout[t.dir];
+  auto const length = static_cast<std::size_t>(layout[1] * m_value_size);
+  auto const stride = layout[2] * m_value_size;
+  for (auto const field : t.fields) {
+    auto *dest = t.recv_buffer + field * m_field_size;
+    for (int block = 0; block < layout[0]; block++) {
+      std::memset(dest, 0, length);
+      dest += stride;
+    }
   }
 }
 
-void halo_communication(const HaloCommunicator &hc, char *const base) {
-
-  std::shared_ptr<FieldType> fieldtype;
-  MPI_Datatype datatype;
-  MPI_Request request;
-  MPI_Status status;
-
-  for (int n = 0; n < hc.num; n++) {
-    int s_node, r_node;
-    int comm_type = hc.halo_info[n].type;
-    char *s_buffer = (char *)base + hc.halo_info[n].s_offset;
-    char *r_buffer = (char *)base + hc.halo_info[n].r_offset;
-
-    switch (comm_type) {
-
-    case HALO_LOCL:
-      fieldtype = hc.halo_info[n].fieldtype;
-      halo_dtcopy(r_buffer, s_buffer, 1, fieldtype);
-      break;
-
-    case HALO_SENDRECV:
-      datatype = hc.halo_info[n].datatype;
-      s_node = hc.halo_info[n].source_node;
-      r_node = hc.halo_info[n].dest_node;
-      MPI_Sendrecv(s_buffer, 1, datatype, r_node, REQ_HALO_SPREAD, r_buffer, 1,
-                   datatype, s_node, REQ_HALO_SPREAD, comm_cart, &status);
-      break;
-
-    case HALO_SEND:
-      datatype = hc.halo_info[n].datatype;
-      fieldtype = hc.halo_info[n].fieldtype;
-      r_node = hc.halo_info[n].dest_node;
-      MPI_Isend(s_buffer, 1, datatype, r_node, REQ_HALO_SPREAD, comm_cart,
-                &request);
-      halo_dtset(r_buffer, 0, fieldtype);
-      MPI_Wait(&request, &status);
-      break;
+void HaloCommunicator::communicate() {
+  std::vector<MPI_Request> requests;
+
+  auto transfer = m_transfers.begin();
+  while (transfer != m_transfers.end()) {
+    auto const dir = transfer->dir;
+    auto const end =
+        std::find_if(transfer, m_transfers.end(),
+                     [dir](Transfer const &t) { return t.dir != dir; });
+
+    requests.clear();
+    for (auto t = transfer; t != end; ++t) {
+      if (t->local or not t->recv)
+        continue;
+      requests.push_back(t->recv_request);
+    }
+    for (auto t = transfer; t != end; ++t) {
+      if (t->local or not t->send)
+        continue;
+      requests.push_back(t->send_request);
+    }
+    if (not requests.empty()) {
+      MPI_Startall(static_cast<int>(requests.size()), requests.data());
+    }
 
-    case HALO_RECV:
-      datatype = hc.halo_info[n].datatype;
-      s_node = hc.halo_info[n].source_node;
-      MPI_Irecv(r_buffer, 1, datatype, s_node, REQ_HALO_SPREAD, comm_cart,
-                &request);
-      MPI_Wait(&request, &status);
-      break;
+    for (auto t = transfer; t != end; ++t) {
+      if (not t->recv) {
+        set_zero(*t);
+      } else if (t->local and t->send) {
+        copy_local(*t);
+      }
+    }
 
-    case HALO_OPEN:
-      fieldtype = hc.halo_info[n].fieldtype;
-      /** \todo this does not work for the n_i - \<n_i\> */
-      halo_dtset(r_buffer, 0, fieldtype);
-      break;
+    if (not requests.empty()) {
+      MPI_Waitall(static_cast<int>(requests.size()), requests.data(),
+                  MPI_STATUSES_IGNORE);
     }
+    transfer = end;
   }
 }
@@ -23,6 +23,15 @@
  * Halo scheme for parallelization of lattice algorithms.
  * Header file for \ref halo.cpp.
  *
+ * The lattice data consists of a set of fields, each of them an array of
+ * values over the full halo grid, stored one after the other. A halo
+ * communication transfers a subset of the fields of one plane of the
+ * halo grid to another plane on the neighboring node, face by face. The
+ * data of a face is described by an MPI derived datatype, and transferred
+ * with persistent requests directly from and into the lattice, without
+ * intermediate buffers. If the neighbor in a direction is the node
+ * itself, the data is copied without MPI.
+ *
  */
 
 #ifndef _HALO_HPP
@@ -30,108 +39,89 @@
 
 #include "grid_based_algorithms/lattice.hpp"
 
-#include <utils/Vector.hpp>
-
 #include <mpi.h>
 
-#include <memory>
+#include <array>
+#include <cstddef>
 #include <vector>
 
-/** \name Types of halo communications */
-/**@{*/
-#define HALO_LOCL                                                              \
-  0 /**< Tag for local exchange of halo regions on the same processor */
-#define HALO_SENDRECV                                                          \
-  1                 /**< Tag for halo exchange between different processors */
-#define HALO_SEND 2 /**< Tag for halo send only */
-#define HALO_RECV 3 /**< Tag for halo receive only */
-#define HALO_OPEN 4 /**< Tag for halo open boundary */
-/**@}*/
-
 /** \name Tags for halo communications */
 /**@{*/
 #define REQ_HALO_SPREAD 501 /**< Tag for halo update */
 #define REQ_HALO_CHECK 599  /**< Tag for consistency check of halo regions */
 /**@}*/
 
-/** Layout of the lattice data.
- *  The description is similar to MPI datatypes but a bit more compact.
- */
-struct FieldType {
-  FieldType(int new_extent)
-      : count(0), disps({}), lengths({}), extent(new_extent), vblocks(0),
-        vstride(0), vskip(0), vflag(false), subtype(nullptr) {}
-  FieldType(int new_vblocks, int new_vstride, int new_vskip, bool new_vflag,
-            std::shared_ptr<FieldType> oldtype)
-      : count(oldtype->count), disps(oldtype->disps), lengths(oldtype->lengths),
-        extent(0), vblocks(new_vblocks), vstride(new_vstride), vskip(new_vskip),
-        vflag(new_vflag), subtype(oldtype) {
-    if (vflag) {
-      extent = oldtype->extent * ((vblocks - 1) * vskip + vstride);
-    } else {
-      extent = oldtype->extent * vstride + (vblocks - 1) * vskip;
-    }
-  }
-  int count;                /**< number of subtypes in fieldtype */
-  std::vector<int> disps;   /**< displacements of the subtypes */
-  std::vector<int> lengths; /**< lengths of the subtypes */
-  int extent;  /**< extent of the complete fieldtype including gaps */
-  int vblocks; /**< number of blocks in field vectors */
-  int vstride; /**< size of strides in field vectors */
-  int vskip;   /**< displacement between strides in field vectors */
-  bool vflag;
-  std::shared_ptr<FieldType> subtype;
+/** Transfer of a set of fields through one face of the local domain. */
+struct HaloFace {
+  int dir;                 /**< direction normal to the face */
+  int side;                /**< 0 to send to the left, 1 to the right */
+  int send_plane;          /**< index of the plane that is sent */
+  int recv_plane;          /**< index of the plane that is received */
+  std::vector<int> fields; /**< indices of the transferred fields */
 };
 
-/** Structure describing a Halo region */
-typedef struct {
-
-  int type; /**< type of halo communication */
-
-  int source_node; /**< index of processor which sends halo data */
-  int dest_node;   /**< index of processor receiving halo data */
-
-  unsigned long s_offset; /**< offset for send buffer */
-  unsigned long r_offset; /**< offset for receive buffer */
-
-  std::shared_ptr<FieldType>
-      fieldtype;         /**< type layout of the data being exchanged */
-  MPI_Datatype datatype; /**< MPI datatype of data being communicated */
-
-} HaloInfo;
-
-/** Structure holding a set of \ref HaloInfo which comprise a certain
- *  parallelization scheme */
+/** Halo communication of a lattice, bound to the memory of its fields.
+ *
+ *  The faces of the same direction are communicated concurrently, the
+ *  directions one after the other in the order of the faces, such that
+ *  data in edge and corner nodes is passed on to the diagonal neighbors.
+ */
 class HaloCommunicator {
 public:
-  HaloCommunicator(int num) : num(num){};
-
-  int num; /**< number of halo communications in the scheme */
-
-  std::vector<HaloInfo> halo_info; /**< set of halo communications */
+  HaloCommunicator() = default;
+  /**
+   * @param lattice          Lattice of the fields.
+   * @param base             Start of the first field.
+   * @param datatype         MPI datatype of the values.
+   * @param faces            Faces to communicate.
+   * @param open_boundaries  Whether the box is open in its non-periodic
+   *                         directions. The planes received across the
+   *                         box boundary are then set to zero instead.
+   */
+  HaloCommunicator(const Lattice &lattice, void *base, MPI_Datatype datatype,
+                   std::vector<HaloFace> const &faces, bool open_boundaries);
+  ~HaloCommunicator();
+
+  HaloCommunicator(HaloCommunicator const &) = delete;
+  HaloCommunicator &operator=(HaloCommunicator const &) = delete;
+  HaloCommunicator(HaloCommunicator &&other) noexcept;
+  HaloCommunicator &operator=(HaloCommunicator &&other) noexcept;
+
+  /** Start of the first field the communication is bound to. */
+  void const *base() const { return m_base; }
+
+  /** Perform the communication. Has to be called on all nodes. */
+  void communicate();
+
+private:
+  /** Data of a face. */
+  struct Transfer {
+    int dir;
+    char *send_buffer;
+    char *recv_buffer;
+    std::vector<int> fields;
+    /** Copy locally instead of communicating. */
+    bool local;
+    bool send;
+    bool recv;
+    MPI_Datatype datatype;
+    MPI_Request send_request;
+    MPI_Request recv_request;
+  };
+
+  void copy_local(Transfer const &transfer) const;
+  void set_zero(Transfer const &transfer) const;
+  void release();
+
+  char *m_base = nullptr;
+  /** Size of a value in bytes. */
+  int m_value_size = 0;
+  /** Size of a field in bytes. */
+  std::size_t m_field_size = 0;
+  /** Layout of a plane normal to each direction: number of blocks, block
+   *  length and distance between blocks, in values. */
+  std::array<std::array<int, 3>, 3> m_plane_layout;
+  std::vector<Transfer> m_transfers;
 };
 
-/** Preparation of the halo parallelization scheme. Sets up the
- *  necessary data structures for \ref halo_communication
- *  @param[in,out] hc       halo communicator being created
- *  @param[in]     lattice  lattice the communication is created for
- *  @param datatype         MPI datatype for the lattice data
- *  @param local_node_grid  Number of nodes in each spatial dimension
- */
-void prepare_halo_communication(HaloCommunicator &hc, const Lattice &lattice,
-                                MPI_Datatype datatype,
-                                const Utils::Vector3i &local_node_grid);
-
-/** Frees data structures associated with a halo communicator
- *  @param[in,out] hc  halo communicator to be released
- */
-void release_halo_communication(HaloCommunicator &hc);
-
-/** Perform communication according to the parallelization scheme
- *  described by the halo communicator
- *  @param[in]  hc    halo communicator describing the parallelization scheme
- *  @param[in]  base  base plane of local node
- */
-void halo_communication(const HaloCommunicator &hc, char *base);
-
 #endif /* HALO_H */
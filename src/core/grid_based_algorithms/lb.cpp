@@ -34,6 +34,7 @@
 #include "errorhandling.hpp"
 #include "grid.hpp"
 #include "grid_based_algorithms/lb_boundaries.hpp"
+#include "grid_based_algorithms/lb_refinement.hpp"
 #include "halo.hpp"
 #include "lb-d3q19.hpp"
 #include "random.hpp"
@@ -63,7 +64,12 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 using Utils::get_linear_index;
 
@@ -139,6 +145,8 @@ static void lb_check_halo_regions(const LB_Fluid &lb_fluid,
                                   const Lattice &lb_lattice);
 #endif // ADDITIONAL_CHECKS
 
+static void lb_prepare_communication(const Lattice &lb_lattice);
+
 boost::optional<Utils::Counter<uint64_t>> rng_counter_fluid;
 
 LB_Parameters lbpar = {
@@ -171,7 +179,7 @@ LB_Parameters lbpar = {
 
 Lattice lblattice;
 
-using LB_FluidData = boost::multi_array<double, 2>;
+using LB_FluidData = boost::multi_array<lb_float, 2>;
 static LB_FluidData lbfluid_a;
 static LB_FluidData lbfluid_b;
 
@@ -184,7 +192,14 @@ LB_Fluid lbfluid_post;
 
 std::vector<LB_FluidNode> lbfields;
 
-HaloCommunicator update_halo_comm = HaloCommunicator(0);
+/** Communication of the populations streamed into the halo, for the
+ *  population buffers @ref lbfluid_a and @ref lbfluid_b.
+ */
+static std::array<HaloCommunicator, 2> push_halo_comm;
+/** Update of the halo populations from the neighbors, for the population
+ *  buffers @ref lbfluid_a and @ref lbfluid_b.
+ */
+static std::array<HaloCommunicator, 2> update_halo_comm;
 
 /**
  * @brief Initialize fluid nodes.
@@ -198,6 +213,9 @@ void lb_initialize_fields(std::vector<LB_FluidNode> &fields,
   fields.resize(lb_lattice.halo_grid_volume);
   for (auto &field : fields) {
     field.force_density = lb_parameters.ext_force_density;
+#ifdef LB_SINGLE_PRECISION
+    field.rounding_residual = {};
+#endif
 #ifdef LB_BOUNDARIES
     field.boundary = false;
 #endif // LB_BOUNDARIES
@@ -215,8 +233,8 @@ void lb_realloc_fluid(LB_FluidData &lb_fluid_a, LB_FluidData &lb_fluid_b,
 
   using Utils::Span;
   for (int i = 0; i < size[0]; i++) {
-    lb_fluid[i] = Span<double>(lb_fluid_a[i].origin(), size[1]);
-    lb_fluid_post[i] = Span<double>(lb_fluid_b[i].origin(), size[1]);
+    lb_fluid[i] = Span<lb_float>(lb_fluid_a[i].origin(), size[1]);
+    lb_fluid_post[i] = Span<lb_float>(lb_fluid_b[i].origin(), size[1]);
   }
 }
 
@@ -253,9 +271,10 @@ void lb_init(const LB_Parameters &lb_parameters) {
                    lbfluid_post);
 
   lb_initialize_fields(lbfields, lbpar, lblattice);
+  lb_update_node_lists();
 
   /* prepare the halo communication */
-  lb_prepare_communication(update_halo_comm, lblattice);
+  lb_prepare_communication(lblattice);
 
   /* initialize derived parameters */
   lb_reinit_parameters(lbpar);
@@ -265,6 +284,8 @@ void lb_init(const LB_Parameters &lb_parameters) {
 #ifdef LB_BOUNDARIES
   LBBoundaries::lb_init_boundaries();
 #endif
+
+  lb_refinement_init();
 }
 
 void lb_reinit_fluid(std::vector<LB_FluidNode> &lb_fields,
@@ -272,6 +293,8 @@ void lb_reinit_fluid(std::vector<LB_FluidNode> &lb_fields,
                      LB_Parameters const &lb_parameters) {
   lb_set_equilibrium_populations(lb_lattice, lb_parameters);
   lb_initialize_fields(lbfields, lb_parameters, lb_lattice);
+  lb_update_node_lists();
+  lb_refinement_init();
 }
 
 void lb_reinit_parameters(LB_Parameters &lb_parameters) {
@@ -325,270 +348,73 @@ void lb_reinit_parameters(LB_Parameters &lb_parameters) {
   }
 }
 
+/** Select the communication bound to the populations @p lb_fluid. */
+static HaloCommunicator &
+halo_comm_for(std::array<HaloCommunicator, 2> &comms,
+              const LB_Fluid &lb_fluid) {
+  return (comms[0].base() == lb_fluid[0].data()) ? comms[0] : comms[1];
+}
+
 /** Halo communication for push scheme */
-static void halo_push_communication(LB_Fluid &lb_fluid,
-                                    const Lattice &lb_lattice) {
-  Lattice::index_t index;
-  int x, y, z, count;
-  int rnode, snode;
-  double *buffer;
-  MPI_Status status;
+static void halo_push_communication(LB_Fluid &lb_fluid) {
+  halo_comm_for(push_halo_comm, lb_fluid).communicate();
+}
 
-  auto const yperiod = lb_lattice.halo_grid[0];
-  auto const zperiod = lb_lattice.halo_grid[0] * lb_lattice.halo_grid[1];
+void lb_update_halo() {
+  halo_comm_for(update_halo_comm, lbfluid).communicate();
+}
 
+void lb_collect_halo_force_density() {
+  auto const &halo_grid = lblattice.halo_grid;
   auto const node_neighbors = calc_node_neighbors(comm_cart);
+  MPI_Status status;
 
-  /***************
-   * X direction *
-   ***************/
-  count = 5 * lb_lattice.halo_grid[1] * lb_lattice.halo_grid[2];
-  std::vector<double> sbuf(count);
-  std::vector<double> rbuf(count);
-
-  /* send to right, recv from left i = 1, 7, 9, 11, 13 */
-  snode = node_neighbors[1];
-  rnode = node_neighbors[0];
-
-  buffer = sbuf.data();
-  index = get_linear_index(lb_lattice.grid[0] + 1, 0, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-      buffer[0] = lb_fluid[1][index];
-      buffer[1] = lb_fluid[7][index];
-      buffer[2] = lb_fluid[9][index];
-      buffer[3] = lb_fluid[11][index];
-      buffer[4] = lb_fluid[13][index];
-      buffer += 5;
-
-      index += yperiod;
-    }
-  }
-
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-               comm_cart, &status);
-
-  buffer = rbuf.data();
-  index = get_linear_index(1, 0, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-      lb_fluid[1][index] = buffer[0];
-      lb_fluid[7][index] = buffer[1];
-      lb_fluid[9][index] = buffer[2];
-      lb_fluid[11][index] = buffer[3];
-      lb_fluid[13][index] = buffer[4];
-      buffer += 5;
-
-      index += yperiod;
-    }
-  }
-
-  /* send to left, recv from right i = 2, 8, 10, 12, 14 */
-  snode = node_neighbors[0];
-  rnode = node_neighbors[1];
-
-  buffer = sbuf.data();
-  index = get_linear_index(0, 0, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-      buffer[0] = lb_fluid[2][index];
-      buffer[1] = lb_fluid[8][index];
-      buffer[2] = lb_fluid[10][index];
-      buffer[3] = lb_fluid[12][index];
-      buffer[4] = lb_fluid[14][index];
-      buffer += 5;
-
-      index += yperiod;
-    }
-  }
-
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-               comm_cart, &status);
-
-  buffer = rbuf.data();
-  index = get_linear_index(lb_lattice.grid[0], 0, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-      lb_fluid[2][index] = buffer[0];
-      lb_fluid[8][index] = buffer[1];
-      lb_fluid[10][index] = buffer[2];
-      lb_fluid[12][index] = buffer[3];
-      lb_fluid[14][index] = buffer[4];
-      buffer += 5;
-
-      index += yperiod;
-    }
-  }
-
-  /***************
-   * Y direction *
-   ***************/
-  count = 5 * lb_lattice.halo_grid[0] * lb_lattice.halo_grid[2];
-  sbuf.resize(count);
-  rbuf.resize(count);
-
-  /* send to right, recv from left i = 3, 7, 10, 15, 17 */
-  snode = node_neighbors[3];
-  rnode = node_neighbors[2];
-
-  buffer = sbuf.data();
-  index = get_linear_index(0, lb_lattice.grid[1] + 1, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      buffer[0] = lb_fluid[3][index];
-      buffer[1] = lb_fluid[7][index];
-      buffer[2] = lb_fluid[10][index];
-      buffer[3] = lb_fluid[15][index];
-      buffer[4] = lb_fluid[17][index];
-      buffer += 5;
-
-      ++index;
-    }
-    index += zperiod - lb_lattice.halo_grid[0];
-  }
-
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-               comm_cart, &status);
-
-  buffer = rbuf.data();
-  index = get_linear_index(0, 1, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      lb_fluid[3][index] = buffer[0];
-      lb_fluid[7][index] = buffer[1];
-      lb_fluid[10][index] = buffer[2];
-      lb_fluid[15][index] = buffer[3];
-      lb_fluid[17][index] = buffer[4];
-      buffer += 5;
-
-      ++index;
-    }
-    index += zperiod - lb_lattice.halo_grid[0];
-  }
-
-  /* send to left, recv from right i = 4, 8, 9, 16, 18 */
-  snode = node_neighbors[2];
-  rnode = node_neighbors[3];
-
-  buffer = sbuf.data();
-  index = get_linear_index(0, 0, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      buffer[0] = lb_fluid[4][index];
-      buffer[1] = lb_fluid[8][index];
-      buffer[2] = lb_fluid[9][index];
-      buffer[3] = lb_fluid[16][index];
-      buffer[4] = lb_fluid[18][index];
-      buffer += 5;
-
-      ++index;
-    }
-    index += zperiod - lb_lattice.halo_grid[0];
-  }
-
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-               comm_cart, &status);
-
-  buffer = rbuf.data();
-  index = get_linear_index(0, lb_lattice.grid[1], 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      lb_fluid[4][index] = buffer[0];
-      lb_fluid[8][index] = buffer[1];
-      lb_fluid[9][index] = buffer[2];
-      lb_fluid[16][index] = buffer[3];
-      lb_fluid[18][index] = buffer[4];
-      buffer += 5;
-
-      ++index;
-    }
-    index += zperiod - lb_lattice.halo_grid[0];
-  }
-
-  /***************
-   * Z direction *
-   ***************/
-  count = 5 * lb_lattice.halo_grid[0] * lb_lattice.halo_grid[1];
-  sbuf.resize(count);
-  rbuf.resize(count);
-
-  /* send to right, recv from left i = 5, 11, 14, 15, 18 */
-  snode = node_neighbors[5];
-  rnode = node_neighbors[4];
-
-  buffer = sbuf.data();
-  index = get_linear_index(0, 0, lb_lattice.grid[2] + 1, lb_lattice.halo_grid);
-  for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      buffer[0] = lb_fluid[5][index];
-      buffer[1] = lb_fluid[11][index];
-      buffer[2] = lb_fluid[14][index];
-      buffer[3] = lb_fluid[15][index];
-      buffer[4] = lb_fluid[18][index];
-      buffer += 5;
-
-      ++index;
-    }
-  }
-
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-               comm_cart, &status);
-
-  buffer = rbuf.data();
-  index = get_linear_index(0, 0, 1, lb_lattice.halo_grid);
-  for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      lb_fluid[5][index] = buffer[0];
-      lb_fluid[11][index] = buffer[1];
-      lb_fluid[14][index] = buffer[2];
-      lb_fluid[15][index] = buffer[3];
-      lb_fluid[18][index] = buffer[4];
-      buffer += 5;
-
-      ++index;
-    }
-  }
+  /* The directions are processed one after the other on full planes of
+   * the halo grid, such that the contributions to edge and corner halo
+   * nodes are passed on to the diagonal neighbors. */
+  for (int dir = 0; dir < 3; dir++) {
+    auto const dir1 = (dir + 1) % 3;
+    auto const dir2 = (dir + 2) % 3;
+    auto const count = 3 * halo_grid[dir1] * halo_grid[dir2];
+    std::vector<double> sbuf(count);
+    std::vector<double> rbuf(count);
+
+    auto for_each_in_plane = [&](int plane, auto &&op) {
+      Utils::Vector3i ind;
+      ind[dir] = plane;
+      for (ind[dir2] = 0; ind[dir2] < halo_grid[dir2]; ind[dir2]++) {
+        for (ind[dir1] = 0; ind[dir1] < halo_grid[dir1]; ind[dir1]++) {
+          op(lbfields[get_linear_index(ind, halo_grid)].force_density);
+        }
+      }
+    };
+
+    /* send the left halo to the left, recv from right,
+     * then the right halo to the right, recv from left */
+    for (int lr = 0; lr < 2; lr++) {
+      auto const s_plane = (lr == 0) ? 0 : lblattice.grid[dir] + 1;
+      auto const r_plane = (lr == 0) ? lblattice.grid[dir] : 1;
+      auto const snode = node_neighbors[2 * dir + lr];
+      auto const rnode = node_neighbors[2 * dir + 1 - lr];
+
+      auto buffer = sbuf.data();
+      for_each_in_plane(s_plane, [&](Utils::Vector3d &force_density) {
+        for (int i = 0; i < 3; i++) {
+          *buffer++ = force_density[i] - lbpar.ext_force_density[i];
+        }
+        force_density = lbpar.ext_force_density;
+      });
 
-  /* send to left, recv from right i = 6, 12, 13, 16, 17 */
-  snode = node_neighbors[4];
-  rnode = node_neighbors[5];
-
-  buffer = sbuf.data();
-  index = get_linear_index(0, 0, 0, lb_lattice.halo_grid);
-  for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      buffer[0] = lb_fluid[6][index];
-      buffer[1] = lb_fluid[12][index];
-      buffer[2] = lb_fluid[13][index];
-      buffer[3] = lb_fluid[16][index];
-      buffer[4] = lb_fluid[17][index];
-      buffer += 5;
-
-      ++index;
-    }
-  }
+      MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
+                   rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
+                   comm_cart, &status);
 
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-               comm_cart, &status);
-
-  buffer = rbuf.data();
-  index = get_linear_index(0, 0, lb_lattice.grid[2], lb_lattice.halo_grid);
-  for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      lb_fluid[6][index] = buffer[0];
-      lb_fluid[12][index] = buffer[1];
-      lb_fluid[13][index] = buffer[2];
-      lb_fluid[16][index] = buffer[3];
-      lb_fluid[17][index] = buffer[4];
-      buffer += 5;
-
-      ++index;
+      buffer = rbuf.data();
+      for_each_in_plane(r_plane, [&](Utils::Vector3d &force_density) {
+        for (int i = 0; i < 3; i++) {
+          force_density[i] += *buffer++;
+        }
+      });
     }
   }
 }
@@ -612,6 +438,7 @@ void lb_sanity_checks(const LB_Parameters &lb_parameters) {
   if (cell_structure.decomposition_type() != CELL_STRUCTURE_DOMDEC) {
     runtimeErrorMsg() << "LB requires domain-decomposition cellsystem";
   }
+  lb_refinement_sanity_checks();
 }
 
 uint64_t lb_fluid_get_rng_state() {
@@ -630,58 +457,65 @@ void lb_fluid_set_rng_state(uint64_t counter) {
   mpi_set_lb_fluid_counter(counter);
 }
 
+/** Whether the collisions run concurrently with the force calculation. */
+static bool lb_concurrent_update = false;
+
+bool lb_get_concurrent_update() { return lb_concurrent_update; }
+
+void mpi_set_lb_concurrent_update_local(bool concurrent) {
+  lb_concurrent_update = concurrent;
+}
+
+REGISTER_CALLBACK(mpi_set_lb_concurrent_update_local)
+
+void mpi_set_lb_concurrent_update(bool concurrent) {
+  mpi_call_all(mpi_set_lb_concurrent_update_local, concurrent);
+}
+
 /***********************************************************************/
 
 /** Set up the structures for exchange of the halo regions.
  *  See also \ref halo.cpp
+ *
+ *  After the streaming, only the populations that crossed a face of the
+ *  local domain are pushed to the neighbor. The update of the halo
+ *  transfers all populations.
  */
-void lb_prepare_communication(HaloCommunicator &halo_comm,
-                              const Lattice &lb_lattice) {
-  HaloCommunicator comm = HaloCommunicator(0);
-
-  /* since the data layout is a structure of arrays, we have to
-   * generate a communication for this structure: first we generate
-   * the communication for one of the arrays (the 0-th velocity
-   * population), then we replicate this communication for the other
-   * velocity indices by constructing appropriate vector
-   * datatypes */
-
-  /* prepare the communication for a single velocity */
-  prepare_halo_communication(comm, lb_lattice, MPI_DOUBLE, node_grid);
-
-  halo_comm.num = comm.num;
-  halo_comm.halo_info.resize(comm.num);
-
-  /* replicate the halo structure */
-  for (int i = 0; i < comm.num; i++) {
-    HaloInfo &hinfo = halo_comm.halo_info[i];
-
-    hinfo.source_node = comm.halo_info[i].source_node;
-    hinfo.dest_node = comm.halo_info[i].dest_node;
-    hinfo.s_offset = comm.halo_info[i].s_offset;
-    hinfo.r_offset = comm.halo_info[i].r_offset;
-    hinfo.type = comm.halo_info[i].type;
-
-    /* generate the vector datatype for the structure of lattices we
-     * have to use hvector here because the extent of the subtypes
-     * does not span the full lattice and hence we cannot get the
-     * correct vskip out of them */
-
-    MPI_Aint lower;
-    MPI_Aint extent;
-    MPI_Type_get_extent(MPI_DOUBLE, &lower, &extent);
-    MPI_Type_create_hvector(D3Q19::n_vel, 1,
-                            lb_lattice.halo_grid_volume * extent,
-                            comm.halo_info[i].datatype, &hinfo.datatype);
-    MPI_Type_commit(&hinfo.datatype);
-
-    hinfo.fieldtype = std::make_shared<FieldType>(
-        D3Q19::n_vel, 1,
-        static_cast<int>(lb_lattice.halo_grid_volume * sizeof(double)), false,
-        comm.halo_info[i].fieldtype);
+static void lb_prepare_communication(const Lattice &lb_lattice) {
+  auto const &grid = lb_lattice.grid;
+
+  std::vector<int> all_populations(D3Q19::n_vel);
+  std::iota(all_populations.begin(), all_populations.end(), 0);
+
+  std::vector<HaloFace> push_faces;
+  std::vector<HaloFace> update_faces;
+  for (int dir = 0; dir < 3; dir++) {
+    std::vector<int> to_right;
+    std::vector<int> to_left;
+    for (int i = 0; i < D3Q19::n_vel; i++) {
+      if (D3Q19::c[i][dir] == 1)
+        to_right.push_back(i);
+      if (D3Q19::c[i][dir] == -1)
+        to_left.push_back(i);
+    }
+
+    push_faces.push_back({dir, 1, grid[dir] + 1, 1, to_right});
+    push_faces.push_back({dir, 0, 0, grid[dir], to_left});
+    update_faces.push_back({dir, 0, 1, grid[dir] + 1, all_populations});
+    update_faces.push_back({dir, 1, grid[dir], 0, all_populations});
   }
 
-  release_halo_communication(comm);
+  /* the persistent communications are bound to the population buffers */
+  std::array<lb_float *, 2> const buffers = {
+      {lbfluid_a.origin(), lbfluid_b.origin()}};
+  auto const datatype =
+      std::is_same<lb_float, float>::value ? MPI_FLOAT : MPI_DOUBLE;
+  for (int i = 0; i < 2; i++) {
+    push_halo_comm[i] =
+        HaloCommunicator(lb_lattice, buffers[i], datatype, push_faces, false);
+    update_halo_comm[i] =
+        HaloCommunicator(lb_lattice, buffers[i], datatype, update_faces, true);
+  }
 }
 
 /***********************************************************************/
@@ -866,6 +700,19 @@ std::array<T, 19> lb_apply_forces(const std::array<T, 19> &modes,
            modes[14], modes[15], modes[16], modes[17], modes[18]}};
 }
 
+std::array<double, 19> lb_collide_modes(std::array<double, 19> const &modes,
+                                        Utils::Vector3d const &force_density,
+                                        LB_Parameters const &lb_parameters) {
+  auto const relaxed_modes =
+      lb_relax_modes(modes, force_density, lb_parameters);
+  return lb_apply_forces(relaxed_modes, lb_parameters, force_density);
+}
+
+std::array<double, 19>
+lb_calc_populations(std::array<double, 19> const &modes) {
+  return lb_calc_n_from_m(modes);
+}
+
 /**
  * @brief Relative index for the next node for each lattice velocity.
  *
@@ -890,70 +737,221 @@ template <typename T>
 void lb_stream(LB_Fluid &lb_fluid, const std::array<T, 19> &populations,
                size_t index, std::array<ptrdiff_t, 19> const &offsets) {
   for (int i = 0; i < populations.size(); i++) {
-    lb_fluid[i][index + offsets[i]] = populations[i];
+    lb_fluid[i][index + offsets[i]] = static_cast<lb_float>(populations[i]);
   }
 }
 
-/* Collisions and streaming (push scheme) */
-void lb_integrate() {
-  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
-  /* loop over all lattice cells (halo excluded) */
-#ifdef LB_BOUNDARIES
-  for (auto &lbboundary : LBBoundaries::lbboundaries) {
-    (*lbboundary).reset_force();
+#ifdef LB_SINGLE_PRECISION
+/** @brief Mass and momentum density lost by rounding the populations to
+ *  single precision.
+ *
+ *  The difference between a double and its rounding to float is exactly
+ *  representable, so adding it back to the modes in the next collision
+ *  conserves the mass and the momentum of the fluid to double precision.
+ *
+ *  @param populations  Post-collision populations.
+ *  @return Mass density and momentum density of the rounding errors.
+ */
+Utils::Vector4d
+lb_rounding_residual(std::array<double, 19> const &populations) {
+  Utils::Vector4d residual{};
+  for (int i = 0; i < populations.size(); i++) {
+    auto const delta =
+        populations[i] - static_cast<lb_float>(populations[i]);
+    residual[0] += delta;
+    for (int j = 0; j < 3; j++) {
+      residual[j + 1] += D3Q19::c[i][j] * delta;
+    }
   }
+  return residual;
+}
+#endif
+
+/** Run of consecutive local fluid nodes along x. */
+struct LB_FluidRun {
+  /** Index of the first node. */
+  Lattice::index_t index;
+  /** Number of nodes. */
+  int length;
+};
+
+/** Runs of local fluid nodes, in the order of the linear index. */
+static std::vector<LB_FluidRun> lb_fluid_runs;
+
+#ifdef LB_BOUNDARIES
+/** Boundary node with links to local fluid nodes. */
+struct LB_BoundaryNode {
+  Lattice::index_t index;
+  /** Boundary number, starting at 1. */
+  int boundary;
+  /** Range of the velocities of the links in @ref lb_fluid_links. */
+  std::size_t links_begin;
+  std::size_t links_end;
+};
+
+/** Boundary nodes (halo included) with at least one fluid neighbor. */
+static std::vector<LB_BoundaryNode> lb_boundary_nodes;
+/** Velocities pointing from a local fluid node into a boundary node. */
+static std::vector<int> lb_fluid_links;
+/** Links between a boundary node and a local boundary node, given
+ *  as the index of the former and the velocity from the latter.
+ */
+static std::vector<std::pair<Lattice::index_t, int>> lb_solid_links;
 #endif // LB_BOUNDARIES
 
-  auto const next_offsets = lb_next_offsets(lblattice, D3Q19::c);
+void lb_update_node_lists() {
+  auto const &grid = lblattice.grid;
+  auto const &halo_grid = lblattice.halo_grid;
 
-  Lattice::index_t index = lblattice.halo_offset;
-  for (int z = 1; z <= lblattice.grid[2]; z++) {
-    for (int y = 1; y <= lblattice.grid[1]; y++) {
-      for (int x = 1; x <= lblattice.grid[0]; x++) {
-        // as we only want to apply this to non-boundary nodes we can throw out
-        // the if-clause if we have a non-bounded domain
+  lb_fluid_runs.clear();
+  for (int z = 1; z <= grid[2]; z++) {
+    for (int y = 1; y <= grid[1]; y++) {
+      auto const row = get_linear_index(1, y, z, halo_grid);
 #ifdef LB_BOUNDARIES
-        if (!lbfields[index].boundary)
+      for (int x = 0; x < grid[0];) {
+        if (lbfields[row + x].boundary) {
+          x++;
+          continue;
+        }
+        auto const begin = x;
+        while (x < grid[0] and not lbfields[row + x].boundary)
+          x++;
+        lb_fluid_runs.push_back({row + begin, x - begin});
+      }
+#else
+      lb_fluid_runs.push_back({row, grid[0]});
+#endif // LB_BOUNDARIES
+    }
+  }
+
+#ifdef LB_BOUNDARIES
+  auto const next = lb_next_offsets(lblattice, D3Q19::c);
+
+  lb_boundary_nodes.clear();
+  lb_fluid_links.clear();
+  lb_solid_links.clear();
+  for (int z = 0; z < halo_grid[2]; z++) {
+    for (int y = 0; y < halo_grid[1]; y++) {
+      for (int x = 0; x < halo_grid[0]; x++) {
+        auto const k = get_linear_index(x, y, z, halo_grid);
+        if (not lbfields[k].boundary)
+          continue;
+
+        auto const links_begin = lb_fluid_links.size();
+        for (int i = 0; i < 19; i++) {
+          auto const ci = D3Q19::c[i];
+          /* only links to local nodes */
+          if (x - ci[0] > 0 && x - ci[0] < grid[0] + 1 && y - ci[1] > 0 &&
+              y - ci[1] < grid[1] + 1 && z - ci[2] > 0 &&
+              z - ci[2] < grid[2] + 1) {
+            if (lbfields[k - next[i]].boundary) {
+              lb_solid_links.emplace_back(k, i);
+            } else {
+              lb_fluid_links.push_back(i);
+            }
+          }
+        }
+        if (lb_fluid_links.size() != links_begin) {
+          lb_boundary_nodes.push_back(
+              {k, lbfields[k].boundary, links_begin, lb_fluid_links.size()});
+        }
+      }
+    }
+  }
 #endif // LB_BOUNDARIES
-        {
-          /* calculate modes locally */
-          auto const modes = lb_calc_modes(index, lbfluid);
+}
 
-          /* deterministic collisions */
-          auto const relaxed_modes =
-              lb_relax_modes(modes, lbfields[index].force_density, lbpar);
+/**
+ * @brief Collide a run of fluid nodes and stream the populations
+ *        to their neighbors (push scheme).
+ *
+ * Only the populations streamed from the nodes of the run and the
+ * fields of these nodes are written, so that different runs can be
+ * processed concurrently.
+ *
+ * @param run     Fluid nodes.
+ * @param offsets Relative index of the next node for each velocity.
+ */
+void lb_collide_stream_run(LB_FluidRun const &run,
+                           std::array<ptrdiff_t, 19> const &offsets) {
+  for (auto node = run.index; node < run.index + run.length; node++) {
+    /* calculate modes locally */
+    auto modes = lb_calc_modes(node, lbfluid);
+
+#ifdef LB_SINGLE_PRECISION
+    /* mass and momentum lost when this node was last rounded */
+    for (int i = 0; i < 4; i++) {
+      modes[i] += lbfields[node].rounding_residual[i];
+    }
+#endif
+
+    /* deterministic collisions */
+    auto const relaxed_modes =
+        lb_relax_modes(modes, lbfields[node].force_density, lbpar);
 
-          /* fluctuating hydrodynamics */
-          auto const thermalized_modes = lb_thermalize_modes(
-              index, relaxed_modes, lbpar, rng_counter_fluid);
+    /* fluctuating hydrodynamics */
+    auto const thermalized_modes =
+        lb_thermalize_modes(node, relaxed_modes, lbpar, rng_counter_fluid);
 
-          /* apply forces */
-          auto const modes_with_forces = lb_apply_forces(
-              thermalized_modes, lbpar, lbfields[index].force_density);
+    /* apply forces */
+    auto const modes_with_forces = lb_apply_forces(
+        thermalized_modes, lbpar, lbfields[node].force_density);
 
 #ifdef VIRTUAL_SITES_INERTIALESS_TRACERS
-          // Safeguard the node forces so that we can later use them for the IBM
-          // particle update
-          lbfields[index].force_density_buf = lbfields[index].force_density;
+    // Safeguard the node forces so that we can later use them for the IBM
+    // particle update
+    lbfields[node].force_density_buf = lbfields[node].force_density;
 #endif
 
-          /* reset the force density */
-          lbfields[index].force_density = lbpar.ext_force_density;
+    /* reset the force density */
+    lbfields[node].force_density = lbpar.ext_force_density;
 
-          /* transform back to populations and streaming */
-          auto const populations = lb_calc_n_from_m(modes_with_forces);
-          lb_stream(lbfluid_post, populations, index, next_offsets);
-        }
+    /* transform back to populations and streaming */
+    auto const populations = lb_calc_n_from_m(modes_with_forces);
+#ifdef LB_SINGLE_PRECISION
+    lbfields[node].rounding_residual = lb_rounding_residual(populations);
+#endif
+    lb_stream(lbfluid_post, populations, node, offsets);
+  }
+}
 
-        ++index; /* next node */
-      }
-      index += 2; /* skip halo region */
-    }
-    index += 2 * lblattice.halo_grid[0]; /* skip halo region */
+/** @brief Reset the boundary forces and save the state needed by the
+ *  refined region, before the collisions of a time step.
+ */
+static void lb_integrate_prepare() {
+#ifdef LB_BOUNDARIES
+  for (auto &lbboundary : LBBoundaries::lbboundaries) {
+    (*lbboundary).reset_force();
   }
+#endif // LB_BOUNDARIES
+
+  lb_refinement_save_coarse_state();
+}
+
+/** @brief Collide the local fluid nodes and stream into the post-collision
+ *  populations. Does not communicate.
+ */
+static void lb_collide_stream() {
+  auto const next_offsets = lb_next_offsets(lblattice, D3Q19::c);
+  auto const n_runs = static_cast<int>(lb_fluid_runs.size());
 
+  /* The runs only write to the populations streamed from their own
+   * nodes, and can hence be processed concurrently. Boundary nodes
+   * are not part of any run. */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int i = 0; i < n_runs; i++) {
+    lb_collide_stream_run(lb_fluid_runs[i], next_offsets);
+  }
+}
+
+/** @brief Exchange the halo regions, apply the boundary conditions and
+ *  make the post-collision populations the current ones.
+ */
+static void lb_integrate_complete() {
   /* exchange halo regions */
-  halo_push_communication(lbfluid_post, lblattice);
+  halo_push_communication(lbfluid_post);
 
 #ifdef LB_BOUNDARIES
   /* boundary conditions for links */
@@ -963,14 +961,48 @@ void lb_integrate() {
   /* swap the pointers for old and new population fields */
   std::swap(lbfluid, lbfluid_post);
 
-  halo_communication(update_halo_comm,
-                     reinterpret_cast<char *>(lbfluid[0].data()));
+  lb_update_halo();
+
+  /* fine time steps of the refined region */
+  lb_refinement_integrate();
 
 #ifdef ADDITIONAL_CHECKS
   lb_check_halo_regions(lbfluid, lblattice);
 #endif
 }
 
+/* Collisions and streaming (push scheme) */
+void lb_integrate() {
+  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
+  lb_integrate_prepare();
+  lb_collide_stream();
+  lb_integrate_complete();
+}
+
+/** Worker thread of a pending concurrent time step. */
+static std::thread lb_collide_stream_thread;
+
+void lb_integrate_begin() {
+  assert(not lb_collide_stream_thread.joinable());
+  lb_integrate_prepare();
+  lb_collide_stream_thread = std::thread(lb_collide_stream);
+}
+
+bool lb_integrate_end() {
+  if (not lb_collide_stream_thread.joinable())
+    return false;
+
+  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
+  lb_collide_stream_thread.join();
+  lb_integrate_complete();
+  return true;
+}
+
+void lb_integrate_abort() {
+  if (lb_collide_stream_thread.joinable())
+    lb_collide_stream_thread.join();
+}
+
 /***********************************************************************/
 /** \name Coupling part */
 /***********************************************************************/
@@ -1251,39 +1283,30 @@ void lb_bounce_back(LB_Fluid &lb_fluid, const LB_Parameters &lb_parameters,
   static constexpr int reverse[] = {0, 2,  1,  4,  3,  6,  5,  8,  7, 10,
                                     9, 12, 11, 14, 13, 16, 15, 18, 17};
 
-  /* bottom-up sweep */
-  for (int z = 0; z < lblattice.grid[2] + 2; z++) {
-    for (int y = 0; y < lblattice.grid[1] + 2; y++) {
-      for (int x = 0; x < lblattice.grid[0] + 2; x++) {
-        auto const k = get_linear_index(x, y, z, lblattice.halo_grid);
-
-        if (lb_fields[k].boundary) {
-          Utils::Vector3d boundary_force = {};
-          for (int i = 0; i < 19; i++) {
-            auto const ci = D3Q19::c[i];
-
-            if (x - ci[0] > 0 && x - ci[0] < lblattice.grid[0] + 1 &&
-                y - ci[1] > 0 && y - ci[1] < lblattice.grid[1] + 1 &&
-                z - ci[2] > 0 && z - ci[2] < lblattice.grid[2] + 1) {
-              if (!lb_fields[k - next[i]].boundary) {
-                auto const population_shift =
-                    -lb_parameters.density * 2 * D3Q19::w[i] *
-                    (ci * lb_fields[k].slip_velocity) /
-                    D3Q19::c_sound_sq<double>;
-
-                boundary_force += (2 * lb_fluid[i][k] + population_shift) * ci;
-                lb_fluid[reverse[i]][k - next[i]] =
-                    lb_fluid[i][k] + population_shift;
-              } else {
-                lb_fluid[reverse[i]][k - next[i]] = lb_fluid[i][k] = 0.0;
-              }
-            }
-          }
-          LBBoundaries::lbboundaries[lb_fields[k].boundary - 1]->force() +=
-              boundary_force;
-        }
-      }
+  for (auto const &node : lb_boundary_nodes) {
+    auto const k = node.index;
+    Utils::Vector3d boundary_force = {};
+    for (auto l = node.links_begin; l < node.links_end; l++) {
+      auto const i = lb_fluid_links[l];
+      auto const ci = D3Q19::c[i];
+      auto const population_shift = -lb_parameters.density * 2 * D3Q19::w[i] *
+                                    (ci * lb_fields[k].slip_velocity) /
+                                    D3Q19::c_sound_sq<double>;
+
+      auto const population = static_cast<double>(lb_fluid[i][k]);
+
+      boundary_force += (2 * population + population_shift) * ci;
+      lb_fluid[reverse[i]][k - next[i]] =
+          static_cast<lb_float>(population + population_shift);
     }
+    LBBoundaries::lbboundaries[node.boundary - 1]->force() += boundary_force;
+  }
+
+  /* no populations are exchanged between boundary nodes */
+  for (auto const &link : lb_solid_links) {
+    auto const k = link.first;
+    auto const i = link.second;
+    lb_fluid[reverse[i]][k - next[i]] = lb_fluid[i][k] = 0.0;
   }
 }
 #endif // LB_BOUNDARIES
@@ -1296,18 +1319,13 @@ void lb_bounce_back(LB_Fluid &lb_fluid, const LB_Parameters &lb_parameters,
  */
 Utils::Vector3d lb_calc_local_momentum_density(Lattice::index_t index,
                                                const LB_Fluid &lb_fluid) {
-  return {{lb_fluid[1][index] - lb_fluid[2][index] + lb_fluid[7][index] -
-               lb_fluid[8][index] + lb_fluid[9][index] - lb_fluid[10][index] +
-               lb_fluid[11][index] - lb_fluid[12][index] + lb_fluid[13][index] -
-               lb_fluid[14][index],
-           lb_fluid[3][index] - lb_fluid[4][index] + lb_fluid[7][index] -
-               lb_fluid[8][index] - lb_fluid[9][index] + lb_fluid[10][index] +
-               lb_fluid[15][index] - lb_fluid[16][index] + lb_fluid[17][index] -
-               lb_fluid[18][index],
-           lb_fluid[5][index] - lb_fluid[6][index] + lb_fluid[11][index] -
-               lb_fluid[12][index] - lb_fluid[13][index] + lb_fluid[14][index] +
-               lb_fluid[15][index] - lb_fluid[16][index] - lb_fluid[17][index] +
-               lb_fluid[18][index]}};
+  auto const f = [&](int i) { return static_cast<double>(lb_fluid[i][index]); };
+  return {{f(1) - f(2) + f(7) - f(8) + f(9) - f(10) + f(11) - f(12) + f(13) -
+               f(14),
+           f(3) - f(4) + f(7) - f(8) - f(9) + f(10) + f(15) - f(16) + f(17) -
+               f(18),
+           f(5) - f(6) + f(11) - f(12) - f(13) + f(14) + f(15) - f(16) - f(17) +
+               f(18)}};
 }
 
 /** Calculate momentum of the LB fluid.
@@ -1328,6 +1346,11 @@ void lb_calc_fluid_momentum(double *result, const LB_Parameters &lb_parameters,
 
         momentum_density = lb_calc_local_momentum_density(index, lbfluid);
         momentum += momentum_density + .5 * lb_fields[index].force_density;
+#ifdef LB_SINGLE_PRECISION
+        momentum += Utils::Vector3d{lb_fields[index].rounding_residual[1],
+                                    lb_fields[index].rounding_residual[2],
+                                    lb_fields[index].rounding_residual[3]};
+#endif
       }
     }
   }
@@ -42,8 +42,6 @@
 #include "grid_based_algorithms/lb-d3q19.hpp"
 #include "grid_based_algorithms/lb_constants.hpp"
 
-#include "halo.hpp"
-
 #include <utils/Counter.hpp>
 #include <utils/Span.hpp>
 #include <utils/Vector.hpp>
@@ -74,6 +72,11 @@ struct LB_FluidNode {
   // Therefore we save it here
   Utils::Vector3d force_density_buf;
 #endif
+#ifdef LB_SINGLE_PRECISION
+  /** mass and momentum density lost when the populations were rounded to
+   *  single precision, they are added back in the next collision */
+  Utils::Vector4d rounding_residual;
+#endif
 };
 
 /** Data structure holding the parameters for the Lattice Boltzmann system. */
@@ -133,9 +136,6 @@ extern LB_Parameters lbpar;
 /** The underlying lattice */
 extern Lattice lblattice;
 
-/** Communicator for halo exchange between processors */
-extern HaloCommunicator update_halo_comm;
-
 void lb_init(const LB_Parameters &lb_parameters);
 
 void lb_reinit_fluid(std::vector<LB_FluidNode> &lb_fields,
@@ -144,7 +144,29 @@ void lb_reinit_fluid(std::vector<LB_FluidNode> &lb_fields,
 
 void lb_reinit_parameters(LB_Parameters &lb_parameters);
 
-using LB_Fluid = std::array<Utils::Span<double>, 19>;
+/** @brief Rebuild the lists of local fluid nodes and boundary links.
+ *
+ *  The collision only visits the listed fluid nodes, and the bounce-back
+ *  only the listed links, hence this has to be called whenever the
+ *  boundary flags in @ref lbfields change.
+ */
+void lb_update_node_lists();
+
+/** @brief Update the halo nodes of the populations from the nodes of the
+ *  neighboring domains they are the image of. Has to be called on all
+ *  nodes.
+ */
+void lb_update_halo();
+
+/** @brief Add the force density in the halo nodes to the nodes of the
+ *  neighboring domains they are the image of.
+ *
+ *  The force density of the halo nodes is reset to the external force
+ *  density. Has to be called on all nodes.
+ */
+void lb_collect_halo_force_density();
+
+using LB_Fluid = std::array<Utils::Span<lb_float>, 19>;
 extern LB_Fluid lbfluid;
 
 class LB_Fluid_Ref {
@@ -162,8 +184,8 @@ private:
 
 namespace Utils {
 
-template <std::size_t I> auto get(const LB_Fluid_Ref &lb_fluid) {
-  return lb_fluid.get<I>();
+template <std::size_t I> double get(const LB_Fluid_Ref &lb_fluid) {
+  return static_cast<double>(lb_fluid.get<I>());
 }
 
 } // namespace Utils
@@ -184,6 +206,36 @@ extern std::vector<LB_FluidNode> lbfields;
  */
 void lb_integrate();
 
+/** Start the time step of the lattice-Boltzmann system on a worker
+ *  thread. The collisions and the streaming of the local nodes run
+ *  concurrently with the caller, which must not access the fluid until
+ *  the time step is completed by @ref lb_integrate_end.
+ */
+void lb_integrate_begin();
+
+/** Complete a time step started by @ref lb_integrate_begin: wait for the
+ *  worker thread, exchange the halo regions and apply the boundary
+ *  conditions. Has to be called on all nodes.
+ *  @return Whether a time step was pending.
+ */
+bool lb_integrate_end();
+
+/** Discard a time step started by @ref lb_integrate_begin: wait for the
+ *  worker thread without communicating, and leave the fluid in the state
+ *  before the time step. Only affects the local node.
+ */
+void lb_integrate_abort();
+
+/** @brief Whether the time steps run concurrently with the force
+ *  calculation.
+ */
+bool lb_get_concurrent_update();
+
+/** @brief Set on all nodes whether the time steps run concurrently with
+ *  the force calculation.
+ */
+void mpi_set_lb_concurrent_update(bool concurrent);
+
 void lb_sanity_checks(const LB_Parameters &lb_parameters);
 
 /** Sets the equilibrium distributions.
@@ -216,6 +268,21 @@ Utils::Vector6d lb_calc_pressure_tensor(std::array<double, 19> const &modes,
 std::array<double, 19> lb_calc_modes(Lattice::index_t index,
                                      const LB_Fluid &lb_fluid);
 
+/** Deterministic collision: relaxation of the modes and application of
+ *  the force density.
+ *
+ *  @param[in] modes          Pre-collision modes
+ *  @param[in] force_density  Force density of the node
+ *  @param[in] lb_parameters  LB parameters
+ *  @retval Post-collision modes.
+ */
+std::array<double, 19> lb_collide_modes(std::array<double, 19> const &modes,
+                                        Utils::Vector3d const &force_density,
+                                        LB_Parameters const &lb_parameters);
+
+/** Transformation of modes to populations. */
+std::array<double, 19> lb_calc_populations(std::array<double, 19> const &modes);
+
 /**
  * @brief Get the populations as a function of density, flux density and stress.
  * @param density fluid density
@@ -238,14 +305,13 @@ inline Utils::Vector19d lb_get_population(Lattice::index_t index) {
 inline void lb_set_population(Lattice::index_t index,
                               const Utils::Vector19d &pop) {
   for (int i = 0; i < D3Q19::n_vel; ++i) {
-    lbfluid[i][index] = pop[i] - D3Q19::coefficients[i][0] * lbpar.density;
+    lbfluid[i][index] = static_cast<lb_float>(
+        pop[i] - D3Q19::coefficients[i][0] * lbpar.density);
   }
 }
 
 uint64_t lb_fluid_get_rng_state();
 void lb_fluid_set_rng_state(uint64_t counter);
-void lb_prepare_communication(HaloCommunicator &halo_comm,
-                              const Lattice &lb_lattice);
 
 #ifdef LB_BOUNDARIES
 /** Bounce back boundary conditions.
@@ -252,6 +252,7 @@ void lb_init_boundaries() {
         }
       }
     }
+    lb_update_node_lists();
 #endif
   }
 }
@@ -38,6 +38,7 @@
 #ifndef LBBOUNDARIES_H
 #define LBBOUNDARIES_H
 
+#include "grid_based_algorithms/lb_constants.hpp"
 #include "lbboundaries/LBBoundary.hpp"
 
 #include "config.hpp"
@@ -49,7 +50,7 @@
 #include <vector>
 
 namespace LBBoundaries {
-using LB_Fluid = std::array<Utils::Span<double>, 19>;
+using LB_Fluid = std::array<Utils::Span<lb_float>, 19>;
 
 extern std::vector<std::shared_ptr<LBBoundary>> lbboundaries;
 #if defined(LB_BOUNDARIES) || defined(LB_BOUNDARIES_GPU)
@@ -23,6 +23,20 @@
 #ifndef LB_CONSTANTS_HPP
 #define LB_CONSTANTS_HPP
 
+#include "config.hpp"
+
+/** @brief Floating-point type of the stored CPU LB populations.
+ *
+ *  The populations are stored relative to the background density, which
+ *  keeps their magnitude small and retains the significant digits in
+ *  single precision. All arithmetic on them is done in double precision.
+ */
+#ifdef LB_SINGLE_PRECISION
+using lb_float = float;
+#else
+using lb_float = double;
+#endif
+
 /** @brief Parameter fields for lattice Boltzmann
  *
  *  Determine what actions have to take place upon change of the respective
@@ -24,13 +24,13 @@
 #include "electrokinetics.hpp"
 #include "errorhandling.hpp"
 #include "grid.hpp"
-#include "halo.hpp"
 #include "lb-d3q19.hpp"
 #include "lb.hpp"
 #include "lb_boundaries.hpp"
 #include "lb_collective_interface.hpp"
 #include "lb_constants.hpp"
 #include "lb_interpolation.hpp"
+#include "lb_refinement.hpp"
 #include "lbgpu.hpp"
 
 #include <utils/Vector.hpp>
@@ -44,6 +44,7 @@ using Utils::get_linear_index;
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 ActiveLB lattice_switch = ActiveLB::NONE;
 
@@ -70,6 +71,11 @@ void lb_lbfluid_integrate() {
 }
 
 void lb_lbfluid_propagate() {
+  if (lattice_switch == ActiveLB::CPU and lb_get_concurrent_update()) {
+    /* completed by lb_lbfluid_finish_propagation() */
+    lb_integrate_begin();
+    return;
+  }
   if (lattice_switch != ActiveLB::NONE) {
     lb_lbfluid_integrate();
     if (lb_lbfluid_get_kT() > 0.0) {
@@ -84,6 +90,15 @@ void lb_lbfluid_propagate() {
   }
 }
 
+void lb_lbfluid_finish_propagation() {
+  /* the collisions read the RNG counter until the time step is complete */
+  if (lb_integrate_end() and lbpar.kT > 0.0) {
+    rng_counter_fluid->increment();
+  }
+}
+
+void lb_lbfluid_abort_propagation() { lb_integrate_abort(); }
+
 /**
  * @brief Check the boundary velocities.
  * Sanity check if the velocity defined at LB boundaries is within the Mach
@@ -122,8 +137,7 @@ void lb_lbfluid_sanity_checks(double time_step) {
 
 void lb_lbfluid_on_integration_start() {
   if (lattice_switch == ActiveLB::CPU) {
-    halo_communication(update_halo_comm,
-                       reinterpret_cast<char *>(lbfluid[0].data()));
+    lb_update_halo();
   }
 }
 
@@ -469,6 +483,61 @@ void lb_lbfluid_set_kT(double kT) {
   }
 }
 
+void lb_lbfluid_set_refined_region(const Utils::Vector3i &lower,
+                                   const Utils::Vector3i &upper) {
+  if (lattice_switch == ActiveLB::GPU) {
+    throw std::runtime_error(
+        "LB grid refinement is only implemented for the CPU LB");
+  }
+  if (lattice_switch == ActiveLB::CPU) {
+    mpi_set_lb_refined_region(lower, upper);
+  } else {
+    throw NoLBActive();
+  }
+}
+
+void lb_lbfluid_set_concurrent_update(bool concurrent) {
+  if (lattice_switch == ActiveLB::GPU) {
+    throw std::runtime_error(
+        "Concurrent LB updates are only implemented for the CPU LB");
+  }
+  if (lattice_switch == ActiveLB::CPU) {
+    mpi_set_lb_concurrent_update(concurrent);
+  } else {
+    throw NoLBActive();
+  }
+}
+
+bool lb_lbfluid_get_concurrent_update() {
+  if (lattice_switch == ActiveLB::CPU) {
+    return lb_get_concurrent_update();
+  }
+  if (lattice_switch == ActiveLB::GPU) {
+    return false;
+  }
+  throw NoLBActive();
+}
+
+void lb_lbfluid_clear_refined_region() {
+  if (lattice_switch == ActiveLB::CPU) {
+    mpi_clear_lb_refined_region();
+  } else if (lattice_switch == ActiveLB::NONE) {
+    throw NoLBActive();
+  }
+}
+
+std::vector<Utils::Vector3i> lb_lbfluid_get_refined_region() {
+  if (lattice_switch == ActiveLB::NONE) {
+    throw NoLBActive();
+  }
+  if (lattice_switch == ActiveLB::CPU) {
+    if (auto const region = lb_refinement_get_region()) {
+      return {region->first, region->second};
+    }
+  }
+  return {};
+}
+
 double lb_lbfluid_get_kT() {
   if (lattice_switch == ActiveLB::GPU) {
 #ifdef CUDA
@@ -1219,11 +1288,10 @@ Utils::Vector3d lb_lbfluid_calc_fluid_momentum() {
 const Utils::Vector3d
 lb_lbfluid_get_interpolated_velocity(const Utils::Vector3d &pos) {
   auto const folded_pos = folded_position(pos, box_geo);
-  auto const interpolation_order = lb_lbinterpolation_get_interpolation_order();
   if (lattice_switch == ActiveLB::GPU) {
 #ifdef CUDA
     Utils::Vector3d interpolated_u{};
-    switch (interpolation_order) {
+    switch (lb_lbinterpolation_get_interpolation_order()) {
     case (InterpolationOrder::linear):
       lb_get_interpolated_velocity_gpu<8>(folded_pos.data(),
                                           interpolated_u.data(), 1);
@@ -1237,34 +1305,21 @@ lb_lbfluid_get_interpolated_velocity(const Utils::Vector3d &pos) {
 #endif
   }
   if (lattice_switch == ActiveLB::CPU) {
-    switch (interpolation_order) {
-    case (InterpolationOrder::quadratic):
-      throw std::runtime_error("The non-linear interpolation scheme is not "
-                               "implemented for the CPU LB.");
-    case (InterpolationOrder::linear):
-      return mpi_call(::Communication::Result::one_rank,
-                      mpi_lb_get_interpolated_velocity, folded_pos);
-    }
+    return mpi_call(::Communication::Result::one_rank,
+                    mpi_lb_get_interpolated_velocity, folded_pos);
   }
   throw NoLBActive();
 }
 
 double lb_lbfluid_get_interpolated_density(const Utils::Vector3d &pos) {
   auto const folded_pos = folded_position(pos, box_geo);
-  auto const interpolation_order = lb_lbinterpolation_get_interpolation_order();
   if (lattice_switch == ActiveLB::GPU) {
     throw std::runtime_error(
         "Density interpolation is not implemented for the GPU LB.");
   }
   if (lattice_switch == ActiveLB::CPU) {
-    switch (interpolation_order) {
-    case (InterpolationOrder::quadratic):
-      throw std::runtime_error("The non-linear interpolation scheme is not "
-                               "implemented for the CPU LB.");
-    case (InterpolationOrder::linear):
-      return mpi_call(::Communication::Result::one_rank,
-                      mpi_lb_get_interpolated_density, folded_pos);
-    }
+    return mpi_call(::Communication::Result::one_rank,
+                    mpi_lb_get_interpolated_density, folded_pos);
   }
   throw NoLBActive();
 }
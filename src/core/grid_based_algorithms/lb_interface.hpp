@@ -39,6 +39,25 @@ extern ActiveLB lattice_switch;
  */
 void lb_lbfluid_propagate();
 
+/**
+ * @brief Wait for the completion of a concurrent LB time step.
+ *
+ * With concurrent updates, @ref lb_lbfluid_propagate only starts the
+ * collisions on a worker thread, and the MD step continues. This function
+ * has to be called on all nodes before the fluid is accessed again.
+ * Does nothing if no time step is pending.
+ */
+void lb_lbfluid_finish_propagation();
+
+/**
+ * @brief Discard a pending concurrent LB time step.
+ *
+ * Joins the worker thread without communicating, e.g. while an exception
+ * propagates. The fluid keeps its state before the time step.
+ * Does nothing if no time step is pending.
+ */
+void lb_lbfluid_abort_propagation();
+
 /**
  * @brief Event handler for integration start.
  */
@@ -130,6 +149,45 @@ void lb_lbfluid_set_ext_force_density(const Utils::Vector3d &force_density);
  */
 void lb_lbfluid_set_kT(double kT);
 
+/**
+ * @brief Refine the LB lattice between two nodes.
+ *
+ * The region spanned by the nodes is covered by a lattice with half the
+ * lattice constant and half the time step, see lb_refinement.hpp.
+ *
+ * @param lower Index of the lower corner node.
+ * @param upper Index of the upper corner node.
+ */
+void lb_lbfluid_set_refined_region(const Utils::Vector3i &lower,
+                                   const Utils::Vector3i &upper);
+
+/**
+ * @brief Remove the refined region of the LB lattice.
+ */
+void lb_lbfluid_clear_refined_region();
+
+/**
+ * @brief Get the refined region of the LB lattice.
+ *
+ * @return Indices of the lower and upper corner node, or nothing if
+ *         there is no refined region.
+ */
+std::vector<Utils::Vector3i> lb_lbfluid_get_refined_region();
+
+/**
+ * @brief Run the LB time steps concurrently with the force calculation.
+ *
+ * The collisions and the streaming of a time step then overlap with the
+ * next force calculation up to the particle coupling.
+ */
+void lb_lbfluid_set_concurrent_update(bool concurrent);
+
+/**
+ * @brief Whether the LB time steps run concurrently with the force
+ * calculation.
+ */
+bool lb_lbfluid_get_concurrent_update();
+
 /**
  * @brief Perform LB parameter and boundary velocity checks.
  */
@@ -23,12 +23,20 @@
 #include "config.hpp"
 #include "grid_based_algorithms/lattice.hpp"
 #include "lb.hpp"
+#include "lb_refinement.hpp"
 
 #include <utils/Vector.hpp>
+#include <utils/index.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstddef>
+#include <limits>
+#include <numeric>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace {
 InterpolationOrder interpolation_order = InterpolationOrder::linear;
@@ -71,6 +79,93 @@ void lattice_interpolation(Lattice const &lattice, Utils::Vector3d const &pos,
   }
 }
 
+/** Position relative to the local lattice in lattice units, such that
+ *  the lattice sites are at integer values (halo included).
+ */
+Utils::Vector3d lattice_position(Lattice const &lattice,
+                                 Utils::Vector3d const &pos) {
+  Utils::Vector3d rel;
+  for (int dir = 0; dir < 3; dir++) {
+    auto const lpos = pos[dir] - (lattice.my_right[dir] - lattice.local_box[dir]);
+    rel[dir] = lpos / lattice.agrid + lattice.offset;
+  }
+  return rel;
+}
+
+/** Three-point interpolation kernel, cf. @cite duenweg09a.
+ *
+ *  @param u Distance to the lattice site in lattice units.
+ */
+double three_point_polynomial(double u) {
+  auto const abs_u = std::fabs(u);
+  if (abs_u <= 0.5) {
+    return (1. + std::sqrt(1. - 3. * u * u)) / 3.;
+  }
+  return (5. - 3. * abs_u - std::sqrt(-2. + 6. * abs_u - 3. * u * u)) / 6.;
+}
+
+template <typename Op>
+void quadratic_lattice_interpolation(Lattice const &lattice,
+                                     Utils::Vector3d const &pos, Op &&op) {
+  auto const rel = lattice_position(lattice, pos);
+
+  /* nearest lattice site and the weights of the sites around it */
+  Utils::Vector3i center;
+  std::array<std::array<double, 3>, 3> weights;
+  for (int dir = 0; dir < 3; dir++) {
+    center[dir] = static_cast<int>(std::floor(rel[dir] + 0.5));
+
+    /* the stencil is not completely inside this box,
+       adjust if this is due to round off errors */
+    if (center[dir] < 1) {
+      if (rel[dir] - 0.5 > -std::numeric_limits<double>::epsilon())
+        center[dir] = 1;
+      else
+        throw std::runtime_error("position not inside a local plaquette");
+    } else if (center[dir] > lattice.grid[dir]) {
+      if (rel[dir] - lattice.grid[dir] - 0.5 <
+          std::numeric_limits<double>::epsilon() * lattice.grid[dir])
+        center[dir] = lattice.grid[dir];
+      else
+        throw std::runtime_error("position not inside a local plaquette");
+    }
+
+    auto const dist = rel[dir] - center[dir];
+    weights[dir] = {{three_point_polynomial(dist + 1.),
+                     three_point_polynomial(dist),
+                     three_point_polynomial(dist - 1.)}};
+  }
+
+  auto const first = Utils::get_linear_index(
+      center - Utils::Vector3i::broadcast(1), lattice.halo_grid);
+  for (int z = 0; z < 3; z++) {
+    for (int y = 0; y < 3; y++) {
+      for (int x = 0; x < 3; x++) {
+        auto const index = first + (z * lattice.halo_grid[1] + y) *
+                                       lattice.halo_grid[0] +
+                           x;
+        op(index, weights[0][x] * weights[1][y] * weights[2][z]);
+      }
+    }
+  }
+}
+
+/** Call a functor for the lattice sites and weights of the interpolation
+ *  scheme selected by @ref interpolation_order.
+ */
+template <typename Op>
+void interpolation(Lattice const &lattice, Utils::Vector3d const &pos,
+                   Op &&op) {
+  switch (interpolation_order) {
+  case (InterpolationOrder::quadratic):
+    quadratic_lattice_interpolation(lattice, pos, std::forward<Op>(op));
+    break;
+  case (InterpolationOrder::linear):
+    lattice_interpolation(lattice, pos, std::forward<Op>(op));
+    break;
+  }
+}
+
 Utils::Vector3d node_u(Lattice::index_t index) {
 #ifdef LB_BOUNDARIES
   if (lbfields[index].boundary) {
@@ -96,43 +191,99 @@ double node_dens(Lattice::index_t index) {
 
 const Utils::Vector3d
 lb_lbinterpolation_get_interpolated_velocity(const Utils::Vector3d &pos) {
+  if (lb_refinement_covers(pos)) {
+    return lb_refinement_get_interpolated_velocity(pos);
+  }
+
   Utils::Vector3d interpolated_u{};
 
   /* Calculate fluid velocity at particle's position.
-     This is done by linear interpolation (eq. (11) @cite ahlrichs99a) */
-  lattice_interpolation(lblattice, pos,
-                        [&interpolated_u](Lattice::index_t index, double w) {
-                          interpolated_u += w * node_u(index);
-                        });
+     This is done by linear interpolation (eq. (11) @cite ahlrichs99a)
+     or with the three-point kernel (@cite duenweg09a) */
+  interpolation(lblattice, pos,
+                [&interpolated_u](Lattice::index_t index, double w) {
+                  interpolated_u += w * node_u(index);
+                });
 
   return interpolated_u;
 }
 
 double lb_lbinterpolation_get_interpolated_density(const Utils::Vector3d &pos) {
+  if (lb_refinement_covers(pos)) {
+    return lb_refinement_get_interpolated_density(pos);
+  }
+
   double interpolated_dens = 0.;
 
   /* Calculate fluid density at the position.
-     This is done by linear interpolation (eq. (11) @cite ahlrichs99a) */
-  lattice_interpolation(lblattice, pos,
-                        [&interpolated_dens](Lattice::index_t index, double w) {
-                          interpolated_dens += w * node_dens(index);
-                        });
+     This is done by linear interpolation (eq. (11) @cite ahlrichs99a)
+     or with the three-point kernel (@cite duenweg09a) */
+  interpolation(lblattice, pos,
+                [&interpolated_dens](Lattice::index_t index, double w) {
+                  interpolated_dens += w * node_dens(index);
+                });
 
   return interpolated_dens;
 }
 
 void lb_lbinterpolation_add_force_density(
     const Utils::Vector3d &pos, const Utils::Vector3d &force_density) {
-  switch (interpolation_order) {
-  case (InterpolationOrder::quadratic):
-    throw std::runtime_error("The non-linear interpolation scheme is not "
-                             "implemented for the CPU LB.");
-  case (InterpolationOrder::linear):
-    lattice_interpolation(lblattice, pos,
-                          [&force_density](Lattice::index_t index, double w) {
-                            auto &field = lbfields[index];
-                            field.force_density += w * force_density;
-                          });
-    break;
+  if (lb_refinement_covers(pos)) {
+    lb_refinement_add_force_density(pos, force_density);
+    return;
+  }
+
+  interpolation(lblattice, pos,
+                [&force_density](Lattice::index_t index, double w) {
+                  auto &field = lbfields[index];
+                  field.force_density += w * force_density;
+                });
+}
+
+void lb_lbinterpolation_add_force_densities(
+    std::vector<std::pair<Utils::Vector3d, Utils::Vector3d>> const
+        &force_densities) {
+  /* Sort the positions by their nearest lattice plane along z. Both
+   * interpolation schemes only touch the neighboring planes of it,
+   * hence positions in planes three apart never write to the same
+   * lattice site. Positions in the refined region are added last. */
+  auto const n_planes = lblattice.halo_grid[2];
+  auto const refined_bin = n_planes;
+  std::vector<int> bins(force_densities.size());
+  std::vector<std::size_t> bin_begin(n_planes + 2, 0);
+  for (std::size_t i = 0; i < force_densities.size(); i++) {
+    auto const &pos = force_densities[i].first;
+    if (lb_refinement_covers(pos)) {
+      bins[i] = refined_bin;
+    } else {
+      auto const plane = static_cast<int>(
+          std::floor(lattice_position(lblattice, pos)[2] + 0.5));
+      bins[i] = std::max(0, std::min(plane, n_planes - 1));
+    }
+    bin_begin[bins[i] + 1]++;
+  }
+  std::partial_sum(bin_begin.begin(), bin_begin.end(), bin_begin.begin());
+
+  std::vector<std::size_t> order(force_densities.size());
+  auto bin_end = bin_begin;
+  for (std::size_t i = 0; i < force_densities.size(); i++) {
+    order[bin_end[bins[i]]++] = i;
+  }
+
+  auto add_bin = [&](int bin) {
+    for (auto j = bin_begin[bin]; j < bin_begin[bin + 1]; j++) {
+      auto const &f = force_densities[order[j]];
+      lb_lbinterpolation_add_force_density(f.first, f.second);
+    }
+  };
+
+  for (int color = 0; color < 3; color++) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int plane = color; plane < n_planes; plane += 3) {
+      add_bin(plane);
+    }
   }
+  add_bin(refined_bin);
 }
@@ -20,9 +20,15 @@
 #define LATTICE_INTERPOLATION_HPP
 
 #include <utils/Vector.hpp>
+
+#include <utility>
+#include <vector>
+
 /**
  * @brief Interpolation order for the LB fluid interpolation.
- * @note For the CPU LB only linear interpolation is available.
+ *
+ * The quadratic scheme uses the three-point kernel of @cite duenweg09a
+ * on the 27 lattice sites around the nearest site.
  */
 enum class InterpolationOrder { linear, quadratic };
 
@@ -53,4 +59,18 @@ double lb_lbinterpolation_get_interpolated_density(const Utils::Vector3d &p);
  */
 void lb_lbinterpolation_add_force_density(const Utils::Vector3d &p,
                                           const Utils::Vector3d &force_density);
+
+/**
+ * @brief Add force densities to the fluid at several positions.
+ *
+ * Equivalent to calling @ref lb_lbinterpolation_add_force_density for
+ * every position, but the positions are sorted by lattice plane, and
+ * planes that do not share lattice sites are processed concurrently.
+ * The result does not depend on the number of threads.
+ *
+ * @param force_densities Pairs of position and force density.
+ */
+void lb_lbinterpolation_add_force_densities(
+    std::vector<std::pair<Utils::Vector3d, Utils::Vector3d>> const
+        &force_densities);
 #endif
@@ -25,6 +25,7 @@
 #include "grid.hpp"
 #include "grid_based_algorithms/OptionalCounter.hpp"
 #include "integrate.hpp"
+#include "lb.hpp"
 #include "lb_interface.hpp"
 #include "lb_interpolation.hpp"
 #include "lbgpu.hpp"
@@ -39,8 +40,8 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
-#include <stdexcept>
 #include <utility>
+#include <vector>
 
 LB_Particle_Coupling lb_particle_coupling;
 
@@ -119,35 +120,32 @@ void lb_lbcoupling_set_rng_state(uint64_t counter) {
 
 namespace {
 /**
- * @brief Add a force to the lattice force density.
- * @param pos Position of the force
+ * @brief Momentum transfer of a force to the lattice.
  * @param force Force in MD units.
  * @param time_step MD time step.
+ * @return Momentum transfer in lattice units.
  */
-void add_md_force(Utils::Vector3d const &pos, Utils::Vector3d const &force,
-                  double time_step) {
+Utils::Vector3d momentum_transfer(Utils::Vector3d const &force,
+                                  double time_step) {
   /* transform momentum transfer to lattice units
      (eq. (12) @cite ahlrichs99a) */
-  auto const delta_j = -(time_step / lb_lbfluid_get_lattice_speed()) * force;
-  lb_lbinterpolation_add_force_density(pos, delta_j);
+  return -(time_step / lb_lbfluid_get_lattice_speed()) * force;
 }
 } // namespace
 
-/** Coupling of a single particle to viscous fluid with Stokesian friction.
+/** Viscous coupling force of a single particle with Stokesian friction.
  *
  *  Section II.C. @cite ahlrichs99a
  *
  *  @param[in] p             The coupled particle.
  *  @param[in] f_random      Additional force to be included.
- *  @param[in] time_step     MD time step.
  *
  *  @return The viscous coupling force plus @p f_random.
  */
 Utils::Vector3d lb_viscous_coupling(Particle const &p,
-                                    Utils::Vector3d const &f_random,
-                                    double time_step) {
+                                    Utils::Vector3d const &f_random) {
   /* calculate fluid velocity at particle's position
-     this is done by linear interpolation (eq. (11) @cite ahlrichs99a) */
+     this is done by interpolation (eq. (11) @cite ahlrichs99a) */
   auto const interpolated_u =
       lb_lbinterpolation_get_interpolated_velocity(p.r.p) *
       lb_lbfluid_get_lattice_speed();
@@ -164,11 +162,7 @@ Utils::Vector3d lb_viscous_coupling(Particle const &p,
 #endif
 
   /* calculate viscous force (eq. (9) @cite ahlrichs99a) */
-  auto const force = -lb_lbcoupling_get_gamma() * (p.m.v - v_drift) + f_random;
-
-  add_md_force(p.r.p, force, time_step);
-
-  return force;
+  return -lb_lbcoupling_get_gamma() * (p.m.v - v_drift) + f_random;
 }
 
 namespace {
@@ -212,35 +206,23 @@ bool in_local_domain(Vector<T, 3> const &pos, LocalBox<T> const &local_box,
       pos, {local_geo.my_left() - halo_vec, local_geo.my_right() + halo_vec});
 }
 
+#ifdef ENGINE
 /**
- * @brief Check if a position is within the local LB domain
- *       plus halo.
- *
- * @param pos Position to check
+ * @brief Momentum transfer of the swimming force to the fluid.
  *
- * @return True iff the point is inside of the domain.
+ * @param p Swimming particle.
+ * @param time_step MD time step.
+ * @return Source position and momentum transfer in lattice units.
  */
-bool in_local_halo(Vector3d const &pos) {
-  auto const halo = 0.5 * lb_lbfluid_get_agrid();
-
-  return in_local_domain(pos, local_geo, halo);
-}
-
-#ifdef ENGINE
-void add_swimmer_force(Particle const &p, double time_step) {
-  if (p.p.swim.swimming) {
-    // calculate source position
-    const double direction =
-        double(p.p.swim.push_pull) * p.p.swim.dipole_length;
-    auto const director = p.r.calc_director();
-    auto const source_position = p.r.p + direction * director;
-
-    if (not in_local_halo(source_position)) {
-      return;
-    }
-
-    add_md_force(source_position, p.p.swim.f_swim * director, time_step);
-  }
+std::pair<Vector3d, Vector3d> swimmer_momentum_transfer(Particle const &p,
+                                                        double time_step) {
+  // calculate source position
+  const double direction = double(p.p.swim.push_pull) * p.p.swim.dipole_length;
+  auto const director = p.r.calc_director();
+  auto const source_position = p.r.p + direction * director;
+
+  return {source_position,
+          momentum_transfer(p.p.swim.f_swim * director, time_step)};
 }
 #endif
 
@@ -268,66 +250,72 @@ void lb_lbcoupling_calc_particle_lattice_ia(bool couple_virtual,
 #endif
   } else if (lattice_switch == ActiveLB::CPU) {
     if (lb_particle_coupling.couple_to_md) {
-      switch (lb_lbinterpolation_get_interpolation_order()) {
-      case (InterpolationOrder::quadratic):
-        throw std::runtime_error("The non-linear interpolation scheme is not "
-                                 "implemented for the CPU LB.");
-      case (InterpolationOrder::linear): {
-        auto const kT = lb_lbfluid_get_kT();
-        /* Eq. (16) @cite ahlrichs99a.
-         * The factor 12 comes from the fact that we use random numbers
-         * from -0.5 to 0.5 (equally distributed) which have variance 1/12.
-         * time_step comes from the discretization.
-         */
-        auto const noise_amplitude =
-            (kT > 0.) ? std::sqrt(12. * 2. * lb_lbcoupling_get_gamma() * kT /
-                                  time_step)
-                      : 0.0;
-
-        auto f_random = [noise_amplitude](int id) -> Utils::Vector3d {
-          if (noise_amplitude > 0.0) {
-            return Random::noise_uniform<RNGSalt::PARTICLES>(
-                lb_particle_coupling.rng_counter_coupling->value(), 0, id);
-          }
-          return {};
-        };
-
-        auto couple_particle = [&](Particle &p) -> void {
+      auto const kT = lb_lbfluid_get_kT();
+      /* Eq. (16) @cite ahlrichs99a.
+       * The factor 12 comes from the fact that we use random numbers
+       * from -0.5 to 0.5 (equally distributed) which have variance 1/12.
+       * time_step comes from the discretization.
+       */
+      auto const noise_amplitude =
+          (kT > 0.) ? std::sqrt(12. * 2. * lb_lbcoupling_get_gamma() * kT /
+                                time_step)
+                    : 0.0;
+
+      auto f_random = [noise_amplitude](int id) -> Utils::Vector3d {
+        if (noise_amplitude > 0.0) {
+          return Random::noise_uniform<RNGSalt::PARTICLES>(
+              lb_particle_coupling.rng_counter_coupling->value(), 0, id);
+        }
+        return {};
+      };
+
+      /* Every particle is coupled by the node that contains it, be it a
+       * local or a ghost particle. The momentum transferred to the halo
+       * of the lattice is collected by the neighbors afterwards. */
+      std::vector<Particle *> coupled_particles;
+      std::vector<std::pair<Vector3d, Vector3d>> momentum_transfers;
+      auto gather = [&](ParticleRange const &range) {
+        for (auto &p : range) {
           if (p.p.is_virtual and !couple_virtual)
-            return;
+            continue;
 
-          /* Particle is in our LB volume, so this node
-           * is responsible to adding its force */
           if (in_local_domain(p.r.p, local_geo)) {
-            auto const force = lb_viscous_coupling(
-                p, noise_amplitude * f_random(p.identity()), time_step);
-            /* add force to the particle */
-            p.f.f += force;
-            /* Particle is not in our domain, but adds to the force
-             * density in our domain, only calculate contribution to
-             * the LB force density. */
-          } else if (in_local_halo(p.r.p)) {
-            lb_viscous_coupling(p, noise_amplitude * f_random(p.identity()),
-                                time_step);
+            coupled_particles.push_back(&p);
           }
-
 #ifdef ENGINE
-          add_swimmer_force(p, time_step);
+          if (p.p.swim.swimming) {
+            auto transfer = swimmer_momentum_transfer(p, time_step);
+            if (in_local_domain(transfer.first, local_geo)) {
+              momentum_transfers.emplace_back(std::move(transfer));
+            }
+          }
 #endif
-        };
-
-        /* Couple particles ranges */
-        for (auto &p : particles) {
-          couple_particle(p);
         }
-
-        for (auto &p : more_particles) {
-          couple_particle(p);
-        }
-
-        break;
-      }
+      };
+      gather(particles);
+      gather(more_particles);
+
+      auto const n_swimmers = momentum_transfers.size();
+      auto const n_coupled = static_cast<int>(coupled_particles.size());
+      momentum_transfers.resize(n_swimmers + coupled_particles.size());
+
+      /* The interpolation only reads the fluid, and every particle
+       * writes to its own force and momentum transfer. */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+      for (int i = 0; i < n_coupled; i++) {
+        auto &p = *coupled_particles[i];
+        auto const force =
+            lb_viscous_coupling(p, noise_amplitude * f_random(p.identity()));
+        /* add force to the particle */
+        p.f.f += force;
+        momentum_transfers[n_swimmers + i] = {
+            p.r.p, momentum_transfer(force, time_step)};
       }
+
+      lb_lbinterpolation_add_force_densities(momentum_transfers);
+      lb_collect_halo_force_density();
     }
   }
 }
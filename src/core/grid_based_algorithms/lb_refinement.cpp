@@ -0,0 +1,581 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *  Implementation of lb_refinement.hpp.
+ */
+#include "grid_based_algorithms/lb_refinement.hpp"
+
+#include "config.hpp"
+
+#include "communication.hpp"
+#include "errorhandling.hpp"
+#include "grid_based_algorithms/lattice.hpp"
+#include "grid_based_algorithms/lb.hpp"
+#include "lb-d3q19.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/index.hpp>
+#include <utils/math/sqr.hpp>
+
+#include <boost/multi_array.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using Utils::get_linear_index;
+
+std::array<double, 19> lb_rescale_modes(std::array<double, 19> const &modes,
+                                        double density, double mass_ratio,
+                                        double bulk_ratio,
+                                        double shear_ratio) {
+  using Utils::sqr;
+
+  auto const rho = density + modes[0];
+  auto const j = Utils::Vector3d{modes[1], modes[2], modes[3]};
+  auto const j2 = j.norm2();
+
+  /* equilibrium part of the stress modes, cf. lb_relax_modes() */
+  auto const stress_eq =
+      std::array<double, 6>{{j2, sqr(j[0]) - sqr(j[1]), j2 - 3. * sqr(j[2]),
+                             j[0] * j[1], j[0] * j[2], j[1] * j[2]}};
+
+  std::array<double, 19> result{};
+  for (int i = 0; i < 4; i++) {
+    result[i] = mass_ratio * modes[i];
+  }
+  result[4] = mass_ratio * stress_eq[0] / rho +
+              bulk_ratio * (modes[4] - stress_eq[0] / rho);
+  for (int i = 5; i < 10; i++) {
+    result[i] = mass_ratio * stress_eq[i - 4] / rho +
+                shear_ratio * (modes[i] - stress_eq[i - 4] / rho);
+  }
+
+  return result;
+}
+
+namespace {
+/** Global indices of the corner nodes of the refined region. */
+boost::optional<std::pair<Utils::Vector3i, Utils::Vector3i>> refined_region;
+
+/** Fine lattice of the refined region on the node that owns it. */
+struct FineLattice {
+  /** Local index (halo included) of the lower coarse corner node. */
+  Utils::Vector3i lower;
+  /** Number of coarse lattice spacings spanned by the region. */
+  Utils::Vector3i size;
+  /** Number of fine nodes in each direction, halo included. */
+  Utils::Vector3i halo_grid;
+
+  boost::multi_array<lb_float, 2> data_a;
+  boost::multi_array<lb_float, 2> data_b;
+  /** Pre-collision populations. */
+  LB_Fluid fluid;
+  /** Post-collision populations. */
+  LB_Fluid fluid_post;
+  /** Momentum transferred to the fine nodes during a coarse time step. */
+  std::vector<Utils::Vector3d> force_density;
+
+  /** Pre-collision modes of the coarse nodes of the region at the
+   *  beginning of the coarse time step, only set on the surface.
+   */
+  std::vector<std::array<double, 19>> coarse_modes;
+  /** Force density of the coarse nodes of the region at the beginning
+   *  of the coarse time step, only set on the surface.
+   */
+  std::vector<Utils::Vector3d> coarse_force_density;
+
+  /** Index of a fine node. */
+  Lattice::index_t index(Utils::Vector3i const &k) const {
+    return get_linear_index(k, halo_grid);
+  }
+
+  /** Index of a coarse node of the region in @ref coarse_modes. */
+  std::size_t box_index(Utils::Vector3i const &c) const {
+    return static_cast<std::size_t>(get_linear_index(
+        c - lower, size + Utils::Vector3i::broadcast(1)));
+  }
+
+  /** Whether a fine node is on the surface of the region. */
+  bool on_surface(Utils::Vector3i const &k) const {
+    for (int d = 0; d < 3; d++) {
+      if (k[d] == 1 or k[d] == 2 * size[d] + 1)
+        return true;
+    }
+    return false;
+  }
+
+  /** Whether a coarse node is on the surface of the region. */
+  bool on_coarse_surface(Utils::Vector3i const &c) const {
+    for (int d = 0; d < 3; d++) {
+      if (c[d] == lower[d] or c[d] == lower[d] + size[d])
+        return true;
+    }
+    return false;
+  }
+};
+
+std::unique_ptr<FineLattice> fine;
+
+/** Parameters of the fine lattice. */
+LB_Parameters fine_parameters() {
+  auto params = lbpar;
+  params.density /= 8.;
+  params.viscosity *= 2.;
+  params.bulk_viscosity *= 2.;
+  params.agrid /= 2.;
+  params.tau /= 2.;
+  params.ext_force_density /= 16.;
+  params.kT = 0.;
+  lb_reinit_parameters(params);
+
+  return params;
+}
+
+/** Modes of a coarse node on the fine lattice. */
+std::array<double, 19> refine_modes(std::array<double, 19> const &modes,
+                                    LB_Parameters const &fine_params) {
+  return lb_rescale_modes(
+      modes, lbpar.density, 1. / 8.,
+      lb_refinement_neq_ratio(lbpar.gamma_bulk, fine_params.gamma_bulk),
+      lb_refinement_neq_ratio(lbpar.gamma_shear, fine_params.gamma_shear));
+}
+
+/** Modes of a fine node on the coarse lattice. */
+std::array<double, 19> coarsen_modes(std::array<double, 19> const &modes,
+                                     LB_Parameters const &fine_params) {
+  return lb_rescale_modes(
+      modes, fine_params.density, 8.,
+      1. / lb_refinement_neq_ratio(lbpar.gamma_bulk, fine_params.gamma_bulk),
+      1. / lb_refinement_neq_ratio(lbpar.gamma_shear, fine_params.gamma_shear));
+}
+
+/**
+ * @brief Call a functor for the coarse nodes interpolating a fine node.
+ *
+ * The fine nodes coincide with the coarse nodes or lie halfway between
+ * them, hence the interpolation weights are products of 1 or 1/2.
+ *
+ * @param f  Fine lattice.
+ * @param k  Index of the fine node (halo included).
+ * @param op Functor called with the local index of the coarse node
+ *           (halo included) and the interpolation weight.
+ */
+template <class F>
+void for_each_coarse_node(FineLattice const &f, Utils::Vector3i const &k,
+                          F &&op) {
+  Utils::Vector3i first;
+  Utils::Vector3i count;
+  for (int d = 0; d < 3; d++) {
+    first[d] = f.lower[d] + (k[d] - 1) / 2;
+    count[d] = (k[d] - 1) % 2 + 1;
+  }
+  auto const weight = 1. / (count[0] * count[1] * count[2]);
+  for (int z = 0; z < count[2]; z++) {
+    for (int y = 0; y < count[1]; y++) {
+      for (int x = 0; x < count[0]; x++) {
+        op(first + Utils::Vector3i{x, y, z}, weight);
+      }
+    }
+  }
+}
+
+/** Interpolate the current coarse modes to a fine node. */
+std::array<double, 19> interpolate_coarse_modes(FineLattice const &f,
+                                                Utils::Vector3i const &k) {
+  std::array<double, 19> modes{};
+  for_each_coarse_node(f, k, [&](Utils::Vector3i const &c, double w) {
+    auto const node_modes =
+        lb_calc_modes(get_linear_index(c, lblattice.halo_grid), lbfluid);
+    for (int i = 0; i < 19; i++) {
+      modes[i] += w * node_modes[i];
+    }
+  });
+  return modes;
+}
+
+/** @brief Allocate the fine lattice and initialize it from the coarse
+ *  fluid.
+ */
+std::unique_ptr<FineLattice> make_fine_lattice(Utils::Vector3i const &lower,
+                                               Utils::Vector3i const &upper) {
+  auto f = std::make_unique<FineLattice>();
+  f->lower = lower;
+  f->size = upper - lower;
+  f->halo_grid = 2 * f->size + Utils::Vector3i::broadcast(3);
+
+  auto const volume = f->halo_grid[0] * f->halo_grid[1] * f->halo_grid[2];
+  const std::array<int, 2> shape = {{D3Q19::n_vel, volume}};
+  f->data_a.resize(shape);
+  f->data_b.resize(shape);
+  for (int i = 0; i < D3Q19::n_vel; i++) {
+    f->fluid[i] = Utils::Span<lb_float>(f->data_a[i].origin(), volume);
+    f->fluid_post[i] = Utils::Span<lb_float>(f->data_b[i].origin(), volume);
+  }
+  f->force_density.assign(volume, Utils::Vector3d{});
+
+  auto const box_volume = (f->size[0] + 1) * (f->size[1] + 1) *
+                          (f->size[2] + 1);
+  f->coarse_modes.resize(box_volume);
+  f->coarse_force_density.resize(box_volume);
+
+  auto const params = fine_parameters();
+  for (int z = 1; z <= 2 * f->size[2] + 1; z++) {
+    for (int y = 1; y <= 2 * f->size[1] + 1; y++) {
+      for (int x = 1; x <= 2 * f->size[0] + 1; x++) {
+        auto const k = Utils::Vector3i{x, y, z};
+        auto const populations = lb_calc_populations(
+            refine_modes(interpolate_coarse_modes(*f, k), params));
+        for (int i = 0; i < D3Q19::n_vel; i++) {
+          f->fluid[i][f->index(k)] = static_cast<lb_float>(populations[i]);
+        }
+      }
+    }
+  }
+
+  return f;
+}
+
+/** @brief Check whether the region fits into the local lattice of a
+ *  single node with a margin of one coarse node.
+ */
+bool region_fits_lattice(Utils::Vector3i const &lower,
+                         Utils::Vector3i const &upper) {
+  for (int d = 0; d < 3; d++) {
+    auto const grid = lblattice.grid[d];
+    if (lower[d] < 0 or upper[d] >= lblattice.global_grid[d] or
+        upper[d] - lower[d] < 2 or lower[d] / grid != upper[d] / grid or
+        lower[d] % grid < 1 or upper[d] % grid > grid - 2)
+      return false;
+  }
+  return true;
+}
+
+/** One time step of the fine lattice.
+ *
+ *  @param f         Fine lattice.
+ *  @param params    Parameters of the fine lattice.
+ *  @param time      Time of the step relative to the coarse time step,
+ *                   used to interpolate the coarse surface nodes.
+ */
+void fine_time_step(FineLattice &f, LB_Parameters const &params,
+                    double time) {
+  std::array<std::ptrdiff_t, 19> offsets;
+  for (int i = 0; i < D3Q19::n_vel; i++) {
+    offsets[i] = get_linear_index(D3Q19::c[i], f.halo_grid);
+  }
+
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(static)
+#endif
+  for (int z = 1; z <= 2 * f.size[2] + 1; z++) {
+    for (int y = 1; y <= 2 * f.size[1] + 1; y++) {
+      for (int x = 1; x <= 2 * f.size[0] + 1; x++) {
+        auto const k = Utils::Vector3i{x, y, z};
+        auto const index = f.index(k);
+
+        std::array<double, 19> modes;
+        if (f.on_surface(k)) {
+          /* surface nodes are interpolated from the coarse lattice,
+             and collided on the fine lattice */
+          std::array<double, 19> coarse_modes{};
+          Utils::Vector3d coarse_force_density{};
+          for_each_coarse_node(f, k, [&](Utils::Vector3i const &c, double w) {
+            auto const b = f.box_index(c);
+            auto const current_modes = lb_calc_modes(
+                get_linear_index(c, lblattice.halo_grid), lbfluid);
+            for (int i = 0; i < 19; i++) {
+              coarse_modes[i] += w * ((1. - time) * f.coarse_modes[b][i] +
+                                      time * current_modes[i]);
+            }
+            coarse_force_density += w * f.coarse_force_density[b];
+          });
+          modes = lb_collide_modes(refine_modes(coarse_modes, params),
+                                   coarse_force_density / 16., params);
+        } else {
+          modes = lb_collide_modes(lb_calc_modes(index, f.fluid),
+                                   0.5 * f.force_density[index] +
+                                       params.ext_force_density,
+                                   params);
+        }
+
+        auto const populations = lb_calc_populations(modes);
+        for (int i = 0; i < D3Q19::n_vel; i++) {
+          f.fluid_post[i][index + offsets[i]] =
+              static_cast<lb_float>(populations[i]);
+        }
+      }
+    }
+  }
+
+  std::swap(f.fluid, f.fluid_post);
+}
+
+/** Overwrite the coarse nodes inside of the region with the fine fluid. */
+void restrict_to_coarse(FineLattice const &f, LB_Parameters const &params) {
+  for (int z = f.lower[2] + 1; z < f.lower[2] + f.size[2]; z++) {
+    for (int y = f.lower[1] + 1; y < f.lower[1] + f.size[1]; y++) {
+      for (int x = f.lower[0] + 1; x < f.lower[0] + f.size[0]; x++) {
+        auto const c = Utils::Vector3i{x, y, z};
+        auto const k = 2 * (c - f.lower) + Utils::Vector3i::broadcast(1);
+        auto const populations = lb_calc_populations(
+            coarsen_modes(lb_calc_modes(f.index(k), f.fluid), params));
+        auto const index = get_linear_index(c, lblattice.halo_grid);
+        for (int i = 0; i < D3Q19::n_vel; i++) {
+          lbfluid[i][index] = static_cast<lb_float>(populations[i]);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Call a functor for the fine nodes surrounding a position.
+ *
+ * @param f   Fine lattice.
+ * @param pos Position inside of the region.
+ * @param op  Functor called with the index of the fine node (halo
+ *            included) and the interpolation weight.
+ */
+template <class F>
+void fine_lattice_interpolation(FineLattice const &f,
+                                Utils::Vector3d const &pos, F &&op) {
+  auto const agrid = 0.5 * lblattice.agrid;
+  auto const my_left = lblattice.my_right - lblattice.local_box;
+
+  Utils::Vector3i first;
+  Utils::Vector3d delta;
+  for (int d = 0; d < 3; d++) {
+    /* position of the lower fine node in fine lattice spacings */
+    auto const origin = (f.lower[d] - lblattice.offset) * lblattice.agrid;
+    auto const rel = (pos[d] - my_left[d] - origin) / agrid;
+    first[d] = std::max(0, std::min(static_cast<int>(std::floor(rel)),
+                                    2 * f.size[d] - 1)) +
+               1;
+    delta[d] = rel - (first[d] - 1);
+  }
+
+  for (int z = 0; z < 2; z++) {
+    for (int y = 0; y < 2; y++) {
+      for (int x = 0; x < 2; x++) {
+        auto const w = (x ? delta[0] : 1. - delta[0]) *
+                       (y ? delta[1] : 1. - delta[1]) *
+                       (z ? delta[2] : 1. - delta[2]);
+        op(first + Utils::Vector3i{x, y, z}, w);
+      }
+    }
+  }
+}
+} // namespace
+
+bool lb_refinement_is_local() { return static_cast<bool>(fine); }
+
+void lb_refinement_init() {
+  fine.reset();
+  if (not refined_region)
+    return;
+
+  auto const &lower = refined_region->first;
+  auto const &upper = refined_region->second;
+  if (not region_fits_lattice(lower, upper)) {
+    if (this_node == 0) {
+      runtimeErrorMsg() << "The refined LB region does not fit the lattice "
+                           "anymore and was removed";
+    }
+    refined_region = boost::none;
+    return;
+  }
+
+  auto const local_lower = lblattice.local_index(lower);
+  auto const local_upper = lblattice.local_index(upper);
+  for (int d = 0; d < 3; d++) {
+    if (local_lower[d] < 1 or local_lower[d] > lblattice.grid[d])
+      return;
+  }
+
+  fine = make_fine_lattice(local_lower, local_upper);
+}
+
+void lb_refinement_save_coarse_state() {
+  if (not fine)
+    return;
+
+  auto &f = *fine;
+  for (int z = f.lower[2]; z <= f.lower[2] + f.size[2]; z++) {
+    for (int y = f.lower[1]; y <= f.lower[1] + f.size[1]; y++) {
+      for (int x = f.lower[0]; x <= f.lower[0] + f.size[0]; x++) {
+        auto const c = Utils::Vector3i{x, y, z};
+        if (not f.on_coarse_surface(c))
+          continue;
+        auto const index = get_linear_index(c, lblattice.halo_grid);
+        f.coarse_modes[f.box_index(c)] = lb_calc_modes(index, lbfluid);
+        f.coarse_force_density[f.box_index(c)] = lbfields[index].force_density;
+      }
+    }
+  }
+}
+
+void lb_refinement_integrate() {
+  if (not fine)
+    return;
+
+  auto const params = fine_parameters();
+  fine_time_step(*fine, params, 0.);
+  fine_time_step(*fine, params, 0.5);
+  std::fill(fine->force_density.begin(), fine->force_density.end(),
+            Utils::Vector3d{});
+
+  restrict_to_coarse(*fine, params);
+}
+
+bool lb_refinement_covers(Utils::Vector3d const &pos) {
+  if (not fine)
+    return false;
+
+  auto const my_left = lblattice.my_right - lblattice.local_box;
+  for (int d = 0; d < 3; d++) {
+    auto const lower =
+        my_left[d] + (fine->lower[d] - lblattice.offset) * lblattice.agrid;
+    auto const upper = lower + fine->size[d] * lblattice.agrid;
+    if (pos[d] <= lower or pos[d] >= upper)
+      return false;
+  }
+  return true;
+}
+
+Utils::Vector3d
+lb_refinement_get_interpolated_velocity(Utils::Vector3d const &pos) {
+  auto const &f = *fine;
+  auto const params = fine_parameters();
+
+  Utils::Vector3d u{};
+  fine_lattice_interpolation(f, pos, [&](Utils::Vector3i const &k, double w) {
+    if (f.on_surface(k)) {
+      auto const modes = interpolate_coarse_modes(f, k);
+      u += w * Utils::Vector3d{modes[1], modes[2], modes[3]} /
+           (lbpar.density + modes[0]);
+    } else {
+      auto const modes = lb_calc_modes(f.index(k), f.fluid);
+      u += w * Utils::Vector3d{modes[1], modes[2], modes[3]} /
+           (params.density + modes[0]);
+    }
+  });
+
+  return u;
+}
+
+double lb_refinement_get_interpolated_density(Utils::Vector3d const &pos) {
+  auto const &f = *fine;
+  auto const params = fine_parameters();
+
+  double density = 0.;
+  fine_lattice_interpolation(f, pos, [&](Utils::Vector3i const &k, double w) {
+    if (f.on_surface(k)) {
+      density += w * (lbpar.density + interpolate_coarse_modes(f, k)[0]);
+    } else {
+      auto const modes = lb_calc_modes(f.index(k), f.fluid);
+      density += w * 8. * (params.density + modes[0]);
+    }
+  });
+
+  return density;
+}
+
+void lb_refinement_add_force_density(Utils::Vector3d const &pos,
+                                     Utils::Vector3d const &force_density) {
+  auto &f = *fine;
+
+  fine_lattice_interpolation(f, pos, [&](Utils::Vector3i const &k, double w) {
+    if (f.on_surface(k)) {
+      /* the surface nodes follow the coarse lattice */
+      for_each_coarse_node(f, k, [&](Utils::Vector3i const &c, double wc) {
+        lbfields[get_linear_index(c, lblattice.halo_grid)].force_density +=
+            w * wc * force_density;
+      });
+    } else {
+      f.force_density[f.index(k)] += w * force_density;
+    }
+  });
+}
+
+void lb_refinement_sanity_checks() {
+  if (not fine)
+    return;
+
+  if (lbpar.kT > 0.) {
+    runtimeErrorMsg() << "LB grid refinement does not support thermal "
+                         "fluctuations";
+  }
+#ifdef LB_BOUNDARIES
+  auto const &f = *fine;
+  for (int z = f.lower[2]; z <= f.lower[2] + f.size[2]; z++) {
+    for (int y = f.lower[1]; y <= f.lower[1] + f.size[1]; y++) {
+      for (int x = f.lower[0]; x <= f.lower[0] + f.size[0]; x++) {
+        if (lbfields[get_linear_index(x, y, z, lblattice.halo_grid)].boundary) {
+          runtimeErrorMsg() << "LB boundaries inside of the refined region "
+                               "are not supported";
+          return;
+        }
+      }
+    }
+  }
+#endif
+}
+
+void mpi_set_lb_refined_region_local(Utils::Vector3i const &lower,
+                                     Utils::Vector3i const &upper) {
+  refined_region = std::make_pair(lower, upper);
+  lb_refinement_init();
+}
+
+REGISTER_CALLBACK(mpi_set_lb_refined_region_local)
+
+void mpi_set_lb_refined_region(Utils::Vector3i const &lower,
+                               Utils::Vector3i const &upper) {
+  if (not region_fits_lattice(lower, upper)) {
+    throw std::invalid_argument(
+        "The refined region has to span at least two lattice spacings in "
+        "every direction and to be at least one node away from the "
+        "boundaries of the local LB domain of a single MPI rank");
+  }
+
+  mpi_call_all(mpi_set_lb_refined_region_local, lower, upper);
+}
+
+void mpi_clear_lb_refined_region_local() {
+  refined_region = boost::none;
+  fine.reset();
+}
+
+REGISTER_CALLBACK(mpi_clear_lb_refined_region_local)
+
+void mpi_clear_lb_refined_region() {
+  mpi_call_all(mpi_clear_lb_refined_region_local);
+}
+
+boost::optional<std::pair<Utils::Vector3i, Utils::Vector3i>>
+lb_refinement_get_region() {
+  return refined_region;
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_LB_REFINEMENT_HPP
+#define CORE_LB_REFINEMENT_HPP
+/** \file
+ *  Local grid refinement for the CPU lattice-Boltzmann method.
+ *
+ *  A box of the coarse lattice, spanned by the coarse nodes from
+ *  @c lower to @c upper, is covered by a fine lattice with half the
+ *  lattice constant and half the time step (acoustic scaling), such
+ *  that the lattice speed, and hence velocities in lattice units, are
+ *  the same on both levels. The fine lattice performs two time steps
+ *  per coarse time step. The levels are coupled as in @cite dupuis03a:
+ *
+ *  - the pre-collision modes of the fine nodes on the surface of the
+ *    box are interpolated from the coarse surface nodes, in space and
+ *    in time, and rescaled to the fine lattice. These nodes are then
+ *    collided with the fine parameters and streamed like the inner
+ *    fine nodes, which gives the populations entering the box,
+ *  - the coarse nodes inside of the box are overwritten with the
+ *    rescaled populations of the coinciding fine nodes after every
+ *    coarse time step.
+ *
+ *  The rescaling converts masses and momenta per node, and keeps the
+ *  non-equilibrium stress consistent with the viscous stress of the
+ *  other level. Ghost modes are not transferred.
+ *
+ *  The fine lattice is always local to a single MPI rank, the box hence
+ *  has to be at least one coarse node away from the boundaries of the
+ *  local domain. Thermal fluctuations and LB boundaries inside of the
+ *  box are not supported.
+ *
+ *  Implementation in lb_refinement.cpp.
+ */
+
+#include <utils/Vector.hpp>
+
+#include <boost/optional.hpp>
+
+#include <array>
+#include <utility>
+
+/**
+ * @brief Rescale the modes of a node to another lattice level.
+ *
+ * Density and momentum are multiplied by @p mass_ratio, as is the
+ * equilibrium part of the stress modes. The non-equilibrium part of
+ * the bulk and shear stress modes is multiplied by @p bulk_ratio and
+ * @p shear_ratio, respectively. Ghost modes are set to zero.
+ *
+ * @param modes       Modes of the node (populations relative to the
+ *                    background density).
+ * @param density     Background density of the source lattice.
+ * @param mass_ratio  Ratio of the node masses of the target lattice and
+ *                    the source lattice.
+ * @param bulk_ratio  Ratio of the non-equilibrium bulk stress.
+ * @param shear_ratio Ratio of the non-equilibrium shear stress.
+ * @return Modes on the target lattice.
+ */
+std::array<double, 19> lb_rescale_modes(std::array<double, 19> const &modes,
+                                        double density, double mass_ratio,
+                                        double bulk_ratio, double shear_ratio);
+
+/**
+ * @brief Ratio of the pre-collision non-equilibrium stress on the fine
+ * and the coarse lattice.
+ *
+ * The pre-collision non-equilibrium stress is proportional to the mass
+ * per node, the time step and the relaxation time @f$ 1/(1-\gamma) @f$.
+ *
+ * @param gamma_coarse Relaxation parameter of the coarse lattice.
+ * @param gamma_fine   Relaxation parameter of the fine lattice.
+ */
+inline double lb_refinement_neq_ratio(double gamma_coarse, double gamma_fine) {
+  return (1. - gamma_coarse) / (16. * (1. - gamma_fine));
+}
+
+/** @brief Whether a refined region is active on this node. */
+bool lb_refinement_is_local();
+
+/** @brief Set up the fine lattice for the current coarse lattice.
+ *
+ *  The fine populations are initialized from the coarse fluid. Has to
+ *  be called whenever the coarse lattice or fluid is re-initialized.
+ */
+void lb_refinement_init();
+
+/** @brief Store the coarse state needed by the fine time steps.
+ *
+ *  Has to be called before the coarse collision.
+ */
+void lb_refinement_save_coarse_state();
+
+/** @brief Perform the two fine time steps and update the coarse nodes
+ *  inside of the refined region.
+ *
+ *  Has to be called after the coarse streaming.
+ */
+void lb_refinement_integrate();
+
+/** @brief Whether the particle coupling at a position uses the fine
+ *  lattice.
+ */
+bool lb_refinement_covers(Utils::Vector3d const &pos);
+
+/** @brief Interpolated velocity (lattice units) at a position covered by
+ *  the fine lattice.
+ */
+Utils::Vector3d
+lb_refinement_get_interpolated_velocity(Utils::Vector3d const &pos);
+
+/** @brief Interpolated density (coarse lattice units) at a position
+ *  covered by the fine lattice.
+ */
+double lb_refinement_get_interpolated_density(Utils::Vector3d const &pos);
+
+/** @brief Distribute a momentum transfer (lattice units) at a position
+ *  covered by the fine lattice.
+ */
+void lb_refinement_add_force_density(Utils::Vector3d const &pos,
+                                     Utils::Vector3d const &force_density);
+
+/** @brief Check the compatibility of the refined region with the fluid. */
+void lb_refinement_sanity_checks();
+
+/**
+ * @brief Refine the region between two coarse nodes on all nodes.
+ *
+ * @param lower Global index of the lower corner node.
+ * @param upper Global index of the upper corner node.
+ */
+void mpi_set_lb_refined_region(Utils::Vector3i const &lower,
+                               Utils::Vector3i const &upper);
+
+/** @brief Remove the refined region on all nodes. */
+void mpi_clear_lb_refined_region();
+
+/** @brief Global indices of the corner nodes of the refined region. */
+boost::optional<std::pair<Utils::Vector3i, Utils::Vector3i>>
+lb_refinement_get_region();
+
+#endif
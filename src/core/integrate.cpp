@@ -44,6 +44,7 @@
 #include "grid.hpp"
 #include "grid_based_algorithms/lb_interface.hpp"
 #include "grid_based_algorithms/lb_particle_coupling.hpp"
+#include "load_balancing.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "npt.hpp"
 #include "rattle.hpp"
@@ -94,6 +95,18 @@ void notify_sig_int() {
   ctrl_C = 0;              // reset
   set_py_interrupt = true; // global to notify Python
 }
+
+/** @brief Discards a pending concurrent LB time step when it goes out of
+ *  scope, so that the worker thread is also joined if an exception leaves
+ *  the integration loop. The regular completion, which communicates, is
+ *  done after the loop and leaves nothing to discard.
+ */
+struct LBPropagationGuard {
+  LBPropagationGuard() = default;
+  LBPropagationGuard(LBPropagationGuard const &) = delete;
+  LBPropagationGuard &operator=(LBPropagationGuard const &) = delete;
+  ~LBPropagationGuard() { lb_lbfluid_abort_propagation(); }
+};
 } // namespace
 
 void integrator_sanity_checks() {
@@ -216,7 +229,7 @@ int integrate(int n_steps, int reuse_forces) {
 #endif
 
     // Communication step: distribute ghost positions
-    cells_update_ghosts(global_ghost_flags());
+    cells_update_ghosts(global_ghost_flags(), true);
 
     force_calc(cell_structure, time_step, temperature);
 
@@ -243,6 +256,7 @@ int integrate(int n_steps, int reuse_forces) {
   /* Integration loop */
   ESPRESSO_PROFILER_CXX_MARK_LOOP_BEGIN(integration_loop, "Integration loop");
   int integrated_steps = 0;
+  LBPropagationGuard lb_propagation_guard;
   for (int step = 0; step < n_steps; step++) {
     ESPRESSO_PROFILER_CXX_MARK_LOOP_ITERATION(integration_loop, step);
 
@@ -276,7 +290,7 @@ int integrate(int n_steps, int reuse_forces) {
       n_verlet_updates++;
 
     // Communication step: distribute ghost positions
-    cells_update_ghosts(global_ghost_flags());
+    cells_update_ghosts(global_ghost_flags(), true);
 
     particles = cell_structure.local_particles();
 
@@ -318,6 +332,8 @@ int integrate(int n_steps, int reuse_forces) {
 
     integrated_steps++;
 
+    load_balancing_step();
+
     if (check_runtime_errors(comm_cart))
       break;
 
@@ -330,6 +346,9 @@ int integrate(int n_steps, int reuse_forces) {
   } // for-loop over integration steps
   ESPRESSO_PROFILER_CXX_MARK_LOOP_END(integration_loop);
 
+  /* complete the last LB time step if it runs concurrently */
+  lb_lbfluid_finish_propagation();
+
 #ifdef VALGRIND_INSTRUMENTATION
   CALLGRIND_STOP_INSTRUMENTATION;
 #endif
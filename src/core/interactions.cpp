@@ -35,6 +35,7 @@
 
 void mpi_bcast_all_ia_params_local() {
   boost::mpi::broadcast(comm_cart, ia_params, 0);
+  on_short_range_ia_change();
 }
 
 REGISTER_CALLBACK(mpi_bcast_all_ia_params_local)
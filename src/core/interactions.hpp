@@ -24,7 +24,9 @@
 #ifndef _INTERACTIONS_HPP
 #define _INTERACTIONS_HPP
 
-/** Broadcast \ref ia_params to all nodes. */
+/** Broadcast \ref ia_params to all nodes.
+ *  Also calls \ref on_short_range_ia_change.
+ */
 void mpi_bcast_all_ia_params();
 
 /** Send new IA params.
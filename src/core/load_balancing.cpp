@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *  Implementation of load_balancing.hpp.
+ */
+#include "load_balancing.hpp"
+
+#include "config.hpp"
+
+#include "cells.hpp"
+#include "communication.hpp"
+#include "errorhandling.hpp"
+#include "grid.hpp"
+#include "grid_based_algorithms/lb_interface.hpp"
+#include "integrate.hpp"
+
+#include "electrostatics_magnetostatics/coulomb.hpp"
+#include "electrostatics_magnetostatics/dipole.hpp"
+
+#include <boost/mpi/collectives.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+LoadBalancingParameters load_balancing_params;
+
+/** Integration steps since the last load check. */
+static int steps_since_check = 0;
+/** Short-range force time since the last load check. */
+static double force_time = 0.;
+
+std::vector<double> balance_boundaries(std::vector<double> const &boundaries,
+                                       std::vector<double> const &loads,
+                                       double min_width) {
+  auto const n_slabs = loads.size();
+  auto const total_load = std::accumulate(loads.begin(), loads.end(), 0.);
+  if (total_load <= 0.)
+    return boundaries;
+
+  std::vector<double> result(boundaries.size());
+  result.front() = 0.;
+  result.back() = 1.;
+
+  /* Invert the piecewise linear cumulative load. */
+  std::size_t slab = 0;
+  double load_below = 0.;
+  for (std::size_t k = 1; k < n_slabs; k++) {
+    auto const target = total_load * static_cast<double>(k) /
+                        static_cast<double>(n_slabs);
+    while (load_below + loads[slab] <= target and slab + 1 < n_slabs) {
+      load_below += loads[slab];
+      slab++;
+    }
+
+    auto const fraction =
+        std::min(1., (target - load_below) / std::max(loads[slab], 1e-300));
+    result[k] = boundaries[slab] +
+                fraction * (boundaries[slab + 1] - boundaries[slab]);
+  }
+
+  /* Enforce the minimal width, first from the left, then from the right. */
+  for (std::size_t k = 1; k < n_slabs; k++) {
+    result[k] = std::max(result[k], result[k - 1] + min_width);
+  }
+  for (std::size_t k = n_slabs - 1; k > 0; k--) {
+    result[k] = std::min(result[k], result[k + 1] - min_width);
+  }
+
+  return result;
+}
+
+void load_balancing_add_force_time(double seconds) { force_time += seconds; }
+
+/** @brief Shift the node boundaries if the load imbalance is too large.
+ *
+ *  @param load Load of this node.
+ */
+static void balance_load(double load) {
+  auto const max_load =
+      boost::mpi::all_reduce(comm_cart, load, boost::mpi::maximum<double>());
+  auto const total_load =
+      boost::mpi::all_reduce(comm_cart, load, std::plus<double>());
+
+  if (total_load <= 0.)
+    return;
+
+  auto const imbalance = max_load * comm_cart.size() / total_load - 1.;
+  if (imbalance <= load_balancing_params.threshold)
+    return;
+
+  auto const node_pos = calc_node_pos(comm_cart);
+  auto const range = interaction_range();
+  auto boundaries = get_node_boundaries();
+
+  for (int dir = 0; dir < 3; dir++) {
+    auto const n_slabs = node_grid[dir];
+    if (n_slabs == 1)
+      continue;
+
+    std::vector<double> local_loads(n_slabs, 0.);
+    std::vector<double> slab_loads(n_slabs);
+    local_loads[node_pos[dir]] = load;
+    boost::mpi::all_reduce(comm_cart, local_loads.data(), n_slabs,
+                           slab_loads.data(), std::plus<double>());
+
+    auto &bounds = boundaries[dir];
+    if (bounds.empty()) {
+      for (int i = 0; i <= n_slabs; i++) {
+        bounds.push_back(static_cast<double>(i) / n_slabs);
+      }
+    }
+
+    auto const min_width =
+        std::max(range * box_geo.length_inv()[dir],
+                 load_balancing_min_relative_width / n_slabs);
+    bounds = balance_boundaries(bounds, slab_loads, min_width);
+  }
+
+  set_node_boundaries(boundaries);
+  /* The new cell system triggers a global resort. */
+  cells_re_init(cell_structure.decomposition_type());
+}
+
+void load_balancing_step() {
+  if (not load_balancing_params.active or
+      cell_structure.decomposition_type() != CELL_STRUCTURE_DOMDEC)
+    return;
+
+  if (++steps_since_check < load_balancing_params.interval)
+    return;
+
+  auto const load =
+      (load_balancing_params.metric == LOAD_METRIC_PARTICLES)
+          ? static_cast<double>(cell_structure.local_particles().size())
+          : force_time;
+
+  steps_since_check = 0;
+  force_time = 0.;
+
+  balance_load(load);
+}
+
+bool load_balancing_supported() {
+#ifdef ELECTROSTATICS
+  if (coulomb.method == COULOMB_P3M or coulomb.method == COULOMB_P3M_GPU or
+      coulomb.method == COULOMB_ELC_P3M)
+    return false;
+#endif
+#ifdef DIPOLES
+  if (dipole.method == DIPOLAR_P3M or dipole.method == DIPOLAR_MDLC_P3M)
+    return false;
+#endif
+  return lb_lbfluid_get_lattice_switch() == ActiveLB::NONE;
+}
+
+void load_balancing_sanity_checks() {
+  if (not load_balancing_params.active)
+    return;
+
+  if (cell_structure.decomposition_type() != CELL_STRUCTURE_DOMDEC) {
+    runtimeErrorMsg()
+        << "Load balancing requires the domain decomposition cell system";
+  }
+  if (not load_balancing_supported()) {
+    runtimeErrorMsg() << "Load balancing is not compatible with P3M and "
+                         "lattice-Boltzmann";
+  }
+}
+
+/** @brief Whether the node boundaries are equally spaced. */
+static bool regular_node_boundaries() {
+  auto const &boundaries = get_node_boundaries();
+  return std::all_of(boundaries.begin(), boundaries.end(),
+                     [](std::vector<double> const &b) { return b.empty(); });
+}
+
+void load_balancing_on_method_change() {
+  if (not regular_node_boundaries() and not load_balancing_supported()) {
+    set_node_boundaries(NodeBoundaries{});
+  }
+}
+
+void mpi_set_load_balancing_local(bool active, double threshold, int interval,
+                                  int metric) {
+  load_balancing_params.active = active;
+  load_balancing_params.threshold = threshold;
+  load_balancing_params.interval = interval;
+  load_balancing_params.metric = static_cast<LoadMetric>(metric);
+
+  steps_since_check = 0;
+  force_time = 0.;
+
+  if (not active and not regular_node_boundaries()) {
+    set_node_boundaries(NodeBoundaries{});
+    cells_re_init(cell_structure.decomposition_type());
+  }
+}
+
+REGISTER_CALLBACK(mpi_set_load_balancing_local)
+
+void mpi_set_load_balancing(bool active, double threshold, int interval,
+                            int metric) {
+  if (threshold < 0.)
+    throw std::domain_error("Load balancing threshold must be >= 0");
+  if (interval < 1)
+    throw std::domain_error("Load balancing interval must be > 0");
+  if (metric != LOAD_METRIC_PARTICLES and metric != LOAD_METRIC_FORCE_TIME)
+    throw std::domain_error("Unknown load balancing metric");
+  if (active and not load_balancing_supported())
+    throw std::runtime_error(
+        "Load balancing is not compatible with P3M and lattice-Boltzmann");
+
+  mpi_call_all(mpi_set_load_balancing_local, active, threshold, interval,
+               metric);
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_LOAD_BALANCING_HPP
+#define ESPRESSO_LOAD_BALANCING_HPP
+/** \file
+ *  Dynamic load balancing for the domain decomposition.
+ *
+ *  The node boundaries are shifted independently along every direction
+ *  of the node grid, so that the subdomains remain a tensor product grid
+ *  (see @ref tensor_product_decomposition). The load of a node is either
+ *  its number of particles or the time it spent in the short-range
+ *  force calculation since the last check. If the load imbalance
+ *  exceeds a threshold, the boundaries are moved such that every slab
+ *  of nodes carries the same share of the load, and the particles are
+ *  redistributed by a global resort.
+ *
+ *  Implementation in load_balancing.cpp.
+ */
+
+#include <vector>
+
+/** Measure for the load of a node. */
+enum LoadMetric : int {
+  /** Number of local particles. */
+  LOAD_METRIC_PARTICLES = 0,
+  /** Time spent in the short-range force calculation. */
+  LOAD_METRIC_FORCE_TIME = 1
+};
+
+struct LoadBalancingParameters {
+  /** Whether the node boundaries are adapted to the load. */
+  bool active = false;
+  /** Maximal tolerated imbalance, i.e. maximal load over mean load
+   *  minus one.
+   */
+  double threshold = 0.1;
+  /** Number of integration steps between two load checks. */
+  int interval = 100;
+  LoadMetric metric = LOAD_METRIC_PARTICLES;
+};
+
+extern LoadBalancingParameters load_balancing_params;
+
+/** Minimal width of a subdomain in units of the equally spaced width. */
+constexpr double load_balancing_min_relative_width = 0.1;
+
+/**
+ * @brief Move the node boundaries along one direction to balance the load.
+ *
+ * The load is assumed to be uniformly distributed within every slab.
+ * The new boundaries split the cumulative load into equal parts, while
+ * keeping every slab at least @p min_width wide.
+ *
+ * @param boundaries Relative node boundaries, from 0 to 1.
+ * @param loads Load of every slab between two boundaries.
+ * @param min_width Minimal relative width of a slab.
+ * @return New relative node boundaries.
+ */
+std::vector<double> balance_boundaries(std::vector<double> const &boundaries,
+                                       std::vector<double> const &loads,
+                                       double min_width);
+
+/** @brief Add to the short-range force time of this node. */
+void load_balancing_add_force_time(double seconds);
+
+/** @brief Count an integration step and rebalance the load if needed.
+ *
+ *  Has to be called on all nodes.
+ */
+void load_balancing_step();
+
+/** @brief Check whether load balancing is compatible with the active
+ *  methods.
+ */
+bool load_balancing_supported();
+
+/** @brief Check load balancing parameters and incompatibilities. */
+void load_balancing_sanity_checks();
+
+/** @brief Reset to equally spaced node boundaries if the active methods
+ *  do not support shifted ones.
+ */
+void load_balancing_on_method_change();
+
+/** @brief Set the load balancing parameters on all nodes.
+ *
+ *  Deactivating load balancing restores the equally spaced node grid.
+ */
+void mpi_set_load_balancing(bool active, double threshold, int interval,
+                            int metric);
+
+#endif
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CENTRAL_POTENTIALS_HPP
+#define CENTRAL_POTENTIALS_HPP
+/** \file
+ *  Dispatch of the central non-bonded potentials.
+ *
+ *  Every type pair stores the set of its active central potentials
+ *  in @ref IA_parameters::central_potentials, so that the force and
+ *  energy of a pair only evaluate the kernels of these potentials.
+ */
+
+#include "config.hpp"
+
+#include "nonbonded_interactions/bmhtf-nacl.hpp"
+#include "nonbonded_interactions/buckingham.hpp"
+#include "nonbonded_interactions/gaussian.hpp"
+#include "nonbonded_interactions/hat.hpp"
+#include "nonbonded_interactions/hertzian.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/ljcos.hpp"
+#include "nonbonded_interactions/ljcos2.hpp"
+#include "nonbonded_interactions/ljgen.hpp"
+#include "nonbonded_interactions/morse.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "nonbonded_interactions/nonbonded_tab.hpp"
+#include "nonbonded_interactions/smooth_step.hpp"
+#include "nonbonded_interactions/soft_sphere.hpp"
+#include "nonbonded_interactions/wca.hpp"
+
+#include <array>
+
+/** Kernels of a central potential. */
+struct CentralPotentialKernels {
+  /** Force factor, the force is this times the distance vector. */
+  double (*force_factor)(IA_parameters const &, double);
+  /** Energy. */
+  double (*energy)(IA_parameters const &, double);
+};
+
+/** Kernels of the central potentials, in the order of
+ *  @ref CentralPotential.
+ */
+constexpr std::array<CentralPotentialKernels, N_CENTRAL_POTENTIALS>
+    central_potential_kernels = {{
+#ifdef LENNARD_JONES
+        {lj_pair_force_factor, lj_pair_energy},
+#endif
+#ifdef WCA
+        {wca_pair_force_factor, wca_pair_energy},
+#endif
+#ifdef LENNARD_JONES_GENERIC
+        {ljgen_pair_force_factor, ljgen_pair_energy},
+#endif
+#ifdef SMOOTH_STEP
+        {SmSt_pair_force_factor, SmSt_pair_energy},
+#endif
+#ifdef HERTZIAN
+        {hertzian_pair_force_factor, hertzian_pair_energy},
+#endif
+#ifdef GAUSSIAN
+        {gaussian_pair_force_factor, gaussian_pair_energy},
+#endif
+#ifdef BMHTF_NACL
+        {BMHTF_pair_force_factor, BMHTF_pair_energy},
+#endif
+#ifdef BUCKINGHAM
+        {buck_pair_force_factor, buck_pair_energy},
+#endif
+#ifdef MORSE
+        {morse_pair_force_factor, morse_pair_energy},
+#endif
+#ifdef SOFT_SPHERE
+        {soft_pair_force_factor, soft_pair_energy},
+#endif
+#ifdef HAT
+        {hat_pair_force_factor, hat_pair_energy},
+#endif
+#ifdef LJCOS
+        {ljcos_pair_force_factor, ljcos_pair_energy},
+#endif
+#ifdef LJCOS2
+        {ljcos2_pair_force_factor, ljcos2_pair_energy},
+#endif
+#ifdef TABULATED
+        {tabulated_pair_force_factor, tabulated_pair_energy},
+#endif
+    }};
+
+/** Call a functor with the kernels of all active central potentials
+ *  of a type pair.
+ */
+template <class F>
+void for_each_central_potential(IA_parameters const &ia_params, F &&f) {
+  auto mask = ia_params.central_potentials;
+  for (unsigned i = 0; mask != 0u; i++, mask >>= 1u) {
+    if (mask & 1u) {
+      f(central_potential_kernels[i]);
+    }
+  }
+}
+
+/** Sum of the force factors of the central potentials of a pair. */
+inline double central_pair_force_factor(IA_parameters const &ia_params,
+                                        double dist) {
+  double force_factor = 0.;
+  for_each_central_potential(
+      ia_params, [&](CentralPotentialKernels const &kernels) {
+        force_factor += kernels.force_factor(ia_params, dist);
+      });
+  return force_factor;
+}
+
+/** Sum of the energies of the central potentials of a pair. */
+inline double central_pair_energy(IA_parameters const &ia_params,
+                                  double dist) {
+  double energy = 0.;
+  for_each_central_potential(ia_params,
+                             [&](CentralPotentialKernels const &kernels) {
+                               energy += kernels.energy(ia_params, dist);
+                             });
+  return energy;
+}
+
+#endif
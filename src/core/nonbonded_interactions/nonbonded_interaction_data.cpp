@@ -49,6 +49,7 @@
  *****************************************/
 int max_seen_particle_type = 0;
 std::vector<IA_parameters> ia_params;
+std::vector<BatchIAParameters> batch_ia_params;
 
 double min_global_cut = INACTIVE_CUTOFF;
 
@@ -96,7 +97,8 @@ static double recalc_long_range_cutoff() {
   return max_cut_long_range;
 }
 
-static double recalc_maximal_cutoff(const IA_parameters &data) {
+/** Maximal cutoff of the potentials in @ref BatchIAParameters. */
+static double recalc_maximal_cutoff_batched(const IA_parameters &data) {
   auto max_cut_current = INACTIVE_CUTOFF;
 
 #ifdef LENNARD_JONES
@@ -107,6 +109,13 @@ static double recalc_maximal_cutoff(const IA_parameters &data) {
   max_cut_current = std::max(max_cut_current, data.wca.cut);
 #endif
 
+  return max_cut_current;
+}
+
+/** Maximal cutoff of the potentials not in @ref BatchIAParameters. */
+static double recalc_maximal_cutoff_other(const IA_parameters &data) {
+  auto max_cut_current = INACTIVE_CUTOFF;
+
 #ifdef DPD
   max_cut_current = std::max(
       max_cut_current, std::max(data.dpd_radial.cutoff, data.dpd_trans.cutoff));
@@ -178,11 +187,106 @@ static double recalc_maximal_cutoff(const IA_parameters &data) {
   return max_cut_current;
 }
 
-double maximal_cutoff_nonbonded() {
-  auto max_cut_nonbonded = INACTIVE_CUTOFF;
+static double recalc_maximal_cutoff(const IA_parameters &data) {
+  return std::max(recalc_maximal_cutoff_batched(data),
+                  recalc_maximal_cutoff_other(data));
+}
+
+static_assert(N_CENTRAL_POTENTIALS <= 8 * sizeof(unsigned),
+              "Too many central potentials for the bit mask.");
+
+/** Bit mask of the central potentials with positive cutoff. */
+static unsigned recalc_central_potentials(const IA_parameters &data) {
+  auto mask = 0u;
+  auto const add = [&mask](CentralPotential potential, double cut) {
+    if (cut > 0.)
+      mask |= 1u << potential;
+  };
+
+#ifdef LENNARD_JONES
+  add(CENTRAL_POTENTIAL_LJ, data.lj.cut + data.lj.offset);
+#endif
+#ifdef WCA
+  add(CENTRAL_POTENTIAL_WCA, data.wca.cut);
+#endif
+#ifdef LENNARD_JONES_GENERIC
+  add(CENTRAL_POTENTIAL_LJGEN, data.ljgen.cut + data.ljgen.offset);
+#endif
+#ifdef SMOOTH_STEP
+  add(CENTRAL_POTENTIAL_SMOOTH_STEP, data.smooth_step.cut);
+#endif
+#ifdef HERTZIAN
+  add(CENTRAL_POTENTIAL_HERTZIAN, data.hertzian.sig);
+#endif
+#ifdef GAUSSIAN
+  add(CENTRAL_POTENTIAL_GAUSSIAN, data.gaussian.cut);
+#endif
+#ifdef BMHTF_NACL
+  add(CENTRAL_POTENTIAL_BMHTF, data.bmhtf.cut);
+#endif
+#ifdef BUCKINGHAM
+  add(CENTRAL_POTENTIAL_BUCKINGHAM, data.buckingham.cut);
+#endif
+#ifdef MORSE
+  add(CENTRAL_POTENTIAL_MORSE, data.morse.cut);
+#endif
+#ifdef SOFT_SPHERE
+  add(CENTRAL_POTENTIAL_SOFT_SPHERE,
+      data.soft_sphere.cut + data.soft_sphere.offset);
+#endif
+#ifdef HAT
+  add(CENTRAL_POTENTIAL_HAT, data.hat.r);
+#endif
+#ifdef LJCOS
+  add(CENTRAL_POTENTIAL_LJCOS, data.ljcos.cut + data.ljcos.offset);
+#endif
+#ifdef LJCOS2
+  add(CENTRAL_POTENTIAL_LJCOS2, data.ljcos2.cut + data.ljcos2.offset);
+#endif
+#ifdef TABULATED
+  add(CENTRAL_POTENTIAL_TABULATED, data.tab.cutoff());
+#endif
+
+  return mask;
+}
 
+static BatchIAParameters batch_parameters(const IA_parameters &data) {
+  BatchIAParameters params{};
+#ifdef LENNARD_JONES
+  params.lj = data.lj;
+#endif
+#ifdef WCA
+  params.wca = data.wca;
+#endif
+  params.batched = (recalc_maximal_cutoff_other(data) == INACTIVE_CUTOFF);
+
+  return params;
+}
+
+/** Update @ref batch_ia_params from @ref ia_params. */
+static void recalc_batch_ia_params() {
+  auto const n = max_seen_particle_type;
+  batch_ia_params.resize(n * n);
+
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) {
+      batch_ia_params[i * n + j] = batch_parameters(*get_ia_param(i, j));
+    }
+}
+
+void recalc_ia_params() {
   for (auto &data : ia_params) {
     data.max_cut = recalc_maximal_cutoff(data);
+    data.central_potentials = recalc_central_potentials(data);
+  }
+
+  recalc_batch_ia_params();
+}
+
+double maximal_cutoff_nonbonded() {
+  auto max_cut_nonbonded = INACTIVE_CUTOFF;
+
+  for (auto const &data : ia_params) {
     max_cut_nonbonded = std::max(max_cut_nonbonded, data.max_cut);
   }
 
@@ -222,6 +326,8 @@ void realloc_ia_params(int nsize) {
 
   max_seen_particle_type = nsize;
   std::swap(ia_params, new_params);
+
+  recalc_ia_params();
 }
 
 void reset_ia_params() {
@@ -42,6 +42,57 @@
  */
 constexpr double INACTIVE_CUTOFF = -1.;
 
+/** Central non-bonded potentials, i.e. potentials that only depend on
+ *  the types and the distance of the particles. The values are the bit
+ *  positions in @ref IA_parameters::central_potentials, and the indices
+ *  of the kernels in @ref central_potential_kernels.
+ */
+enum CentralPotential : unsigned {
+#ifdef LENNARD_JONES
+  CENTRAL_POTENTIAL_LJ,
+#endif
+#ifdef WCA
+  CENTRAL_POTENTIAL_WCA,
+#endif
+#ifdef LENNARD_JONES_GENERIC
+  CENTRAL_POTENTIAL_LJGEN,
+#endif
+#ifdef SMOOTH_STEP
+  CENTRAL_POTENTIAL_SMOOTH_STEP,
+#endif
+#ifdef HERTZIAN
+  CENTRAL_POTENTIAL_HERTZIAN,
+#endif
+#ifdef GAUSSIAN
+  CENTRAL_POTENTIAL_GAUSSIAN,
+#endif
+#ifdef BMHTF_NACL
+  CENTRAL_POTENTIAL_BMHTF,
+#endif
+#ifdef BUCKINGHAM
+  CENTRAL_POTENTIAL_BUCKINGHAM,
+#endif
+#ifdef MORSE
+  CENTRAL_POTENTIAL_MORSE,
+#endif
+#ifdef SOFT_SPHERE
+  CENTRAL_POTENTIAL_SOFT_SPHERE,
+#endif
+#ifdef HAT
+  CENTRAL_POTENTIAL_HAT,
+#endif
+#ifdef LJCOS
+  CENTRAL_POTENTIAL_LJCOS,
+#endif
+#ifdef LJCOS2
+  CENTRAL_POTENTIAL_LJCOS2,
+#endif
+#ifdef TABULATED
+  CENTRAL_POTENTIAL_TABULATED,
+#endif
+  N_CENTRAL_POTENTIALS
+};
+
 /** Lennard-Jones with shift */
 struct LJ_Parameters {
   double eps = 0.0;
@@ -205,6 +256,12 @@ struct IA_parameters {
    */
   double max_cut = INACTIVE_CUTOFF;
 
+  /** Bit mask of the @ref CentralPotential "central potentials"
+   *  with a positive cutoff for this pair of particle types.
+   *  Updated together with @ref max_cut.
+   */
+  unsigned central_potentials = 0u;
+
 #ifdef LENNARD_JONES
   LJ_Parameters lj;
 #endif
@@ -280,13 +337,35 @@ struct IA_parameters {
 
 extern std::vector<IA_parameters> ia_params;
 
+/** Parameters of the potentials of a type pair that can be evaluated
+ *  for several pairs at once, see @ref add_central_pair_forces_batch.
+ */
+struct BatchIAParameters {
+#ifdef LENNARD_JONES
+  LJ_Parameters lj;
+#endif
+#ifdef WCA
+  WCA_Parameters wca;
+#endif
+  /** Whether the type pair has no other active potentials. */
+  bool batched = true;
+};
+
+/** Batch parameters of all type pairs, stored as full matrix. */
+extern std::vector<BatchIAParameters> batch_ia_params;
+
 /** Maximal particle type seen so far. */
 extern int max_seen_particle_type;
 
 /** Maximal interaction cutoff (real space/short range non-bonded
- *  interactions).
+ *  interactions), as of the last call of @ref recalc_ia_params.
  */
 double maximal_cutoff_nonbonded();
+
+/** Update the cutoffs and the active central potentials of all
+ *  non-bonded interactions. Has to be called when @ref ia_params change.
+ */
+void recalc_ia_params();
 /** Maximal interaction cutoff (bonded interactions).
  */
 double maximal_cutoff_bonded();
@@ -316,6 +395,23 @@ inline IA_parameters *get_ia_param(int i, int j) {
                                             max_seen_particle_type)];
 }
 
+/**
+ * @brief Get the batch parameters of a particle type with all types.
+ *
+ * @param i Type, has to be smaller than @ref max_seen_particle_type.
+ *
+ * @return Pointer to the batch parameters of the type pairs (i, j),
+ *         which can be indexed by j.
+ */
+inline BatchIAParameters const *get_batch_ia_params(int i) {
+  assert(i >= 0 && i < max_seen_particle_type);
+  assert(batch_ia_params.size() ==
+         static_cast<std::size_t>(max_seen_particle_type) *
+             static_cast<std::size_t>(max_seen_particle_type));
+
+  return batch_ia_params.data() + i * max_seen_particle_type;
+}
+
 /** Get interaction parameters between particle types i and j.
  *  Slower than @ref get_ia_param, but can also be used on not
  *  yet present particle types
@@ -339,7 +435,8 @@ void make_particle_type_exist(int type);
 
 void make_particle_type_exist_local(int type);
 
-/** This function increases the LOCAL ia_params field to the given size.
+/** This function increases the LOCAL ia_params field to the given size
+ *  and updates the derived parameters.
  *  Better use \ref make_particle_type_exist since it takes care of
  *  the other nodes.
  */
@@ -49,6 +49,11 @@ public:
     histogram.normalize();
     return histogram.get_histogram();
   }
+
+  boost::optional<std::vector<double>> evaluate_in_situ() const override {
+    return in_situ_histogram(
+        ids(), histogram_params(ParticleHistogram::Value::one));
+  }
 };
 
 } // Namespace Observables
@@ -58,6 +58,11 @@ public:
     auto const b = n_bins();
     return {b[0], b[1], b[2], 3};
   }
+
+  boost::optional<std::vector<double>> evaluate_in_situ() const override {
+    return in_situ_histogram(
+        ids(), histogram_params(ParticleHistogram::Value::velocity));
+  }
 };
 
 } // Namespace Observables
@@ -22,6 +22,7 @@
 #include <utility>
 
 #include "CylindricalProfileObservable.hpp"
+#include "ParticleHistogram.hpp"
 #include "PidObservable.hpp"
 
 namespace Observables {
@@ -39,6 +40,20 @@ public:
         CylindricalProfileObservable(std::move(transform_params), n_r_bins,
                                      n_phi_bins, n_z_bins, min_r, max_r,
                                      min_phi, max_phi, min_z, max_z) {}
+
+protected:
+  /** Histogram over the cylindrical bins of the profile. */
+  ParticleHistogram histogram_params(ParticleHistogram::Value value) const {
+    ParticleHistogram params;
+    params.coordinates = ParticleHistogram::Coordinates::cylindrical;
+    params.value = value;
+    params.n_bins = n_bins();
+    params.limits = limits();
+    params.center = transform_params->center();
+    params.axis = transform_params->axis();
+    params.orientation = transform_params->orientation();
+    return params;
+  }
 };
 
 } // Namespace Observables
@@ -65,6 +65,12 @@ public:
     auto const b = n_bins();
     return {b[0], b[1], b[2], 3};
   }
+
+  boost::optional<std::vector<double>> evaluate_in_situ() const override {
+    auto params = histogram_params(ParticleHistogram::Value::velocity);
+    params.normalization = ParticleHistogram::Normalization::count;
+    return in_situ_histogram(ids(), params);
+  }
 };
 
 } // Namespace Observables
@@ -50,6 +50,11 @@ public:
     histogram.normalize();
     return histogram.get_histogram();
   }
+
+  boost::optional<std::vector<double>> evaluate_in_situ() const override {
+    return in_situ_histogram(
+        ids(), histogram_params(ParticleHistogram::Value::force));
+  }
 };
 
 } // Namespace Observables
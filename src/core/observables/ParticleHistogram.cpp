@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ParticleHistogram.hpp"
+
+#include "BoxGeometry.hpp"
+#include "CellStructure.hpp"
+#include "Particle.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "grid.hpp"
+
+#include <utils/Histogram.hpp>
+#include <utils/Vector.hpp>
+#include <utils/math/coordinate_transformation.hpp>
+
+#include <boost/mpi/collectives/reduce.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Observables {
+namespace {
+/** @brief Fill a histogram with the local particles in @p multiplicity.
+ *  @return The histogram, the counts per bin and the number of particles.
+ */
+template <class Histogram, class Map>
+std::vector<double>
+local_histogram(ParticleHistogram const &params,
+                std::vector<int> const &multiplicity, Map map) {
+  std::size_t const n_values =
+      (params.value == ParticleHistogram::Value::one) ? 1 : 3;
+  Histogram histogram(params.n_bins, n_values, params.limits);
+
+  auto n_particles = 0;
+  for (auto const &p : cell_structure.local_particles()) {
+    auto const id = static_cast<std::size_t>(p.identity());
+    if (id >= multiplicity.size() or multiplicity[id] == 0)
+      continue;
+    auto const pos = folded_position(p.r.p, box_geo);
+    for (int i = 0; i < multiplicity[id]; ++i) {
+      switch (params.value) {
+      case ParticleHistogram::Value::one:
+        histogram.update(map(pos));
+        break;
+      case ParticleHistogram::Value::velocity:
+        histogram.update(map(pos), map(pos, p.m.v));
+        break;
+      case ParticleHistogram::Value::force:
+        histogram.update(map(pos), map(pos, p.f.f));
+        break;
+      }
+    }
+    n_particles += multiplicity[id];
+  }
+
+  if (params.normalization == ParticleHistogram::Normalization::volume) {
+    histogram.normalize();
+  }
+  auto result = histogram.get_histogram();
+  auto const counts = histogram.get_tot_count();
+  result.insert(result.end(), counts.begin(), counts.end());
+  result.push_back(static_cast<double>(n_particles));
+  return result;
+}
+
+struct CartesianMap {
+  Utils::Vector3d operator()(Utils::Vector3d const &pos) const { return pos; }
+  Utils::Vector3d operator()(Utils::Vector3d const &,
+                             Utils::Vector3d const &vec) const {
+    return vec;
+  }
+};
+
+struct CylindricalMap {
+  Utils::Vector3d center;
+  Utils::Vector3d axis;
+  Utils::Vector3d orientation;
+
+  Utils::Vector3d operator()(Utils::Vector3d const &pos) const {
+    return Utils::transform_coordinate_cartesian_to_cylinder(
+        pos - center, axis, orientation);
+  }
+  Utils::Vector3d operator()(Utils::Vector3d const &pos,
+                             Utils::Vector3d const &vec) const {
+    return Utils::transform_vector_cartesian_to_cylinder(vec, axis,
+                                                         pos - center);
+  }
+};
+
+/** @brief Histogram of the local particles, reduced on the head node.
+ *
+ *  The histograms are normalized by the bin volumes before the
+ *  reduction, which is linear. The last entry is the number of
+ *  particles found on all nodes.
+ */
+std::vector<double> particle_histogram_local(std::vector<int> const &ids,
+                                             ParticleHistogram const &params) {
+  auto const max_id =
+      ids.empty() ? -1 : *std::max_element(ids.begin(), ids.end());
+  std::vector<int> multiplicity(static_cast<std::size_t>(max_id + 1));
+  for (auto const id : ids) {
+    if (id >= 0)
+      ++multiplicity[id];
+  }
+
+  auto const histogram =
+      (params.coordinates == ParticleHistogram::Coordinates::cartesian)
+          ? local_histogram<Utils::Histogram<double, 3>>(params, multiplicity,
+                                                         CartesianMap{})
+          : local_histogram<Utils::CylindricalHistogram<double, 3>>(
+                params, multiplicity,
+                CylindricalMap{params.center, params.axis,
+                               params.orientation});
+
+  std::vector<double> total(histogram.size());
+  boost::mpi::reduce(comm_cart, histogram.data(),
+                     static_cast<int>(histogram.size()), total.data(),
+                     std::plus<double>(), 0);
+  return total;
+}
+} // namespace
+
+REGISTER_CALLBACK_MASTER_RANK(particle_histogram_local)
+
+boost::optional<std::vector<double>>
+in_situ_histogram(std::vector<int> const &ids,
+                  ParticleHistogram const &histogram) {
+  auto result = mpi_call(::Communication::Result::master_rank,
+                         particle_histogram_local, ids, histogram);
+  if (static_cast<std::size_t>(result.back()) != ids.size()) {
+    return boost::none;
+  }
+  result.pop_back();
+
+  /* the first half are the bins, the second half the counts */
+  auto const n_bins_total = result.size() / 2;
+  if (histogram.normalization == ParticleHistogram::Normalization::count) {
+    for (std::size_t ind = 0; ind < n_bins_total; ++ind) {
+      if (result[n_bins_total + ind] > 0.) {
+        result[ind] /= result[n_bins_total + ind];
+      }
+    }
+  }
+  result.resize(n_bins_total);
+  return {std::move(result)};
+}
+
+} // namespace Observables
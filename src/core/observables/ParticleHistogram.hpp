@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OBSERVABLES_PARTICLEHISTOGRAM_HPP
+#define OBSERVABLES_PARTICLEHISTOGRAM_HPP
+
+#include <utils/Vector.hpp>
+
+#include <boost/optional.hpp>
+#include <boost/serialization/array.hpp>
+#include <boost/serialization/utility.hpp>
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Observables {
+
+/** @brief Histogram of a particle property over the particle positions.
+ *
+ *  This describes the contribution of a single particle to a profile,
+ *  so that the profile can be evaluated in situ: every node sorts its
+ *  local particles into the bins, and the histograms of the nodes are
+ *  summed up on the head node.
+ */
+struct ParticleHistogram {
+  enum class Coordinates : int { cartesian, cylindrical };
+  enum class Value : int { one, velocity, force };
+  enum class Normalization : int {
+    /** Divide by the bin volume. */
+    volume,
+    /** Divide by the number of particles in the bin. */
+    count
+  };
+
+  Coordinates coordinates = Coordinates::cartesian;
+  /** Value added to the bins, vectors are transformed to the coordinates
+   *  of the histogram.
+   */
+  Value value = Value::one;
+  Normalization normalization = Normalization::volume;
+  std::array<std::size_t, 3> n_bins;
+  std::array<std::pair<double, double>, 3> limits;
+  /** @name Cylindrical coordinate system */
+  /**@{*/
+  Utils::Vector3d center;
+  Utils::Vector3d axis;
+  Utils::Vector3d orientation;
+  /**@}*/
+
+  template <class Archive>
+  void serialize(Archive &ar, long int /* version */) {
+    ar &coordinates &value &normalization &n_bins &limits &center &axis
+        &orientation;
+  }
+};
+
+/** @brief Evaluate a histogram of a group of particles in situ.
+ *
+ *  Particles which appear several times in @p ids are counted as often.
+ *
+ *  @param ids        Particle identifiers.
+ *  @param histogram  Parameters of the histogram.
+ *  @return The flat histogram, or nothing if some of the particles do
+ *          not exist.
+ */
+boost::optional<std::vector<double>>
+in_situ_histogram(std::vector<int> const &ids,
+                  ParticleHistogram const &histogram);
+
+} // namespace Observables
+#endif
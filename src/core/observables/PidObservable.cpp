@@ -22,10 +22,15 @@
 #include "fetch_particles.hpp"
 
 #include <functional>
+#include <utility>
 #include <vector>
 
 namespace Observables {
 std::vector<double> PidObservable::operator()() const {
+  if (auto result = evaluate_in_situ()) {
+    return std::move(*result);
+  }
+
   std::vector<Particle> particles = fetch_particles(ids());
 
   std::vector<std::reference_wrapper<const Particle>> particle_refs(
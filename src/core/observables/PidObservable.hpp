@@ -30,6 +30,7 @@
 #include <utils/Vector.hpp>
 #include <utils/flatten.hpp>
 
+#include <boost/optional.hpp>
 #include <boost/range/algorithm/copy.hpp>
 
 #include <cstddef>
@@ -57,6 +58,16 @@ class PidObservable : virtual public Observable {
   evaluate(ParticleReferenceRange particles,
            const ParticleObservables::traits<Particle> &traits) const = 0;
 
+  /** @brief Evaluate on the local particles of every node.
+   *  Observables which are reductions over the particles can override
+   *  this to avoid fetching the particles to the head node.
+   *  @return The result, or nothing if the observable has to be
+   *          evaluated on the fetched particles.
+   */
+  virtual boost::optional<std::vector<double>> evaluate_in_situ() const {
+    return boost::none;
+  }
+
 public:
   explicit PidObservable(std::vector<int> ids) : m_ids(std::move(ids)) {}
   std::vector<double> operator()() const final;
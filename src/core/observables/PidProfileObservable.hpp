@@ -19,6 +19,7 @@
 #ifndef OBSERVABLES_PIDPROFILEOBSERVABLE_HPP
 #define OBSERVABLES_PIDPROFILEOBSERVABLE_HPP
 
+#include "ParticleHistogram.hpp"
 #include "PidObservable.hpp"
 #include "ProfileObservable.hpp"
 
@@ -35,6 +36,16 @@ public:
       : PidObservable(ids),
         ProfileObservable(n_x_bins, n_y_bins, n_z_bins, min_x, max_x, min_y,
                           max_y, min_z, max_z) {}
+
+protected:
+  /** Histogram over the Cartesian bins of the profile. */
+  ParticleHistogram histogram_params(ParticleHistogram::Value value) const {
+    ParticleHistogram params;
+    params.value = value;
+    params.n_bins = n_bins();
+    params.limits = limits();
+    return params;
+  }
 };
 
 } // Namespace Observables
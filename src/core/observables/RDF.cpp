@@ -19,6 +19,10 @@
 #include "RDF.hpp"
 
 #include "BoxGeometry.hpp"
+#include "CellStructure.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "event.hpp"
 #include "fetch_particles.hpp"
 #include "grid.hpp"
 
@@ -28,12 +32,124 @@
 #include <utils/for_each_pair.hpp>
 #include <utils/math/int_pow.hpp>
 
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/collectives/reduce.hpp>
 #include <boost/range/algorithm/transform.hpp>
+
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <functional>
 
 namespace Observables {
+namespace {
+/** @brief Histogram bin of a distance in [@p min_r, @p max_r).
+ *
+ *  Distances just below @p max_r can be rounded up to @p n_r_bins,
+ *  they are put in the last bin.
+ */
+int rdf_bin(double dist, double min_r, double inv_bin_width, int n_r_bins) {
+  auto const ind = static_cast<int>(std::floor((dist - min_r) * inv_bin_width));
+  return std::min(ind, n_r_bins - 1);
+}
+
+/** @brief Whether the pair loop of the cell system finds all pairs closer
+ *  than @p max_r, each with its minimum image only.
+ */
+bool pair_loop_in_range(double max_r) {
+  auto const range = cell_structure.max_range();
+  auto valid = true;
+  for (unsigned int i = 0; i < 3; i++) {
+    valid &= max_r <= range[i];
+    if (box_geo.periodic(i))
+      valid &= 2. * max_r <= box_geo.length()[i];
+  }
+  return boost::mpi::all_reduce(comm_cart, valid, std::logical_and<bool>());
+}
+
+/** @brief Distance histogram of the local pairs, reduced on the head node.
+ *
+ *  The pairs are taken from the cell system, so that every node only
+ *  looks at its own particles and their ghosts. The last two entries of
+ *  the histogram are the numbers of particles in the two groups.
+ *
+ *  @return The histogram, or an empty vector if @p max_r exceeds the range
+ *          of the cell system.
+ */
+std::vector<double> rdf_histogram_local(std::vector<int> const &ids1,
+                                        std::vector<int> const &ids2,
+                                        double min_r, double max_r,
+                                        int n_r_bins) {
+  on_observable_calc();
+  if (not pair_loop_in_range(max_r)) {
+    return {};
+  }
+
+  /* group membership by particle id: bit 0 for ids1, bit 1 for ids2 */
+  auto const max_id = std::max(
+      ids1.empty() ? -1 : *std::max_element(ids1.begin(), ids1.end()),
+      ids2.empty() ? -1 : *std::max_element(ids2.begin(), ids2.end()));
+  std::vector<unsigned char> groups(static_cast<std::size_t>(max_id + 1));
+  for (auto const id : ids1)
+    groups[id] |= 1u;
+  for (auto const id : ids2)
+    groups[id] |= 2u;
+  auto const group = [&groups](Particle const &p) -> unsigned {
+    auto const id = static_cast<std::size_t>(p.identity());
+    return (id < groups.size()) ? groups[id] : 0u;
+  };
+
+  std::vector<double> histogram(n_r_bins + 2, 0.);
+  auto const inv_bin_width = static_cast<double>(n_r_bins) / (max_r - min_r);
+  auto const max_r2 = max_r * max_r;
+  cell_structure.non_bonded_loop([&](Particle const &p1, Particle const &p2,
+                                     Distance const &d) {
+    if (d.dist2 >= max_r2)
+      return;
+    auto const dist = std::sqrt(d.dist2);
+    if (dist <= min_r)
+      return;
+    auto const g1 = group(p1);
+    auto const g2 = group(p2);
+    /* every pair is visited once, but counts in both directions */
+    auto const weight = ids2.empty()
+                            ? static_cast<int>((g1 & g2 & 1u) != 0u)
+                            : static_cast<int>((g1 & 1u) and (g2 & 2u)) +
+                                  static_cast<int>((g1 & 2u) and (g2 & 1u));
+    if (weight) {
+      histogram[rdf_bin(dist, min_r, inv_bin_width, n_r_bins)] += weight;
+    }
+  });
+  for (auto const &p : cell_structure.local_particles()) {
+    auto const g = group(p);
+    histogram[n_r_bins] += static_cast<double>(g & 1u);
+    histogram[n_r_bins + 1] += static_cast<double>((g & 2u) >> 1u);
+  }
+
+  std::vector<double> total(histogram.size());
+  boost::mpi::reduce(comm_cart, histogram.data(),
+                     static_cast<int>(histogram.size()), total.data(),
+                     std::plus<double>(), 0);
+  return total;
+}
+} // namespace
+
+REGISTER_CALLBACK_MASTER_RANK(rdf_histogram_local)
+
 std::vector<double> RDF::operator()() const {
+  if (min_r >= 0.) {
+    auto histogram =
+        mpi_call(::Communication::Result::master_rank, rdf_histogram_local,
+                 ids1(), ids2(), min_r, max_r, static_cast<int>(n_r_bins));
+    if (not histogram.empty()) {
+      auto const n1 = static_cast<long int>(histogram[n_r_bins]);
+      auto const n2 = static_cast<long int>(histogram[n_r_bins + 1]);
+      histogram.resize(n_r_bins);
+      auto const cnt = ids2().empty() ? n1 * (n1 - 1) / 2 : n1 * n2;
+      return normalize(std::move(histogram), cnt);
+    }
+  }
+
   std::vector<Particle> particles1 = fetch_particles(ids1());
   std::vector<const Particle *> particles_ptrs1(particles1.size());
   boost::transform(particles1, particles_ptrs1.begin(),
@@ -61,9 +177,7 @@ RDF::evaluate(Utils::Span<const Particle *const> particles1,
                             const Particle *const p2) {
     auto const dist = box_geo.get_mi_vector(p1->r.p, p2->r.p).norm();
     if (dist > min_r && dist < max_r) {
-      auto const ind =
-          static_cast<int>(std::floor((dist - min_r) * inv_bin_width));
-      res[ind]++;
+      res[rdf_bin(dist, min_r, inv_bin_width, static_cast<int>(n_r_bins))]++;
     }
     cnt++;
   };
@@ -73,9 +187,14 @@ RDF::evaluate(Utils::Span<const Particle *const> particles1,
     auto cmp = std::not_equal_to<const Particle *const>();
     Utils::for_each_cartesian_pair_if(particles1, particles2, op, cmp);
   }
+  return normalize(std::move(res), cnt);
+}
+
+std::vector<double> RDF::normalize(std::vector<double> res,
+                                   long int cnt) const {
   if (cnt == 0)
     return res;
-  // normalization
+  auto const bin_width = (max_r - min_r) / static_cast<double>(n_r_bins);
   auto const volume = box_geo.volume();
   for (int i = 0; i < n_r_bins; ++i) {
     auto const r_in = i * bin_width + min_r;
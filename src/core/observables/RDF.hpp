@@ -43,6 +43,9 @@ class RDF : public Observable {
   virtual std::vector<double>
   evaluate(Utils::Span<const Particle *const> particles1,
            Utils::Span<const Particle *const> particles2) const;
+  /** Normalize a histogram of @p cnt pairs by the ideal gas. */
+  std::vector<double> normalize(std::vector<double> histogram,
+                                long int cnt) const;
 
 public:
   // Range of the profile.
@@ -23,6 +23,8 @@
 #include "energy_inline.hpp"
 #include "particle_data.hpp"
 
+#include <boost/serialization/access.hpp>
+
 #include <stdexcept>
 
 namespace PairCriteria {
@@ -55,6 +57,12 @@ public:
 
 private:
   double m_cut_off;
+
+  friend boost::serialization::access;
+  template <class Archive>
+  void serialize(Archive &ar, long int /* version */) {
+    ar &m_cut_off;
+  }
 };
 
 /** True if the short range energy is larger than a cut_off */
@@ -76,6 +84,12 @@ public:
 
 private:
   double m_cut_off;
+
+  friend boost::serialization::access;
+  template <class Archive>
+  void serialize(Archive &ar, long int /* version */) {
+    ar &m_cut_off;
+  }
 };
 
 /** True if a bond of given type exists between the two particles */
@@ -90,6 +104,12 @@ public:
 
 private:
   int m_bond_type;
+
+  friend boost::serialization::access;
+  template <class Archive>
+  void serialize(Archive &ar, long int /* version */) {
+    ar &m_bond_type;
+  }
 };
 } // namespace PairCriteria
 
@@ -380,8 +380,6 @@ void mpi_update_particle_property(int id, const T &value) {
  ************************************************/
 bool type_list_enable;
 std::unordered_map<int, std::unordered_set<int>> particle_type_map{};
-void remove_id_from_map(int part_id, int type);
-void add_id_to_type_map(int part_id, int type);
 
 /**
  * @brief id -> rank
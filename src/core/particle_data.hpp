@@ -348,6 +348,17 @@ void auto_exclusions(int distance);
 
 void init_type_map(int type);
 
+/** @brief Remove a particle from the list of particles of a type.
+ *
+ *  This is done by @ref set_particle_type, it is only needed for
+ *  particles whose type was changed on their node.
+ */
+void remove_id_from_map(int part_id, int type);
+/** @brief Add a particle to the list of particles of a type,
+ *  see @ref remove_id_from_map.
+ */
+void add_id_to_type_map(int part_id, int type);
+
 /** Find a particle of given type and return its id */
 int get_random_p_id(int type, int random_index_in_type_map);
 int number_of_particles_with_type(int type);
@@ -47,4 +47,25 @@ double ConstantpHEnsemble::calculate_acceptance_probability(
   return bf;
 }
 
+/**
+ * Acceptance probability in a subvolume: the same expression with the
+ * particle numbers of the subvolume
+ */
+ParallelReaction ConstantpHEnsemble::parallel_reaction(
+    SingleReaction const &current_reaction) const {
+  ParallelReaction reaction;
+  reaction.reactant_types = current_reaction.reactant_types;
+  reaction.reactant_coefficients = current_reaction.reactant_coefficients;
+  reaction.product_types = current_reaction.product_types;
+  reaction.product_coefficients = current_reaction.product_coefficients;
+  reaction.factorial_terms = {{current_reaction.reactant_types[0],
+                               -current_reaction.reactant_coefficients[0]},
+                              {current_reaction.product_types[0],
+                               current_reaction.product_coefficients[0]}};
+  auto const pKa = -current_reaction.nu_bar * log10(current_reaction.gamma);
+  reaction.prefactor =
+      exp(current_reaction.nu_bar * log(10) * (m_constant_pH - pKa));
+  return reaction;
+}
+
 } // namespace ReactionMethods
@@ -48,6 +48,8 @@ protected:
       SingleReaction const &current_reaction, double E_pot_old,
       double E_pot_new,
       std::map<int, int> const &old_particle_numbers) const override;
+  ParallelReaction
+  parallel_reaction(SingleReaction const &current_reaction) const override;
 };
 
 } // namespace ReactionMethods
@@ -43,13 +43,87 @@
 
 namespace ReactionMethods {
 
+namespace {
+/** Charges and positions of particles, see
+ *  @ref calculate_long_range_energy_change.
+ */
+std::vector<ParticleCharge>
+get_particle_charges(std::vector<int> const &p_ids) {
+  std::vector<ParticleCharge> charges;
+#ifdef ELECTROSTATICS
+  for (auto const p_id : p_ids) {
+    auto const &p = get_particle_data(p_id);
+    charges.emplace_back(p.p.q, p.r.p);
+  }
+#else
+  static_cast<void>(p_ids);
+#endif
+  return charges;
+}
+} // namespace
+
 /**
  * Performs a randomly selected reaction in the reaction ensemble
  */
 int ReactionAlgorithm::do_reaction(int reaction_steps) {
+  // the long-range energy of the system is calculated once, the trials
+  // only calculate its change
+  auto long_range_energy = calculate_long_range_energy();
   for (int i = 0; i < reaction_steps; i++) {
     int reaction_id = i_random(static_cast<int>(reactions.size()));
-    generic_oneway_reaction(reactions[reaction_id]);
+    generic_oneway_reaction(reactions[reaction_id], long_range_energy);
+  }
+  return 0;
+}
+
+/**
+ * Performs trial reactions in all cells at once
+ */
+int ReactionAlgorithm::do_parallel_reaction(int reaction_steps) {
+  check_reaction_method();
+  if (box_is_cylindric_around_z_axis or box_has_wall_constraints) {
+    throw std::runtime_error(
+        "Parallel trials require the whole box as reaction volume");
+  }
+  ParallelTrialParameters params;
+  for (auto const &current_reaction : reactions) {
+    params.reactions.push_back(parallel_reaction(current_reaction));
+  }
+  params.charges_of_types = charges_of_types;
+  params.temperature = temperature;
+  params.exclusion_radius = exclusion_radius;
+  params.non_interacting_type = non_interacting_type;
+  params.reaction_steps = reaction_steps;
+  params.seed = i_random(std::numeric_limits<int>::max());
+  params.free_ids = m_empty_p_ids_smaller_than_max_seen_particle;
+  std::sort(params.free_ids.begin(), params.free_ids.end());
+  params.max_id = get_maximal_particle_id();
+
+  auto const result = run_parallel_trials(params);
+
+  for (std::size_t i = 0; i < reactions.size(); ++i) {
+    reactions[i].tried_moves += result.tried_moves[i];
+    reactions[i].accepted_moves += result.accepted_moves[i];
+  }
+
+  // the ids of deleted particles and the unused ids below the new maximal
+  // id are the holes in the id range
+  auto const max_id = get_maximal_particle_id();
+  std::vector<int> candidates = params.free_ids;
+  for (auto const &change : result.changes) {
+    if (change.new_type == -1)
+      candidates.push_back(change.p_id);
+  }
+  for (int p_id = params.max_id + 1; p_id < max_id; ++p_id) {
+    candidates.push_back(p_id);
+  }
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                   candidates.end());
+  m_empty_p_ids_smaller_than_max_seen_particle.clear();
+  for (auto const p_id : candidates) {
+    if (p_id < max_id and not particle_exists(p_id))
+      m_empty_p_ids_smaller_than_max_seen_particle.push_back(p_id);
   }
   return 0;
 }
@@ -133,26 +207,36 @@ void ReactionAlgorithm::set_cuboid_reaction_ensemble_volume() {
  */
 bool ReactionAlgorithm::all_reactant_particles_exist(
     SingleReaction const &current_reaction) const {
-  bool enough_particles = true;
+  // the reactant particles are drawn without replacement, a type can
+  // occur several times among the reactants
+  std::map<int, int> required_numbers;
   for (int i = 0; i < current_reaction.reactant_types.size(); i++) {
-    int current_number =
-        number_of_particles_with_type(current_reaction.reactant_types[i]);
-    if (current_number < current_reaction.reactant_coefficients[i]) {
-      enough_particles = false;
-      break;
-    }
+    required_numbers[current_reaction.reactant_types[i]] +=
+        current_reaction.reactant_coefficients[i];
   }
-  return enough_particles;
+  return std::all_of(required_numbers.begin(), required_numbers.end(),
+                     [](std::pair<int const, int> const &item) {
+                       return number_of_particles_with_type(item.first) >=
+                              item.second;
+                     });
 }
 
 /**
  * Stores the particle property of a random particle of the provided type into
- * the provided vector
+ * the provided vector. The particle is drawn without replacement from the
+ * particles that are not in @p drawn_p_ids yet, and its id is appended to
+ * @p drawn_p_ids.
  */
 void ReactionAlgorithm::append_particle_property_of_random_particle(
-    int type, std::vector<StoredParticleProperty> &list_of_particles) {
-  int random_index_in_type_map = i_random(number_of_particles_with_type(type));
-  int p_id = get_random_p_id(type, random_index_in_type_map);
+    int type, std::vector<StoredParticleProperty> &list_of_particles,
+    std::vector<int> &drawn_p_ids) {
+  int p_id;
+  do {
+    int random_index_in_type_map =
+        i_random(number_of_particles_with_type(type));
+    p_id = get_random_p_id(type, random_index_in_type_map);
+  } while (Utils::contains(drawn_p_ids, p_id));
+  drawn_p_ids.push_back(p_id);
   StoredParticleProperty property_of_part = {p_id, charges_of_types[type],
                                              type};
   list_of_particles.push_back(property_of_part);
@@ -170,6 +254,13 @@ ReactionAlgorithm::make_reaction_attempt(
   std::vector<StoredParticleProperty> hidden_particles_properties;
   std::vector<StoredParticleProperty> changed_particles_properties;
 
+  // draw all reactant particles before any particle is changed, so that
+  // the energy of the changed particles is calculated once before and
+  // once after the attempt
+  std::vector<int> drawn_p_ids;
+  std::vector<int> changed_particles_types;
+  std::vector<int> created_particles_types;
+
   for (int i = 0; i < std::min(current_reaction.product_types.size(),
                                current_reaction.reactant_types.size());
        i++) {
@@ -179,9 +270,9 @@ ReactionAlgorithm::make_reaction_attempt(
                                  current_reaction.reactant_coefficients[i]);
          j++) {
       append_particle_property_of_random_particle(
-          current_reaction.reactant_types[i], changed_particles_properties);
-      replace_particle(changed_particles_properties.back().p_id,
-                       current_reaction.product_types[i]);
+          current_reaction.reactant_types[i], changed_particles_properties,
+          drawn_p_ids);
+      changed_particles_types.push_back(current_reaction.product_types[i]);
     }
     // create product_coefficients(i)-reactant_coefficients(i) many product
     // particles iff product_coefficients(i)-reactant_coefficients(i)>0,
@@ -193,9 +284,7 @@ ReactionAlgorithm::make_reaction_attempt(
       for (int j = 0; j < current_reaction.product_coefficients[i] -
                               current_reaction.reactant_coefficients[i];
            j++) {
-        int p_id = create_particle(current_reaction.product_types[i]);
-        check_exclusion_radius(p_id);
-        p_ids_created_particles.push_back(p_id);
+        created_particles_types.push_back(current_reaction.product_types[i]);
       }
     } else if (current_reaction.reactant_coefficients[i] -
                    current_reaction.product_coefficients[i] >
@@ -204,9 +293,8 @@ ReactionAlgorithm::make_reaction_attempt(
                               current_reaction.product_coefficients[i];
            j++) {
         append_particle_property_of_random_particle(
-            current_reaction.reactant_types[i], hidden_particles_properties);
-        check_exclusion_radius(hidden_particles_properties.back().p_id);
-        hide_particle(hidden_particles_properties.back().p_id);
+            current_reaction.reactant_types[i], hidden_particles_properties,
+            drawn_p_ids);
       }
     }
   }
@@ -221,20 +309,39 @@ ReactionAlgorithm::make_reaction_attempt(
       // hide superfluous reactant_types particles
       for (int j = 0; j < current_reaction.reactant_coefficients[i]; j++) {
         append_particle_property_of_random_particle(
-            current_reaction.reactant_types[i], hidden_particles_properties);
-        check_exclusion_radius(hidden_particles_properties.back().p_id);
-        hide_particle(hidden_particles_properties.back().p_id);
+            current_reaction.reactant_types[i], hidden_particles_properties,
+            drawn_p_ids);
       }
     } else {
       // create additional product_types particles
       for (int j = 0; j < current_reaction.product_coefficients[i]; j++) {
-        int p_id = create_particle(current_reaction.product_types[i]);
-        check_exclusion_radius(p_id);
-        p_ids_created_particles.push_back(p_id);
+        created_particles_types.push_back(current_reaction.product_types[i]);
       }
     }
   }
 
+  auto const energy_old = calculate_particles_energy(drawn_p_ids);
+  m_charges_old = get_particle_charges(drawn_p_ids);
+
+  for (std::size_t k = 0; k < changed_particles_properties.size(); k++) {
+    replace_particle(changed_particles_properties[k].p_id,
+                     changed_particles_types[k]);
+  }
+  for (auto const &hidden_particle : hidden_particles_properties) {
+    check_exclusion_radius(hidden_particle.p_id);
+    hide_particle(hidden_particle.p_id);
+  }
+  for (auto const type : created_particles_types) {
+    int p_id = create_particle(type);
+    check_exclusion_radius(p_id);
+    p_ids_created_particles.push_back(p_id);
+  }
+
+  drawn_p_ids.insert(drawn_p_ids.end(), p_ids_created_particles.begin(),
+                     p_ids_created_particles.end());
+  m_energy_change = calculate_particles_energy(drawn_p_ids) - energy_old;
+  m_charges_new = get_particle_charges(drawn_p_ids);
+
   return {changed_particles_properties, p_ids_created_particles,
           hidden_particles_properties};
 }
@@ -289,7 +396,7 @@ std::map<int, int> ReactionAlgorithm::save_old_particle_numbers(
  * are more reactants than products, old reactant particles are deleted.
  */
 void ReactionAlgorithm::generic_oneway_reaction(
-    SingleReaction &current_reaction) {
+    SingleReaction &current_reaction, double &long_range_energy) {
 
   current_reaction.tried_moves += 1;
   particle_inside_exclusion_radius_touched = false;
@@ -299,17 +406,12 @@ void ReactionAlgorithm::generic_oneway_reaction(
     return;
   }
 
-  // calculate potential energy
-  const double E_pot_old =
-      calculate_current_potential_energy_of_system(); // only consider potential
-                                                      // energy since we assume
-                                                      // that the kinetic part
-                                                      // drops out in the
-                                                      // process of calculating
-                                                      // ensemble averages
-                                                      // (kinetic part may be
-                                                      // separated and crossed
-                                                      // out)
+  // calculate potential energy: only consider potential energy since we
+  // assume that the kinetic part drops out in the process of calculating
+  // ensemble averages (kinetic part may be separated and crossed out);
+  // the change of the short-range part is calculated by the reaction
+  // attempt, the long-range part from the charges changed by the attempt
+  const double E_pot_old = long_range_energy;
 
   // find reacting molecules in reactants and save their properties for later
   // recreation if step is not accepted
@@ -329,9 +431,14 @@ void ReactionAlgorithm::generic_oneway_reaction(
            hidden_particles_properties) =
       make_reaction_attempt(current_reaction);
 
+  auto const long_range_energy_new =
+      (particle_inside_exclusion_radius_touched)
+          ? std::numeric_limits<double>::max()
+          : long_range_energy + calculate_long_range_energy_change(
+                                    m_charges_old, m_charges_new);
   auto const E_pot_new = (particle_inside_exclusion_radius_touched)
                              ? std::numeric_limits<double>::max()
-                             : calculate_current_potential_energy_of_system();
+                             : long_range_energy_new + m_energy_change;
 
   auto const bf = calculate_acceptance_probability(
       current_reaction, E_pot_old, E_pot_new, old_particle_numbers);
@@ -361,6 +468,8 @@ void ReactionAlgorithm::generic_oneway_reaction(
       delete_particle(to_be_deleted_hidden_ids[i]); // delete particle
     }
     current_reaction.accepted_moves += 1;
+    long_range_energy = long_range_energy_new;
+    accept_long_range_energy_change();
   } else {
     // reject
     // reverse reaction
@@ -522,20 +631,24 @@ void ReactionAlgorithm::move_particle(int p_id, Utils::Vector3d const &new_pos,
 std::vector<std::pair<int, Utils::Vector3d>>
 ReactionAlgorithm::generate_new_particle_positions(int type, int n_particles) {
 
-  std::vector<int> p_id_s_changed_particles;
   std::vector<std::pair<int, Utils::Vector3d>> old_positions;
   old_positions.reserve(n_particles);
 
   // draw particle ids at random without replacement
-  int p_id = -1;
-  std::vector<int> drawn_pids{p_id};
+  std::vector<int> drawn_pids;
   for (int i = 0; i < n_particles; i++) {
-    // draw a new particle id
-    while (Utils::contains(drawn_pids, p_id)) {
+    int p_id;
+    do {
       auto const random_index = i_random(number_of_particles_with_type(type));
       p_id = get_random_p_id(type, random_index);
-    }
+    } while (Utils::contains(drawn_pids, p_id));
     drawn_pids.emplace_back(p_id);
+  }
+
+  auto const energy_old = calculate_particles_energy(drawn_pids);
+  m_charges_old = get_particle_charges(drawn_pids);
+
+  for (auto const p_id : drawn_pids) {
     // store original position
     auto const &p = get_particle_data(p_id);
     old_positions.emplace_back(std::pair<int, Utils::Vector3d>{p_id, p.r.p});
@@ -546,6 +659,9 @@ ReactionAlgorithm::generate_new_particle_positions(int type, int n_particles) {
     check_exclusion_radius(p_id);
   }
 
+  m_energy_change = calculate_particles_energy(drawn_pids) - energy_old;
+  m_charges_new = get_particle_charges(drawn_pids);
+
   return old_positions;
 }
 
@@ -564,14 +680,18 @@ bool ReactionAlgorithm::do_global_mc_move_for_particles_of_type(
     return false;
   }
 
-  const double E_pot_old = calculate_current_potential_energy_of_system();
+  const double E_pot_old = calculate_long_range_energy();
 
   auto const original_positions = generate_new_particle_positions(
       type, particle_number_of_type_to_be_changed);
 
-  auto const E_pot_new = (particle_inside_exclusion_radius_touched)
-                             ? std::numeric_limits<double>::max()
-                             : calculate_current_potential_energy_of_system();
+  auto const E_pot_new =
+      (particle_inside_exclusion_radius_touched)
+          ? std::numeric_limits<double>::max()
+          : E_pot_old +
+                calculate_long_range_energy_change(m_charges_old,
+                                                   m_charges_new) +
+                m_energy_change;
 
   double beta = 1.0 / temperature;
 
@@ -592,6 +712,7 @@ bool ReactionAlgorithm::do_global_mc_move_for_particles_of_type(
   if (m_uniform_real_distribution(m_generator) < bf) {
     // accept
     m_accepted_configurational_MC_moves += 1;
+    accept_long_range_energy_change();
     return true;
   }
   // reject: restore original particle positions
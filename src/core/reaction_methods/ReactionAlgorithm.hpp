@@ -22,6 +22,8 @@
 #include "config.hpp"
 
 #include "SingleReaction.hpp"
+#include "energy.hpp"
+#include "parallel_trials.hpp"
 
 #include "random.hpp"
 
@@ -29,6 +31,7 @@
 
 #include <map>
 #include <random>
+#include <stdexcept>
 #include <tuple>
 #include <vector>
 
@@ -80,6 +83,13 @@ public:
 
   void set_cuboid_reaction_ensemble_volume();
   virtual int do_reaction(int reaction_steps);
+  /**
+   * Perform trial reactions in all cells of the domain decomposition at
+   * once, see @ref parallel_trials.hpp. Every cell gets
+   * @p reaction_steps trials, with the particle numbers and the volume
+   * of the cell in the acceptance probabilities.
+   */
+  int do_parallel_reaction(int reaction_steps);
   void check_reaction_method() const;
 
   int delete_particle(int p_id);
@@ -98,7 +108,31 @@ public:
 
 protected:
   std::vector<int> m_empty_p_ids_smaller_than_max_seen_particle;
-  void generic_oneway_reaction(SingleReaction &current_reaction);
+  /**
+   * Change of the short-range energy by the last trial move, calculated
+   * from the energies of the changed particles before and after the move,
+   * see @ref calculate_particles_energy. Only energy differences enter the
+   * acceptance probabilities, the full short-range energy of the system
+   * is never needed.
+   */
+  double m_energy_change = 0.;
+  /**
+   * Charges and positions of the particles changed by the last trial move,
+   * before and after the move. They determine the change of the long-range
+   * energy, see @ref calculate_long_range_energy_change.
+   */
+  std::vector<ParticleCharge> m_charges_old;
+  std::vector<ParticleCharge> m_charges_new;
+  /**
+   * Perform a trial reaction.
+   *
+   * @param current_reaction Reaction to attempt.
+   * @param long_range_energy Long-range energy of the system, see
+   *        @ref calculate_long_range_energy. It is updated if the trial
+   *        is accepted.
+   */
+  void generic_oneway_reaction(SingleReaction &current_reaction,
+                               double &long_range_energy);
 
   std::tuple<std::vector<StoredParticleProperty>, std::vector<int>,
              std::vector<StoredParticleProperty>>
@@ -128,6 +162,15 @@ protected:
       double E_pot_new, std::map<int, int> const &old_particle_numbers) const {
     return -10;
   }
+  /**
+   * Acceptance probability of a reaction in a subvolume, as used by
+   * @ref do_parallel_reaction.
+   */
+  virtual ParallelReaction
+  parallel_reaction(SingleReaction const &current_reaction) const {
+    throw std::runtime_error("Parallel trials are not supported by this "
+                             "method");
+  }
 
 private:
   std::mt19937 m_generator;
@@ -145,7 +188,8 @@ private:
                      double velocity_prefactor);
 
   void append_particle_property_of_random_particle(
-      int type, std::vector<StoredParticleProperty> &list_of_particles);
+      int type, std::vector<StoredParticleProperty> &list_of_particles,
+      std::vector<int> &drawn_p_ids);
 
   Utils::Vector3d get_random_position_in_box();
 };
@@ -42,4 +42,30 @@ double ReactionEnsemble::calculate_acceptance_probability(
          factorial_expr * exp(-beta * (E_pot_new - E_pot_old));
 }
 
+/**
+ * Acceptance probability in a subvolume: the same expression with the
+ * particle numbers and the volume of the subvolume
+ */
+ParallelReaction ReactionEnsemble::parallel_reaction(
+    SingleReaction const &current_reaction) const {
+  ParallelReaction reaction;
+  reaction.reactant_types = current_reaction.reactant_types;
+  reaction.reactant_coefficients = current_reaction.reactant_coefficients;
+  reaction.product_types = current_reaction.product_types;
+  reaction.product_coefficients = current_reaction.product_coefficients;
+  for (int i = 0; i < current_reaction.reactant_types.size(); i++) {
+    reaction.factorial_terms.emplace_back(
+        current_reaction.reactant_types[i],
+        -current_reaction.reactant_coefficients[i]);
+  }
+  for (int i = 0; i < current_reaction.product_types.size(); i++) {
+    reaction.factorial_terms.emplace_back(
+        current_reaction.product_types[i],
+        current_reaction.product_coefficients[i]);
+  }
+  reaction.prefactor = current_reaction.gamma;
+  reaction.volume_exponent = current_reaction.nu_bar;
+  return reaction;
+}
+
 } // namespace ReactionMethods
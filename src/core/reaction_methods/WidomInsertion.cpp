@@ -36,7 +36,10 @@ std::pair<double, double> WidomInsertion::measure_excess_chemical_potential(
     throw std::runtime_error("Trying to remove some non-existing particles "
                              "from the system via the inverse Widom scheme.");
 
-  const double E_pot_old = calculate_current_potential_energy_of_system();
+  // the change of the short-range energy is calculated by the reaction
+  // attempt, the change of the long-range energy from the charges changed
+  // by the attempt
+  const double E_pot_old = calculate_long_range_energy();
 
   // make reaction attempt
   std::vector<int> p_ids_created_particles;
@@ -51,7 +54,10 @@ std::pair<double, double> WidomInsertion::measure_excess_chemical_potential(
            hidden_particles_properties) =
       make_reaction_attempt(current_reaction);
 
-  const double E_pot_new = calculate_current_potential_energy_of_system();
+  const double E_pot_new =
+      E_pot_old +
+      calculate_long_range_energy_change(m_charges_old, m_charges_new) +
+      m_energy_change;
   // reverse reaction attempt
   // reverse reaction
   // 1) delete created product particles
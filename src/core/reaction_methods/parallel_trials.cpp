@@ -0,0 +1,505 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.hpp"
+
+#include "reaction_methods/parallel_trials.hpp"
+
+#include "reaction_methods/ReactionAlgorithm.hpp"
+#include "reaction_methods/utils.hpp"
+
+#include "Cell.hpp"
+#include "CellStructure.hpp"
+#include "DomainDecomposition.hpp"
+#include "Particle.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "energy.hpp"
+#include "event.hpp"
+#include "grid.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "particle_data.hpp"
+#include "random.hpp"
+
+#include "electrostatics_magnetostatics/coulomb.hpp"
+#include "electrostatics_magnetostatics/dipole.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/math/sqr.hpp>
+
+#include <boost/mpi/collectives.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace ReactionMethods {
+namespace {
+
+/** Remove a particle from a local cell, bonds to it are not removed. */
+void remove_local_particle(Cell &cell, int p_id) {
+  auto &parts = cell.particles();
+  auto const it =
+      std::find_if(parts.begin(), parts.end(),
+                   [p_id](Particle const &p) { return p.identity() == p_id; });
+  assert(it != parts.end());
+  parts.erase(it);
+  cell_structure.update_particle_index(p_id, nullptr);
+  cell_structure.update_particle_index(parts);
+}
+
+/** Trial reactions in the cells of this node. */
+class CellTrials {
+public:
+  explicit CellTrials(ParallelTrialParameters const &params)
+      : m_params(params), m_generator(Random::mt19937(
+                              std::seed_seq({params.seed, this_node}))),
+        m_normal_distribution(0.0, 1.0),
+        m_uniform_real_distribution(0.0, 1.0) {
+    m_result.tried_moves.resize(params.reactions.size());
+    m_result.accepted_moves.resize(params.reactions.size());
+  }
+
+  /** @brief Perform a trial reaction in a cell.
+   *
+   *  Like @ref ReactionAlgorithm::generic_oneway_reaction, but the
+   *  particles are drawn from the cell and placed in the cell.
+   *
+   *  @param cell Local cell.
+   *  @param corner Lower corner of the cell.
+   *  @param size Size of the cell.
+   */
+  void run(Cell &cell, Utils::Vector3d const &corner,
+           Utils::Vector3d const &size) {
+    auto const reaction_id =
+        i_random(static_cast<int>(m_params.reactions.size()));
+    auto const &reaction = m_params.reactions[reaction_id];
+    m_result.tried_moves[reaction_id] += 1;
+
+    auto const old_particle_numbers = particle_numbers(cell, reaction);
+    for (std::size_t i = 0; i < reaction.reactant_types.size(); i++) {
+      if (old_particle_numbers.at(reaction.reactant_types[i]) <
+          reaction.reactant_coefficients[i])
+        return;
+    }
+
+    m_energy_change = 0.;
+    m_inside_exclusion_radius = false;
+
+    std::vector<StoredParticleProperty> changed_particles_properties;
+    std::vector<StoredParticleProperty> hidden_particles_properties;
+    std::vector<int> p_ids_created_particles;
+
+    auto const hide = [&](int type) {
+      hidden_particles_properties.push_back(random_particle(cell, type));
+      auto const p_id = hidden_particles_properties.back().p_id;
+      check_exclusion_radius(p_id);
+      change_particle(p_id, m_params.non_interacting_type, 0.);
+    };
+    auto const create = [&](int type) {
+      p_ids_created_particles.push_back(
+          create_particle(cell, corner, size, type));
+    };
+
+    auto const &reactant_types = reaction.reactant_types;
+    auto const &reactant_coefficients = reaction.reactant_coefficients;
+    auto const &product_types = reaction.product_types;
+    auto const &product_coefficients = reaction.product_coefficients;
+    auto const n_common =
+        std::min(reactant_types.size(), product_types.size());
+
+    for (std::size_t i = 0; i < n_common; i++) {
+      for (int j = 0;
+           j < std::min(product_coefficients[i], reactant_coefficients[i]);
+           j++) {
+        changed_particles_properties.push_back(
+            random_particle(cell, reactant_types[i]));
+        change_particle(changed_particles_properties.back().p_id,
+                        product_types[i],
+                        m_params.charges_of_types.at(product_types[i]));
+      }
+      for (int j = 0; j < product_coefficients[i] - reactant_coefficients[i];
+           j++) {
+        create(product_types[i]);
+      }
+      for (int j = 0; j < reactant_coefficients[i] - product_coefficients[i];
+           j++) {
+        hide(reactant_types[i]);
+      }
+    }
+    for (auto i = n_common; i < reactant_types.size(); i++) {
+      for (int j = 0; j < reactant_coefficients[i]; j++) {
+        hide(reactant_types[i]);
+      }
+    }
+    for (auto i = n_common; i < product_types.size(); i++) {
+      for (int j = 0; j < product_coefficients[i]; j++) {
+        create(product_types[i]);
+      }
+    }
+
+    auto acceptance = 0.;
+    if (not m_inside_exclusion_radius) {
+      auto const volume = size[0] * size[1] * size[2];
+      acceptance = reaction.prefactor *
+                   std::pow(volume, reaction.volume_exponent) *
+                   std::exp(-m_energy_change / m_params.temperature);
+      for (auto const &term : reaction.factorial_terms) {
+        acceptance *= factorial_Ni0_divided_by_factorial_Ni0_plus_nu_i(
+            old_particle_numbers.at(term.first), term.second);
+      }
+    }
+
+    if (m_uniform_real_distribution(m_generator) < acceptance) {
+      for (auto const &item : changed_particles_properties) {
+        auto const &p = *cell_structure.get_local_particle(item.p_id);
+        m_result.changes.push_back({item.p_id, item.type, p.p.type});
+      }
+      for (auto const p_id : p_ids_created_particles) {
+        auto const &p = *cell_structure.get_local_particle(p_id);
+        m_result.changes.push_back({p_id, -1, p.p.type});
+      }
+      for (auto const &item : hidden_particles_properties) {
+        remove_local_particle(cell, item.p_id);
+        m_result.changes.push_back({item.p_id, item.type, -1});
+      }
+      m_result.accepted_moves[reaction_id] += 1;
+    } else {
+      for (auto const p_id : p_ids_created_particles) {
+        remove_local_particle(cell, p_id);
+        m_returned_ids.push_back(p_id);
+      }
+      for (auto const &item : hidden_particles_properties) {
+        restore_particle(item);
+      }
+      for (auto const &item : changed_particles_properties) {
+        restore_particle(item);
+      }
+    }
+  }
+
+  ParallelTrialResult const &result() const { return m_result; }
+
+private:
+  ParallelTrialParameters const &m_params;
+  ParallelTrialResult m_result;
+  std::mt19937 m_generator;
+  std::normal_distribution<double> m_normal_distribution;
+  std::uniform_real_distribution<double> m_uniform_real_distribution;
+
+  /** Number of ids drawn from the pool of this node. */
+  int m_n_ids = 0;
+  /** Ids of deleted particles that were created by this node. */
+  std::vector<int> m_returned_ids;
+
+  double m_energy_change = 0.;
+  bool m_inside_exclusion_radius = false;
+
+  int i_random(int maxint) {
+    std::uniform_int_distribution<int> uniform_int_dist(0, maxint - 1);
+    return uniform_int_dist(m_generator);
+  }
+
+  /** @brief Draw an unused particle id.
+   *
+   *  The nodes take turns in drawing from the free ids and then from the
+   *  ids above the largest one in use, so that they never draw the same.
+   */
+  int new_particle_id() {
+    if (not m_returned_ids.empty()) {
+      auto const p_id = m_returned_ids.back();
+      m_returned_ids.pop_back();
+      return p_id;
+    }
+    auto const n_free = static_cast<int>(m_params.free_ids.size());
+    auto const index = m_n_ids++ * comm_cart.size() + this_node;
+    return (index < n_free) ? m_params.free_ids[index]
+                            : m_params.max_id + 1 + index - n_free;
+  }
+
+  std::map<int, int> particle_numbers(Cell const &cell,
+                                      ParallelReaction const &reaction) const {
+    std::map<int, int> numbers;
+    for (auto const type : reaction.reactant_types)
+      numbers[type] = 0;
+    for (auto const type : reaction.product_types)
+      numbers[type] = 0;
+    for (auto const &term : reaction.factorial_terms)
+      numbers[term.first] = 0;
+
+    for (auto const &p : cell.particles()) {
+      auto const it = numbers.find(p.p.type);
+      if (it != numbers.end())
+        it->second += 1;
+    }
+    return numbers;
+  }
+
+  StoredParticleProperty random_particle(Cell const &cell, int type) {
+    std::vector<Particle const *> candidates;
+    for (auto const &p : cell.particles()) {
+      if (p.p.type == type)
+        candidates.push_back(&p);
+    }
+    auto const &p =
+        *candidates[i_random(static_cast<int>(candidates.size()))];
+#ifdef ELECTROSTATICS
+    return {p.identity(), p.p.q, type};
+#else
+    return {p.identity(), 0., type};
+#endif
+  }
+
+  void check_exclusion_radius(int p_id) {
+    if (m_params.exclusion_radius == 0.) {
+      return;
+    }
+    auto const r2 = Utils::sqr(m_params.exclusion_radius);
+    cell_structure.particle_neighbor_loop(
+        *cell_structure.get_local_particle(p_id),
+        [this, r2](Particle const &, Particle const &, Distance const &d) {
+          if (d.dist2 < r2)
+            m_inside_exclusion_radius = true;
+        });
+  }
+
+  void change_particle(int p_id, int type, double charge) {
+    auto &p = *cell_structure.get_local_particle(p_id);
+    auto const energy_old = particle_non_bonded_energy(p);
+    p.p.type = type;
+#ifdef ELECTROSTATICS
+    p.p.q = charge;
+#endif
+    m_energy_change += particle_non_bonded_energy(p) - energy_old;
+  }
+
+  void restore_particle(StoredParticleProperty const &item) {
+    auto &p = *cell_structure.get_local_particle(item.p_id);
+    p.p.type = item.type;
+#ifdef ELECTROSTATICS
+    p.p.q = item.charge;
+#endif
+  }
+
+  int create_particle(Cell &cell, Utils::Vector3d const &corner,
+                      Utils::Vector3d const &size, int type) {
+    Particle new_part;
+    new_part.p.identity = new_particle_id();
+    new_part.p.type = type;
+#ifdef ELECTROSTATICS
+    new_part.p.q = m_params.charges_of_types.at(type);
+#endif
+    /* positions on the upper cell boundary may be rounded to the
+     * neighboring cell */
+    do {
+      for (int i = 0; i < 3; i++) {
+        new_part.r.p[i] =
+            corner[i] + size[i] * m_uniform_real_distribution(m_generator);
+      }
+    } while (cell_structure.find_current_cell(new_part) != &cell);
+    // we use mass=1 for all particles, as the serial algorithm
+    for (int i = 0; i < 3; i++) {
+      new_part.m.v[i] = std::sqrt(m_params.temperature) *
+                        m_normal_distribution(m_generator);
+    }
+
+    auto const p_id = new_part.identity();
+    auto const &p = *cell_structure.add_local_particle(std::move(new_part));
+    m_energy_change += particle_non_bonded_energy(p);
+    check_exclusion_radius(p_id);
+
+    return p_id;
+  }
+};
+
+/** @brief Global numbers of the cells in one direction.
+ *
+ *  @return The global number of the first local cell, and the number
+ *          of cells in the direction.
+ */
+std::pair<int, int> global_cell_numbers(DomainDecomposition const &dd,
+                                        int dir) {
+  auto const node_pos = calc_node_pos(comm_cart);
+  std::vector<Utils::Vector3i> node_positions;
+  std::vector<Utils::Vector3i> cell_grids;
+  boost::mpi::all_gather(comm_cart, node_pos, node_positions);
+  boost::mpi::all_gather(comm_cart, dd.cell_grid, cell_grids);
+
+  int offset = 0;
+  int n_cells = 0;
+  for (std::size_t node = 0; node < node_positions.size(); node++) {
+    auto const &pos = node_positions[node];
+    if (pos[(dir + 1) % 3] != node_pos[(dir + 1) % 3] or
+        pos[(dir + 2) % 3] != node_pos[(dir + 2) % 3])
+      continue;
+    n_cells += cell_grids[node][dir];
+    if (pos[dir] < node_pos[dir])
+      offset += cell_grids[node][dir];
+  }
+
+  return {offset, n_cells};
+}
+
+ParallelTrialResult
+mpi_parallel_trials_local(ParallelTrialParameters const &params) {
+  /* the trials of a cell only see the particles stored in it, which
+   * therefore have to be sorted into the cells of their positions */
+  cell_structure.set_resort_particles(Cells::RESORT_LOCAL);
+  on_observable_calc();
+
+  auto const &dd = *get_domain_decomposition();
+
+  /* In every direction, every second cell gets the same color. If the
+   * number of cells is odd in a periodic direction, the last cell is
+   * a neighbor of the first one and gets a third color. */
+  Utils::Vector3i offset, n_cells, n_colors;
+  auto valid = params.exclusion_radius <=
+               *std::min_element(dd.cell_size.begin(), dd.cell_size.end());
+  for (int dir = 0; dir < 3; dir++) {
+    std::tie(offset[dir], n_cells[dir]) = global_cell_numbers(dd, dir);
+    if (box_geo.periodic(dir) and n_cells[dir] % 2) {
+      /* a single cell would see the periodic images of its particles */
+      valid &= n_cells[dir] > 1;
+      n_colors[dir] = 3;
+    } else {
+      n_colors[dir] = std::min(n_cells[dir], 2);
+    }
+  }
+  valid = boost::mpi::all_reduce(comm_cart, valid, std::logical_and<bool>());
+  if (not valid) {
+    if (this_node == 0) {
+      throw std::runtime_error(
+          "Parallel trials need at least two cells in every periodic "
+          "direction, and cells that are larger than the exclusion radius");
+    }
+    return {};
+  }
+
+  auto const color = [&](int dir, int i) {
+    auto const global = offset[dir] + i - 1;
+    return (n_colors[dir] == 3 and global == n_cells[dir] - 1) ? 2
+                                                                : global % 2;
+  };
+
+  CellTrials trials(params);
+  Utils::Vector3i c;
+  for (c[2] = 0; c[2] < n_colors[2]; c[2]++)
+    for (c[1] = 0; c[1] < n_colors[1]; c[1]++)
+      for (c[0] = 0; c[0] < n_colors[0]; c[0]++) {
+        cell_structure.for_each_local_cell([&](Cell &cell) {
+          /* position of the cell in the ghost cell grid */
+          auto const index = static_cast<int>(&cell - dd.cells.data());
+          auto const &grid = dd.ghost_cell_grid;
+          Utils::Vector3i const pos{index % grid[0],
+                                    (index / grid[0]) % grid[1],
+                                    index / (grid[0] * grid[1])};
+          if (color(0, pos[0]) != c[0] or color(1, pos[1]) != c[1] or
+              color(2, pos[2]) != c[2])
+            return;
+          auto const corner =
+              dd.m_local_box.my_left() +
+              Utils::hadamard_product(
+                  Utils::Vector3d{pos[0] - 1., pos[1] - 1., pos[2] - 1.},
+                  dd.cell_size);
+          for (int step = 0; step < params.reaction_steps; step++) {
+            trials.run(cell, corner, dd.cell_size);
+          }
+        });
+
+        /* the cells of the next color see the changes in their ghosts */
+        cell_structure.set_resort_particles(Cells::RESORT_LOCAL);
+        cells_update_ghosts(global_ghost_flags());
+      }
+
+  on_particle_change();
+
+  std::vector<ParallelTrialResult> results;
+  boost::mpi::gather(comm_cart, trials.result(), results, 0);
+  if (this_node != 0) {
+    return {};
+  }
+
+  ParallelTrialResult result;
+  result.tried_moves.resize(params.reactions.size());
+  result.accepted_moves.resize(params.reactions.size());
+  for (auto const &node_result : results) {
+    for (std::size_t i = 0; i < params.reactions.size(); i++) {
+      result.tried_moves[i] += node_result.tried_moves[i];
+      result.accepted_moves[i] += node_result.accepted_moves[i];
+    }
+    result.changes.insert(result.changes.end(), node_result.changes.begin(),
+                          node_result.changes.end());
+  }
+  return result;
+}
+
+} // namespace
+
+REGISTER_CALLBACK_MASTER_RANK(mpi_parallel_trials_local)
+
+ParallelTrialResult run_parallel_trials(ParallelTrialParameters const &params) {
+  if (cell_structure.decomposition_type() != CELL_STRUCTURE_DOMDEC) {
+    throw std::runtime_error(
+        "Parallel trials require the domain decomposition cell system");
+  }
+#ifdef ELECTROSTATICS
+  if (coulomb.method != COULOMB_NONE and coulomb.method != COULOMB_DH and
+      coulomb.method != COULOMB_RF) {
+    throw std::runtime_error("Parallel trials do not support long-range "
+                             "electrostatics");
+  }
+#endif
+#ifdef DIPOLES
+  if (dipole.method != DIPOLAR_NONE) {
+    throw std::runtime_error("Parallel trials do not support "
+                             "magnetostatics");
+  }
+#endif
+
+  /* types are created by broadcasting the interaction parameters,
+   * which is not possible during the trials */
+  make_particle_type_exist(params.non_interacting_type);
+  for (auto const &reaction : params.reactions) {
+    for (auto const type : reaction.reactant_types)
+      make_particle_type_exist(type);
+    for (auto const type : reaction.product_types)
+      make_particle_type_exist(type);
+  }
+
+  auto const result = mpi_call(::Communication::Result::master_rank,
+                               mpi_parallel_trials_local, params);
+
+  for (auto const &change : result.changes) {
+    if (change.old_type != -1)
+      remove_id_from_map(change.p_id, change.old_type);
+    if (change.new_type != -1)
+      add_id_to_type_map(change.p_id, change.new_type);
+  }
+  clear_particle_node();
+
+  return result;
+}
+
+} // namespace ReactionMethods
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef REACTION_METHODS_PARALLEL_TRIALS_HPP
+#define REACTION_METHODS_PARALLEL_TRIALS_HPP
+
+/** @file
+ *  Trial reactions in many cells of the domain decomposition at once.
+ *
+ *  The cells are colored like a checkerboard, so that cells of the same
+ *  color are not neighbors of each other. For one color after the other,
+ *  every node performs trial reactions in its cells of that color: the
+ *  reactants are drawn from the particles in the cell, and the products
+ *  are placed in the cell. The acceptance probabilities use the particle
+ *  numbers in the cell and the volume of the cell, and the energy changes
+ *  only depend on the particles in the cell and its neighbors, which are
+ *  not changed at the same time. Only the short-range energy is taken
+ *  into account, so this is restricted to systems without long-range
+ *  interactions. The changes of the particle types are collected, and
+ *  the particle bookkeeping on the head node is updated once at the end.
+ *
+ *  Implementation in parallel_trials.cpp.
+ */
+
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace ReactionMethods {
+
+/** @brief Reaction in the form used by the parallel trials.
+ *
+ *  The acceptance probability of a trial in a cell of volume
+ *  @f$ V_c @f$ is
+ *  @f$ a V_c^{n} \prod_i N_i! / (N_i + \nu_i)! \exp(-\beta \Delta E) @f$,
+ *  where @f$ N_i @f$ are the numbers of particles of the types in
+ *  @ref factorial_terms in the cell before the trial.
+ */
+struct ParallelReaction {
+  std::vector<int> reactant_types;
+  std::vector<int> reactant_coefficients;
+  std::vector<int> product_types;
+  std::vector<int> product_coefficients;
+  /** Types and changes @f$ \nu_i @f$ in the factorial expression. */
+  std::vector<std::pair<int, int>> factorial_terms;
+  /** State-independent prefactor @f$ a @f$. */
+  double prefactor = 1.;
+  /** Exponent @f$ n @f$ of the cell volume. */
+  int volume_exponent = 0;
+
+  template <class Archive>
+  void serialize(Archive &ar, long int /* version */) {
+    ar &reactant_types &reactant_coefficients &product_types
+        &product_coefficients &factorial_terms &prefactor &volume_exponent;
+  }
+};
+
+struct ParallelTrialParameters {
+  std::vector<ParallelReaction> reactions;
+  std::map<int, double> charges_of_types;
+  double temperature = 1.;
+  double exclusion_radius = 0.;
+  int non_interacting_type = 100;
+  /** Number of trials per cell. */
+  int reaction_steps = 1;
+  int seed = 0;
+  /** Unused particle ids below @ref max_id, in ascending order. */
+  std::vector<int> free_ids;
+  /** Largest particle id in use. */
+  int max_id = -1;
+
+  template <class Archive>
+  void serialize(Archive &ar, long int /* version */) {
+    ar &reactions &charges_of_types &temperature &exclusion_radius
+        &non_interacting_type &reaction_steps &seed &free_ids &max_id;
+  }
+};
+
+/** @brief Change of the type of a particle by an accepted trial.
+ *
+ *  The old type is -1 for created particles, the new type is -1 for
+ *  deleted particles.
+ */
+struct ParticleTypeChange {
+  int p_id;
+  int old_type;
+  int new_type;
+
+  template <class Archive>
+  void serialize(Archive &ar, long int /* version */) {
+    ar &p_id &old_type &new_type;
+  }
+};
+
+struct ParallelTrialResult {
+  /** Tried moves per reaction. */
+  std::vector<int> tried_moves;
+  /** Accepted moves per reaction. */
+  std::vector<int> accepted_moves;
+  std::vector<ParticleTypeChange> changes;
+
+  template <class Archive>
+  void serialize(Archive &ar, long int /* version */) {
+    ar &tried_moves &accepted_moves &changes;
+  }
+};
+
+/** @brief Perform trial reactions in all cells.
+ *
+ *  Every cell gets @ref ParallelTrialParameters::reaction_steps trials.
+ *  The particle type maps are updated, and the index of the particle
+ *  nodes is invalidated.
+ *
+ *  @return The changes of all nodes.
+ */
+ParallelTrialResult run_parallel_trials(ParallelTrialParameters const &params);
+
+} // namespace ReactionMethods
+#endif
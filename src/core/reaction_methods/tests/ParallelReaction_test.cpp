@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Unit tests for the parallel trial reactions. */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE Parallel reaction test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "reaction_methods/ReactionAlgorithm.hpp"
+#include "reaction_methods/ReactionEnsemble.hpp"
+
+#include "EspressoSystemStandAlone.hpp"
+#include "communication.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "particle_data.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace utf = boost::unit_test;
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+BOOST_AUTO_TEST_CASE(ParallelReaction_test,
+                     *utf::precondition(if_head_node())) {
+  using namespace ReactionMethods;
+  int const type_A = 0;
+  int const type_B = 1;
+  int const type_C = 2;
+  int const n_particles = 200;
+
+  // a 4x4x4 cell grid
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(10.));
+  espresso::system->set_skin(0.4);
+  mpi_set_min_global_cut(2.);
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> uniform(0., 10.);
+  for (int pid = 0; pid < n_particles; ++pid) {
+    place_particle(pid, {uniform(generator), uniform(generator),
+                         uniform(generator)});
+    set_particle_type(pid, type_A);
+  }
+
+  // method without parallel trials
+  {
+    class ReactionAlgorithmTest : public ReactionAlgorithm {
+    public:
+      using ReactionAlgorithm::ReactionAlgorithm;
+    };
+    ReactionAlgorithmTest r_algo(42);
+    r_algo.temperature = 1.;
+    r_algo.charges_of_types = {{type_A, 0.}, {type_B, 0.}, {type_C, 0.}};
+    r_algo.add_reaction(2., {type_A}, {1}, {type_B}, {1});
+    BOOST_CHECK_THROW(r_algo.do_parallel_reaction(1), std::runtime_error);
+  }
+
+  // isomerization A <-> B in an ideal system: N_B / N_A = gamma
+  {
+    ReactionEnsemble r_algo(42);
+    r_algo.temperature = 1.;
+    r_algo.charges_of_types = {{type_A, 0.}, {type_B, 0.}, {type_C, 0.}};
+    r_algo.add_reaction(2., {type_A}, {1}, {type_B}, {1});
+    r_algo.add_reaction(0.5, {type_B}, {1}, {type_A}, {1});
+
+    // the exclusion radius has to fit into a cell
+    r_algo.exclusion_radius = 3.;
+    BOOST_CHECK_THROW(r_algo.do_parallel_reaction(1), std::runtime_error);
+    r_algo.exclusion_radius = 0.;
+
+    for (int i = 0; i < 20; ++i) {
+      r_algo.do_parallel_reaction(2);
+    }
+    double fraction_B = 0.;
+    int const n_samples = 200;
+    for (int i = 0; i < n_samples; ++i) {
+      r_algo.do_parallel_reaction(2);
+      auto const n_A = number_of_particles_with_type(type_A);
+      auto const n_B = number_of_particles_with_type(type_B);
+      BOOST_REQUIRE_EQUAL(n_A + n_B, n_particles);
+      fraction_B += static_cast<double>(n_B) / n_particles / n_samples;
+    }
+    BOOST_CHECK_CLOSE(fraction_B, 2. / 3., 3.);
+    BOOST_CHECK_GT(r_algo.reactions[0].accepted_moves, 0);
+    BOOST_CHECK_GT(r_algo.reactions[1].accepted_moves, 0);
+    BOOST_CHECK_LE(r_algo.reactions[0].accepted_moves,
+                   r_algo.reactions[0].tried_moves);
+
+    for (int pid = 0; pid < n_particles; ++pid) {
+      set_particle_type(pid, type_A);
+    }
+  }
+
+  // dissociation A <-> B + C in an ideal system, with particles moving
+  // between the trials: the distribution of the number of dissociated
+  // particles n is proportional to (gamma V)^n / ((N - n)! n! n!)
+  {
+    auto const gamma = 0.1;
+    auto const volume = 1000.;
+    std::normal_distribution<double> normal(0., 1.);
+    for (int pid = 0; pid < n_particles; ++pid) {
+      set_particle_v(pid, {normal(generator), normal(generator),
+                           normal(generator)});
+    }
+    espresso::system->set_time_step(0.01);
+    espresso::system->set_skin(1.0);
+
+    ReactionEnsemble r_algo(44);
+    r_algo.temperature = 1.;
+    r_algo.charges_of_types = {{type_A, 0.}, {type_B, 0.}, {type_C, 0.}};
+    r_algo.add_reaction(gamma, {type_A}, {1}, {type_B, type_C}, {1, 1});
+    r_algo.add_reaction(1. / gamma, {type_B, type_C}, {1, 1}, {type_A}, {1});
+
+    std::vector<double> log_weights;
+    for (int n = 0; n <= n_particles; ++n) {
+      log_weights.push_back(n * std::log(gamma * volume) -
+                            std::lgamma(n_particles - n + 1.) -
+                            2. * std::lgamma(n + 1.));
+    }
+    auto const max_log_weight =
+        *std::max_element(log_weights.begin(), log_weights.end());
+    auto norm = 0.;
+    auto n_expected = 0.;
+    auto n2_expected = 0.;
+    for (int n = 0; n <= n_particles; ++n) {
+      auto const weight = std::exp(log_weights[n] - max_log_weight);
+      norm += weight;
+      n_expected += n * weight;
+      n2_expected += n * n * weight;
+    }
+    n_expected /= norm;
+    auto const variance = n2_expected / norm - n_expected * n_expected;
+
+    auto const cycle = [&r_algo]() {
+      r_algo.do_parallel_reaction(2);
+      mpi_integrate(20, 0);
+    };
+    for (int i = 0; i < 50; ++i) {
+      cycle();
+    }
+    /* consecutive cycles are correlated, after four cycles the
+     * autocorrelation of n has decayed to about 0.1 */
+    int const n_decorrelation = 4;
+    int const n_samples = 300;
+    double n_B = 0.;
+    for (int i = 0; i < n_samples; ++i) {
+      for (int j = 0; j < n_decorrelation; ++j) {
+        cycle();
+      }
+      n_B += static_cast<double>(number_of_particles_with_type(type_B)) /
+             n_samples;
+    }
+    // five standard errors of the mean of uncorrelated samples
+    BOOST_CHECK_SMALL(n_B - n_expected, 5. * std::sqrt(variance / n_samples));
+
+    auto const max_id = get_maximal_particle_id();
+    for (int pid = 0; pid <= max_id; ++pid) {
+      if (particle_exists(pid)) {
+        remove_particle(pid);
+      }
+    }
+    for (int pid = 0; pid < n_particles; ++pid) {
+      place_particle(pid, {uniform(generator), uniform(generator),
+                           uniform(generator)});
+      set_particle_type(pid, type_A);
+    }
+  }
+
+  // dissociation A <-> B + C: the particle bookkeeping is consistent
+  {
+    ReactionEnsemble r_algo(43);
+    r_algo.temperature = 1.;
+    r_algo.charges_of_types = {{type_A, 0.}, {type_B, 0.}, {type_C, 0.}};
+    r_algo.add_reaction(0.05, {type_A}, {1}, {type_B, type_C}, {1, 1});
+    r_algo.add_reaction(20., {type_B, type_C}, {1, 1}, {type_A}, {1});
+
+    for (int i = 0; i < 20; ++i) {
+      r_algo.do_parallel_reaction(2);
+      auto const n_A = number_of_particles_with_type(type_A);
+      auto const n_B = number_of_particles_with_type(type_B);
+      auto const n_C = number_of_particles_with_type(type_C);
+      BOOST_REQUIRE_EQUAL(n_A + n_B, n_particles);
+      BOOST_REQUIRE_EQUAL(n_B, n_C);
+      BOOST_REQUIRE_EQUAL(get_n_part(), n_A + n_B + n_C);
+
+      // the type maps agree with the particles
+      std::set<int> ids;
+      for (auto const type : {type_A, type_B, type_C}) {
+        for (int j = 0; j < number_of_particles_with_type(type); ++j) {
+          auto const pid = get_random_p_id(type, j);
+          BOOST_REQUIRE(particle_exists(pid));
+          BOOST_REQUIRE_EQUAL(get_particle_data(pid).p.type, type);
+          ids.insert(pid);
+        }
+      }
+      BOOST_REQUIRE_EQUAL(static_cast<int>(ids.size()), get_n_part());
+    }
+    BOOST_CHECK_GT(r_algo.reactions[0].accepted_moves, 0);
+    BOOST_CHECK_GT(r_algo.reactions[1].accepted_moves, 0);
+
+    // deleted particles leave holes which are filled again
+    BOOST_CHECK_LT(get_maximal_particle_id(), 3 * n_particles);
+  }
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
@@ -35,11 +35,60 @@ struct True {
 };
 } // namespace detail
 
+/**
+ * @brief Run the bonded and the non-bonded pair kernels.
+ *
+ * @param bond_kernel Kernel for the bonded interactions.
+ * @param pair_kernel Kernel for the non-bonded interactions.
+ * @param pair_cutoff Cutoff of the non-bonded interactions,
+ *                    negative if there are none.
+ * @param bond_cutoff Cutoff of the bonded interactions,
+ *                    negative if there are none.
+ * @param verlet_criterion Filter for verlet lists.
+ * @param concurrent Whether the pair kernel may be called concurrently,
+ *                   see @ref CellStructure::non_bonded_loop.
+ */
 template <class BondKernel, class PairKernel,
           class VerletCriterion = detail::True>
 void short_range_loop(BondKernel bond_kernel, PairKernel pair_kernel,
                       double pair_cutoff, double bond_cutoff,
-                      const VerletCriterion &verlet_criterion = {}) {
+                      const VerletCriterion &verlet_criterion = {},
+                      bool concurrent = false) {
+  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
+
+  assert(cell_structure.get_resort_particles() == Cells::RESORT_NONE);
+
+  /* While the ghost update is in flight, the non-bonded loop goes
+   * first, because it can start with the pairs of local particles. */
+  auto const non_bonded_first = cell_structure.ghosts_pending();
+
+  if (non_bonded_first and pair_cutoff >= 0.)
+    cell_structure.non_bonded_loop(pair_kernel, verlet_criterion, concurrent);
+
+  if (bond_cutoff >= 0.) {
+    cell_structure.bond_loop(bond_kernel);
+  }
+
+  if (not non_bonded_first and pair_cutoff >= 0.)
+    cell_structure.non_bonded_loop(pair_kernel, verlet_criterion, concurrent);
+
+  cell_structure.ghosts_wait();
+}
+
+/**
+ * @brief Run the bonded pair kernel, and the non-bonded kernels
+ *        on packed particle data.
+ *
+ * Like @ref short_range_loop, but the non-bonded kernels are run by
+ * @ref CellStructure::soa_non_bonded_loop.
+ */
+template <class BondKernel, class PairKernel, class ParticleKernel,
+          class VerletCriterion>
+void short_range_soa_loop(BondKernel bond_kernel, PairKernel pair_kernel,
+                          ParticleKernel particle_kernel, double pair_cutoff,
+                          double bond_cutoff,
+                          const VerletCriterion &verlet_criterion,
+                          bool concurrent = false) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
   assert(cell_structure.get_resort_particles() == Cells::RESORT_NONE);
@@ -49,6 +98,9 @@ void short_range_loop(BondKernel bond_kernel, PairKernel pair_kernel,
   }
 
   if (pair_cutoff >= 0.)
-    cell_structure.non_bonded_loop(pair_kernel, verlet_criterion);
+    cell_structure.soa_non_bonded_loop(pair_kernel, particle_kernel,
+                                       verlet_criterion, concurrent);
+
+  cell_structure.ghosts_wait();
 }
 #endif
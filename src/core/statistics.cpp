@@ -39,10 +39,16 @@
 #include <utils/contains.hpp>
 #include <utils/math/sqr.hpp>
 
+#include <boost/mpi/collectives/reduce.hpp>
+
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdlib>
+#include <functional>
 #include <limits>
 #include <stdexcept>
+#include <vector>
 
 /****************************************************************************************
  *                                 basic observables calculation
@@ -265,51 +271,118 @@ void calc_part_distribution(PartCfg &partCfg, std::vector<int> const &p1_types,
     dist[i] /= (double)cnt;
 }
 
-void calc_structurefactor(PartCfg &partCfg, std::vector<int> const &p_types,
-                          int order, std::vector<double> &wavevectors,
-                          std::vector<double> &intensities) {
-
-  if (order < 1)
-    throw std::domain_error("order has to be a strictly positive number");
-
+/** Wave vectors @f$ 2\pi/L (i, j, k) @f$ of the structure factor, in units
+ *  of @f$ 2\pi/L @f$, ordered by i, j and k.
+ */
+static std::vector<Utils::Vector3i> structurefactor_wavevectors(int order) {
+  std::vector<Utils::Vector3i> wavevectors;
   auto const order_sq = order * order;
-  std::vector<double> ff(2 * order_sq + 1);
-  auto const twoPI_L = 2 * Utils::pi() * box_geo.length_inv()[0];
-
   for (int i = 0; i <= order; i++) {
     for (int j = -order; j <= order; j++) {
       for (int k = -order; k <= order; k++) {
         auto const n = i * i + j * j + k * k;
         if ((n <= order_sq) && (n >= 1)) {
-          double C_sum = 0.0, S_sum = 0.0;
-          for (auto const &p : partCfg) {
-            for (int t : p_types) {
-              if (p.p.type == t) {
-                auto const qr = twoPI_L * (Utils::Vector3i{{i, j, k}} * p.r.p);
-                C_sum += cos(qr);
-                S_sum += sin(qr);
-              }
-            }
-          }
-          ff[2 * n - 2] += C_sum * C_sum + S_sum * S_sum;
-          ff[2 * n - 1]++;
+          wavevectors.push_back({i, j, k});
         }
       }
     }
   }
+  return wavevectors;
+}
 
-  long n_particles = 0l;
-  for (auto const &p : partCfg) {
-    for (int t : p_types) {
-      if (p.p.type == t)
-        n_particles++;
+/** @brief Sums of the phase factors of the local particles.
+ *
+ *  The phase factors @f$ \exp(i q r) @f$ of all wave vectors are obtained
+ *  by multiplication from those of the unit wave vectors, which avoids
+ *  evaluating trigonometric functions in the inner loop. The sums are
+ *  reduced on the head node, which also receives the number of particles
+ *  in the last element.
+ *
+ *  @return Real and imaginary part of the sum for every wave vector.
+ */
+std::vector<double> structurefactor_local(std::vector<int> const &p_types,
+                                          int order) {
+  auto const wavevectors = structurefactor_wavevectors(order);
+  auto const twoPI_L = 2 * Utils::pi() * box_geo.length_inv()[0];
+  auto const n_phases = static_cast<std::size_t>(2 * order + 1);
+
+  std::vector<double> sums(2 * wavevectors.size() + 1);
+  /* phase factors exp(i twoPI_L n x) for n in [-order, order] */
+  std::vector<double> cos_x(n_phases), sin_x(n_phases);
+  std::vector<double> cos_y(n_phases), sin_y(n_phases);
+  std::vector<double> cos_z(n_phases), sin_z(n_phases);
+  auto const phases = [order](double x, std::vector<double> &c,
+                              std::vector<double> &s) {
+    auto const c1 = cos(x), s1 = sin(x);
+    c[order] = 1.;
+    s[order] = 0.;
+    for (int n = 1; n <= order; n++) {
+      c[order + n] = c[order + n - 1] * c1 - s[order + n - 1] * s1;
+      s[order + n] = c[order + n - 1] * s1 + s[order + n - 1] * c1;
+      c[order - n] = c[order + n];
+      s[order - n] = -s[order + n];
     }
+  };
+
+  for (auto const &p : cell_structure.local_particles()) {
+    /* a particle contributes once for every occurrence of its type */
+    auto const weight = static_cast<double>(
+        std::count(p_types.begin(), p_types.end(), p.p.type));
+    if (weight == 0.)
+      continue;
+
+    auto const pos =
+        twoPI_L * unfolded_position(p.r.p, p.l.i, box_geo.length());
+    phases(pos[0], cos_x, sin_x);
+    phases(pos[1], cos_y, sin_y);
+    phases(pos[2], cos_z, sin_z);
+
+    for (std::size_t w = 0; w < wavevectors.size(); w++) {
+      auto const &q = wavevectors[w];
+      auto const cx = cos_x[order + q[0]], sx = sin_x[order + q[0]];
+      auto const cy = cos_y[order + q[1]], sy = sin_y[order + q[1]];
+      auto const cz = cos_z[order + q[2]], sz = sin_z[order + q[2]];
+      auto const cxy = cx * cy - sx * sy;
+      auto const sxy = cx * sy + sx * cy;
+      sums[2 * w] += weight * (cxy * cz - sxy * sz);
+      sums[2 * w + 1] += weight * (cxy * sz + sxy * cz);
+    }
+    sums.back() += weight;
+  }
+
+  std::vector<double> total(sums.size());
+  boost::mpi::reduce(comm_cart, sums.data(), static_cast<int>(sums.size()),
+                     total.data(), std::plus<double>(), 0);
+  return total;
+}
+
+REGISTER_CALLBACK_MASTER_RANK(structurefactor_local)
+
+void calc_structurefactor(std::vector<int> const &p_types, int order,
+                          std::vector<double> &wavevectors,
+                          std::vector<double> &intensities) {
+
+  if (order < 1)
+    throw std::domain_error("order has to be a strictly positive number");
+
+  auto const order_sq = order * order;
+  std::vector<double> ff(2 * order_sq + 1);
+  auto const twoPI_L = 2 * Utils::pi() * box_geo.length_inv()[0];
+
+  auto const sums = mpi_call(::Communication::Result::master_rank,
+                             structurefactor_local, p_types, order);
+  auto const q_vectors = structurefactor_wavevectors(order);
+  for (std::size_t w = 0; w < q_vectors.size(); w++) {
+    auto const n = q_vectors[w].norm2();
+    ff[2 * n - 2] += Utils::sqr(sums[2 * w]) + Utils::sqr(sums[2 * w + 1]);
+    ff[2 * n - 1]++;
   }
+  auto const n_particles = sums.back();
 
   int length = 0;
   for (int qi = 0; qi < order_sq; qi++) {
     if (ff[2 * qi + 1] != 0) {
-      ff[2 * qi] /= static_cast<double>(n_particles) * ff[2 * qi + 1];
+      ff[2 * qi] /= n_particles * ff[2 * qi + 1];
       length++;
     }
   }
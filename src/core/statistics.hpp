@@ -97,15 +97,15 @@ void calc_part_distribution(PartCfg &partCfg, std::vector<int> const &p1_types,
  *  nonzero, the first is meaningful. This means the q=1 entries are sf[0]=S(1)
  *  and sf[1]=1. For q=7, there are no possible wave vectors, so
  *  sf[2*(7-1)]=sf[2*(7-1)+1]=0.
+ *  The sums over the particles are computed on all nodes in parallel.
  *
- *  @param[in]  partCfg   particle collection
  *  @param[in]  p_types   list with types of particles to be analyzed
  *  @param[in]  order     the maximum wave vector length in units of 2PI/L
  *  @param[out] wavevectors  the scattering vectors q
  *  @param[out] intensities  the structure factor S(q)
  */
-void calc_structurefactor(PartCfg &partCfg, std::vector<int> const &p_types,
-                          int order, std::vector<double> &wavevectors,
+void calc_structurefactor(std::vector<int> const &p_types, int order,
+                          std::vector<double> &wavevectors,
                           std::vector<double> &intensities);
 
 /** Calculate the center of mass of a special type of the current configuration.
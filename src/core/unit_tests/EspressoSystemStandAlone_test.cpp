@@ -32,30 +32,56 @@ namespace utf = boost::unit_test;
 #include "bonded_interactions/bonded_interaction_utils.hpp"
 #include "bonded_interactions/fene.hpp"
 #include "bonded_interactions/harmonic.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
 #include "electrostatics_magnetostatics/coulomb.hpp"
 #include "electrostatics_magnetostatics/p3m.hpp"
 #include "energy.hpp"
 #include "galilei.hpp"
+#include "grid.hpp"
 #include "integrate.hpp"
+#include "load_balancing.hpp"
 #include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/thole.hpp"
+#include "observables/CylindricalDensityProfile.hpp"
+#include "observables/CylindricalFluxDensityProfile.hpp"
+#include "observables/CylindricalVelocityProfile.hpp"
+#include "observables/DensityProfile.hpp"
+#include "observables/FluxDensityProfile.hpp"
+#include "observables/ForceDensityProfile.hpp"
 #include "observables/ParticleVelocities.hpp"
+#include "observables/RDF.hpp"
+#include "observables/fetch_particles.hpp"
 #include "particle_data.hpp"
+#include "statistics.hpp"
 
 #include <utils/Vector.hpp>
+#include <utils/constants.hpp>
 #include <utils/index.hpp>
+#include <utils/math/cylindrical_transformation_parameters.hpp>
 #include <utils/math/int_pow.hpp>
 #include <utils/math/sqr.hpp>
 
 #include <boost/mpi.hpp>
+#include <boost/range/algorithm/min_element.hpp>
 #include <boost/range/numeric.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdlib>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <numeric>
+#include <random>
 #include <unordered_map>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 /* Guard against a bug in Boost versions < 1.68 where fixtures used to skip
  * test are not propagated correctly to the testsuite, causing skipped tests
  * to trigger a failure of the complete testsuite without any error message.
@@ -195,6 +221,48 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
       BOOST_CHECK_CLOSE(obs_energy.non_bonded_inter[i], ref_inter, 500. * tol);
       BOOST_CHECK_CLOSE(obs_energy.non_bonded_intra[i], ref_intra, 500. * tol);
     }
+
+    // forces from the packed particle data match the regular pair loop
+    espresso::system->set_time_step(0.001);
+    espresso::system->set_skin(0.4);
+    mpi_integrate(0, -1);
+    auto const f_ref = get_particle_data(pid2).f.f;
+    BOOST_REQUIRE_GT(f_ref.norm(), 0.);
+    mpi_set_use_soa(true);
+    mpi_integrate(0, -1);
+    mpi_set_use_soa(false);
+    auto const f_soa = get_particle_data(pid2).f.f;
+    BOOST_CHECK_SMALL((f_soa - f_ref).norm(), tol * f_ref.norm());
+
+    // forces with overlapped ghost communication match the regular ones
+    mpi_set_overlap_communication(true);
+    mpi_integrate(0, -1);
+    mpi_integrate(0, -1);
+    mpi_set_overlap_communication(false);
+    auto const f_overlap = get_particle_data(pid2).f.f;
+    BOOST_CHECK_SMALL((f_overlap - f_ref).norm(), tol * f_ref.norm());
+
+    // forces do not depend on the node boundaries
+    mpi_set_load_balancing(true, 0., 1, LOAD_METRIC_PARTICLES);
+    mpi_integrate(1, 0);
+    if (boost::mpi::communicator().size() > 1) {
+      auto const &boundaries = get_node_boundaries();
+      BOOST_CHECK(std::any_of(boundaries.begin(), boundaries.end(),
+                              [](auto const &b) { return not b.empty(); }));
+    }
+    reset_particle_positions();
+    mpi_integrate(0, -1);
+    auto const f_balanced = get_particle_data(pid2).f.f;
+    mpi_set_load_balancing(false, 0.1, 100, LOAD_METRIC_PARTICLES);
+    BOOST_CHECK_SMALL((f_balanced - f_ref).norm(), tol * f_ref.norm());
+
+    // new particle types update the derived interaction parameters
+    auto const max_cut = maximal_cutoff_nonbonded();
+    BOOST_CHECK_CLOSE(max_cut, cut + offset, 1e-10);
+    make_particle_type_exist(max_seen_particle_type + 1);
+    auto const n_types = static_cast<std::size_t>(max_seen_particle_type);
+    BOOST_CHECK_EQUAL(batch_ia_params.size(), n_types * n_types);
+    BOOST_CHECK_EQUAL(maximal_cutoff_nonbonded(), max_cut);
   }
 #endif // LENNARD_JONES
 
@@ -230,6 +298,57 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
     BOOST_CHECK_CLOSE(obs_energy.bonded[fene_bond_id], fene_energy, 40. * tol);
   }
 
+  // check the energy change of single particle moves
+  {
+    auto const shift = Utils::Vector3d{0., 0.005, 0.002};
+    for (auto const pid : {pid1, pid2}) {
+      auto const energy_old = calculate_current_potential_energy_of_system();
+      auto const particle_energy_old = calculate_particle_energy(pid);
+      place_particle(pid, start_positions.at(pid) + shift);
+      auto const energy_new = calculate_current_potential_energy_of_system();
+      auto const particle_energy_new = calculate_particle_energy(pid);
+      BOOST_REQUIRE_GT(std::abs(energy_new - energy_old), 1e-3);
+      BOOST_CHECK_CLOSE(particle_energy_new - particle_energy_old,
+                        energy_new - energy_old, 1e-8);
+      reset_particle_positions();
+    }
+
+    // check the energy change of a move of bonded neighbors, which share
+    // a pair and a bond
+    {
+      auto const pids = std::vector<int>{pid2, pid1, pid2};
+      auto const energy_old = calculate_current_potential_energy_of_system();
+      auto const particles_energy_old = calculate_particles_energy(pids);
+      place_particle(pid1, start_positions.at(pid1) + shift);
+      place_particle(pid2, start_positions.at(pid2) - shift);
+      auto const energy_new = calculate_current_potential_energy_of_system();
+      auto const particles_energy_new = calculate_particles_energy(pids);
+      BOOST_REQUIRE_GT(std::abs(energy_new - energy_old), 1e-3);
+      BOOST_CHECK_CLOSE(particles_energy_new - particles_energy_old,
+                        energy_new - energy_old, 1e-8);
+      reset_particle_positions();
+    }
+    BOOST_CHECK_EQUAL(calculate_long_range_energy(), 0.);
+
+    // a particle which left its cell by less than half the skin is not
+    // resorted, its energy is the same as after a resort
+    espresso::system->set_skin(0.4);
+    espresso::system->set_time_step(0.0001);
+    mpi_kill_particle_motion(0);
+    set_particle_v(pid1, {1500., 0., 0.});
+    mpi_integrate(1, 0);
+    auto const pos = get_particle_data(pid1).r.p;
+    BOOST_REQUIRE_GT(pos[0], box_center);
+    BOOST_REQUIRE_LT(pos[0] - start_positions.at(pid1)[0], 0.2);
+    auto const particle_energy_unsorted = calculate_particle_energy(pid1);
+    mpi_kill_particle_motion(0);
+    auto const particle_energy_sorted = calculate_particle_energy(pid1);
+    BOOST_REQUIRE_GT(std::abs(particle_energy_sorted), 1e-3);
+    BOOST_CHECK_CLOSE(particle_energy_unsorted, particle_energy_sorted, 1e-8);
+    espresso::system->set_time_step(0.001);
+    reset_particle_positions();
+  }
+
   // check electrostatics
 #ifdef P3M
   {
@@ -262,6 +381,75 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
       auto const energy_p3m = obs_energy.coulomb[0] + obs_energy.coulomb[1];
       BOOST_CHECK_CLOSE(energy_p3m, energy_ref, 0.01);
     }
+
+    // check the change of the k-space energy by changes of charges,
+    // calculated from the changed charges
+    {
+      auto const pids = std::vector<int>{pid1, pid3};
+      auto const get_charges = [&pids]() {
+        std::vector<ParticleCharge> charges;
+        for (auto const pid : pids) {
+          auto const &p = get_particle_data(pid);
+          charges.emplace_back(p.p.q, p.r.p);
+        }
+        return charges;
+      };
+      auto const change_charges = [&](Utils::Vector3d const &shift,
+                                      double q3) {
+        auto const charges_old = get_charges();
+        place_particle(pid1, get_particle_data(pid1).r.p + shift);
+        set_particle_q(pid3, q3);
+        return calculate_long_range_energy_change(charges_old, get_charges());
+      };
+      auto const energy_old = calculate_long_range_energy();
+      // accepted change
+      auto const energy_change_1 = change_charges({0.3, 0.2, 0.1}, 0.5);
+      accept_long_range_energy_change();
+      // rejected change
+      auto const pos1 = get_particle_data(pid1).r.p;
+      change_charges({-1.0, 0.5, 0.}, 1.0);
+      place_particle(pid1, pos1);
+      set_particle_q(pid3, 0.5);
+      // accepted change
+      auto const energy_change_2 = change_charges({0.1, 0.1, 0.4}, -0.5);
+      accept_long_range_energy_change();
+      BOOST_REQUIRE_GT(std::abs(energy_change_1), 1e-3);
+      BOOST_REQUIRE_GT(std::abs(energy_change_2), 1e-3);
+      auto const energy_new = calculate_long_range_energy();
+      BOOST_CHECK_CLOSE(energy_old + energy_change_1 + energy_change_2,
+                        energy_new, 1e-8);
+      set_particle_q(pid3, 0.);
+    }
+
+    // check the change of the k-space energy by an insertion, a charge
+    // change and a deletion against a full recalculation; these change
+    // the self energy and the net charge of the system
+    {
+      auto const pid4 = 11;
+      auto const pos4 = Utils::Vector3d{1.5, 6.0, 3.0};
+      auto energy_old = calculate_long_range_energy();
+      auto const check_energy_change =
+          [&energy_old](std::vector<ParticleCharge> const &charges_old,
+                        std::vector<ParticleCharge> const &charges_new) {
+            auto const energy_change =
+                calculate_long_range_energy_change(charges_old, charges_new);
+            accept_long_range_energy_change();
+            auto const energy_new = calculate_long_range_energy();
+            BOOST_REQUIRE_GT(std::abs(energy_change), 1e-3);
+            BOOST_CHECK_CLOSE(energy_old + energy_change, energy_new, 1e-8);
+            energy_old = energy_new;
+          };
+      // insertion
+      place_particle(pid4, pos4);
+      set_particle_q(pid4, 1.5);
+      check_energy_change({}, {{1.5, pos4}});
+      // charge change
+      set_particle_q(pid4, -0.5);
+      check_energy_change({{1.5, pos4}}, {{-0.5, pos4}});
+      // deletion
+      remove_particle(pid4);
+      check_energy_change({{-0.5, pos4}}, {});
+    }
   }
 #endif // P3M
 
@@ -279,7 +467,7 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
     reset_particle_positions();
 
     // recalculate forces without propagating the system
-    mpi_integrate(0, 0);
+    mpi_integrate(0, -1);
 
     // particles are arranged in a right triangle
     auto const &p1 = get_particle_data(pid1);
@@ -324,6 +512,284 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
   }
 }
 
+#if defined(THOLE) && defined(P3M)
+BOOST_FIXTURE_TEST_CASE(thole_cutoff_box_change, ParticleFactory,
+                        *utf::precondition(if_head_node())) {
+  auto const box_l = 8.;
+  auto const r_cut = 2.;
+  auto const type_a = 3;
+  auto const type_b = 4;
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(box_l));
+
+  // the Thole cutoff is the real-space cutoff of P3M
+  auto const mesh = std::vector<int>{8, 8, 8};
+  Coulomb::set_prefactor(1.);
+  p3m_set_params(r_cut, mesh.data(), 5, 0.654, 1e-3);
+  thole_set_params(type_a, type_b, 2., 1.);
+  BOOST_CHECK_CLOSE(maximal_cutoff_nonbonded(), r_cut, 1e-10);
+
+  // which scales with the box length
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(0.75 * box_l));
+  BOOST_CHECK_CLOSE(maximal_cutoff_nonbonded(), 0.75 * r_cut, 1e-10);
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(box_l));
+  BOOST_CHECK_CLOSE(maximal_cutoff_nonbonded(), r_cut, 1e-10);
+
+  thole_set_params(type_a, type_b, 0., 0.);
+}
+#endif // THOLE and P3M
+
+#if defined(LENNARD_JONES) && defined(_OPENMP)
+static void set_num_threads_local(int n_threads) {
+  omp_set_num_threads(n_threads);
+}
+
+REGISTER_CALLBACK(set_num_threads_local)
+
+BOOST_FIXTURE_TEST_CASE(threaded_pair_forces, ParticleFactory,
+                        *utf::precondition(if_head_node())) {
+  auto const box_l = 8.;
+  auto const type = 6;
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(box_l));
+  espresso::system->set_time_step(0.001);
+  espresso::system->set_skin(0.3);
+  lennard_jones_set_params(type, type, 1., 1., 1.2, 0., 0., 0.);
+
+  // particles on a perturbed lattice, spread over all MPI domains
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> noise(-0.1, 0.1);
+  std::vector<int> pids;
+  for (int i = 0; i < 8; ++i) {
+    for (int j = 0; j < 8; ++j) {
+      for (int k = 0; k < 8; ++k) {
+        auto const pos = Utils::Vector3d{i + 0.5 + noise(generator),
+                                         j + 0.5 + noise(generator),
+                                         k + 0.5 + noise(generator)};
+        auto const pid = 1000 + static_cast<int>(pids.size());
+        create_particle(pos, pid, type);
+        pids.push_back(pid);
+      }
+    }
+  }
+
+  auto const max_threads = omp_get_max_threads();
+  auto const get_forces = [&pids](int n_threads) {
+    mpi_call_all(set_num_threads_local, n_threads);
+    mpi_integrate(0, -1);
+    std::vector<Utils::Vector3d> forces;
+    for (auto const pid : pids) {
+      forces.push_back(get_particle_data(pid).f.f);
+    }
+    return forces;
+  };
+
+  // forces from the colored cell loop match the serial ones
+  for (auto const use_verlet_lists : {false, true}) {
+    mpi_set_use_verlet_lists(use_verlet_lists);
+    auto const f_serial = get_forces(1);
+    auto const f_threaded = get_forces(4);
+    auto const f_max = std::accumulate(
+        f_serial.begin(), f_serial.end(), 0.,
+        [](double acc, auto const &f) { return std::max(acc, f.norm()); });
+    BOOST_REQUIRE_GT(f_max, 0.);
+    for (std::size_t i = 0; i < pids.size(); ++i) {
+      BOOST_CHECK_SMALL((f_threaded[i] - f_serial[i]).norm(), 1e-12 * f_max);
+    }
+  }
+
+  mpi_set_use_verlet_lists(true);
+  mpi_call_all(set_num_threads_local, max_threads);
+  lennard_jones_set_params(type, type, 0., 0., 0., 0., 0., 0.);
+}
+#endif // LENNARD_JONES and _OPENMP
+
+BOOST_FIXTURE_TEST_CASE(distributed_analysis, ParticleFactory,
+                        *utf::precondition(if_head_node())) {
+  auto const box_l = 8.;
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(box_l));
+
+  // particles of two types, spread over all MPI domains
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> uniform(0., box_l);
+  std::vector<int> ids_a, ids_b;
+  std::unordered_map<int, Utils::Vector3d> positions;
+  for (int pid = 100; pid < 300; ++pid) {
+    auto const pos = Utils::Vector3d{uniform(generator), uniform(generator),
+                                     uniform(generator)};
+    auto const type = pid % 2;
+    create_particle(pos, pid, type);
+    positions[pid] = pos;
+    (type == 0 ? ids_a : ids_b).push_back(pid);
+  }
+
+  // check the radial distribution function against all pairs
+  {
+    auto const min_r = 0.1;
+    auto const max_r = 1.5;
+    auto const n_bins = 7;
+    BOOST_REQUIRE_GE(*boost::min_element(cell_structure.max_range()), max_r);
+    auto const reference = [&](std::vector<int> const &ids1,
+                               std::vector<int> const &ids2) {
+      auto const bin_width = (max_r - min_r) / n_bins;
+      std::vector<double> histogram(n_bins);
+      auto cnt = 0l;
+      auto const add = [&](int pid1, int pid2) {
+        auto const dist =
+            box_geo.get_mi_vector(positions[pid1], positions[pid2]).norm();
+        if (dist > min_r and dist < max_r)
+          histogram[static_cast<int>((dist - min_r) / bin_width)] += 1.;
+        cnt++;
+      };
+      if (ids2.empty()) {
+        for (std::size_t i = 0; i < ids1.size(); ++i)
+          for (std::size_t j = i + 1; j < ids1.size(); ++j)
+            add(ids1[i], ids1[j]);
+      } else {
+        for (auto const pid1 : ids1)
+          for (auto const pid2 : ids2)
+            add(pid1, pid2);
+      }
+      for (int i = 0; i < n_bins; ++i) {
+        auto const r_in = min_r + i * bin_width;
+        auto const r_out = r_in + bin_width;
+        auto const bin_volume = 4. / 3. * Utils::pi() *
+                                (Utils::int_pow<3>(r_out) -
+                                 Utils::int_pow<3>(r_in));
+        histogram[i] *= box_geo.volume() / (bin_volume * cnt);
+      }
+      return histogram;
+    };
+
+    for (auto const &ids2 : {std::vector<int>{}, ids_b}) {
+      auto const rdf = Observables::RDF(ids_a, ids2, n_bins, min_r, max_r)();
+      auto const rdf_ref = reference(ids_a, ids2);
+      BOOST_REQUIRE_EQUAL(rdf.size(), rdf_ref.size());
+      for (int i = 0; i < n_bins; ++i) {
+        BOOST_CHECK_CLOSE(rdf[i], rdf_ref[i], 1e-9);
+      }
+    }
+  }
+
+  // check the structure factor against the sums over all particles
+  {
+    auto const order = 3;
+    std::vector<double> wavevectors, intensities;
+    calc_structurefactor({0}, order, wavevectors, intensities);
+
+    auto const twoPI_L = 2. * Utils::pi() / box_l;
+    std::vector<double> sf(order * order), n_vectors(order * order);
+    for (int i = 0; i <= order; ++i)
+      for (int j = -order; j <= order; ++j)
+        for (int k = -order; k <= order; ++k) {
+          auto const n = i * i + j * j + k * k;
+          if (n < 1 or n > order * order)
+            continue;
+          auto c = 0., s = 0.;
+          for (auto const pid : ids_a) {
+            auto const qr = twoPI_L * (Utils::Vector3i{{i, j, k}} *
+                                       positions[pid]);
+            c += std::cos(qr);
+            s += std::sin(qr);
+          }
+          sf[n - 1] += (c * c + s * s) / static_cast<double>(ids_a.size());
+          n_vectors[n - 1] += 1.;
+        }
+    std::size_t cnt = 0;
+    for (int n = 1; n <= order * order; ++n) {
+      if (n_vectors[n - 1] == 0.)
+        continue;
+      BOOST_REQUIRE_LT(cnt, intensities.size());
+      BOOST_CHECK_CLOSE(wavevectors[cnt], twoPI_L * std::sqrt(n), 1e-9);
+      BOOST_CHECK_CLOSE(intensities[cnt], sf[n - 1] / n_vectors[n - 1], 1e-7);
+      cnt++;
+    }
+    BOOST_CHECK_EQUAL(cnt, intensities.size());
+  }
+
+  // check the profiles evaluated in situ against the fetched particles
+  {
+    std::uniform_real_distribution<double> uniform_vec(-1., 1.);
+    for (auto const pid : ids_a) {
+      set_particle_v(pid, {uniform_vec(generator), uniform_vec(generator),
+                           uniform_vec(generator)});
+      set_particle_f(pid, {uniform_vec(generator), uniform_vec(generator),
+                           uniform_vec(generator)});
+    }
+    // particles which appear twice are counted twice
+    auto ids = ids_a;
+    ids.push_back(ids_a.front());
+
+    auto const check_profile = [&ids](auto const &obs) {
+      auto const particles = fetch_particles(ids);
+      std::vector<std::reference_wrapper<const Particle>> particle_refs(
+          particles.begin(), particles.end());
+      auto const reference =
+          obs.evaluate(Observables::ParticleReferenceRange(particle_refs),
+                       ParticleObservables::traits<Particle>{});
+      auto const profile = obs();
+      BOOST_REQUIRE_EQUAL(profile.size(), reference.size());
+      for (std::size_t i = 0; i < profile.size(); ++i) {
+        BOOST_CHECK_CLOSE(profile[i], reference[i], 1e-9);
+      }
+    };
+    using namespace Observables;
+    check_profile(DensityProfile(ids, 4, 3, 2, 1., 7., 0., box_l, 0., box_l));
+    check_profile(
+        FluxDensityProfile(ids, 4, 3, 2, 1., 7., 0., box_l, 0., box_l));
+    check_profile(
+        ForceDensityProfile(ids, 4, 3, 2, 1., 7., 0., box_l, 0., box_l));
+    auto const transform_params =
+        std::make_shared<Utils::CylindricalTransformationParameters>(
+            Utils::Vector3d::broadcast(box_l / 2.), Utils::Vector3d{0., 0., 1.},
+            Utils::Vector3d{1., 0., 0.});
+    auto const pi = Utils::pi();
+    check_profile(CylindricalDensityProfile(ids, transform_params, 3, 4, 2, 0.,
+                                            3., -pi, pi, -3., 3.));
+    check_profile(CylindricalFluxDensityProfile(ids, transform_params, 3, 4, 2,
+                                                0., 3., -pi, pi, -3., 3.));
+    check_profile(CylindricalVelocityProfile(ids, transform_params, 3, 4, 2,
+                                             0., 3., -pi, pi, -3., 3.));
+
+    // particles which do not exist
+    ids.push_back(1000);
+    BOOST_CHECK_THROW(
+        DensityProfile(ids, 4, 3, 2, 1., 7., 0., box_l, 0., box_l)(),
+        std::exception);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(rdf_last_bin, ParticleFactory,
+                        *utf::precondition(if_head_node())) {
+  auto const box_l = 8.;
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(box_l));
+
+  // a pair just below max_r, whose bin index rounds up to n_bins
+  auto const max_r = 0.9;
+  auto const dist = std::nextafter(max_r, 0.);
+  create_particle({0., 0., 0.}, 10, 0);
+  create_particle({dist, 0., 0.}, 11, 0);
+  auto const ids = std::vector<int>{10, 11};
+
+  // from the cell system (min_r >= 0) and on the head node (min_r < 0)
+  for (auto const min_r : {0.1, -0.3}) {
+    auto const n_bins = 5;
+    auto const bin_width = (max_r - min_r) / n_bins;
+    // bin index with the arithmetic of the respective code path
+    auto const bin = (min_r >= 0.) ? (dist - min_r) * (n_bins / (max_r - min_r))
+                                   : (dist - min_r) * (1. / bin_width);
+    BOOST_REQUIRE_GE(std::floor(bin), n_bins);
+    auto const rdf = Observables::RDF(ids, {}, n_bins, min_r, max_r)();
+    BOOST_REQUIRE_EQUAL(rdf.size(), n_bins);
+    auto const r_in = max_r - bin_width;
+    auto const bin_volume =
+        4. / 3. * Utils::pi() *
+        (Utils::int_pow<3>(max_r) - Utils::int_pow<3>(r_in));
+    for (int i = 0; i < n_bins - 1; ++i) {
+      BOOST_CHECK_EQUAL(rdf[i], 0.);
+    }
+    BOOST_CHECK_CLOSE(rdf[n_bins - 1], box_geo.volume() / bin_volume, 1e-9);
+  }
+}
+
 int main(int argc, char **argv) {
   espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
 
@@ -62,4 +62,19 @@ BOOST_AUTO_TEST_CASE(constructors) {
     BOOST_CHECK(boost::equal(boundaries, box.boundary()));
     check_length(box);
   }
+
+  /* lower corner + upper corner */
+  {
+    Utils::Vector<double, 3> const lower_corner = {0.1, 0.2, 0.3};
+    Utils::Vector<double, 3> const upper_corner = {0.7, 0.8, 0.9};
+    Utils::Array<int, 6> const boundaries = {-1, 0, 1, 1, 0, -1};
+
+    auto const box =
+        LocalBox<double>::from_corners(lower_corner, upper_corner, boundaries);
+
+    BOOST_CHECK(box.my_left() == lower_corner);
+    BOOST_CHECK(box.my_right() == upper_corner);
+    BOOST_CHECK(boost::equal(boundaries, box.boundary()));
+    check_length(box);
+  }
 }
@@ -235,3 +235,79 @@ BOOST_AUTO_TEST_CASE(regular_decomposition_test) {
         }
   }
 }
+
+BOOST_AUTO_TEST_CASE(tensor_product_decomposition_test) {
+  auto const eps = std::numeric_limits<double>::epsilon();
+
+  auto const box_l = Utils::Vector3d{10, 20, 30};
+  auto box = BoxGeometry();
+  box.set_length(box_l);
+  auto const node_grid = Utils::Vector3i{1, 2, 3};
+
+  /* without boundaries, this is the regular decomposition */
+  {
+    auto const node_pos = Utils::Vector3i{0, 1, 2};
+    auto const result =
+        tensor_product_decomposition(box, node_pos, node_grid, {});
+    auto const expected = regular_decomposition(box, node_pos, node_grid);
+
+    BOOST_CHECK_SMALL((result.my_left() - expected.my_left()).norm(), eps);
+    BOOST_CHECK_SMALL((result.length() - expected.length()).norm(), eps);
+    for (int i = 0; i < 6; i++) {
+      BOOST_CHECK_EQUAL(result.boundary()[i], expected.boundary()[i]);
+    }
+  }
+
+  /* shifted boundaries in z */
+  {
+    NodeBoundaries boundaries;
+    boundaries[2] = {0., 0.1, 0.5, 1.};
+
+    Utils::Vector3i node_pos;
+    for (node_pos[1] = 0; node_pos[1] < node_grid[1]; node_pos[1]++)
+      for (node_pos[2] = 0; node_pos[2] < node_grid[2]; node_pos[2]++) {
+        node_pos[0] = 0;
+        auto const result =
+            tensor_product_decomposition(box, node_pos, node_grid, boundaries);
+        auto const regular = regular_decomposition(box, node_pos, node_grid);
+        auto const &b = boundaries[2];
+
+        BOOST_CHECK_CLOSE(result.my_left()[1], regular.my_left()[1],
+                          100. * eps);
+        BOOST_CHECK_CLOSE(result.length()[1], regular.length()[1], 100. * eps);
+        BOOST_CHECK_SMALL(result.my_left()[2] - b[node_pos[2]] * box_l[2],
+                          100. * eps);
+        BOOST_CHECK_SMALL(result.my_right()[2] -
+                              b[node_pos[2] + 1] * box_l[2],
+                          100. * eps);
+        for (int i = 0; i < 6; i++) {
+          BOOST_CHECK_EQUAL(result.boundary()[i], regular.boundary()[i]);
+        }
+      }
+  }
+
+  /* neighboring nodes share their boundaries exactly */
+  {
+    NodeBoundaries boundaries;
+    boundaries[2] = {0., 0.1, 0.7, 1.};
+    for (int dir = 1; dir < 3; dir++) {
+      for (int pos = 0; pos < node_grid[dir]; pos++) {
+        auto node_pos = Utils::Vector3i{0, 0, 0};
+        node_pos[dir] = pos;
+        auto const result =
+            tensor_product_decomposition(box, node_pos, node_grid, boundaries);
+        if (pos == 0) {
+          BOOST_CHECK_EQUAL(result.my_left()[dir], 0.);
+        } else {
+          node_pos[dir] = pos - 1;
+          auto const below = tensor_product_decomposition(
+              box, node_pos, node_grid, boundaries);
+          BOOST_CHECK_EQUAL(result.my_left()[dir], below.my_right()[dir]);
+        }
+        if (pos == node_grid[dir] - 1) {
+          BOOST_CHECK_EQUAL(result.my_right()[dir], box_l[dir]);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MODULE LB grid refinement test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "grid_based_algorithms/lb_refinement.hpp"
+
+#include <utils/math/sqr.hpp>
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+auto constexpr eps = 100. * std::numeric_limits<double>::epsilon();
+
+auto constexpr density = 0.8;
+
+/** Modes with a given momentum density and equilibrium stress. */
+std::array<double, 19> equilibrium_modes(double rho, double jx, double jy,
+                                         double jz) {
+  using Utils::sqr;
+  auto const j2 = sqr(jx) + sqr(jy) + sqr(jz);
+  auto const total_density = density + rho;
+  return {{rho, jx, jy, jz, j2 / total_density,
+           (sqr(jx) - sqr(jy)) / total_density,
+           (j2 - 3. * sqr(jz)) / total_density, jx * jy / total_density,
+           jx * jz / total_density, jy * jz / total_density}};
+}
+
+BOOST_AUTO_TEST_CASE(conserved_modes) {
+  auto modes = equilibrium_modes(0.01, 0.02, -0.01, 0.005);
+  for (int i = 10; i < 19; i++) {
+    modes[i] = 1e-3 * i;
+  }
+
+  auto const result = lb_rescale_modes(modes, density, 0.125, 0.3, 0.4);
+
+  for (int i = 0; i < 4; i++) {
+    BOOST_CHECK_SMALL(result[i] - 0.125 * modes[i], eps);
+  }
+  /* ghost modes are not transferred */
+  for (int i = 10; i < 19; i++) {
+    BOOST_CHECK_EQUAL(result[i], 0.);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(equilibrium) {
+  /* an equilibrium maps to the equilibrium of the target lattice */
+  auto const modes = equilibrium_modes(0.01, 0.02, -0.01, 0.005);
+  auto const result = lb_rescale_modes(modes, density, 0.125, 0.3, 0.4);
+
+  for (int i = 4; i < 10; i++) {
+    BOOST_CHECK_SMALL(result[i] - 0.125 * modes[i], eps);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(non_equilibrium) {
+  auto const eq = equilibrium_modes(0.01, 0.02, -0.01, 0.005);
+  auto modes = eq;
+  for (int i = 4; i < 10; i++) {
+    modes[i] += 1e-3 * i;
+  }
+
+  auto const result = lb_rescale_modes(modes, density, 0.125, 0.3, 0.4);
+
+  BOOST_CHECK_SMALL(result[4] - 0.125 * eq[4] - 0.3 * 4e-3, eps);
+  for (int i = 5; i < 10; i++) {
+    BOOST_CHECK_SMALL(result[i] - 0.125 * eq[i] - 0.4 * 1e-3 * i, eps);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(round_trip) {
+  auto modes = equilibrium_modes(-0.02, 0.01, 0.03, -0.02);
+  for (int i = 4; i < 10; i++) {
+    modes[i] -= 2e-3 * i;
+  }
+
+  auto const fine = lb_rescale_modes(modes, density, 1. / 8., 0.3, 0.4);
+  auto const coarse =
+      lb_rescale_modes(fine, density / 8., 8., 1. / 0.3, 1. / 0.4);
+
+  for (int i = 0; i < 10; i++) {
+    BOOST_CHECK_SMALL(coarse[i] - modes[i], eps);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(neq_ratio) {
+  /* same relaxation time: mass ratio 1/8 times time step ratio 1/2 */
+  BOOST_CHECK_SMALL(lb_refinement_neq_ratio(0.2, 0.2) - 1. / 16., eps);
+
+  /* relaxation time 1/(1 - gamma) = 3 nu + 1/2 with the viscosity nu in
+   * lattice units, which is twice as large on the fine lattice */
+  auto const nu = 0.5;
+  auto const gamma = [](double nu) { return 1. - 1. / (3. * nu + 0.5); };
+  auto const tau_coarse = 3. * nu + 0.5;
+  auto const tau_fine = 3. * (2. * nu) + 0.5;
+  BOOST_CHECK_SMALL(lb_refinement_neq_ratio(gamma(nu), gamma(2. * nu)) -
+                        tau_fine / (16. * tau_coarse),
+                    eps);
+}
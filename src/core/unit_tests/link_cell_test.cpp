@@ -21,11 +21,14 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 
+#include "algorithm/colored_link_cell.hpp"
 #include "algorithm/link_cell.hpp"
 
 #include "Cell.hpp"
 #include "Particle.hpp"
 
+#include <cstddef>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -72,3 +75,83 @@ BOOST_AUTO_TEST_CASE(link_cell) {
       ++it;
     }
 }
+
+BOOST_AUTO_TEST_CASE(colored_link_cell) {
+  /* 1D periodic chain of cells, every cell has the next
+   * two cells as red neighbors. */
+  const int n_cells = 12;
+  const auto n_part_per_cell = 3;
+  const auto n_part = n_cells * n_part_per_cell;
+
+  std::vector<Cell> cells(n_cells);
+
+  auto id = 0;
+  for (int i = 0; i < n_cells; i++) {
+    std::vector<Cell *> red = {&cells[(i + 1) % n_cells],
+                               &cells[(i + 2) % n_cells]};
+    std::vector<Cell *> black = {&cells[(i + n_cells - 1) % n_cells],
+                                 &cells[(i + n_cells - 2) % n_cells]};
+    cells[i].m_neighbors = Neighbors<Cell *>(red, black);
+
+    cells[i].particles().resize(n_part_per_cell);
+    for (auto &p : cells[i].particles()) {
+      p.p.identity = id++;
+    }
+  }
+
+  auto const colors = Algorithm::color_cells(cells.begin(), cells.end());
+
+  /* Every cell has exactly one color */
+  std::set<Cell *> colored;
+  for (auto const &color : colors) {
+    for (auto const cell : color) {
+      BOOST_CHECK(colored.insert(cell).second);
+    }
+  }
+  BOOST_CHECK_EQUAL(colored.size(), n_cells);
+
+  /* Cells of the same color do not write to common cells */
+  for (auto const &color : colors) {
+    std::set<Cell *> written;
+    for (auto const cell : color) {
+      BOOST_CHECK(written.insert(cell).second);
+      for (auto const neighbor : cell->neighbors().red()) {
+        BOOST_CHECK(written.insert(neighbor).second);
+      }
+    }
+  }
+
+  /* Same pairs as the link cell algorithm */
+  std::vector<std::vector<int>> counts(n_part, std::vector<int>(n_part));
+  Algorithm::colored_link_cell(colors,
+                               [&counts](Particle const &p1,
+                                         Particle const &p2) {
+                                 counts[p1.p.identity][p2.p.identity]++;
+                               });
+
+  std::vector<std::vector<int>> expected(n_part, std::vector<int>(n_part));
+  Algorithm::link_cell(cells.begin(), cells.end(),
+                       [&expected](Particle const &p1, Particle const &p2) {
+                         expected[p1.p.identity][p2.p.identity]++;
+                       });
+
+  BOOST_CHECK(counts == expected);
+
+  /* The callback runs once per color, after all cells of the color */
+  std::vector<std::size_t> cells_done;
+  std::size_t n_visited = 0;
+  Algorithm::for_each_colored_cell(
+      colors, [&n_visited](Cell &) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        n_visited++;
+      },
+      [&]() { cells_done.push_back(n_visited); });
+  BOOST_REQUIRE_EQUAL(cells_done.size(), colors.size());
+  std::size_t n_expected = 0;
+  for (std::size_t i = 0; i < colors.size(); ++i) {
+    n_expected += colors[i].size();
+    BOOST_CHECK_EQUAL(cells_done[i], n_expected);
+  }
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MODULE load balancing test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "load_balancing.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+auto constexpr eps = 10. * std::numeric_limits<double>::epsilon();
+
+BOOST_AUTO_TEST_CASE(balanced_load) {
+  auto const boundaries = std::vector<double>{0., 0.25, 0.5, 0.75, 1.};
+  auto const loads = std::vector<double>{2., 2., 2., 2.};
+
+  auto const result = balance_boundaries(boundaries, loads, 0.);
+
+  BOOST_REQUIRE_EQUAL(result.size(), boundaries.size());
+  for (std::size_t i = 0; i < result.size(); i++) {
+    BOOST_CHECK_SMALL(result[i] - boundaries[i], eps);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(no_load) {
+  auto const boundaries = std::vector<double>{0., 0.3, 1.};
+  auto const loads = std::vector<double>{0., 0.};
+
+  auto const result = balance_boundaries(boundaries, loads, 0.);
+
+  BOOST_CHECK(result == boundaries);
+}
+
+BOOST_AUTO_TEST_CASE(unbalanced_load) {
+  /* All the load in the second half: the boundaries split the
+   * second half into equal parts. */
+  {
+    auto const boundaries = std::vector<double>{0., 0.5, 1.};
+    auto const loads = std::vector<double>{0., 4.};
+
+    auto const result = balance_boundaries(boundaries, loads, 0.);
+
+    BOOST_CHECK_SMALL(result[0], eps);
+    BOOST_CHECK_SMALL(result[1] - 0.75, eps);
+    BOOST_CHECK_SMALL(result[2] - 1., eps);
+  }
+
+  /* Load ratio 1:3 */
+  {
+    auto const boundaries = std::vector<double>{0., 0.5, 1.};
+    auto const loads = std::vector<double>{1., 3.};
+
+    auto const result = balance_boundaries(boundaries, loads, 0.);
+
+    BOOST_CHECK_SMALL(result[1] - (0.5 + 0.5 / 3.), eps);
+  }
+
+  /* Uneven boundaries with uniform density */
+  {
+    auto const boundaries = std::vector<double>{0., 0.2, 0.6, 1.};
+    auto const loads = std::vector<double>{1., 2., 2.};
+
+    auto const result = balance_boundaries(boundaries, loads, 0.);
+
+    BOOST_CHECK_SMALL(result[1] - 1. / 3., eps);
+    BOOST_CHECK_SMALL(result[2] - 2. / 3., eps);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(min_width) {
+  auto const boundaries = std::vector<double>{0., 0.25, 0.5, 0.75, 1.};
+  auto const loads = std::vector<double>{0., 0., 0., 8.};
+  auto const min_width = 0.1;
+
+  auto const result = balance_boundaries(boundaries, loads, min_width);
+
+  BOOST_CHECK_SMALL(result.front(), eps);
+  BOOST_CHECK_SMALL(result.back() - 1., eps);
+  for (std::size_t i = 1; i < result.size(); i++) {
+    BOOST_CHECK_GE(result[i] - result[i - 1], min_width - eps);
+  }
+  /* the slabs are packed towards the loaded region */
+  BOOST_CHECK_SMALL(result[1] - 0.7, eps);
+  BOOST_CHECK_SMALL(result[2] - 0.8, eps);
+  BOOST_CHECK_SMALL(result[3] - 0.9, eps);
+}
@@ -23,8 +23,16 @@
 
 #include "electrostatics_magnetostatics/p3m-common.hpp"
 
+#if defined(P3M) || defined(DP3M)
+#include "electrostatics_magnetostatics/p3m_interpolation.hpp"
+
+#include <utils/Vector.hpp>
+#endif
+
 #include <array>
+#include <cmath>
 #include <cstddef>
+#include <random>
 #include <vector>
 
 BOOST_AUTO_TEST_CASE(calc_meshift_false) {
@@ -44,7 +52,7 @@ BOOST_AUTO_TEST_CASE(calc_meshift_false) {
 BOOST_AUTO_TEST_CASE(calc_meshift_true) {
   std::array<std::vector<int>, 3> const ref = {
       std::vector<int>{0}, std::vector<int>{0, 1, 0, -1},
-      std::vector<int>{0, 1, 2, 0, -3, -2, -1}};
+      std::vector<int>{0, 1, 2, 3, -3, -2, -1}};
 
   auto const val = detail::calc_meshift({1, 4, 7}, true);
 
@@ -54,3 +62,104 @@ BOOST_AUTO_TEST_CASE(calc_meshift_true) {
     }
   }
 }
+
+#if defined(P3M) || defined(DP3M)
+BOOST_AUTO_TEST_CASE(assign_concurrently) {
+  constexpr int cao = 3;
+  auto const n_points = 200;
+
+  p3m_local_mesh local_mesh{};
+  local_mesh.dim = {12, 5, 6};
+  local_mesh.size = 12 * 5 * 6;
+  local_mesh.q_2_off = local_mesh.dim[2] - cao;
+  local_mesh.q_21_off = local_mesh.dim[2] * (local_mesh.dim[1] - cao);
+  auto const ai = Utils::Vector3d{1., 1., 1.};
+
+  std::mt19937 rng(42);
+  std::vector<double> charges(n_points);
+  p3m_interpolation_cache weights;
+  weights.reset(cao);
+  weights.resize(n_points);
+  for (int i = 0; i < n_points; i++) {
+    Utils::Vector3d pos;
+    for (int d = 0; d < 3; d++) {
+      pos[d] = std::uniform_real_distribution<double>(
+          1., local_mesh.dim[d] - cao)(rng);
+    }
+    charges[i] = std::uniform_real_distribution<double>(-1., 1.)(rng);
+    weights.store<cao>(
+        i, p3m_calculate_interpolation_weights<cao>(pos, ai, local_mesh));
+  }
+
+  /* reference: assign the points one after another */
+  std::vector<double> mesh_ref(local_mesh.size, 0.);
+  for (int i = 0; i < n_points; i++) {
+    p3m_interpolate(local_mesh, weights.load<cao>(i), [&](int ind, double w) {
+      mesh_ref[ind] += w * charges[i];
+    });
+  }
+
+  std::vector<double> mesh(local_mesh.size, 0.);
+  p3m_assign_concurrently<cao>(local_mesh, weights,
+                               [&](std::size_t i, int ind, double w) {
+                                 mesh[ind] += w * charges[i];
+                               });
+
+  for (int i = 0; i < local_mesh.size; i++) {
+    BOOST_CHECK_SMALL(mesh[i] - mesh_ref[i], 1e-12);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(interpolate_gradient) {
+  constexpr int cao = 5;
+
+  p3m_local_mesh local_mesh{};
+  local_mesh.dim = {10, 9, 8};
+  local_mesh.size = 10 * 9 * 8;
+  local_mesh.q_2_off = local_mesh.dim[2] - cao;
+  local_mesh.q_21_off = local_mesh.dim[2] * (local_mesh.dim[1] - cao);
+  auto const ai = Utils::Vector3d{2., 1., 0.5};
+
+  std::mt19937 rng(42);
+  std::vector<double> mesh(local_mesh.size);
+  for (auto &v : mesh) {
+    v = std::uniform_real_distribution<double>(-1., 1.)(rng);
+  }
+
+  auto const interpolate = [&](Utils::Vector3d const &pos) {
+    double ret = 0.;
+    p3m_interpolate(
+        local_mesh,
+        p3m_calculate_interpolation_weights<cao>(pos, ai, local_mesh),
+        [&](int ind, double w) { ret += w * mesh[ind]; });
+    return ret;
+  };
+
+  for (int i = 0; i < 20; i++) {
+    Utils::Vector3d pos;
+    for (int d = 0; d < 3; d++) {
+      pos[d] = std::uniform_real_distribution<double>(
+                   1., local_mesh.dim[d] - cao)(rng) /
+               ai[d];
+    }
+
+    Utils::Vector3d grad{};
+    p3m_interpolate_gradient(
+        local_mesh,
+        p3m_calculate_interpolation_weights<cao>(pos, ai, local_mesh),
+        p3m_calculate_interpolation_weight_derivatives<cao>(pos, ai,
+                                                            local_mesh),
+        [&](int ind, Utils::Vector3d const &dw) { grad += mesh[ind] * dw; });
+
+    /* central difference */
+    for (int d = 0; d < 3; d++) {
+      auto const h = 1e-6 / ai[d];
+      auto pos_l = pos, pos_r = pos;
+      pos_l[d] -= h;
+      pos_r[d] += h;
+      auto const grad_ref = (interpolate(pos_r) - interpolate(pos_l)) / (2 * h);
+      BOOST_CHECK_SMALL(grad[d] - grad_ref, 1e-6);
+    }
+  }
+}
+#endif
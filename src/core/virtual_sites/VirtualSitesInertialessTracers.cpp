@@ -49,6 +49,7 @@ void VirtualSitesInertialessTracers::after_force_calc() {
 
 void VirtualSitesInertialessTracers::after_lb_propagation(double time_step) {
 #ifdef VIRTUAL_SITES_INERTIALESS_TRACERS
+  lb_lbfluid_finish_propagation();
   IBM_UpdateParticlePositions(cell_structure.local_particles(), time_step);
 #endif // VS inertialess tracers
 }
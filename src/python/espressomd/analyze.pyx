@@ -638,7 +638,7 @@ class Analysis:
         cdef vector[double] wavevectors
         cdef vector[double] intensities
         analyze.calc_structurefactor(
-            analyze.partCfg(), sf_types, sf_order, wavevectors, intensities)
+            sf_types, sf_order, wavevectors, intensities)
 
         return np.vstack([wavevectors, intensities])
 
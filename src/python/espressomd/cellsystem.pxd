@@ -32,6 +32,9 @@ cdef extern from "cells.hpp":
     ctypedef struct CellStructure:
         int decomposition_type()
         bool use_verlet_list
+        bool use_soa
+        int particle_sort_interval
+        bool overlap_communication
 
     CellStructure cell_structure
 
@@ -42,6 +45,9 @@ cdef extern from "cells.hpp":
     vector[int] mpi_resort_particles(int global_flag)
     void mpi_bcast_cell_structure(int cs)
     void mpi_set_use_verlet_lists(bool use_verlet_lists)
+    void mpi_set_use_soa(bool use_soa)
+    void mpi_set_particle_sort_interval(int interval)
+    void mpi_set_overlap_communication(bool overlap)
 
 cdef extern from "tuning.hpp":
     cdef void c_tune_skin "tune_skin" (double min_skin, double max_skin, double tol, int int_steps, bool adjust_max_skin)
@@ -59,6 +65,20 @@ cdef extern from "DomainDecomposition.hpp":
 cdef extern from "grid.hpp":
     void mpi_set_node_grid(const Vector3i & node_grid)
 
+cdef extern from "load_balancing.hpp":
+    int LOAD_METRIC_PARTICLES
+    int LOAD_METRIC_FORCE_TIME
+
+    ctypedef struct LoadBalancingParameters:
+        bool active
+        double threshold
+        int interval
+        int metric
+
+    LoadBalancingParameters load_balancing_params
+
+    void mpi_set_load_balancing(bool active, double threshold, int interval, int metric) except +
+
 cdef extern from "nonbonded_interactions/nonbonded_interaction_data.hpp":
     double maximal_cutoff_bonded()
     double maximal_cutoff_nonbonded()
@@ -25,12 +25,34 @@ from libcpp.vector cimport vector
 from .cellsystem cimport cell_structure
 from .cellsystem cimport get_verlet_reuse
 from .cellsystem cimport mpi_set_skin, skin
+from .cellsystem cimport load_balancing_params
 from .utils import handle_errors
 from .utils cimport Vector3i
 from .utils cimport check_type_or_throw_except
 
+_load_metrics = {"particles": LOAD_METRIC_PARTICLES,
+                 "force_time": LOAD_METRIC_FORCE_TIME}
+
+
+def _check_common_params(use_verlet_lists, use_soa, particle_sort_interval):
+    check_type_or_throw_except(
+        use_verlet_lists, 1, type(True), "use_verlet_lists must be a bool")
+    check_type_or_throw_except(use_soa, 1, type(True), "use_soa must be a bool")
+    check_type_or_throw_except(
+        particle_sort_interval, 1, int,
+        "particle_sort_interval must be an integer")
+    if particle_sort_interval < 0:
+        raise ValueError("particle_sort_interval must be >= 0")
+
+
 cdef class CellSystem:
-    def set_domain_decomposition(self, use_verlet_lists=True):
+    def set_domain_decomposition(self, use_verlet_lists=True, use_soa=False,
+                                 particle_sort_interval=0,
+                                 load_balancing=False,
+                                 load_balancing_threshold=0.1,
+                                 load_balancing_interval=100,
+                                 load_balancing_metric="particles",
+                                 overlap_communication=False):
         """
         Activates domain decomposition cell system.
 
@@ -39,15 +61,74 @@ cdef class CellSystem:
         use_verlet_lists : :obj:`bool`, optional
             Activates or deactivates the usage of Verlet lists
             in the algorithm.
+        use_soa : :obj:`bool`, optional
+            Calculate central pair forces from a packed copy of the
+            particle positions, types and charges.
+        particle_sort_interval : :obj:`int`, optional
+            Sort the particles in memory along a space-filling curve
+            every ``particle_sort_interval`` times the particles are
+            resorted into the cells. Disabled if 0.
+        load_balancing : :obj:`bool`, optional
+            Shift the boundaries between the subdomains of the MPI ranks
+            to balance their load.
+        load_balancing_threshold : :obj:`float`, optional
+            Rebalance if the maximal load exceeds the mean load by more
+            than this fraction.
+        load_balancing_interval : :obj:`int`, optional
+            Number of integration steps between two load checks.
+        load_balancing_metric : :obj:`str`, optional
+            Load of a rank, either ``'particles'`` for its number of
+            particles or ``'force_time'`` for the time spent in the
+            short-range force calculation.
+        overlap_communication : :obj:`bool`, optional
+            Calculate the pair forces between particles of the same
+            MPI rank while the ghost particles are communicated, and
+            while the FFTs of P3M are redistributed. With several
+            OpenMP threads, the P3M communication progresses after
+            every group of cells that are processed concurrently.
+            Bonds between particles of the same MPI rank are calculated
+            during the communication as well. The pair forces only
+            overlap with the communication if Verlet lists are used
+            and not rebuilt in this time step, and not with ``use_soa``.
 
         """
+        _check_common_params(use_verlet_lists, use_soa,
+                             particle_sort_interval)
+        check_type_or_throw_except(
+            load_balancing, 1, type(True), "load_balancing must be a bool")
+        check_type_or_throw_except(
+            load_balancing_threshold, 1, float,
+            "load_balancing_threshold must be a float")
+        if load_balancing_threshold < 0:
+            raise ValueError("load_balancing_threshold must be >= 0")
+        check_type_or_throw_except(
+            load_balancing_interval, 1, int,
+            "load_balancing_interval must be an integer")
+        if load_balancing_interval < 1:
+            raise ValueError("load_balancing_interval must be > 0")
+        if load_balancing_metric not in _load_metrics:
+            raise ValueError(
+                f"load_balancing_metric must be one of {list(_load_metrics)}")
+        check_type_or_throw_except(
+            overlap_communication, 1, type(True),
+            "overlap_communication must be a bool")
+
+        # the load balancing is set first, it throws if it is not
+        # supported by the active long-range methods
+        mpi_set_load_balancing(load_balancing, load_balancing_threshold,
+                               load_balancing_interval,
+                               _load_metrics[load_balancing_metric])
         mpi_set_use_verlet_lists(use_verlet_lists)
+        mpi_set_use_soa(use_soa)
+        mpi_set_particle_sort_interval(particle_sort_interval)
+        mpi_set_overlap_communication(overlap_communication)
         mpi_bcast_cell_structure(CELL_STRUCTURE_DOMDEC)
 
         handle_errors("Error while initializing the cell system.")
         return True
 
-    def set_n_square(self, use_verlet_lists=True):
+    def set_n_square(self, use_verlet_lists=True, use_soa=False,
+                     particle_sort_interval=0):
         """
         Activates the nsquare force calculation.
 
@@ -56,9 +137,25 @@ cdef class CellSystem:
         use_verlet_lists : :obj:`bool`, optional
             Activates or deactivates the usage of the Verlet
             lists for this algorithm.
+        use_soa : :obj:`bool`, optional
+            Calculate central pair forces from a packed copy of the
+            particle positions, types and charges.
+        particle_sort_interval : :obj:`int`, optional
+            Sort the particles in memory along a space-filling curve
+            every ``particle_sort_interval`` times the particles are
+            resorted into the cells. Disabled if 0.
 
         """
+        _check_common_params(use_verlet_lists, use_soa,
+                             particle_sort_interval)
+
         mpi_set_use_verlet_lists(use_verlet_lists)
+        mpi_set_use_soa(use_soa)
+        mpi_set_particle_sort_interval(particle_sort_interval)
+        mpi_set_load_balancing(False, load_balancing_params.threshold,
+                               load_balancing_params.interval,
+                               load_balancing_params.metric)
+        mpi_set_overlap_communication(False)
         mpi_bcast_cell_structure(CELL_STRUCTURE_NSQUARE)
 
         return True
@@ -79,7 +176,17 @@ cdef class CellSystem:
         return s
 
     def __getstate__(self):
-        s = {"use_verlet_list": cell_structure.use_verlet_list}
+        s = {"use_verlet_list": cell_structure.use_verlet_list,
+             "use_soa": cell_structure.use_soa,
+             "particle_sort_interval": cell_structure.particle_sort_interval}
+
+        if cell_structure.decomposition_type() == CELL_STRUCTURE_DOMDEC:
+            metrics = {v: k for k, v in _load_metrics.items()}
+            s["load_balancing"] = load_balancing_params.active
+            s["load_balancing_threshold"] = load_balancing_params.threshold
+            s["load_balancing_interval"] = load_balancing_params.interval
+            s["load_balancing_metric"] = metrics[load_balancing_params.metric]
+            s["overlap_communication"] = cell_structure.overlap_communication
 
         if cell_structure.decomposition_type() == CELL_STRUCTURE_DOMDEC:
             s["type"] = "domain_decomposition"
@@ -96,9 +203,23 @@ cdef class CellSystem:
         if 'type' in d:
             if d['type'] == "domain_decomposition":
                 self.set_domain_decomposition(
-                    use_verlet_lists=d['use_verlet_list'])
+                    use_verlet_lists=d['use_verlet_list'],
+                    use_soa=d.get('use_soa', False),
+                    particle_sort_interval=d.get('particle_sort_interval', 0),
+                    load_balancing=d.get('load_balancing', False),
+                    load_balancing_threshold=d.get(
+                        'load_balancing_threshold', 0.1),
+                    load_balancing_interval=d.get(
+                        'load_balancing_interval', 100),
+                    load_balancing_metric=d.get(
+                        'load_balancing_metric', "particles"),
+                    overlap_communication=d.get(
+                        'overlap_communication', False))
             elif d['type'] == "nsquare":
-                self.set_n_square(use_verlet_lists=d['use_verlet_list'])
+                self.set_n_square(
+                    use_verlet_lists=d['use_verlet_list'],
+                    use_soa=d.get('use_soa', False),
+                    particle_sort_interval=d.get('particle_sort_interval', 0))
 
     def get_pairs(self, distance, types='all'):
         """
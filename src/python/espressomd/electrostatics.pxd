@@ -71,6 +71,7 @@ IF ELECTROSTATICS:
             void p3m_set_tune_params(double r_cut, int mesh[3], int cao, double accuracy)
             void p3m_set_mesh_offset(double x, double y, double z) except +
             void p3m_set_eps(double eps)
+            void p3m_set_ad(bool ad)
             int p3m_adaptive_tune(int timings, bool verbose)
 
             ctypedef struct p3m_data_struct:
@@ -329,9 +329,35 @@ IF P3M == 1:
         check_neutrality : :obj:`bool`, optional
             Raise a warning if the system is not electrically neutral when
             set to ``True`` (default).
+        ad : :obj:`bool`, optional
+            Calculate the forces by analytical differentiation of the
+            charge-assignment function instead of ik-differentiation
+            when set to ``True``. This needs one instead of three
+            backward FFTs. Defaults to ``False``.
 
         """
 
+        def valid_keys(self):
+            return super().valid_keys() + ["ad"]
+
+        def default_params(self):
+            params = super().default_params()
+            params["ad"] = False
+            return params
+
+        def _tune(self):
+            p3m_set_ad(self._params["ad"])
+            super()._tune()
+
+        def _set_params_in_es_core(self):
+            super()._set_params_in_es_core()
+            p3m_set_ad(self._params["ad"])
+
+        def validate_params(self):
+            super().validate_params()
+            check_type_or_throw_except(
+                self._params["ad"], 1, type(True), "ad should be a bool")
+
         def _activate_method(self):
             check_neutrality(self._params)
             if self._params["tune"]:
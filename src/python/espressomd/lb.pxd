@@ -93,6 +93,11 @@ cdef extern from "grid_based_algorithms/lb_interface.hpp":
     double lb_lbfluid_get_lattice_speed() except +
     void check_tau_time_step_consistency(double tau, double time_s) except +
     const Vector3d lb_lbfluid_get_interpolated_velocity(Vector3d & p) except +
+    void lb_lbfluid_set_refined_region(const Vector3i & lower, const Vector3i & upper) except +
+    void lb_lbfluid_clear_refined_region() except +
+    vector[Vector3i] lb_lbfluid_get_refined_region() except +
+    void lb_lbfluid_set_concurrent_update(bool concurrent) except +
+    bool lb_lbfluid_get_concurrent_update() except +
 
 cdef extern from "grid_based_algorithms/lb_particle_coupling.hpp":
     void lb_lbcoupling_set_rng_state(stdint.uint64_t)
@@ -24,6 +24,7 @@ import functools
 import numpy as np
 cimport numpy as np
 from libc cimport stdint
+from libcpp.vector cimport vector
 from .actors cimport Actor
 from . cimport cuda_init
 from . import cuda_init
@@ -185,8 +186,7 @@ cdef class HydrodynamicInteraction(Actor):
         ----------
         interpolation_order : :obj:`str`, \{"linear", "quadratic"\}
             ``"linear"`` for trilinear interpolation, ``"quadratic"`` for
-            quadratic interpolation. For the CPU implementation of LB, only
-            ``"linear"`` is available.
+            quadratic interpolation.
 
         """
         if interpolation_order == "linear":
@@ -409,6 +409,71 @@ cdef class LBFluid(HydrodynamicInteraction):
         self._set_lattice_switch()
         self._set_params_in_es_core()
 
+    def _deactivate_method(self):
+        lb_lbfluid_clear_refined_region()
+        HydrodynamicInteraction._deactivate_method(self)
+
+    def set_refined_region(self, lower, upper):
+        """Resolve a box of the fluid on a lattice with half the grid
+        spacing and half the time step.
+
+        Parameters
+        ----------
+        lower : (3,) array_like of :obj:`int`
+            Index of the lower corner node of the box.
+        upper : (3,) array_like of :obj:`int`
+            Index of the upper corner node of the box.
+
+        """
+        cdef Vector3i c_lower
+        cdef Vector3i c_upper
+        for i in range(3):
+            c_lower[i] = lower[i]
+            c_upper[i] = upper[i]
+        lb_lbfluid_set_refined_region(c_lower, c_upper)
+
+    def clear_refined_region(self):
+        """Remove the refined region of the fluid."""
+        lb_lbfluid_clear_refined_region()
+
+    def get_refined_region(self):
+        """Get the refined region of the fluid.
+
+        Returns
+        -------
+        (2,) :obj:`tuple` of (3,) :obj:`tuple` of :obj:`int` or ``None``
+            Indices of the lower and upper corner node of the box, or
+            ``None`` if no region is refined.
+
+        """
+        cdef vector[Vector3i] region = lb_lbfluid_get_refined_region()
+        if region.empty():
+            return None
+        return tuple((region[i][0], region[i][1], region[i][2])
+                     for i in range(2))
+
+    def set_concurrent_update(self, concurrent):
+        """Overlap the time steps of the fluid with the force calculation.
+
+        The collisions and the streaming of the fluid then run on a
+        separate thread, and only the particle coupling waits for them.
+        The trajectory is the same as without concurrent updates.
+
+        Parameters
+        ----------
+        concurrent : :obj:`bool`
+            Whether the time steps run concurrently.
+
+        """
+        lb_lbfluid_set_concurrent_update(concurrent)
+
+    def get_concurrent_update(self):
+        """Whether the time steps of the fluid overlap with the force
+        calculation, see :meth:`set_concurrent_update`.
+
+        """
+        return lb_lbfluid_get_concurrent_update()
+
 IF CUDA:
     cdef class LBFluidGPU(HydrodynamicInteraction):
         """
@@ -16,6 +16,8 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 include "myconfig.pxi"
 
+from libcpp cimport bool
+
 IF P3M == 1 or DP3M == 1:
     cdef extern from "electrostatics_magnetostatics/p3m-common.hpp":
         ctypedef struct P3MParameters:
@@ -30,3 +32,4 @@ IF P3M == 1 or DP3M == 1:
             double a[3]
             double alpha
             double r_cut
+            bool ad
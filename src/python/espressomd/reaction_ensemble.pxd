@@ -38,6 +38,7 @@ cdef extern from "reaction_methods/ReactionAlgorithm.hpp" namespace "ReactionMet
     cdef cppclass CReactionAlgorithm "ReactionMethods::ReactionAlgorithm":
         int CReactionAlgorithm(int seed)
         int do_reaction(int reaction_steps) except +
+        int do_parallel_reaction(int reaction_steps) except +
         bool do_global_mc_move_for_particles_of_type(int type, int particle_number_of_type)
         void set_cuboid_reaction_ensemble_volume()
         int check_reaction_method() except +
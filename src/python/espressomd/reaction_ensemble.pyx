@@ -279,6 +279,22 @@ cdef class ReactionAlgorithm:
         """
         deref(self.RE).do_reaction(int(reaction_steps))
 
+    def parallel_reaction(self, reaction_steps=1):
+        """
+        Performs trial reactions in all cells of the domain decomposition
+        at once. The cells are processed in a checkerboard pattern, and the
+        reactants and products of a trial are confined to one cell. Only
+        short-range interactions are supported.
+
+        Parameters
+        ----------
+        reaction_steps : :obj:`int`, optional
+            The number of reactions to be performed in every cell,
+            defaults to 1.
+
+        """
+        deref(self.RE).do_parallel_reaction(int(reaction_steps))
+
     def displacement_mc_move_for_particles_of_type(self, type_mc,
                                                    particle_number_to_be_changed=1):
         """
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UTILS_MORTON_HPP
+#define UTILS_MORTON_HPP
+
+#include <cstdint>
+
+namespace Utils {
+namespace detail {
+/** Insert two zero bits after each of the lower 21 bits of @p x. */
+constexpr inline uint64_t spread_bits_3(uint64_t x) {
+  x &= 0x1fffffu;
+  x = (x | (x << 32u)) & 0x1f00000000ffffu;
+  x = (x | (x << 16u)) & 0x1f0000ff0000ffu;
+  x = (x | (x << 8u)) & 0x100f00f00f00f00fu;
+  x = (x | (x << 4u)) & 0x10c30c30c30c30c3u;
+  x = (x | (x << 2u)) & 0x1249249249249249u;
+  return x;
+}
+} // namespace detail
+
+/** Number of bits per coordinate in @ref morton_code. */
+constexpr unsigned morton_bits = 21u;
+
+/**
+ * @brief Position on the three-dimensional Morton (Z-order) curve.
+ *
+ * The bits of the coordinates are interleaved, so that points
+ * which are close on the curve are also close in space.
+ * Only the lower @ref morton_bits bits of the coordinates are used.
+ */
+constexpr inline uint64_t morton_code(uint32_t x, uint32_t y, uint32_t z) {
+  return detail::spread_bits_3(x) | (detail::spread_bits_3(y) << 1u) |
+         (detail::spread_bits_3(z) << 2u);
+}
+} // namespace Utils
+
+#endif
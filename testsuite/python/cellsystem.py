@@ -17,7 +17,9 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #
 import unittest as ut
+import unittest_decorators as utx
 import espressomd
+import espressomd.interactions
 import numpy as np
 
 
@@ -25,6 +27,46 @@ class CellSystem(ut.TestCase):
     system = espressomd.System(box_l=[5.0, 5.0, 5.0])
     system.cell_system.skin = 0.0
     n_nodes = system.cell_system.get_state()['n_nodes']
+    original_node_grid = tuple(system.cell_system.node_grid)
+
+    soa_lj_params = {
+        (0, 0): {'epsilon': 1.0, 'sigma': 1.0, 'cutoff': 2.0**(1.0 / 6.0)},
+        (0, 1): {'epsilon': 0.5, 'sigma': 0.8, 'cutoff': 1.2}}
+
+    lj_params = {(0, 0): {'epsilon': 1.0, 'sigma': 0.5, 'cutoff': 0.56}}
+
+    def setUp(self):
+        self.system.cell_system.node_grid = self.original_node_grid
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.non_bonded_inter.reset()
+        self.system.integrator.set_vv()
+        self.system.cell_system.set_domain_decomposition()
+        self.system.cell_system.skin = 0.0
+
+    def setup_lj_system(self, n_part, lj_params, n_types=1, skin=0.1,
+                        pos_scale=(1., 1., 1.)):
+        """
+        Add ``n_part`` random particles interacting via the Lennard-Jones
+        parameters ``lj_params`` (a dict keyed by pairs of types) and
+        remove the overlaps by steepest descent.
+        """
+        system = self.system
+        system.time_step = 0.01
+        system.cell_system.skin = skin
+        for (type_a, type_b), params in lj_params.items():
+            system.non_bonded_inter[type_a, type_b].lennard_jones.set_params(
+                shift="auto", **params)
+        np.random.seed(42)
+        pos = np.random.random((n_part, 3)) * np.copy(system.box_l)
+        system.part.add(pos=pos * np.array(pos_scale),
+                        v=np.random.random((n_part, 3)) - 0.5,
+                        type=np.random.randint(n_types, size=n_part))
+        system.integrator.set_steepest_descent(
+            f_max=0, gamma=0.1, max_displacement=0.01)
+        system.integrator.run(20)
+        system.integrator.set_vv()
 
     def test_cell_system(self):
         self.system.cell_system.set_n_square(use_verlet_lists=False)
@@ -45,6 +87,224 @@ class CellSystem(ut.TestCase):
             node_grid = self.system.cell_system.get_state()['node_grid']
             np.testing.assert_array_equal(node_grid, node_grid_ref)
 
+    @utx.skipIfMissingFeatures("LENNARD_JONES")
+    def test_soa_forces(self):
+        system = self.system
+        self.setup_lj_system(100, self.soa_lj_params, n_types=2, skin=0.2)
+
+        for use_verlet_lists in [True, False]:
+            system.cell_system.set_domain_decomposition(
+                use_verlet_lists=use_verlet_lists)
+            system.integrator.run(0, recalc_forces=True)
+            f_ref = np.copy(system.part[:].f)
+            system.cell_system.set_domain_decomposition(
+                use_verlet_lists=use_verlet_lists, use_soa=True)
+            self.assertTrue(system.cell_system.get_state()['use_soa'])
+            system.integrator.run(0, recalc_forces=True)
+            np.testing.assert_allclose(
+                np.copy(system.part[:].f), f_ref, rtol=1e-10, atol=1e-10)
+
+    @utx.skipIfMissingFeatures("LENNARD_JONES")
+    def test_soa_interaction_reset(self):
+        system = self.system
+        self.setup_lj_system(100, self.soa_lj_params, n_types=2, skin=0.2)
+        system.cell_system.set_domain_decomposition()
+        system.integrator.run(0, recalc_forces=True)
+        f_ref = np.copy(system.part[:].f)
+        state = system.non_bonded_inter.__getstate__()
+
+        system.cell_system.set_domain_decomposition(use_soa=True)
+        system.non_bonded_inter.reset()
+        system.integrator.run(0, recalc_forces=True)
+        np.testing.assert_array_equal(np.copy(system.part[:].f), 0.)
+        system.non_bonded_inter.__setstate__(state)
+        system.integrator.run(0, recalc_forces=True)
+        np.testing.assert_allclose(
+            np.copy(system.part[:].f), f_ref, rtol=1e-10, atol=1e-10)
+
+    @utx.skipIfMissingFeatures("LENNARD_JONES")
+    def test_particle_sort(self):
+        system = self.system
+        self.setup_lj_system(200, self.lj_params)
+
+        for set_cell_system in [system.cell_system.set_domain_decomposition,
+                                system.cell_system.set_n_square]:
+            set_cell_system()
+            system.integrator.run(0, recalc_forces=True)
+            f_ref = np.copy(system.part[:].f)
+            ids = np.copy(system.part[:].id)
+            pos = np.copy(system.part[:].pos)
+            set_cell_system(particle_sort_interval=1)
+            self.assertEqual(
+                system.cell_system.get_state()['particle_sort_interval'], 1)
+            system.integrator.run(0, recalc_forces=True)
+            np.testing.assert_array_equal(np.copy(system.part[:].id), ids)
+            np.testing.assert_allclose(np.copy(system.part[:].pos), pos)
+            np.testing.assert_allclose(
+                np.copy(system.part[:].f), f_ref, rtol=1e-10, atol=1e-10)
+            system.integrator.run(50)
+
+        with self.assertRaises(ValueError):
+            system.cell_system.set_domain_decomposition(
+                particle_sort_interval=-1)
+
+    @utx.skipIfMissingFeatures("LENNARD_JONES")
+    def test_overlap_communication(self):
+        system = self.system
+        self.setup_lj_system(200, self.lj_params)
+
+        system.integrator.run(0, recalc_forces=True)
+        f_ref = np.copy(system.part[:].f)
+        system.cell_system.set_domain_decomposition(
+            overlap_communication=True)
+        self.assertTrue(
+            system.cell_system.get_state()['overlap_communication'])
+        system.integrator.run(0, recalc_forces=True)
+        system.integrator.run(0, recalc_forces=True)
+        np.testing.assert_allclose(
+            np.copy(system.part[:].f), f_ref, rtol=1e-10, atol=1e-10)
+        # the trajectory matches the one without overlap
+        pos = np.copy(system.part[:].pos)
+        vel = np.copy(system.part[:].v)
+        system.integrator.run(20)
+        pos_overlap = np.copy(system.part[:].pos)
+        system.cell_system.set_domain_decomposition()
+        system.part[:].pos = pos
+        system.part[:].v = vel
+        system.integrator.run(20)
+        np.testing.assert_allclose(
+            np.copy(system.part[:].pos), pos_overlap, rtol=1e-8, atol=1e-8)
+
+    @utx.skipIfMissingFeatures("LENNARD_JONES")
+    def test_overlap_communication_bonds(self):
+        system = self.system
+        self.setup_lj_system(200, self.lj_params)
+        # harmonic bonds between close pairs, some of them across ranks
+        harmonic = espressomd.interactions.HarmonicBond(
+            k=1., r_0=0.5, r_cut=1.5)
+        system.bonded_inter.add(harmonic)
+        pos = np.copy(system.part[:].pos)
+        ids = np.copy(system.part[:].id)
+        box_l = np.copy(system.box_l)
+        for i in range(len(ids)):
+            dist = pos[i + 1:] - pos[i]
+            dist -= np.rint(dist / box_l) * box_l
+            for j in np.flatnonzero(np.linalg.norm(dist, axis=1) < 0.8):
+                system.part[ids[i]].add_bond((harmonic, ids[i + 1 + j]))
+
+        for use_soa in (False, True):
+            system.cell_system.set_domain_decomposition(use_soa=use_soa)
+            system.part[:].pos = pos
+            system.integrator.run(0, recalc_forces=True)
+            f_ref = np.copy(system.part[:].f)
+            self.assertGreater(np.max(np.abs(f_ref)), 0.)
+            system.cell_system.set_domain_decomposition(
+                use_soa=use_soa, overlap_communication=True)
+            system.integrator.run(0, recalc_forces=True)
+            system.integrator.run(0, recalc_forces=True)
+            np.testing.assert_allclose(
+                np.copy(system.part[:].f), f_ref, rtol=1e-10, atol=1e-10)
+            # the trajectory matches the one without overlap
+            vel = np.copy(system.part[:].v)
+            system.integrator.run(20)
+            pos_overlap = np.copy(system.part[:].pos)
+            system.cell_system.set_domain_decomposition(use_soa=use_soa)
+            system.part[:].pos = pos
+            system.part[:].v = vel
+            system.integrator.run(20)
+            np.testing.assert_allclose(
+                np.copy(system.part[:].pos), pos_overlap, rtol=1e-8,
+                atol=1e-8)
+
+    @utx.skipIfMissingFeatures("LENNARD_JONES")
+    def test_load_balancing(self):
+        system = self.system
+        system.time_step = 0.01
+        system.cell_system.skin = 0.1
+        for (type_a, type_b), params in self.lj_params.items():
+            system.non_bonded_inter[type_a, type_b].lennard_jones.set_params(
+                shift="auto", **params)
+        # a perturbed lattice with 4 planes per direction, all particles in
+        # the lower half of the box: the balancing moves the boundaries of
+        # every direction with 2 nodes to a quarter of the box length
+        np.random.seed(42)
+        spacing = np.copy(system.box_l) / 8.
+        lattice = np.array([[i, j, k] for i in range(4) for j in range(4)
+                            for k in range(4)]) + 0.5
+        pos = lattice * spacing + 0.1 * (np.random.random(lattice.shape) - 0.5)
+        n_part = len(pos)
+        system.part.add(pos=pos)
+
+        system.integrator.run(0, recalc_forces=True)
+        f_ref = np.copy(system.part[:].f)
+        system.cell_system.set_domain_decomposition(
+            load_balancing=True, load_balancing_threshold=0.,
+            load_balancing_interval=1)
+        state = system.cell_system.get_state()
+        self.assertTrue(state['load_balancing'])
+        self.assertEqual(state['load_balancing_interval'], 1)
+        self.assertEqual(state['load_balancing_metric'], "particles")
+        system.integrator.run(1)
+        system.part[:].pos = pos
+        system.part[:].v = np.zeros((n_part, 3))
+        system.integrator.run(0, recalc_forces=True)
+        np.testing.assert_allclose(
+            np.copy(system.part[:].f), f_ref, rtol=1e-10, atol=1e-10)
+        n_parts = system.cell_system.resort()
+        self.assertEqual(sum(n_parts), n_part)
+        if max(system.cell_system.node_grid) <= 2:
+            self.assertEqual(
+                list(n_parts), self.n_nodes * [n_part // self.n_nodes])
+
+        system.cell_system.set_domain_decomposition(
+            load_balancing=True, load_balancing_metric="force_time")
+        system.integrator.run(20)
+        with self.assertRaises(ValueError):
+            system.cell_system.set_domain_decomposition(
+                load_balancing=True, load_balancing_metric="unknown")
+        with self.assertRaises(ValueError):
+            system.cell_system.set_domain_decomposition(
+                load_balancing=True, load_balancing_interval=0)
+
+    def test_exceptions(self):
+        """
+        Invalid arguments are rejected before the cell system is changed.
+        """
+        system = self.system
+        keys = ['type', 'use_verlet_list', 'use_soa', 'particle_sort_interval']
+
+        def get_state():
+            state = system.cell_system.get_state()
+            return {key: state[key] for key in keys}
+
+        system.cell_system.set_n_square(
+            use_verlet_lists=False, particle_sort_interval=2)
+        state = get_state()
+        for kwargs in [{'use_verlet_lists': 'yes'},
+                       {'use_soa': 1},
+                       {'particle_sort_interval': 1.5},
+                       {'particle_sort_interval': -1},
+                       {'load_balancing': None},
+                       {'load_balancing_threshold': 'high'},
+                       {'load_balancing_threshold': -0.1},
+                       {'load_balancing_interval': 10.},
+                       {'load_balancing_interval': 0},
+                       {'load_balancing_metric': 'unknown'},
+                       {'overlap_communication': 0}]:
+            with self.assertRaises(ValueError):
+                system.cell_system.set_domain_decomposition(
+                    **{'use_verlet_lists': True, 'use_soa': True, **kwargs})
+            self.assertEqual(get_state(), state)
+        for kwargs in [{'use_verlet_lists': 'yes'},
+                       {'use_soa': 1},
+                       {'particle_sort_interval': 1.5},
+                       {'particle_sort_interval': -1}]:
+            with self.assertRaises(ValueError):
+                system.cell_system.set_n_square(
+                    **{'use_verlet_lists': True, 'use_soa': True, **kwargs})
+            self.assertEqual(get_state(), state)
+        system.cell_system.set_domain_decomposition()
+
 
 if __name__ == "__main__":
     ut.main()
@@ -57,6 +57,7 @@ class CoulombCloudWall(ut.TestCase):
     def tearDown(self):
         self.S.part.clear()
         self.S.actors.clear()
+        self.S.cell_system.set_domain_decomposition()
 
     def compare(self, method_name, energy=True, prefactor=None):
         # Compare forces and energy now in the system to stored ones
@@ -91,6 +92,38 @@ class CoulombCloudWall(ut.TestCase):
         self.S.integrator.run(0)
         self.compare("p3m", energy=True, prefactor=3)
 
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_p3m_ad(self):
+        """
+        This checks P3M with analytical differentiation.
+
+        """
+
+        p3m = espressomd.electrostatics.P3M(
+            prefactor=3, r_cut=1.001, accuracy=1e-3,
+            mesh=64, cao=7, alpha=2.70746, tune=False, ad=True)
+        self.S.actors.add(p3m)
+        self.assertTrue(p3m.get_params()["ad"])
+        self.S.integrator.run(0)
+        self.compare("p3m_ad", energy=True, prefactor=3)
+
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_p3m_overlap(self):
+        """
+        This checks P3M with the k-space communication overlapped with
+        the short-range forces.
+
+        """
+
+        self.S.cell_system.set_domain_decomposition(
+            overlap_communication=True)
+        self.S.actors.add(
+            espressomd.electrostatics.P3M(
+                prefactor=3, r_cut=1.001, accuracy=1e-3,
+                mesh=64, cao=7, alpha=2.70746, tune=False))
+        self.S.integrator.run(0)
+        self.compare("p3m_overlap", energy=True, prefactor=3)
+
     @utx.skipIfMissingGPU()
     def test_p3m_gpu(self):
         self.S.actors.add(
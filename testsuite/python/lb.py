@@ -308,6 +308,13 @@ class TestLB:
         np.testing.assert_allclose(
             np.copy(p.f), -self.params['friction'] * (v_part - v_fluid), atol=1E-6)
 
+    @utx.skipIfMissingFeatures("EXTERNAL_FORCES")
+    def test_viscous_coupling_higher_order_interpolation(self):
+        self.interpolation = True
+        self.test_viscous_coupling()
+        self.interpolation = False
+        self.lbf.set_interpolation_order("linear")
+
     @utx.skipIfMissingFeatures("EXTERNAL_FORCES")
     def test_ext_force_density(self):
         ext_force_density = [2.3, 1.2, 0.1]
@@ -388,6 +395,77 @@ class TestLBCPU(TestLB, ut.TestCase):
     def setUp(self):
         self.lb_class = espressomd.lb.LBFluid
 
+    def test_concurrent_update(self):
+        positions = np.random.random((10, 3)) * self.system.box_l
+
+        def run(concurrent):
+            self.system.actors.clear()
+            self.system.part.clear()
+            lbf = self.lb_class(
+                visc=self.params['viscosity'],
+                dens=self.params['dens'],
+                agrid=self.params['agrid'],
+                tau=self.system.time_step,
+                kT=self.params['temp'],
+                seed=2,
+                ext_force_density=[0.1, 0.2, 0.3])
+            self.system.actors.add(lbf)
+            lbf.set_concurrent_update(concurrent)
+            self.assertEqual(lbf.get_concurrent_update(), concurrent)
+            self.system.thermostat.set_lb(
+                LB_fluid=lbf, seed=3, gamma=self.params['friction'])
+            self.system.part.add(pos=positions)
+            self.system.integrator.run(20)
+            return (np.copy(self.system.part[:].pos),
+                    np.copy(self.system.part[:].v),
+                    np.copy(lbf[1, 2, 3].velocity))
+
+        reference = run(False)
+        result = run(True)
+        for ref, res in zip(reference, result):
+            np.testing.assert_allclose(res, ref, rtol=0., atol=1e-12)
+
+    def test_population_precision(self):
+        """
+        With ``LB_SINGLE_PRECISION``, the populations are rounded to single
+        precision relative to the fluid at rest, and the fluid evolves like
+        the double-precision fluid within a single-precision tolerance.
+
+        """
+        single_precision = espressomd.has_features("LB_SINGLE_PRECISION")
+        self.lbf = self.lb_class(
+            visc=self.params['viscosity'],
+            dens=self.params['dens'],
+            agrid=self.params['agrid'],
+            tau=self.system.time_step,
+            kT=0.)
+        self.system.actors.add(self.lbf)
+
+        node = self.lbf[1, 2, 3]
+        pop_rest = np.copy(node.population)
+        pop = pop_rest * (1. + 0.1 * np.random.random(19))
+        node.population = pop
+        np.testing.assert_allclose(
+            np.copy(node.population), pop, rtol=0.,
+            atol=(1.2e-7 if single_precision else 1e-15) * np.max(pop))
+        node.population = pop_rest
+
+        # decay of a shear wave, reference values of the double-precision
+        # fluid
+        n_nodes = int(self.system.box_l[1] / self.params['agrid'])
+        y = (np.arange(n_nodes) + 0.5) * self.params['agrid']
+        velocity = np.zeros((n_nodes, n_nodes, n_nodes, 3))
+        velocity[:, :, :, 0] = 0.5 * np.sin(
+            2. * np.pi * y / self.system.box_l[1])[np.newaxis, :, np.newaxis]
+        self.lbf[:, :, :].velocity = velocity
+        self.system.integrator.run(50)
+        profile_ref = [0.02463340874075634, 0.06729972376674617,
+                       0.09193313168198738]
+        profile_ref = np.array(profile_ref + profile_ref[::-1])
+        profile = np.copy(self.lbf[0, :6, 0].velocity[0, :, 0, 0])
+        np.testing.assert_allclose(
+            profile, profile_ref, rtol=1e-5 if single_precision else 1e-10)
+
 
 @utx.skipIfMissingGPU()
 class TestLBGPU(TestLB, ut.TestCase):
@@ -395,12 +473,6 @@ class TestLBGPU(TestLB, ut.TestCase):
     def setUp(self):
         self.lb_class = espressomd.lb.LBFluidGPU
 
-    @utx.skipIfMissingFeatures("EXTERNAL_FORCES")
-    def test_viscous_coupling_higher_order_interpolation(self):
-        self.interpolation = True
-        self.test_viscous_coupling()
-        self.interpolation = False
-
 
 if __name__ == "__main__":
     ut.main()
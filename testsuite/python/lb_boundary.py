@@ -21,12 +21,16 @@ import espressomd.lb
 import espressomd.shapes
 import espressomd.lbboundaries
 import itertools
+import numpy as np
 
 
 class LBBoundariesBase:
     system = espressomd.System(box_l=[10.0, 10.0, 10.0])
+    system.time_step = 1.0
     system.cell_system.skin = 0.1
 
+    lb_params = {'visc': 1.0, 'dens': 1.0, 'agrid': 0.5, 'tau': 1.0}
+
     wall_shape1 = espressomd.shapes.Wall(normal=[1., 0., 0.], dist=2.5)
     wall_shape2 = espressomd.shapes.Wall(normal=[-1., 0., 0.], dist=-7.5)
 
@@ -107,18 +111,69 @@ class LBBoundariesBase:
             espressomd.lbboundaries.LBBoundary(shape=union))
         self.check_boundary_flags([1, 0, 1])
 
+    def test_boundary_update(self):
+        """
+        Add and remove boundaries between integration steps, and compare
+        the fluid velocities and boundary forces to a fluid that is set up
+        with the final boundaries.
+
+        """
+        lbb = self.system.lbboundaries
+        obstacle_shape = espressomd.shapes.Sphere(
+            center=[5., 5., 5.], radius=1.5)
+        v_wall = [0., 0.01, 0.]
+
+        def add_walls():
+            wall2 = lbb.add(
+                espressomd.lbboundaries.LBBoundary(shape=self.wall_shape2))
+            wall1 = lbb.add(espressomd.lbboundaries.LBBoundary(
+                shape=self.wall_shape1, velocity=v_wall))
+            return [wall2, wall1]
+
+        def observables(walls):
+            self.system.integrator.run(20)
+            return (np.copy(self.lbf[:, :, :].velocity),
+                    [np.copy(wall.get_force()) for wall in walls])
+
+        # the fluid at rest is not changed by static boundaries, the walls
+        # change their numbers when the obstacle is removed
+        obstacle = lbb.add(
+            espressomd.lbboundaries.LBBoundary(shape=obstacle_shape))
+        wall2 = lbb.add(
+            espressomd.lbboundaries.LBBoundary(shape=self.wall_shape2))
+        self.system.integrator.run(5)
+        lbb.remove(obstacle)
+        wall1 = lbb.add(espressomd.lbboundaries.LBBoundary(
+            shape=self.wall_shape1, velocity=v_wall))
+        self.system.integrator.run(5)
+        obstacle = lbb.add(
+            espressomd.lbboundaries.LBBoundary(shape=obstacle_shape))
+        lbb.remove(obstacle)
+        velocity, forces = observables([wall2, wall1])
+
+        lbb.clear()
+        self.system.actors.remove(self.lbf)
+        self.lbf = self.lb_class(**self.lb_params)
+        self.system.actors.add(self.lbf)
+        walls = add_walls()
+        self.system.integrator.run(5)
+        velocity_ref, forces_ref = observables(walls)
+
+        self.assertGreater(np.max(np.abs(velocity_ref)), 1e-3)
+        np.testing.assert_allclose(velocity, velocity_ref, rtol=0., atol=1e-12)
+        for force, force_ref in zip(forces, forces_ref):
+            self.assertGreater(np.linalg.norm(force_ref), 1e-4)
+            np.testing.assert_allclose(force, force_ref, rtol=0., atol=1e-12)
+
 
 @utx.skipIfMissingFeatures(["LB_BOUNDARIES"])
 class LBBoundariesCPU(ut.TestCase, LBBoundariesBase):
     lbf = None
 
     def setUp(self):
+        self.lb_class = espressomd.lb.LBFluid
         if not self.lbf:
-            self.lbf = espressomd.lb.LBFluid(
-                visc=1.0,
-                dens=1.0,
-                agrid=0.5,
-                tau=1.0)
+            self.lbf = self.lb_class(**self.lb_params)
 
         self.system.actors.add(self.lbf)
 
@@ -133,12 +188,9 @@ class LBBoundariesGPU(ut.TestCase, LBBoundariesBase):
     lbf = None
 
     def setUp(self):
+        self.lb_class = espressomd.lb.LBFluidGPU
         if not self.lbf:
-            self.lbf = espressomd.lb.LBFluidGPU(
-                visc=1.0,
-                dens=1.0,
-                agrid=0.5,
-                tau=1.0)
+            self.lbf = self.lb_class(**self.lb_params)
 
         self.system.actors.add(self.lbf)
 
@@ -138,6 +138,42 @@ class LBCPUPoiseuille(ut.TestCase, LBPoiseuilleCommon):
         self.lbf = espressomd.lb.LBFluid(**LB_PARAMS)
 
 
+@utx.skipIfMissingFeatures(['LB_BOUNDARIES', 'EXTERNAL_FORCES'])
+class LBCPUPoiseuilleInterpolation(ut.TestCase, LBPoiseuilleCommon):
+
+    """Test for the higher order interpolation scheme of the CPU LB."""
+
+    def setUp(self):
+        self.lbf = espressomd.lb.LBFluid(**LB_PARAMS)
+
+    def tearDown(self):
+        self.lbf.set_interpolation_order("linear")
+
+    def test_profile(self):
+        """
+        Compare against analytical function by calculating the RMSD.
+
+        """
+        self.prepare()
+        self.lbf.set_interpolation_order("quadratic")
+        velocities = np.zeros((50, 2))
+        x_values = np.linspace(
+            2.0 * AGRID,
+            self.system.box_l[0] - 2.0 * AGRID,
+            50)
+        for i, x in enumerate(x_values):
+            pos = [x, 0.5 * self.system.box_l[1], 0.5 * self.system.box_l[2]]
+            velocities[i, 1] = self.lbf.get_interpolated_velocity(pos)[2]
+            velocities[i, 0] = x
+
+        v_expected = poiseuille_flow(x_values - 0.5 * self.system.box_l[0],
+                                     self.system.box_l[0] - 2.0 * AGRID,
+                                     EXT_FORCE,
+                                     VISC * DENS)
+        rmsd = np.linalg.norm(v_expected - velocities[:, 1])
+        self.assertLess(rmsd, 0.02 * AGRID / TIME_STEP)
+
+
 @utx.skipIfMissingGPU()
 @utx.skipIfMissingFeatures(['LB_BOUNDARIES_GPU', 'EXTERNAL_FORCES'])
 class LBGPUPoiseuille(ut.TestCase, LBPoiseuilleCommon):
@@ -0,0 +1,226 @@
+#
+# Copyright (C) 2021 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import unittest as ut
+import unittest_decorators as utx
+import numpy as np
+
+import espressomd
+import espressomd.lb
+import espressomd.lbboundaries
+import espressomd.shapes
+
+"""
+Check the statically refined region of the CPU LB: the interface
+between the coarse and the fine lattice conserves mass and momentum,
+and a flow across the interface matches the flow of the unrefined fluid.
+
+"""
+
+AGRID = 1.0
+TIME_STEP = 1.0
+DENS = 1.0
+VISC = 0.5
+BOX_L = 12
+LB_PARAMS = {'agrid': AGRID,
+             'dens': DENS,
+             'visc': VISC,
+             'tau': TIME_STEP}
+# fits into the local domain with up to two MPI ranks
+LOWER = (1, 3, 3)
+UPPER = (4, 8, 8)
+
+
+class LBRefinement(ut.TestCase):
+
+    system = espressomd.System(box_l=3 * [BOX_L * AGRID])
+    system.time_step = TIME_STEP
+    system.cell_system.skin = 0.4 * AGRID
+
+    def setUp(self):
+        self.lbf = espressomd.lb.LBFluid(**LB_PARAMS)
+        self.system.actors.add(self.lbf)
+
+    def tearDown(self):
+        self.system.lbboundaries.clear()
+        self.system.actors.clear()
+
+    def add_walls(self):
+        for normal, dist in [([0, 1, 0], AGRID), ([0, -1, 0], -11. * AGRID)]:
+            wall = espressomd.shapes.Wall(normal=normal, dist=dist)
+            self.system.lbboundaries.add(
+                espressomd.lbboundaries.LBBoundary(shape=wall))
+
+    def fluid_mass(self):
+        return np.sum(self.lbf[:, :, :].density) * AGRID**3
+
+    def fluid_momentum(self):
+        return self.system.analysis.linear_momentum(
+            include_particles=False, include_lbfluid=True)
+
+    def test_region(self):
+        self.assertIsNone(self.lbf.get_refined_region())
+        self.lbf.set_refined_region(LOWER, UPPER)
+        self.assertEqual(self.lbf.get_refined_region(), (LOWER, UPPER))
+        self.lbf.clear_refined_region()
+        self.assertIsNone(self.lbf.get_refined_region())
+        self.lbf.set_refined_region(LOWER, UPPER)
+        self.assertEqual(self.lbf.get_refined_region(), (LOWER, UPPER))
+
+        # invalid regions are rejected and keep the current region
+        for lower, upper in [((1, 3, 3), (2, 8, 8)),
+                             ((1, 3, 0), (4, 8, 5)),
+                             ((1, 3, -1), (4, 8, 5)),
+                             ((1, 3, 3), (4, 8, BOX_L))]:
+            with self.assertRaisesRegex(ValueError, "The refined region has to span"):
+                self.lbf.set_refined_region(lower, upper)
+            self.assertEqual(self.lbf.get_refined_region(), (LOWER, UPPER))
+
+        # the region is removed with the fluid
+        self.system.actors.remove(self.lbf)
+        with self.assertRaises(RuntimeError):
+            self.lbf.get_refined_region()
+        with self.assertRaises(RuntimeError):
+            self.lbf.set_refined_region(LOWER, UPPER)
+        with self.assertRaises(RuntimeError):
+            self.lbf.clear_refined_region()
+        self.system.actors.add(self.lbf)
+        self.assertIsNone(self.lbf.get_refined_region())
+
+    def test_thermalized_fluid(self):
+        self.system.actors.clear()
+        self.lbf = espressomd.lb.LBFluid(kT=1., seed=42, **LB_PARAMS)
+        self.system.actors.add(self.lbf)
+        self.lbf.set_refined_region(LOWER, UPPER)
+        with self.assertRaisesRegex(Exception, "LB grid refinement does not support thermal fluctuations"):
+            self.system.integrator.run(1)
+
+    @utx.skipIfMissingFeatures(['LB_BOUNDARIES'])
+    def test_boundary_in_region(self):
+        wall = espressomd.shapes.Wall(normal=[0, 1, 0], dist=5.5 * AGRID)
+        self.system.lbboundaries.add(
+            espressomd.lbboundaries.LBBoundary(shape=wall))
+        self.lbf.set_refined_region(LOWER, UPPER)
+        with self.assertRaisesRegex(Exception, "LB boundaries inside of the refined region are not supported"):
+            self.system.integrator.run(1)
+
+    def test_conservation(self):
+        """
+        A shear wave and a uniform flow pass through the refined region.
+        The total mass and momentum of the fluid are conserved once the
+        coarse nodes under the refined region hold the restriction of the
+        fine lattice, which differs from the initial state by the
+        interpolation error.
+
+        """
+        y = (np.arange(BOX_L) + 0.5) * AGRID
+        velocity = np.zeros((BOX_L, BOX_L, BOX_L, 3))
+        velocity[:, :, :, 0] = 0.02
+        velocity[:, :, :, 2] = 0.05 * \
+            np.sin(2. * np.pi * y / (BOX_L * AGRID))[np.newaxis, :, np.newaxis]
+        self.lbf[:, :, :].velocity = velocity
+        self.lbf.set_refined_region(LOWER, UPPER)
+
+        mass = self.fluid_mass()
+        momentum = self.fluid_momentum()
+        np.testing.assert_allclose(
+            momentum, [0.02 * mass, 0., 0.], atol=1e-10)
+        self.system.integrator.run(20)
+        self.assertAlmostEqual(self.fluid_mass() / mass, 1., delta=1e-5)
+        np.testing.assert_allclose(
+            self.fluid_momentum(), momentum, atol=1e-6 * mass)
+
+        mass = self.fluid_mass()
+        momentum = self.fluid_momentum()
+        for _ in range(10):
+            self.system.integrator.run(20)
+            self.assertAlmostEqual(self.fluid_mass() / mass, 1., delta=1e-8)
+            np.testing.assert_allclose(
+                self.fluid_momentum(), momentum, atol=1e-8 * mass)
+
+    @utx.skipIfMissingFeatures(['LB_BOUNDARIES', 'EXTERNAL_FORCES'])
+    def test_interface_fluxes(self):
+        """
+        In a steady channel flow across the refined region, the mass flux
+        and the flux of momentum along the flow through every lattice
+        plane normal to the flow are the same, for the planes of coarse
+        nodes and for the planes of coarse nodes which hold the fine fluid.
+
+        """
+        ext_force_density = 0.002
+        self.system.actors.clear()
+        self.lbf = espressomd.lb.LBFluid(
+            ext_force_density=[ext_force_density, 0., 0.], **LB_PARAMS)
+        self.system.actors.add(self.lbf)
+        self.add_walls()
+        self.lbf.set_refined_region(LOWER, UPPER)
+        self.system.integrator.run(1500)
+
+        nodes = self.lbf[:, 1:BOX_L - 1, :]
+        density = np.copy(nodes.density)
+        velocity = np.copy(nodes.velocity)
+        pressure_tensor = np.copy(nodes.pressure_tensor)
+        mass_flux = np.sum(density * velocity[:, :, :, 0], axis=(1, 2))
+        momentum_flux = np.sum(pressure_tensor[:, :, :, 0, 0], axis=(1, 2))
+        self.assertGreater(np.min(mass_flux), 0.)
+        # planes 2 and 3 are inside of the region, 1 and 4 on its surface
+        np.testing.assert_allclose(mass_flux, np.mean(mass_flux), rtol=1e-3)
+        np.testing.assert_allclose(
+            momentum_flux, np.mean(momentum_flux), rtol=1e-3)
+
+    @utx.skipIfMissingFeatures(['LB_BOUNDARIES', 'EXTERNAL_FORCES'])
+    def test_poiseuille(self):
+        """
+        Plane Poiseuille flow through a refined region between the walls
+        has the profile of the unrefined fluid.
+
+        """
+        ext_force_density = 0.002
+
+        def profile(refined):
+            self.system.lbboundaries.clear()
+            self.system.actors.clear()
+            self.lbf = espressomd.lb.LBFluid(
+                ext_force_density=[0., 0., ext_force_density], **LB_PARAMS)
+            self.system.actors.add(self.lbf)
+            self.add_walls()
+            if refined:
+                self.lbf.set_refined_region(LOWER, UPPER)
+            self.system.integrator.run(1500)
+            x = (LOWER[0] + UPPER[0]) // 2
+            z = (LOWER[2] + UPPER[2]) // 2
+            return np.copy(self.lbf[x, 1:BOX_L - 1, z].velocity[0, :, 0, 2])
+
+        profile_coarse = profile(refined=False)
+        profile_fine = profile(refined=True)
+
+        # analytical profile between the walls, which are half-way
+        # between the boundary nodes and the fluid nodes; the bounce-back
+        # walls add a small slip velocity
+        width = (BOX_L - 2) * AGRID
+        y = (np.arange(1, BOX_L - 1) + 0.5) * AGRID - 0.5 * BOX_L * AGRID
+        profile_ref = ext_force_density / (2. * VISC * DENS) * \
+            (width**2 / 4. - y**2)
+        rmsd = np.sqrt(np.mean(np.square(profile_coarse - profile_ref)))
+        self.assertLess(rmsd, 0.05 * np.max(profile_ref))
+        np.testing.assert_allclose(profile_fine, profile_coarse,
+                                   atol=0.01 * np.max(profile_ref))
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -147,6 +147,18 @@ class TestLBCPU(TestLB, ut.TestCase):
     def setUp(self):
         self.lb_class = espressomd.lb.LBFluid
         self.params.update({"mom_prec": 1E-9, "mass_prec_per_node": 5E-8})
+        if espressomd.has_features("LB_SINGLE_PRECISION"):
+            # The mass and momentum lost in the rounding of the populations
+            # are added back in the next collision and the fluid momentum
+            # includes them, so they do not accumulate over the time steps.
+            # The node densities miss the rounding of the last step: 19
+            # populations of at most the density, each rounded by at most
+            # half a float epsilon. These errors are uniform and independent,
+            # allow for 5 standard deviations of their mean over the nodes.
+            n_nodes = np.product(self.system.box_l / self.params['agrid'])
+            rounding = (np.finfo(np.float32).eps / 2 * self.params['dens']
+                        * np.sqrt(19 / (3 * n_nodes)))
+            self.params["mass_prec_per_node"] += 5 * rounding
 
 
 @utx.skipIfMissingGPU()
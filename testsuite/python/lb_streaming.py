@@ -104,8 +104,9 @@ class LBStreamingCommon:
             for n_v in range(19):
                 target_node_index = np.mod(
                     grid_index + VELOCITY_VECTORS[n_v], self.grid)
-                np.testing.assert_almost_equal(
-                    self.lbf[target_node_index].population[n_v], float(n_v + 1))
+                np.testing.assert_allclose(
+                    self.lbf[target_node_index].population[n_v], float(n_v + 1),
+                    rtol=0., atol=self.atol)
                 self.lbf[target_node_index].population = np.zeros(19)
 
 
@@ -113,6 +114,13 @@ class LBCPU(ut.TestCase, LBStreamingCommon):
 
     """Test for the CPU implementation of the LB."""
 
+    atol = 1.5E-7
+    if espressomd.has_features("LB_SINGLE_PRECISION"):
+        # the populations of at most 19 are rounded to float when they are
+        # set and after the single time step, each time by at most half a
+        # float epsilon relative to their magnitude
+        atol = 2 * 19 * np.finfo(np.float32).eps / 2
+
     def setUp(self):
         self.lbf = espressomd.lb.LBFluid(**LB_PARAMETERS)
 
@@ -122,6 +130,8 @@ class LBGPU(ut.TestCase, LBStreamingCommon):
 
     """Test for the GPU implementation of the LB."""
 
+    atol = 1.5E-7
+
     def setUp(self):
         self.lbf = espressomd.lb.LBFluidGPU(**LB_PARAMETERS)
 
@@ -99,6 +99,26 @@ class FFT_test(ut.TestCase):
             self.system.actors.clear()
             np.testing.assert_allclose(p3m_energy, ref_energy, rtol=1e-4)
 
+    @utx.skipIfMissingFeatures("DP3M")
+    def test_odd_mesh_dp3m(self):
+        # the half spectrum of the real-to-complex FFT has no Nyquist
+        # plane for odd mesh sizes, the results agree with an even mesh
+        import espressomd.magnetostatics
+        self.add_magnetic_particles()
+        results = []
+        for mesh in (32, 33):
+            solver = espressomd.magnetostatics.DipolarP3M(
+                prefactor=2, accuracy=1e-6, tune=False,
+                **{**P3M_PARAMS[1], 'mesh': mesh})
+            self.system.actors.add(solver)
+            self.system.integrator.run(0, recalc_forces=True)
+            results.append((self.system.analysis.energy()['dipolar'],
+                            np.copy(self.system.part[:].f),
+                            np.copy(self.system.part[:].torque_lab)))
+            self.system.actors.clear()
+        for even, odd in zip(*results):
+            np.testing.assert_allclose(odd, even, atol=2e-5)
+
     @utx.skipIfMissingFeatures("P3M")
     @ut.skipIf(n_nodes < 2 or n_nodes >= 8, "only runs for 2 <= n_nodes <= 7")
     def test_unsorted_node_grid_exception_p3m(self):
@@ -0,0 +1,121 @@
+#
+# Copyright (C) 2021 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""Testmodule for the parallel trials of the Reaction Ensemble.
+"""
+import math
+import unittest as ut
+import unittest_decorators as utx
+import numpy as np
+import espressomd
+import espressomd.electrostatics
+from espressomd import reaction_ensemble
+
+
+class ParallelReactionTest(ut.TestCase):
+
+    """Test the reaction ensemble with trials in all cells at once."""
+
+    N0 = 50
+    type_A = 0
+    type_B = 1
+    type_C = 2
+    system = espressomd.System(box_l=3 * [10.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+    np.random.seed(42)
+
+    def setUp(self):
+        self.system.cell_system.set_domain_decomposition()
+        self.system.part.add(
+            pos=np.random.random((self.N0, 3)) * self.system.box_l,
+            v=np.random.normal(size=(self.N0, 3)),
+            type=self.N0 * [self.type_A])
+        self.RE = reaction_ensemble.ReactionEnsemble(
+            temperature=1., exclusion_radius=0., seed=12)
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.actors.clear()
+        self.system.cell_system.set_domain_decomposition()
+
+    def add_dissociation(self, gamma):
+        self.RE.add_reaction(
+            gamma=gamma, reactant_types=[self.type_A],
+            reactant_coefficients=[1],
+            product_types=[self.type_B, self.type_C],
+            product_coefficients=[1, 1],
+            default_charges={self.type_A: 0, self.type_B: 0, self.type_C: 0})
+
+    def test_ideal_dissociation(self):
+        """
+        The number of dissociated particles n of the ideal reaction
+        A <-> B + C is distributed proportional to
+        (gamma V)^n / ((N0 - n)! n! n!). The particles move between the
+        reaction steps, so that they have to be resorted into the cells.
+        """
+        gamma = 20. / self.system.volume()
+        self.add_dissociation(gamma)
+
+        log_weights = np.array(
+            [n * math.log(gamma * self.system.volume())
+             - math.lgamma(self.N0 - n + 1.) - 2. * math.lgamma(n + 1.)
+             for n in range(self.N0 + 1)])
+        weights = np.exp(log_weights - np.max(log_weights))
+        n_expected = np.sum(np.arange(self.N0 + 1) * weights) / np.sum(weights)
+
+        for _ in range(20):
+            self.RE.parallel_reaction(2)
+            self.system.integrator.run(20)
+        n_B = []
+        for _ in range(300):
+            self.RE.parallel_reaction(2)
+            self.system.integrator.run(20)
+            n_B.append(self.system.number_of_particles(type=self.type_B))
+            self.assertEqual(self.system.number_of_particles(type=self.type_C),
+                             n_B[-1])
+            self.assertEqual(
+                self.system.number_of_particles(type=self.type_A) + n_B[-1],
+                self.N0)
+        self.assertAlmostEqual(np.mean(n_B), n_expected,
+                               delta=0.05 * n_expected)
+
+    def test_exceptions(self):
+        self.add_dissociation(1.)
+        self.system.cell_system.set_n_square()
+        with self.assertRaisesRegex(RuntimeError, "require the domain decomposition cell system"):
+            self.RE.parallel_reaction()
+        self.assertEqual(self.system.number_of_particles(type=self.type_A),
+                         self.N0)
+
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_exceptions_electrostatics(self):
+        self.add_dissociation(1.)
+        self.system.part.add(pos=[[1., 1., 1.], [2., 2., 2.]], q=[1., -1.],
+                             type=2 * [self.type_B])
+        self.system.actors.add(espressomd.electrostatics.P3M(
+            prefactor=1., accuracy=1e-2, mesh=8, cao=3, r_cut=2.))
+        with self.assertRaisesRegex(RuntimeError, "do not support long-range electrostatics"):
+            self.RE.parallel_reaction()
+        self.assertEqual(self.system.number_of_particles(type=self.type_A),
+                         self.N0)
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -72,7 +72,14 @@ class CheckpointTest(ut.TestCase):
         with self.assertRaisesRegex(RuntimeError, 'grid dimensions mismatch'):
             lbf.load_checkpoint(cpt_path.format("-wrong-boxdim"), cpt_mode)
         lbf.load_checkpoint(cpt_path.format(""), cpt_mode)
-        precision = 9 if "LB.CPU" in modes else 5
+        precision = 1.5E-5
+        if "LB.CPU" in modes:
+            precision = 1.5E-9
+            if espressomd.has_features("LB_SINGLE_PRECISION"):
+                # the populations of at most 19 are rounded to float when
+                # they are set and when the checkpoint is loaded, each time
+                # by at most half a float epsilon relative to their magnitude
+                precision = 2 * 19 * np.finfo(np.float32).eps / 2
         m = np.pi / 12
         nx = lbf.shape[0]
         ny = lbf.shape[1]
@@ -83,10 +90,10 @@ class CheckpointTest(ut.TestCase):
         for i in range(nx):
             for j in range(ny):
                 for k in range(nz):
-                    np.testing.assert_almost_equal(
+                    np.testing.assert_allclose(
                         np.copy(lbf[i, j, k].population),
                         grid_3D[i, j, k] * np.arange(1, 20),
-                        decimal=precision)
+                        rtol=0., atol=precision)
         state = lbf.get_params()
         reference = {'agrid': 0.5, 'visc': 1.3, 'dens': 1.5, 'tau': 0.01,
                      'gamma_odd': 0.2, 'gamma_even': 0.3}